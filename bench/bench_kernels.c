@@ -0,0 +1,123 @@
+// Mesure des noyaux SoA/SIMD face au chemin scalaire historique (AoS,
+// deux multiply_matrix_vector par sommet avec la matrice passée par valeur).
+// Usage : bench_kernels [nb_elements] [repetitions]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "engine/kernels.h"
+#include "engine/object3d.h"
+#include "engine/soa.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float frand(void) {
+    return (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+int main(int argc, char* argv[]) {
+    int n = (argc > 1) ? atoi(argv[1]) : 100000;
+    int reps = (argc > 2) ? atoi(argv[2]) : 50;
+    if (n <= 0 || reps <= 0) {
+        printf("Usage : %s [nb_elements] [repetitions]\n", argv[0]);
+        return 1;
+    }
+
+    Mat4x4 mat_world = matrix_make_srt((Vec3D){1, 1, 1}, (Vec3D){0.3f, 0.7f, 0.1f}, (Vec3D){0, 0, 3});
+    Mat4x4 mat_proj = matrix_make_projection(90.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+    Mat4x4 mat_mvp = matrix_multiply_matrix(mat_world, mat_proj);
+
+    // --- Transformation de sommets ---
+    Vec3D* aos = (Vec3D*)malloc((size_t)n * sizeof(Vec3D));
+    Vec3D* aos_out = (Vec3D*)malloc((size_t)n * sizeof(Vec3D));
+    float* aos_w = (float*)malloc((size_t)n * sizeof(float));
+    VertexSoA soa;
+    vertex_soa_init(&soa);
+    float* ox = soa_alloc_floats(n);
+    float* oy = soa_alloc_floats(n);
+    float* oz = soa_alloc_floats(n);
+    float* ow = soa_alloc_floats(n);
+    for (int i = 0; i < n; ++i) {
+        aos[i] = (Vec3D){frand(), frand(), frand()};
+    }
+    vertex_soa_append(&soa, aos, n);
+
+    double t0 = now_seconds();
+    for (int r = 0; r < reps; ++r) {
+        for (int i = 0; i < n; ++i) {
+            Vec3D v_world;
+            float dummy_w;
+            multiply_matrix_vector(aos[i], &v_world, &dummy_w, mat_world);
+            multiply_matrix_vector(v_world, &aos_out[i], &aos_w[i], mat_proj);
+        }
+    }
+    double legacy = (now_seconds() - t0) / reps;
+    printf("transform  %-8s %9.3f ms  (%6.2f ns/sommet)  x1.00\n",
+           "legacy", legacy * 1e3, legacy * 1e9 / n);
+
+    SimdLevel best = simd_detect();
+    for (int level = SIMD_SCALAR; level <= (int)best; ++level) {
+        const SimdKernels* k = kernels_for_level((SimdLevel)level);
+        t0 = now_seconds();
+        for (int r = 0; r < reps; ++r) {
+            k->transform_points(&mat_mvp, soa.x, soa.y, soa.z, ox, oy, oz, ow, n);
+        }
+        double t = (now_seconds() - t0) / reps;
+        printf("transform  %-8s %9.3f ms  (%6.2f ns/sommet)  x%.2f\n",
+               k->name, t * 1e3, t * 1e9 / n, legacy / t);
+    }
+
+    // --- Intégration des corps ---
+    Object3D* objects = (Object3D*)calloc((size_t)n, sizeof(Object3D));
+    BodySoA bodies;
+    body_soa_init(&bodies);
+    body_soa_reserve(&bodies, n);
+    for (int i = 0; i < n; ++i) {
+        objects[i].velocity = (Vec3D){frand(), frand(), frand()};
+        objects[i].angular_velocity = (Vec3D){frand(), frand(), frand()};
+        objects[i].orientation = quat_identity();
+        object_set_mass(&objects[i], (i % 16 == 0) ? 0.0f : 1.0f);
+        int b = body_soa_push(&bodies);
+        bodies.vx[b] = objects[i].velocity.x;
+        bodies.vy[b] = objects[i].velocity.y;
+        bodies.vz[b] = objects[i].velocity.z;
+        bodies.inv_mass[b] = objects[i].inv_mass;
+    }
+    Vec3D g = {0.0f, -9.81f, 0.0f};
+    float dt = 1.0f / 60.0f;
+
+    t0 = now_seconds();
+    for (int r = 0; r < reps; ++r) {
+        for (int i = 0; i < n; ++i) {
+            Object3D* body = &objects[i];
+            if (body->inv_mass == 0.0f) continue;
+            body->velocity = vec3_add(body->velocity, vec3_scale(g, dt));
+            body->position = vec3_add(body->position, vec3_scale(body->velocity, dt));
+            body->orientation = quat_integrate(body->orientation, body->angular_velocity, dt);
+        }
+    }
+    legacy = (now_seconds() - t0) / reps;
+    printf("integrate  %-8s %9.3f ms  (%6.2f ns/corps)   x1.00\n",
+           "legacy", legacy * 1e3, legacy * 1e9 / n);
+
+    for (int level = SIMD_SCALAR; level <= (int)best; ++level) {
+        const SimdKernels* k = kernels_for_level((SimdLevel)level);
+        t0 = now_seconds();
+        for (int r = 0; r < reps; ++r) {
+            k->integrate_bodies(&bodies, g, dt, 0, n);
+        }
+        double t = (now_seconds() - t0) / reps;
+        printf("integrate  %-8s %9.3f ms  (%6.2f ns/corps)   x%.2f\n",
+               k->name, t * 1e3, t * 1e9 / n, legacy / t);
+    }
+
+    free(aos); free(aos_out); free(aos_w); free(objects);
+    soa_free_floats(ox); soa_free_floats(oy); soa_free_floats(oz); soa_free_floats(ow);
+    vertex_soa_free(&soa);
+    body_soa_free(&bodies);
+    return 0;
+}
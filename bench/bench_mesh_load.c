@@ -0,0 +1,95 @@
+// Temps de chargement : import OBJ (analyse du texte) face au format binaire
+// projeté en mémoire. Sans fichier, génère une grille de N x N sommets.
+// Usage : bench_mesh_load [fichier.obj | --grid N] [repertoire_temporaire]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/mesh.h"
+#include "engine/mesh_io.h"
+#include "engine/timer.h"
+
+// Grille de quadrilatères : N*N sommets, ~2*N*N arêtes
+static int write_grid_obj(const char* path, int n) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("Impossible de créer %s\n", path);
+        return 0;
+    }
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            fprintf(f, "v %.6f %.6f %.6f\n", i / (float)n, 0.01f * ((i * 7 + j * 13) % 17), j / (float)n);
+        }
+    }
+    for (int j = 0; j + 1 < n; ++j) {
+        for (int i = 0; i + 1 < n; ++i) {
+            int a = j * n + i + 1; // Index OBJ (à partir de 1)
+            fprintf(f, "f %d %d %d %d\n", a, a + 1, a + n + 1, a + n);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// Parcourt toutes les données pour inclure les défauts de page dans la mesure
+static double touch_mesh(const Mesh* mesh) {
+    double sum = 0.0;
+    for (int i = 0; i < mesh->num_vertices; ++i) sum += mesh->vertices[i].x;
+    for (int i = 0; i < mesh->num_edges; ++i) sum += mesh->edges[i].v1_idx;
+    return sum;
+}
+
+int main(int argc, char* argv[]) {
+    const char* obj_path = NULL;
+    const char* tmp_dir = "/tmp";
+    int grid = 1000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc) grid = atoi(argv[++i]);
+        else if (obj_path == NULL && strstr(argv[i], ".obj") != NULL) obj_path = argv[i];
+        else tmp_dir = argv[i];
+    }
+
+    char generated[512], binary[512];
+    snprintf(binary, sizeof(binary), "%s/bench_mesh_load.pmesh", tmp_dir);
+    if (obj_path == NULL) {
+        snprintf(generated, sizeof(generated), "%s/bench_mesh_load.obj", tmp_dir);
+        if (!write_grid_obj(generated, grid)) {
+            return 1;
+        }
+        obj_path = generated;
+    }
+
+    Mesh mesh;
+    uint64_t t0 = timer_now_ns();
+    if (!load_mesh_obj(&mesh, obj_path)) {
+        return 1;
+    }
+    uint64_t t1 = timer_now_ns();
+    double check_obj = touch_mesh(&mesh);
+    int ok = save_mesh_binary(&mesh, binary);
+    printf("%s : %d sommets, %d arêtes\n", obj_path, mesh.num_vertices, mesh.num_edges);
+    free_mesh(&mesh);
+    if (!ok) {
+        return 1;
+    }
+
+    uint64_t t2 = timer_now_ns();
+    if (!load_mesh_binary(&mesh, binary)) {
+        return 1;
+    }
+    uint64_t t3 = timer_now_ns();
+    double check_bin = touch_mesh(&mesh);
+    uint64_t t4 = timer_now_ns();
+    free_mesh(&mesh);
+
+    double obj_ms = timer_ns_to_ms(t1 - t0);
+    double map_ms = timer_ns_to_ms(t3 - t2);
+    double touch_ms = timer_ns_to_ms(t4 - t2);
+    printf("OBJ (analyse)             %9.3f ms\n", obj_ms);
+    printf("binaire (projection)      %9.3f ms  x%.0f\n", map_ms, obj_ms / (map_ms > 0.0 ? map_ms : 1e-6));
+    printf("binaire (projection+lecture) %6.3f ms  x%.0f\n", touch_ms, obj_ms / (touch_ms > 0.0 ? touch_ms : 1e-6));
+    if (check_obj != check_bin) {
+        printf("Contenus différents entre OBJ et binaire !\n");
+        return 1;
+    }
+    return 0;
+}
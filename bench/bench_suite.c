@@ -0,0 +1,589 @@
+// Suite de mesures reproductible des chemins chauds : produits matriciels,
+// transformation de scènes entières (1k à 10M sommets), pas de simulation
+// avec contacts et images complètes sans affichage. Les entrées sont générées par un générateur à graine fixe ;
+// chaque mesure est répétée et on retient la médiane (et le minimum).
+//
+// Sortie CSV (défaut) ou JSON ; --baseline compare chaque mesure à celle d'un
+// CSV produit auparavant par cet outil. La comparaison porte sur le minimum,
+// moins sensible que la médiane aux autres processus de la machine.
+// Usage : bench_suite [--format csv|json] [--output fichier] [--baseline fichier.csv]
+//                     [--tolerance 0.10] [--fail-on-regression]
+//                     [--filter sous-chaine] [--max-vertices N] [--samples N]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/broadphase.h"
+#include "engine/kernels.h"
+#include "engine/math3d.h"
+#include "engine/object3d.h"
+#include "engine/raster.h"
+#include "engine/render.h"
+#include "engine/soa.h"
+#include "engine/transform.h"
+#include "engine/timer.h"
+#include "engine/world.h"
+
+// --- Configuration ---
+#define BENCH_DEFAULT_SAMPLES 15
+#define BENCH_MIN_SAMPLES 3
+#define BENCH_SAMPLE_BUDGET_NS 20000000ull // Temps visé par échantillon (lot répété)
+#define BENCH_MAX_RESULTS 64
+#define BENCH_MATRICES 1024                // Jeu de travail des mesures mathématiques
+#define BENCH_SEED 0x2545f491u
+
+typedef struct {
+    char name[64];
+    long long n;        // Éléments traités par itération (sommets, produits, images)
+    int samples;
+    double median_ns;   // Par élément
+    double min_ns;
+    double baseline_ns; // Minimum de référence, 0 : absente de la référence
+} BenchResult;
+
+typedef void (*BenchFunc)(void* ctx, int iterations);
+
+typedef struct {
+    const char* filter;
+    int samples;
+    BenchResult results[BENCH_MAX_RESULTS];
+    int num_results;
+} BenchSuite;
+
+// Empêche le compilateur d'éliminer les calculs mesurés
+static volatile float bench_sink;
+
+static uint32_t rng_state = BENCH_SEED;
+
+// xorshift32 : mêmes entrées d'une exécution et d'une machine à l'autre
+static float frand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)(rng_state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Lance `fn` par lots dont la taille vise BENCH_SAMPLE_BUDGET_NS, puis
+// enregistre la médiane et le minimum du temps par élément
+static void bench_run(BenchSuite* suite, const char* name, long long n, BenchFunc fn, void* ctx) {
+    if (suite->filter != NULL && strstr(name, suite->filter) == NULL) {
+        return;
+    }
+    if (suite->num_results == BENCH_MAX_RESULTS) {
+        fprintf(stderr, "Trop de mesures, %s ignorée\n", name);
+        return;
+    }
+    // Échauffement (caches, pages, fréquence), qui sert aussi à calibrer le lot
+    uint64_t t0 = timer_now_ns();
+    fn(ctx, 1);
+    uint64_t once = timer_now_ns() - t0;
+    int iterations = once > 0 ? (int)(BENCH_SAMPLE_BUDGET_NS / once) : 1000;
+    if (iterations < 1) iterations = 1;
+    int samples = suite->samples;
+    if (once * (uint64_t)samples > 50 * BENCH_SAMPLE_BUDGET_NS && samples > BENCH_MIN_SAMPLES) {
+        samples = BENCH_MIN_SAMPLES; // Mesures très longues (10M sommets, grandes scènes)
+    }
+
+    double per_item[BENCH_DEFAULT_SAMPLES * 8];
+    if (samples > (int)(sizeof(per_item) / sizeof(per_item[0]))) {
+        samples = (int)(sizeof(per_item) / sizeof(per_item[0]));
+    }
+    for (int s = 0; s < samples; ++s) {
+        t0 = timer_now_ns();
+        fn(ctx, iterations);
+        per_item[s] = (double)(timer_now_ns() - t0) / ((double)iterations * (double)n);
+    }
+    qsort(per_item, samples, sizeof(double), compare_double);
+
+    BenchResult* r = &suite->results[suite->num_results++];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->n = n;
+    r->samples = samples;
+    r->median_ns = per_item[samples / 2];
+    r->min_ns = per_item[0];
+    fprintf(stderr, "%-32s %12lld %12.3f ns/élément\n", r->name, r->n, r->median_ns);
+}
+
+// --- Mathématiques ---
+
+typedef struct {
+    Mat4x4 a[BENCH_MATRICES], b[BENCH_MATRICES], out[BENCH_MATRICES];
+    Vec3D v[BENCH_MATRICES];
+    Vec3D euler[BENCH_MATRICES];
+    Quat q[BENCH_MATRICES];
+    Affine3x4 fa[BENCH_MATRICES], fb[BENCH_MATRICES], fout[BENCH_MATRICES];
+} MathContext;
+
+static void bench_matrix_multiply_matrix(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            c->out[i] = matrix_multiply_matrix(c->a[i], c->b[i]);
+        }
+        bench_sink = c->out[it & (BENCH_MATRICES - 1)].m[3][3];
+    }
+}
+
+static void bench_matrix_multiply_vector(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    float sum = 0.0f;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            Vec4D p = matrix_multiply_vector(c->a[i], c->v[i]);
+            sum += p.w;
+        }
+    }
+    bench_sink = sum;
+}
+
+static void bench_multiply_matrix_vector(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    float sum = 0.0f;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            Vec3D out;
+            float w;
+            multiply_matrix_vector(c->v[i], &out, &w, c->a[i]);
+            sum += w;
+        }
+    }
+    bench_sink = sum;
+}
+
+// Matrice monde depuis les angles d'Euler (trois rotations, six sin/cos)
+static void bench_matrix_make_srt(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            c->out[i] = matrix_make_srt((Vec3D){1.0f, 1.0f, 1.0f}, c->euler[i], c->v[i]);
+        }
+        bench_sink = c->out[it & (BENCH_MATRICES - 1)].m[3][0];
+    }
+}
+
+// La même depuis un quaternion, sans trigonométrie
+static void bench_affine_from_trs(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            c->fout[i] = affine_from_trs(c->v[i], c->q[i], (Vec3D){1.0f, 1.0f, 1.0f});
+        }
+        bench_sink = c->fout[it & (BENCH_MATRICES - 1)].m[3][0];
+    }
+}
+
+static void bench_affine_mul(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            c->fout[i] = affine_mul(&c->fa[i], &c->fb[i]);
+        }
+        bench_sink = c->fout[it & (BENCH_MATRICES - 1)].m[3][2];
+    }
+}
+
+static void bench_affine_mul_mat4(void* ctx, int iterations) {
+    MathContext* c = (MathContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < BENCH_MATRICES; ++i) {
+            c->out[i] = affine_mul_mat4(&c->fa[i], &c->b[i]);
+        }
+        bench_sink = c->out[it & (BENCH_MATRICES - 1)].m[3][3];
+    }
+}
+
+static void run_math(BenchSuite* suite) {
+    MathContext* c = (MathContext*)malloc(sizeof(MathContext));
+    if (c == NULL) {
+        return;
+    }
+    for (int i = 0; i < BENCH_MATRICES; ++i) {
+        c->a[i] = matrix_make_srt((Vec3D){1.0f, 1.0f, 1.0f}, (Vec3D){frand(), frand(), frand()},
+                                  (Vec3D){frand(), frand(), frand() + 3.0f});
+        c->b[i] = matrix_make_projection(60.0f + 30.0f * frand(), 4.0f / 3.0f, 0.1f, 100.0f);
+        c->v[i] = (Vec3D){frand(), frand(), frand()};
+        c->euler[i] = (Vec3D){frand(), frand(), frand()};
+        c->q[i] = quat_from_euler(c->euler[i]);
+        c->fa[i] = affine_from_trs(c->v[i], c->q[i], (Vec3D){1.0f, 1.0f, 1.0f});
+        c->fb[i] = affine_from_trs((Vec3D){frand(), frand(), frand()}, quat_from_euler(c->v[i]),
+                                   (Vec3D){1.0f, 1.0f, 1.0f});
+    }
+    bench_run(suite, "math/matrix_multiply_matrix", BENCH_MATRICES, bench_matrix_multiply_matrix, c);
+    bench_run(suite, "math/matrix_multiply_vector", BENCH_MATRICES, bench_matrix_multiply_vector, c);
+    bench_run(suite, "math/multiply_matrix_vector", BENCH_MATRICES, bench_multiply_matrix_vector, c);
+    bench_run(suite, "math/matrix_make_srt", BENCH_MATRICES, bench_matrix_make_srt, c);
+    bench_run(suite, "math/affine_from_trs", BENCH_MATRICES, bench_affine_from_trs, c);
+    bench_run(suite, "math/affine_mul", BENCH_MATRICES, bench_affine_mul, c);
+    bench_run(suite, "math/affine_mul_mat4", BENCH_MATRICES, bench_affine_mul_mat4, c);
+    free(c);
+}
+
+// --- Transformation de scènes entières ---
+
+typedef struct {
+    const SimdKernels* kernels;
+    Mat4x4 mvp;
+    VertexSoA in;
+    float *ox, *oy, *oz, *ow;
+    int n;
+} TransformContext;
+
+static void bench_transform(void* ctx, int iterations) {
+    TransformContext* c = (TransformContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        c->kernels->transform_points(&c->mvp, c->in.x, c->in.y, c->in.z,
+                                     c->ox, c->oy, c->oz, c->ow, c->n);
+    }
+    bench_sink = c->ow[c->n - 1];
+}
+
+static void run_transform(BenchSuite* suite, int max_vertices) {
+    TransformContext c;
+    memset(&c, 0, sizeof(c));
+    c.mvp = matrix_multiply_matrix(
+        matrix_make_srt((Vec3D){1, 1, 1}, (Vec3D){0.3f, 0.7f, 0.1f}, (Vec3D){0, 0, 3}),
+        matrix_make_projection(90.0f, 4.0f / 3.0f, 0.1f, 100.0f));
+    vertex_soa_init(&c.in);
+    if (!vertex_soa_reserve(&c.in, max_vertices)) {
+        fprintf(stderr, "Allocation impossible pour %d sommets\n", max_vertices);
+        return;
+    }
+    c.ox = soa_alloc_floats(max_vertices);
+    c.oy = soa_alloc_floats(max_vertices);
+    c.oz = soa_alloc_floats(max_vertices);
+    c.ow = soa_alloc_floats(max_vertices);
+    if (c.ox && c.oy && c.oz && c.ow) {
+        for (int i = 0; i < max_vertices; ++i) {
+            c.in.x[i] = frand();
+            c.in.y[i] = frand();
+            c.in.z[i] = frand();
+        }
+        c.in.count = max_vertices;
+
+        SimdLevel best = simd_detect();
+        for (int n = 1000; n <= max_vertices; n *= 10) {
+            for (int level = SIMD_SCALAR; level <= (int)best; ++level) {
+                char name[64];
+                c.kernels = kernels_for_level((SimdLevel)level);
+                c.n = n;
+                snprintf(name, sizeof(name), "transform/%s/%d", c.kernels->name, n);
+                bench_run(suite, name, n, bench_transform, &c);
+            }
+        }
+    }
+    soa_free_floats(c.ox); soa_free_floats(c.oy); soa_free_floats(c.oz); soa_free_floats(c.ow);
+    vertex_soa_free(&c.in);
+}
+
+// --- Pas de simulation avec contacts ---
+
+// Un pas complet : intégration, phase large, îlots, phase étroite et résolution
+static void bench_step(void* ctx, int iterations) {
+    World* world = (World*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        world_step(world);
+    }
+    bench_sink = world->state.py[world->num_bodies - 1];
+}
+
+// Piles de 5 cubes au repos sur un sol statique : la phase étroite domine, et
+// la cohérence d'un pas à l'autre est mesurée en comparant variétés reprises
+// et départ à froid. Le sommeil est désactivé, sauf pour la dernière variante
+// où toutes les piles sont endormies : il ne reste que la phase large.
+static void run_steps(BenchSuite* suite) {
+    static const int num_bodies = 2000;
+    static const char* modes[] = {"warm", "cold", "asleep"};
+    for (int mode = 0; mode < 3; ++mode) {
+        char name[64];
+        snprintf(name, sizeof(name), "step/piles/%d/%s", num_bodies, modes[mode]);
+        if (suite->filter != NULL && strstr(name, suite->filter) == NULL) {
+            continue;
+        }
+        World world;
+        create_world(&world, WORLD_DEFAULT_DT);
+        world_set_broadphase(&world, create_broadphase_sap());
+        world.manifolds.warm_start = mode != 1;
+        world.allow_sleep = mode == 2;
+        int num_piles = (num_bodies + 4) / 5;
+        int per_row = 1;
+        while (per_row * per_row < num_piles) ++per_row;
+        float extent = per_row * 3.0f;
+        Object3D ground;
+        create_cube(&ground, 1.0f);
+        ground.position = (Vec3D){extent * 0.5f, -0.5f, extent * 0.5f};
+        ground.scale = (Vec3D){extent + 2.0f, 1.0f, extent + 2.0f};
+        object_set_mass(&ground, 0.0f);
+        int built = world_add_body(&world, &ground) >= 0;
+        if (!built) free_object(&ground);
+        for (int i = 0; i < num_bodies && built; ++i) {
+            Object3D cube;
+            create_cube(&cube, 1.0f);
+            int pile = i / 5, level = i % 5;
+            cube.position = (Vec3D){(pile % per_row) * 3.0f + 1.0f, 0.5f + level * 1.0f, (pile / per_row) * 3.0f + 1.0f};
+            if (world_add_body(&world, &cube) < 0) {
+                free_object(&cube);
+                built = 0;
+            }
+        }
+        if (built) {
+            int settle = world.allow_sleep ? 120 : 60; // Mise au repos, puis endormissement
+            for (int k = 0; k < settle; ++k) world_step(&world);
+            bench_run(suite, name, 1, bench_step, &world);
+        }
+        free_world(&world);
+    }
+}
+
+// Pyramide de 210 cubes : chaque pas est dominé par le solveur, dont les
+// lignes couplent tous les étages au lieu de piles indépendantes
+static void run_pyramid(BenchSuite* suite) {
+    static const int base = 20;
+    const char* name = "step/pyramid/210";
+    if (suite->filter != NULL && strstr(name, suite->filter) == NULL) {
+        return;
+    }
+    World world;
+    create_world(&world, WORLD_DEFAULT_DT);
+    world_set_broadphase(&world, create_broadphase_sap());
+    world.allow_sleep = 0; // Sinon la pyramide s'endort et le solveur n'est plus mesuré
+    Object3D ground;
+    create_cube(&ground, 1.0f);
+    ground.position = (Vec3D){0.0f, -0.5f, 0.0f};
+    ground.scale = (Vec3D){base * 2.0f + 4.0f, 1.0f, 4.0f};
+    object_set_mass(&ground, 0.0f);
+    int built = world_add_body(&world, &ground) >= 0;
+    if (!built) free_object(&ground);
+    for (int level = 0; level < base && built; ++level) {
+        int count = base - level;
+        for (int i = 0; i < count && built; ++i) {
+            Object3D cube;
+            create_cube(&cube, 1.0f);
+            cube.position = (Vec3D){(i - 0.5f * (count - 1)) * 1.05f, 0.5f + level * 1.0f, 0.0f};
+            if (world_add_body(&world, &cube) < 0) {
+                free_object(&cube);
+                built = 0;
+            }
+        }
+    }
+    if (built) {
+        for (int k = 0; k < 60; ++k) world_step(&world); // Mise au repos
+        bench_run(suite, name, 1, bench_step, &world);
+    }
+    free_world(&world);
+}
+
+// --- Images complètes sans affichage ---
+
+typedef struct {
+    World world;
+    WireRenderer wire;
+    Framebuffer fb;
+    Mat4x4 view_proj;
+} FrameContext;
+
+// Un pas de simulation puis le rendu filaire complet, comme render_frames
+static void bench_frame(void* ctx, int iterations) {
+    FrameContext* c = (FrameContext*)ctx;
+    for (int it = 0; it < iterations; ++it) {
+        world_step(&c->world);
+        framebuffer_clear(&c->fb, RGBA(0, 0, 0, 255));
+        wire_renderer_begin(&c->wire);
+        wire_renderer_add_world(&c->wire, &c->world, &c->view_proj);
+        wire_renderer_draw(&c->wire, &c->fb, RGBA(255, 255, 255, 255));
+    }
+    bench_sink = (float)c->fb.pixels[c->fb.pitch * (c->fb.height / 2) + c->fb.width / 2];
+}
+
+static void run_frames(BenchSuite* suite) {
+    // Vue d'ensemble du champ de cubes, puis caméra au ras du champ (peu de
+    // cubes dans le tronc), sans puis avec élagage
+    static const struct {
+        int num_bodies;
+        int near_camera;
+        int culling;
+        const char* suffix;
+    } configs[] = {
+        {100, 0, 0, ""}, {1000, 0, 0, ""}, {10000, 0, 0, ""},
+        {10000, 1, 0, "/near"}, {10000, 1, 1, "/near/cull"},
+    };
+    for (size_t k = 0; k < sizeof(configs) / sizeof(configs[0]); ++k) {
+        int num_bodies = configs[k].num_bodies;
+        char name[64];
+        snprintf(name, sizeof(name), "frame/800x600/%d%s", num_bodies, configs[k].suffix);
+        if (suite->filter != NULL && strstr(name, suite->filter) == NULL) {
+            continue;
+        }
+        FrameContext c;
+        if (!create_framebuffer(&c.fb, 800, 600)) {
+            return;
+        }
+        wire_renderer_init(&c.wire, 800, 600);
+        wire_renderer_set_culling(&c.wire, configs[k].culling);
+        create_world(&c.world, WORLD_DEFAULT_DT);
+        c.world.gravity = (Vec3D){0.0f, 0.0f, 0.0f};
+        int per_row = 1;
+        while (per_row * per_row < num_bodies) ++per_row;
+        float half = 0.5f * (per_row - 1) * 2.0f;
+        int built = 1;
+        for (int i = 0; i < num_bodies && built; ++i) {
+            Object3D cube;
+            create_cube(&cube, 1.0f);
+            cube.position = (Vec3D){(i % per_row) * 2.0f - half, (i / per_row) * 2.0f - half, half * 1.5f + 3.0f};
+            cube.angular_velocity = (Vec3D){0.5f + 0.01f * (i % 7), 0.8f, 0.0f};
+            if (world_add_body(&c.world, &cube) < 0) {
+                free_object(&cube);
+                built = 0;
+            }
+        }
+        float camera_z = configs[k].near_camera ? half * 1.5f - 2.0f : 0.0f;
+        c.view_proj = matrix_multiply_matrix(matrix_make_translation(0.0f, 0.0f, -camera_z),
+                                             matrix_make_projection(90.0f, 800.0f / 600.0f, 0.1f, 1000.0f));
+        if (built) {
+            bench_run(suite, name, 1, bench_frame, &c);
+        }
+        free_world(&c.world);
+        wire_renderer_free(&c.wire);
+        free_framebuffer(&c.fb);
+    }
+}
+
+// --- Sorties ---
+
+static void write_csv(FILE* f, const BenchSuite* suite) {
+    fprintf(f, "# simd=%s\n", kernels_get()->name);
+    fprintf(f, "benchmark,n,samples,median_ns,min_ns\n");
+    for (int i = 0; i < suite->num_results; ++i) {
+        const BenchResult* r = &suite->results[i];
+        fprintf(f, "%s,%lld,%d,%.4f,%.4f\n", r->name, r->n, r->samples, r->median_ns, r->min_ns);
+    }
+}
+
+static void write_json(FILE* f, const BenchSuite* suite) {
+    fprintf(f, "{\"simd\":\"%s\",\"unit\":\"ns_per_item\",\"benchmarks\":[\n", kernels_get()->name);
+    for (int i = 0; i < suite->num_results; ++i) {
+        const BenchResult* r = &suite->results[i];
+        fprintf(f, "  {\"name\":\"%s\",\"n\":%lld,\"samples\":%d,\"median_ns\":%.4f,\"min_ns\":%.4f",
+                r->name, r->n, r->samples, r->median_ns, r->min_ns);
+        if (r->baseline_ns > 0.0) {
+            fprintf(f, ",\"baseline_min_ns\":%.4f,\"ratio\":%.4f", r->baseline_ns, r->min_ns / r->baseline_ns);
+        }
+        fprintf(f, "}%s\n", i + 1 < suite->num_results ? "," : "");
+    }
+    fprintf(f, "]}\n");
+}
+
+// Associe à chaque mesure le minimum de même nom dans un CSV de référence
+static int load_baseline(BenchSuite* suite, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Référence %s introuvable\n", path);
+        return 0;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char name[64];
+        long long n;
+        int samples;
+        double median, min;
+        if (line[0] == '#' || sscanf(line, "%63[^,],%lld,%d,%lf,%lf", name, &n, &samples, &median, &min) != 5) {
+            continue; // Commentaire ou en-tête
+        }
+        for (int i = 0; i < suite->num_results; ++i) {
+            if (strcmp(suite->results[i].name, name) == 0) {
+                suite->results[i].baseline_ns = min;
+            }
+        }
+    }
+    fclose(f);
+    return 1;
+}
+
+// Affiche les écarts à la référence ; retourne le nombre de régressions
+static int report_baseline(const BenchSuite* suite, double tolerance) {
+    int regressions = 0;
+    fprintf(stderr, "\n%-32s %12s %12s %8s   (minimum, ns/élément)\n", "mesure", "référence", "actuel", "ratio");
+    for (int i = 0; i < suite->num_results; ++i) {
+        const BenchResult* r = &suite->results[i];
+        if (r->baseline_ns <= 0.0) {
+            fprintf(stderr, "%-32s %12s %12.3f %8s\n", r->name, "-", r->min_ns, "nouveau");
+            continue;
+        }
+        double ratio = r->min_ns / r->baseline_ns;
+        const char* verdict = "";
+        if (ratio > 1.0 + tolerance) {
+            verdict = "  RÉGRESSION";
+            regressions++;
+        } else if (ratio < 1.0 - tolerance) {
+            verdict = "  gain";
+        }
+        fprintf(stderr, "%-32s %12.3f %12.3f %8.3f%s\n", r->name, r->baseline_ns, r->min_ns, ratio, verdict);
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    static BenchSuite suite;
+    const char* format = "csv";
+    const char* output_path = NULL;
+    const char* baseline_path = NULL;
+    double tolerance = 0.10;
+    int fail_on_regression = 0;
+    int max_vertices = 10000000;
+    suite.samples = BENCH_DEFAULT_SAMPLES;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) format = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output_path = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline_path = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--fail-on-regression") == 0) fail_on_regression = 1;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) suite.filter = argv[++i];
+        else if (strcmp(argv[i], "--max-vertices") == 0 && i + 1 < argc) max_vertices = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) suite.samples = atoi(argv[++i]);
+        else {
+            printf("Option inconnue : %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (strcmp(format, "csv") != 0 && strcmp(format, "json") != 0) {
+        printf("Format inconnu : %s (csv ou json)\n", format);
+        return 1;
+    }
+    if (max_vertices < 1000 || suite.samples < 1 || suite.samples > BENCH_DEFAULT_SAMPLES * 8) {
+        printf("--max-vertices doit valoir au moins 1000, --samples entre 1 et %d\n", BENCH_DEFAULT_SAMPLES * 8);
+        return 1;
+    }
+
+    run_math(&suite);
+    run_transform(&suite, max_vertices);
+    run_steps(&suite);
+    run_pyramid(&suite);
+    run_frames(&suite);
+
+    int regressions = 0;
+    if (baseline_path != NULL && load_baseline(&suite, baseline_path)) {
+        regressions = report_baseline(&suite, tolerance);
+    }
+
+    FILE* out = stdout;
+    if (output_path != NULL && (out = fopen(output_path, "w")) == NULL) {
+        printf("Impossible de créer %s\n", output_path);
+        return 1;
+    }
+    if (strcmp(format, "json") == 0) write_json(out, &suite);
+    else write_csv(out, &suite);
+    if (out != stdout && fclose(out) != 0) {
+        printf("Écriture incomplète de %s\n", output_path);
+        return 1;
+    }
+    if (regressions > 0) {
+        fprintf(stderr, "%d mesure(s) plus lente(s) de plus de %.0f %%\n", regressions, tolerance * 100.0);
+    }
+    return (fail_on_regression && regressions > 0) ? 2 : 0;
+}
@@ -0,0 +1,266 @@
+#include <stdatomic.h>
+#include <string.h>
+#include "alloc.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// --- Compteur ---
+
+#if PHYS_COUNT_ALLOCATIONS
+
+static atomic_ullong allocation_count;
+
+static void* counted(void* p) {
+    if (p != NULL) {
+        atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    }
+    return p;
+}
+
+void* mem_alloc(size_t size) { return counted(malloc(size)); }
+void* mem_calloc(size_t count, size_t size) { return counted(calloc(count, size)); }
+void* mem_realloc(void* p, size_t size) { return counted(realloc(p, size)); }
+void* mem_aligned_alloc(size_t alignment, size_t size) { return counted(aligned_alloc(alignment, size)); }
+void mem_free(void* p) { free(p); }
+
+uint64_t mem_allocation_count(void) {
+    return atomic_load_explicit(&allocation_count, memory_order_relaxed);
+}
+
+int mem_counting_enabled(void) { return 1; }
+
+#else
+
+uint64_t mem_allocation_count(void) { return 0; }
+int mem_counting_enabled(void) { return 0; }
+
+#endif
+
+// --- Pages ---
+
+#define HUGE_PAGE_SIZE ((uintptr_t)2 << 20)
+
+void mem_advise_huge_pages(void* p, size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    uintptr_t begin = ((uintptr_t)p + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    uintptr_t end = ((uintptr_t)p + size) & ~(HUGE_PAGE_SIZE - 1);
+    if (p != NULL && begin < end) {
+        madvise((void*)begin, end - begin, MADV_HUGEPAGE); // Simple conseil : échec sans conséquence
+    }
+#else
+    (void)p;
+    (void)size;
+#endif
+}
+
+// --- Arène ---
+
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t size;
+    size_t used;
+};
+
+// Les données d'un bloc de débordement suivent son en-tête, alignées
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_MAX_ALIGN - 1) & ~(size_t)(ARENA_MAX_ALIGN - 1))
+
+static size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void arena_init(Arena* a) {
+    memset(a, 0, sizeof(*a));
+}
+
+static void free_overflow(Arena* a) {
+    while (a->overflow != NULL) {
+        ArenaBlock* next = a->overflow->next;
+        mem_free(a->overflow);
+        a->overflow = next;
+    }
+}
+
+void arena_free(Arena* a) {
+    free_overflow(a);
+    mem_free(a->base);
+    memset(a, 0, sizeof(*a));
+}
+
+// Place `size` octets dans un tampon de `capacity` octets dont `*used` sont pris
+static void* bump(char* data, size_t capacity, size_t* used, size_t size, size_t alignment) {
+    size_t offset = round_up(*used, alignment);
+    if (data == NULL || offset + size > capacity) {
+        return NULL;
+    }
+    *used = offset + size;
+    return data + offset;
+}
+
+void* arena_alloc(Arena* a, size_t size, size_t alignment) {
+    if (alignment == 0) alignment = 1;
+    a->cycle_bytes += size + alignment - 1;
+    void* p = bump(a->base, a->size, &a->used, size, alignment);
+    if (p == NULL && a->overflow != NULL) {
+        ArenaBlock* b = a->overflow;
+        p = bump((char*)b + ARENA_HEADER_SIZE, b->size, &b->used, size, alignment);
+    }
+    if (p != NULL) {
+        return p;
+    }
+    // Débordement : nouveau bloc au moins deux fois plus grand que le précédent
+    size_t previous = a->overflow != NULL ? a->overflow->size : a->size;
+    size_t block = 2 * previous;
+    if (block < ARENA_DEFAULT_SIZE) block = ARENA_DEFAULT_SIZE;
+    if (block < size + alignment) block = round_up(size + alignment, ARENA_MAX_ALIGN);
+    ArenaBlock* b = (ArenaBlock*)mem_aligned_alloc(ARENA_MAX_ALIGN, ARENA_HEADER_SIZE + block);
+    if (b == NULL) {
+        return NULL;
+    }
+    b->next = a->overflow;
+    b->size = block;
+    b->used = 0;
+    a->overflow = b;
+    return bump((char*)b + ARENA_HEADER_SIZE, b->size, &b->used, size, alignment);
+}
+
+void arena_reset(Arena* a) {
+    if (a->cycle_bytes > a->peak) a->peak = a->cycle_bytes;
+    if (a->overflow != NULL) {
+        // Le cycle a débordé : un seul bloc principal pour le pic observé
+        free_overflow(a);
+        mem_free(a->base);
+        size_t size = round_up(a->peak > ARENA_DEFAULT_SIZE ? a->peak : ARENA_DEFAULT_SIZE, ARENA_MAX_ALIGN);
+        a->base = (char*)mem_aligned_alloc(ARENA_MAX_ALIGN, size);
+        a->size = a->base != NULL ? size : 0;
+    }
+    a->used = 0;
+    a->cycle_bytes = 0;
+}
+
+// --- Pool ---
+
+void pool_init(Pool* p, size_t block_size, int blocks_per_chunk) {
+    memset(p, 0, sizeof(*p));
+    p->block_size = round_up(block_size > 0 ? block_size : 1, ARENA_MAX_ALIGN);
+    p->blocks_per_chunk = blocks_per_chunk > 0 ? blocks_per_chunk : 1;
+    p->free_head = -1;
+}
+
+void pool_free(Pool* p) {
+    for (int c = 0; c < p->num_chunks; ++c) {
+        mem_free(p->chunks[c]);
+    }
+    mem_free(p->chunks);
+    mem_free(p->generation);
+    mem_free(p->next_free);
+    pool_init(p, p->block_size, p->blocks_per_chunk);
+}
+
+// Une tranche de plus, dont les blocs rejoignent la liste des blocs libres
+static int add_chunk(Pool* p) {
+    if (p->num_chunks == p->chunk_capacity) {
+        int capacity = p->chunk_capacity ? p->chunk_capacity * 2 : 8;
+        char** chunks = (char**)mem_realloc(p->chunks, (size_t)capacity * sizeof(char*));
+        if (chunks == NULL) {
+            return 0;
+        }
+        p->chunks = chunks;
+        p->chunk_capacity = capacity;
+    }
+    int first = p->num_chunks * p->blocks_per_chunk;
+    int blocks = first + p->blocks_per_chunk;
+    uint32_t* generation = (uint32_t*)mem_realloc(p->generation, (size_t)blocks * sizeof(uint32_t));
+    if (generation == NULL) {
+        return 0;
+    }
+    p->generation = generation;
+    int* next_free = (int*)mem_realloc(p->next_free, (size_t)blocks * sizeof(int));
+    if (next_free == NULL) {
+        return 0;
+    }
+    p->next_free = next_free;
+    char* chunk = (char*)mem_aligned_alloc(ARENA_MAX_ALIGN, p->block_size * (size_t)p->blocks_per_chunk);
+    if (chunk == NULL) {
+        return 0;
+    }
+    p->chunks[p->num_chunks++] = chunk;
+    for (int i = blocks - 1; i >= first; --i) {
+        p->generation[i] = 1;
+        p->next_free[i] = p->free_head;
+        p->free_head = i;
+    }
+    return 1;
+}
+
+static char* block_address(const Pool* p, int index) {
+    return p->chunks[index / p->blocks_per_chunk] + (size_t)(index % p->blocks_per_chunk) * p->block_size;
+}
+
+void* pool_alloc(Pool* p, PoolHandle* handle) {
+    *handle = POOL_NULL_HANDLE;
+    if (p->free_head < 0 && !add_chunk(p)) {
+        return NULL;
+    }
+    int index = p->free_head;
+    p->free_head = p->next_free[index];
+    p->next_free[index] = -2; // Occupé
+    p->count++;
+    *handle = (PoolHandle){(uint32_t)index, p->generation[index]};
+    return block_address(p, index);
+}
+
+static int handle_valid(const Pool* p, PoolHandle handle) {
+    int blocks = p->num_chunks * p->blocks_per_chunk;
+    return !pool_handle_is_null(handle) && handle.index < (uint32_t)blocks &&
+           p->next_free[handle.index] == -2 && p->generation[handle.index] == handle.generation;
+}
+
+void* pool_get(const Pool* p, PoolHandle handle) {
+    return handle_valid(p, handle) ? block_address(p, (int)handle.index) : NULL;
+}
+
+int pool_release(Pool* p, PoolHandle handle) {
+    if (!handle_valid(p, handle)) {
+        return 0;
+    }
+    int index = (int)handle.index;
+    uint32_t generation = p->generation[index] + 1;
+    p->generation[index] = generation != 0 ? generation : 1;
+    p->next_free[index] = p->free_head;
+    p->free_head = index;
+    p->count--;
+    return 1;
+}
+
+int pool_restore(Pool* p, const PoolHandle* handles, int count) {
+    pool_free(p);
+    for (int i = 0; i < count; ++i) {
+        if (pool_handle_is_null(handles[i]) || handles[i].index >= (uint32_t)INT32_MAX) {
+            return 0;
+        }
+        while ((uint32_t)(p->num_chunks * p->blocks_per_chunk) <= handles[i].index) {
+            if ((int64_t)(p->num_chunks + 1) * p->blocks_per_chunk > INT32_MAX || !add_chunk(p)) {
+                pool_free(p);
+                return 0;
+            }
+        }
+        if (p->next_free[handles[i].index] == -2) {
+            pool_free(p);
+            return 0;
+        }
+        p->next_free[handles[i].index] = -2;
+        p->generation[handles[i].index] = handles[i].generation;
+    }
+    // Blocs restants chaînés dans l'ordre des index, comme après add_chunk
+    p->free_head = -1;
+    for (int i = p->num_chunks * p->blocks_per_chunk - 1; i >= 0; --i) {
+        if (p->next_free[i] != -2) {
+            p->next_free[i] = p->free_head;
+            p->free_head = i;
+        }
+    }
+    p->count = count;
+    return 1;
+}
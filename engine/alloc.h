@@ -0,0 +1,138 @@
+#ifndef ENGINE_ALLOC_H
+#define ENGINE_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Allocations du moteur. Tout le tas passe par mem_alloc et ses variantes ;
+// avec -DPHYS_COUNT_ALLOCATIONS=1 (option CMake PHYS_COUNT_ALLOCATIONS,
+// activée par défaut en Debug), chaque allocation est comptée et
+// mem_allocation_count() relevé avant et après une série de pas vérifie
+// qu'une boucle en régime établi n'alloue plus rien. Sans compteur, ces
+// fonctions se réduisent aux appels de la libc.
+//
+// Deux allocateurs s'appuient dessus :
+// - Arena : tampon linéaire pour les données d'un pas ou d'une image, rendues
+//   d'un coup par arena_reset ;
+// - Pool : blocs de taille fixe pour les objets de longue durée (les
+//   articulations du monde), désignés par des poignées qui détectent l'usage
+//   d'un bloc déjà rendu.
+
+#ifndef PHYS_COUNT_ALLOCATIONS
+#define PHYS_COUNT_ALLOCATIONS 0
+#endif
+
+#if PHYS_COUNT_ALLOCATIONS
+
+void* mem_alloc(size_t size);
+void* mem_calloc(size_t count, size_t size);
+void* mem_realloc(void* p, size_t size);
+void* mem_aligned_alloc(size_t alignment, size_t size); // size multiple de alignment
+void mem_free(void* p);
+
+#else
+
+static inline void* mem_alloc(size_t size) { return malloc(size); }
+static inline void* mem_calloc(size_t count, size_t size) { return calloc(count, size); }
+static inline void* mem_realloc(void* p, size_t size) { return realloc(p, size); }
+static inline void* mem_aligned_alloc(size_t alignment, size_t size) { return aligned_alloc(alignment, size); }
+static inline void mem_free(void* p) { free(p); }
+
+#endif
+
+// Conseille au noyau des pages de 2 Mio pour la partie alignée de [p, p+size)
+// (Linux, MADV_HUGEPAGE) : à appeler sur un grand tableau encore vierge, dont
+// le premier remplissage coûte sinon un défaut de page tous les 4 Kio. Sans
+// effet ailleurs et sous 2 Mio.
+void mem_advise_huge_pages(void* p, size_t size);
+
+// Allocations réussies depuis le démarrage (un realloc compte pour une) ;
+// toujours 0 sans compteur
+uint64_t mem_allocation_count(void);
+
+// 1 si le compteur est compilé
+int mem_counting_enabled(void);
+
+// --- Arène ---
+#define ARENA_DEFAULT_SIZE 65536
+#define ARENA_MAX_ALIGN 64
+
+typedef struct ArenaBlock ArenaBlock; // Défini dans alloc.c
+
+// Les allocations d'un cycle (entre deux arena_reset) remplissent le bloc
+// principal ; au-delà, des blocs de débordement sont chaînés. arena_reset les
+// fusionne en un bloc principal assez grand pour le cycle le plus chargé :
+// une fois ce pic atteint, l'arène ne touche plus au tas.
+typedef struct {
+    char* base;
+    size_t size;
+    size_t used;
+    ArenaBlock* overflow; // Bloc de débordement courant (le plus récent)
+    size_t cycle_bytes;   // Octets demandés pendant le cycle, alignement compris
+    size_t peak;          // Maximum de cycle_bytes
+} Arena;
+
+void arena_init(Arena* a);
+void arena_free(Arena* a);
+
+// `size` octets alignés sur `alignment` (puissance de 2, ARENA_MAX_ALIGN au
+// plus), valides jusqu'au prochain arena_reset. NULL en cas d'échec d'allocation.
+void* arena_alloc(Arena* a, size_t size, size_t alignment);
+
+// Rend toutes les allocations du cycle
+void arena_reset(Arena* a);
+
+#define ARENA_NEW(arena, type, count) \
+    ((type*)arena_alloc((arena), (size_t)(count) * sizeof(type), _Alignof(type)))
+
+// --- Pool de blocs de taille fixe ---
+
+// Poignée vers un bloc : l'index du bloc et sa génération au moment de
+// l'allocation. Un bloc rendu change de génération, et les poignées qui le
+// désignaient encore sont refusées. La génération 0 est celle de la poignée nulle.
+typedef struct {
+    uint32_t index;
+    uint32_t generation;
+} PoolHandle;
+
+#define POOL_NULL_HANDLE ((PoolHandle){0, 0})
+
+static inline int pool_handle_is_null(PoolHandle h) { return h.generation == 0; }
+
+// Les blocs sont découpés dans des tranches de blocks_per_chunk blocs qui ne
+// sont jamais déplacées : un pointeur de bloc reste valide jusqu'à son retour
+// au pool. Aucun verrou : un pool partagé entre threads doit être protégé par
+// l'appelant.
+typedef struct {
+    size_t block_size;      // Multiple de ARENA_MAX_ALIGN
+    int blocks_per_chunk;
+    char** chunks;
+    int num_chunks;
+    int chunk_capacity;
+    uint32_t* generation;   // Par bloc
+    int* next_free;         // Chaînage des blocs libres
+    int free_head;          // -1 : aucun bloc libre
+    int count;              // Blocs occupés
+} Pool;
+
+void pool_init(Pool* p, size_t block_size, int blocks_per_chunk);
+void pool_free(Pool* p);
+
+// Bloc de block_size octets, aligné sur ARENA_MAX_ALIGN ; NULL en cas
+// d'échec d'allocation (handle reçoit alors la poignée nulle)
+void* pool_alloc(Pool* p, PoolHandle* handle);
+
+// Bloc désigné par la poignée ; NULL si elle est nulle ou périmée
+void* pool_get(const Pool* p, PoolHandle handle);
+
+// Rend le bloc au pool ; 0 si la poignée est nulle ou périmée (bloc déjà rendu)
+int pool_release(Pool* p, PoolHandle handle);
+
+// Vide le pool puis occupe exactement les blocs désignés par `handles`, avec
+// leurs générations : les poignées d'un état sauvegardé restent valides
+// après restauration. Les autres blocs sont libres. 0 si une poignée est
+// nulle ou en double, ou en cas d'échec d'allocation (pool vidé).
+int pool_restore(Pool* p, const PoolHandle* handles, int count);
+
+#endif
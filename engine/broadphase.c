@@ -0,0 +1,511 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "broadphase.h"
+#include "timer.h"
+
+// --- Fonctions communes ---
+
+int broadphase_add_pair(BroadPhase* bp, int a, int b) {
+    if (bp->num_pairs == bp->pair_capacity) {
+        int capacity = bp->pair_capacity ? bp->pair_capacity * 2 : 256;
+        BodyPair* pairs = (BodyPair*)mem_realloc(bp->pairs, capacity * sizeof(BodyPair));
+        if (pairs == NULL) {
+            return 0;
+        }
+        bp->pairs = pairs;
+        bp->pair_capacity = capacity;
+    }
+    bp->pairs[bp->num_pairs++] = (a < b) ? (BodyPair){a, b} : (BodyPair){b, a};
+    return 1;
+}
+
+void broadphase_update(BroadPhase* bp, const AABB* aabbs, int count) {
+    uint64_t start = timer_now_ns();
+    bp->num_pairs = 0;
+    bp->stats.num_tests = 0;
+    bp->find_pairs(bp, aabbs, count);
+    bp->stats.update_ns = timer_now_ns() - start;
+    bp->stats.total_ns += bp->stats.update_ns;
+    bp->stats.num_updates++;
+    bp->stats.num_aabbs = count;
+    bp->stats.num_pairs = bp->num_pairs;
+}
+
+size_t broadphase_state_size(const BroadPhase* bp) {
+    return (bp != NULL && bp->state_size != NULL) ? bp->state_size(bp) : 0;
+}
+
+void broadphase_save_state(const BroadPhase* bp, void* out) {
+    if (bp != NULL && bp->save_state != NULL) {
+        bp->save_state(bp, out);
+    }
+}
+
+int broadphase_load_state(BroadPhase* bp, const void* data, size_t size, int count) {
+    if (bp == NULL || bp->load_state == NULL) {
+        return size == 0;
+    }
+    return bp->load_state(bp, data, size, count);
+}
+
+void free_broadphase(BroadPhase* bp) {
+    if (bp == NULL) {
+        return;
+    }
+    mem_free(bp->pairs);
+    bp->destroy(bp);
+}
+
+// --- Force brute O(n²) ---
+
+static void brute_force_find_pairs(BroadPhase* bp, const AABB* aabbs, int count) {
+    for (int i = 0; i < count; ++i) {
+        for (int j = i + 1; j < count; ++j) {
+            if (aabb_overlap(&aabbs[i], &aabbs[j])) {
+                broadphase_add_pair(bp, i, j);
+            }
+        }
+    }
+    bp->stats.num_tests = (int64_t)count * (count - 1) / 2;
+}
+
+static void brute_force_destroy(BroadPhase* bp) {
+    mem_free(bp);
+}
+
+BroadPhase* create_broadphase_brute_force(void) {
+    BroadPhase* bp = (BroadPhase*)mem_calloc(1, sizeof(BroadPhase));
+    if (bp == NULL) {
+        return NULL;
+    }
+    bp->name = "brute_force";
+    bp->find_pairs = brute_force_find_pairs;
+    bp->destroy = brute_force_destroy;
+    return bp;
+}
+
+// --- Balayage-élagage (sweep and prune) ---
+
+typedef struct {
+    float value;
+    int body;   // Index du corps
+    int is_max; // 0 : extrémité min, 1 : extrémité max
+} SapEndpoint;
+
+typedef struct {
+    BroadPhase base;
+    SapEndpoint* endpoints; // 2 par corps, triés sur `axis`
+    int num_bodies;
+    int axis;               // 0 = x, 1 = y, 2 = z
+    int* active;            // Corps dont l'intervalle est ouvert pendant le balayage
+    int* active_slot;       // Position de chaque corps dans `active` (-1 si absent)
+} SapBroadPhase;
+
+static float aabb_axis(const AABB* box, int axis, int is_max) {
+    const Vec3D* v = is_max ? &box->max : &box->min;
+    return axis == 0 ? v->x : axis == 1 ? v->y : v->z;
+}
+
+// Tableaux pour `count` corps ; 0 en cas d'échec d'allocation
+static int sap_allocate(SapBroadPhase* sap, int count) {
+    mem_free(sap->endpoints);
+    mem_free(sap->active);
+    mem_free(sap->active_slot);
+    sap->endpoints = (SapEndpoint*)mem_alloc((size_t)(2 * count + 1) * sizeof(SapEndpoint));
+    sap->active = (int*)mem_alloc((size_t)(count + 1) * sizeof(int));
+    sap->active_slot = (int*)mem_alloc((size_t)(count + 1) * sizeof(int));
+    if (!sap->endpoints || !sap->active || !sap->active_slot) {
+        sap->num_bodies = 0;
+        return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        sap->active_slot[i] = -1;
+    }
+    sap->num_bodies = count;
+    return 1;
+}
+
+// Reconstruit les extrémités quand le nombre de corps change, sur l'axe
+// où les centres sont le plus dispersés
+static int sap_rebuild(SapBroadPhase* sap, const AABB* aabbs, int count) {
+    if (!sap_allocate(sap, count)) {
+        return 0;
+    }
+
+    double sum[3] = {0}, sum2[3] = {0};
+    for (int i = 0; i < count; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            double c = 0.5 * (aabb_axis(&aabbs[i], a, 0) + aabb_axis(&aabbs[i], a, 1));
+            sum[a] += c;
+            sum2[a] += c * c;
+        }
+    }
+    sap->axis = 0;
+    double best = -1.0;
+    for (int a = 0; a < 3; ++a) {
+        double variance = sum2[a] - sum[a] * sum[a] / (count ? count : 1);
+        if (variance > best) {
+            best = variance;
+            sap->axis = a;
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        sap->endpoints[2 * i] = (SapEndpoint){0.0f, i, 0};
+        sap->endpoints[2 * i + 1] = (SapEndpoint){0.0f, i, 1};
+    }
+    return 1;
+}
+
+static void sap_find_pairs(BroadPhase* bp, const AABB* aabbs, int count) {
+    SapBroadPhase* sap = (SapBroadPhase*)bp;
+    if (count != sap->num_bodies && !sap_rebuild(sap, aabbs, count)) {
+        return;
+    }
+
+    // Rafraîchit les valeurs puis trie par insertion : les corps bougeant peu
+    // d'un pas à l'autre, la liste est presque triée et le tri quasi linéaire
+    SapEndpoint* ep = sap->endpoints;
+    int n = 2 * count;
+    for (int i = 0; i < n; ++i) {
+        ep[i].value = aabb_axis(&aabbs[ep[i].body], sap->axis, ep[i].is_max);
+    }
+    for (int i = 1; i < n; ++i) {
+        SapEndpoint key = ep[i];
+        int j = i - 1;
+        // À valeur égale, les min passent avant les max pour garder les contacts tangents
+        while (j >= 0 && (ep[j].value > key.value ||
+                          (ep[j].value == key.value && ep[j].is_max && !key.is_max))) {
+            ep[j + 1] = ep[j];
+            --j;
+        }
+        ep[j + 1] = key;
+    }
+
+    // Balayage : chaque min est testé contre les intervalles ouverts
+    int num_active = 0;
+    int64_t tests = 0;
+    for (int i = 0; i < n; ++i) {
+        int body = ep[i].body;
+        if (!ep[i].is_max) {
+            for (int k = 0; k < num_active; ++k) {
+                tests++;
+                if (aabb_overlap(&aabbs[body], &aabbs[sap->active[k]])) {
+                    broadphase_add_pair(bp, body, sap->active[k]);
+                }
+            }
+            sap->active_slot[body] = num_active;
+            sap->active[num_active++] = body;
+        } else {
+            int slot = sap->active_slot[body];
+            int last = sap->active[--num_active];
+            sap->active[slot] = last;
+            sap->active_slot[last] = slot;
+            sap->active_slot[body] = -1;
+        }
+    }
+    bp->stats.num_tests = tests;
+}
+
+// État : l'axe, puis l'ordre des extrémités (corps, min/max). Les valeurs sont
+// relues dans les AABB au pas suivant, seul l'ordre issu des tris précédents compte.
+typedef struct {
+    int32_t axis;
+    int32_t num_bodies;
+} SapStateHeader;
+
+typedef struct {
+    int32_t body;
+    int32_t is_max;
+} SapStateEndpoint;
+
+// num_bodies vaut -1 quand une reconstruction est demandée (sap_load_state)
+static int sap_state_bodies(const SapBroadPhase* sap) {
+    return sap->num_bodies > 0 ? sap->num_bodies : 0;
+}
+
+static size_t sap_state_size(const BroadPhase* bp) {
+    const SapBroadPhase* sap = (const SapBroadPhase*)bp;
+    return sizeof(SapStateHeader) + (size_t)(2 * sap_state_bodies(sap)) * sizeof(SapStateEndpoint);
+}
+
+static void sap_save_state(const BroadPhase* bp, void* out) {
+    const SapBroadPhase* sap = (const SapBroadPhase*)bp;
+    SapStateHeader header = {sap->axis, sap_state_bodies(sap)};
+    memcpy(out, &header, sizeof(header));
+    SapStateEndpoint* ep = (SapStateEndpoint*)((char*)out + sizeof(header));
+    for (int i = 0; i < 2 * header.num_bodies; ++i) {
+        ep[i] = (SapStateEndpoint){sap->endpoints[i].body, sap->endpoints[i].is_max};
+    }
+}
+
+static int sap_load_state(BroadPhase* bp, const void* data, size_t size, int count) {
+    SapBroadPhase* sap = (SapBroadPhase*)bp;
+    SapStateHeader header;
+    if (size < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.num_bodies < 0 || header.axis < 0 || header.axis > 2 ||
+        size != sizeof(header) + (size_t)(2 * header.num_bodies) * sizeof(SapStateEndpoint)) {
+        return 0;
+    }
+    if (header.num_bodies != count) {
+        sap->num_bodies = -1; // Extrémités pas encore construites : le prochain pas les reconstruit
+        return 1;
+    }
+    if (!sap_allocate(sap, count)) {
+        return 0;
+    }
+    // Chaque corps doit avoir exactement une extrémité min et une max
+    // (active_slot sert de compteur, puis est remis à -1)
+    const SapStateEndpoint* ep = (const SapStateEndpoint*)((const char*)data + sizeof(header));
+    int ok = 1;
+    for (int i = 0; i < count; ++i) sap->active_slot[i] = 0;
+    for (int i = 0; ok && i < 2 * count; ++i) {
+        int body = ep[i].body;
+        ok = body >= 0 && body < count && (ep[i].is_max == 0 || ep[i].is_max == 1) &&
+             !(sap->active_slot[body] & (1 << ep[i].is_max));
+        if (ok) {
+            sap->active_slot[body] |= 1 << ep[i].is_max;
+            sap->endpoints[i] = (SapEndpoint){0.0f, body, ep[i].is_max};
+        }
+    }
+    for (int i = 0; i < count; ++i) sap->active_slot[i] = -1;
+    if (!ok) {
+        sap->num_bodies = -1; // Reconstruction complète au prochain pas
+        return 0;
+    }
+    sap->axis = header.axis;
+    return 1;
+}
+
+static void sap_destroy(BroadPhase* bp) {
+    SapBroadPhase* sap = (SapBroadPhase*)bp;
+    mem_free(sap->endpoints);
+    mem_free(sap->active);
+    mem_free(sap->active_slot);
+    mem_free(sap);
+}
+
+BroadPhase* create_broadphase_sap(void) {
+    SapBroadPhase* sap = (SapBroadPhase*)mem_calloc(1, sizeof(SapBroadPhase));
+    if (sap == NULL) {
+        return NULL;
+    }
+    sap->base.name = "sap";
+    sap->base.find_pairs = sap_find_pairs;
+    sap->base.destroy = sap_destroy;
+    sap->base.state_size = sap_state_size;
+    sap->base.save_state = sap_save_state;
+    sap->base.load_state = sap_load_state;
+    return &sap->base;
+}
+
+// --- Grille de hachage uniforme ---
+
+typedef struct {
+    uint32_t hash;
+    int cx, cy, cz;
+    int body;
+} GridEntry;
+
+typedef struct {
+    BodyPair* pairs;
+    int count;
+    int capacity;
+    int64_t tests;
+} PairChunk;
+
+typedef struct {
+    BroadPhase base;
+    float cell_size;     // Fixée à la création, ou 0 pour l'adapter à chaque pas
+    float inv_cell;      // Valeur utilisée pendant le pas courant
+    GridEntry* entries;
+    int entry_capacity;
+    int* cell_start;     // Début de chaque groupe de cellules identiques dans `entries`
+    int num_cells;
+    int cell_capacity;
+    PairChunk* chunks;   // Paires trouvées par chaque morceau du balayage parallèle
+    int chunk_capacity;
+    const AABB* aabbs;
+} HashGridBroadPhase;
+
+static uint32_t grid_hash(int cx, int cy, int cz) {
+    return ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u) ^ ((uint32_t)cz * 83492791u);
+}
+
+static int grid_entry_compare(const void* pa, const void* pb) {
+    const GridEntry* a = (const GridEntry*)pa;
+    const GridEntry* b = (const GridEntry*)pb;
+    if (a->hash != b->hash) return a->hash < b->hash ? -1 : 1;
+    if (a->cx != b->cx) return a->cx < b->cx ? -1 : 1;
+    if (a->cy != b->cy) return a->cy < b->cy ? -1 : 1;
+    if (a->cz != b->cz) return a->cz < b->cz ? -1 : 1;
+    return a->body - b->body;
+}
+
+static int grid_cell(float v, float inv_cell) {
+    return (int)floorf(v * inv_cell);
+}
+
+// Paires au sein des cellules [begin, end). Une paire partageant plusieurs
+// cellules n'est retenue que dans celle qui contient le coin min de l'intersection.
+static void hash_grid_cell_pairs(void* ctx, int begin, int end, int chunk_index) {
+    HashGridBroadPhase* grid = (HashGridBroadPhase*)ctx;
+    PairChunk* chunk = &grid->chunks[chunk_index];
+    const GridEntry* e = grid->entries;
+    const AABB* aabbs = grid->aabbs;
+    float inv_cell = grid->inv_cell;
+    chunk->count = 0;
+    chunk->tests = 0;
+
+    for (int cell = begin; cell < end; ++cell) {
+        int first = grid->cell_start[cell], last = grid->cell_start[cell + 1];
+        for (int i = first; i < last; ++i) {
+            for (int j = i + 1; j < last; ++j) {
+                const AABB* a = &aabbs[e[i].body];
+                const AABB* b = &aabbs[e[j].body];
+                chunk->tests++;
+                if (!aabb_overlap(a, b)) continue;
+                if (grid_cell(fmaxf(a->min.x, b->min.x), inv_cell) != e[i].cx ||
+                    grid_cell(fmaxf(a->min.y, b->min.y), inv_cell) != e[i].cy ||
+                    grid_cell(fmaxf(a->min.z, b->min.z), inv_cell) != e[i].cz) {
+                    continue;
+                }
+                if (chunk->count == chunk->capacity) {
+                    int capacity = chunk->capacity ? chunk->capacity * 2 : 64;
+                    BodyPair* pairs = (BodyPair*)mem_realloc(chunk->pairs, capacity * sizeof(BodyPair));
+                    if (pairs == NULL) {
+                        return;
+                    }
+                    chunk->pairs = pairs;
+                    chunk->capacity = capacity;
+                }
+                int pa = e[i].body, pb = e[j].body;
+                chunk->pairs[chunk->count++] = (pa < pb) ? (BodyPair){pa, pb} : (BodyPair){pb, pa};
+            }
+        }
+    }
+}
+
+static void hash_grid_find_pairs(BroadPhase* bp, const AABB* aabbs, int count) {
+    HashGridBroadPhase* grid = (HashGridBroadPhase*)bp;
+    if (count == 0) {
+        return;
+    }
+
+    float cell = grid->cell_size;
+    if (cell <= 0.0f) {
+        // Deux fois l'étendue moyenne : la plupart des AABB couvrent 1 à 8 cellules
+        double extent = 0.0;
+        for (int i = 0; i < count; ++i) {
+            extent += (aabbs[i].max.x - aabbs[i].min.x) + (aabbs[i].max.y - aabbs[i].min.y) +
+                      (aabbs[i].max.z - aabbs[i].min.z);
+        }
+        cell = (float)(2.0 * extent / (3.0 * count));
+        if (cell <= 0.0f) cell = 1.0f;
+    }
+    float inv_cell = 1.0f / cell;
+
+    // Insertion de chaque AABB dans toutes les cellules qu'elle recouvre
+    int num_entries = 0;
+    for (int i = 0; i < count; ++i) {
+        int x0 = grid_cell(aabbs[i].min.x, inv_cell), x1 = grid_cell(aabbs[i].max.x, inv_cell);
+        int y0 = grid_cell(aabbs[i].min.y, inv_cell), y1 = grid_cell(aabbs[i].max.y, inv_cell);
+        int z0 = grid_cell(aabbs[i].min.z, inv_cell), z1 = grid_cell(aabbs[i].max.z, inv_cell);
+        int needed = num_entries + (x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+        if (needed > grid->entry_capacity) {
+            int capacity = grid->entry_capacity ? grid->entry_capacity : 1024;
+            while (capacity < needed) capacity *= 2;
+            GridEntry* entries = (GridEntry*)mem_realloc(grid->entries, capacity * sizeof(GridEntry));
+            if (entries == NULL) {
+                return;
+            }
+            grid->entries = entries;
+            grid->entry_capacity = capacity;
+        }
+        for (int cx = x0; cx <= x1; ++cx)
+            for (int cy = y0; cy <= y1; ++cy)
+                for (int cz = z0; cz <= z1; ++cz)
+                    grid->entries[num_entries++] = (GridEntry){grid_hash(cx, cy, cz), cx, cy, cz, i};
+    }
+
+    qsort(grid->entries, num_entries, sizeof(GridEntry), grid_entry_compare);
+
+    // Regroupement des entrées d'une même cellule
+    GridEntry* e = grid->entries;
+    grid->num_cells = 0;
+    for (int start = 0; start < num_entries;) {
+        int end = start + 1;
+        while (end < num_entries && e[end].cx == e[start].cx && e[end].cy == e[start].cy &&
+               e[end].cz == e[start].cz) {
+            ++end;
+        }
+        if (grid->num_cells + 1 >= grid->cell_capacity) {
+            int capacity = grid->cell_capacity ? grid->cell_capacity * 2 : 1024;
+            int* cell_start = (int*)mem_realloc(grid->cell_start, capacity * sizeof(int));
+            if (cell_start == NULL) {
+                return;
+            }
+            grid->cell_start = cell_start;
+            grid->cell_capacity = capacity;
+        }
+        grid->cell_start[grid->num_cells++] = start;
+        start = end;
+    }
+    grid->cell_start[grid->num_cells] = num_entries;
+
+    // Test des paires cellule par cellule, en parallèle si un pool est fourni
+    int grain = bp->grain > 0 ? bp->grain : 256;
+    int num_chunks = job_chunk_count(grid->num_cells, grain);
+    if (num_chunks > grid->chunk_capacity) {
+        PairChunk* chunks = (PairChunk*)mem_realloc(grid->chunks, num_chunks * sizeof(PairChunk));
+        if (chunks == NULL) {
+            return;
+        }
+        memset(chunks + grid->chunk_capacity, 0,
+               (num_chunks - grid->chunk_capacity) * sizeof(PairChunk));
+        grid->chunks = chunks;
+        grid->chunk_capacity = num_chunks;
+    }
+    grid->inv_cell = inv_cell;
+    grid->aabbs = aabbs;
+    job_parallel_for(bp->jobs, grid->num_cells, grain, hash_grid_cell_pairs, grid);
+
+    // Fusion dans l'ordre des morceaux
+    int64_t tests = 0;
+    for (int k = 0; k < num_chunks; ++k) {
+        PairChunk* chunk = &grid->chunks[k];
+        for (int i = 0; i < chunk->count; ++i) {
+            broadphase_add_pair(bp, chunk->pairs[i].a, chunk->pairs[i].b);
+        }
+        tests += chunk->tests;
+    }
+    bp->stats.num_tests = tests;
+}
+
+static void hash_grid_destroy(BroadPhase* bp) {
+    HashGridBroadPhase* grid = (HashGridBroadPhase*)bp;
+    for (int k = 0; k < grid->chunk_capacity; ++k) {
+        mem_free(grid->chunks[k].pairs);
+    }
+    mem_free(grid->chunks);
+    mem_free(grid->cell_start);
+    mem_free(grid->entries);
+    mem_free(grid);
+}
+
+BroadPhase* create_broadphase_hash_grid(float cell_size) {
+    HashGridBroadPhase* grid = (HashGridBroadPhase*)mem_calloc(1, sizeof(HashGridBroadPhase));
+    if (grid == NULL) {
+        return NULL;
+    }
+    grid->base.name = "hash_grid";
+    grid->base.find_pairs = hash_grid_find_pairs;
+    grid->base.destroy = hash_grid_destroy;
+    grid->cell_size = cell_size;
+    return &grid->base;
+}
@@ -0,0 +1,76 @@
+#ifndef ENGINE_BROADPHASE_H
+#define ENGINE_BROADPHASE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "jobs.h"
+#include "math3d.h"
+
+// --- Structures ---
+// Paire candidate, toujours avec a < b
+typedef struct {
+    int a, b;
+} BodyPair;
+
+typedef struct {
+    int num_aabbs;
+    int num_pairs;
+    int64_t num_tests;     // Tests de chevauchement AABB effectués
+    uint64_t update_ns;    // Durée du dernier broadphase_update
+    uint64_t total_ns;     // Cumul depuis la création
+    uint64_t num_updates;
+} BroadPhaseStats;
+
+// Phase large interchangeable : chaque implémentation remplit `pairs`
+typedef struct BroadPhase BroadPhase;
+struct BroadPhase {
+    const char* name;
+    void (*find_pairs)(BroadPhase* bp, const AABB* aabbs, int count);
+    void (*destroy)(BroadPhase* bp);
+
+    // État conservé d'un pas à l'autre et dont dépend l'ordre des paires, pour
+    // les instantanés (NULL pour une structure reconstruite à chaque pas)
+    size_t (*state_size)(const BroadPhase* bp);
+    void (*save_state)(const BroadPhase* bp, void* out);
+    int (*load_state)(BroadPhase* bp, const void* data, size_t size, int count);
+
+    BodyPair* pairs;
+    int num_pairs;
+    int pair_capacity;
+    BroadPhaseStats stats;
+
+    // Parallélisme optionnel (grille) ; les paires sont fusionnées dans l'ordre
+    // des morceaux, donc déterministes tant que `grain` ne dépend pas du pool
+    JobSystem* jobs;
+    int grain;
+};
+
+// Test O(n²) de référence, pour valider les autres structures
+BroadPhase* create_broadphase_brute_force(void);
+// Balayage-élagage incrémental : l'ordre trié des extrémités est conservé
+// d'un pas à l'autre et remis en ordre par tri par insertion
+BroadPhase* create_broadphase_sap(void);
+// Grille de hachage uniforme ; cell_size <= 0 : taille déduite des AABB
+BroadPhase* create_broadphase_hash_grid(float cell_size);
+void free_broadphase(BroadPhase* bp);
+
+// Calcule les paires candidates et met à jour les statistiques
+void broadphase_update(BroadPhase* bp, const AABB* aabbs, int count);
+
+// État persistant : broadphase_state_size(bp) octets écrits par
+// broadphase_save_state (0 sans état). broadphase_load_state le reprend pour
+// `count` corps ; 0 si les données sont incohérentes ou l'allocation impossible.
+size_t broadphase_state_size(const BroadPhase* bp);
+void broadphase_save_state(const BroadPhase* bp, void* out);
+int broadphase_load_state(BroadPhase* bp, const void* data, size_t size, int count);
+
+static inline int aabb_overlap(const AABB* a, const AABB* b) {
+    return a->min.x <= b->max.x && a->max.x >= b->min.x &&
+           a->min.y <= b->max.y && a->max.y >= b->min.y &&
+           a->min.z <= b->max.z && a->max.z >= b->min.z;
+}
+
+// Ajoute une paire (usage interne des implémentations) ; 0 si allocation impossible
+int broadphase_add_pair(BroadPhase* bp, int a, int b);
+
+#endif
@@ -0,0 +1,218 @@
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "bvh.h"
+
+void bvh_init(Bvh* bvh) {
+    memset(bvh, 0, sizeof(*bvh));
+}
+
+void bvh_free(Bvh* bvh) {
+    mem_free(bvh->nodes);
+    mem_free(bvh->items);
+    mem_free(bvh->leaf_of);
+    mem_free(bvh->boxes);
+    mem_free(bvh->dirty);
+    bvh_init(bvh);
+}
+
+static inline AABB aabb_union(const AABB* a, const AABB* b) {
+    return (AABB){{fminf(a->min.x, b->min.x), fminf(a->min.y, b->min.y), fminf(a->min.z, b->min.z)},
+                  {fmaxf(a->max.x, b->max.x), fmaxf(a->max.y, b->max.y), fmaxf(a->max.z, b->max.z)}};
+}
+
+// Demi-aire de la surface : coût d'un nœud pour l'heuristique de reconstruction
+static inline float aabb_area(const AABB* box) {
+    float dx = box->max.x - box->min.x, dy = box->max.y - box->min.y, dz = box->max.z - box->min.z;
+    if (dx < 0.0f || dy < 0.0f || dz < 0.0f) return 0.0f; // Boîte vide
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static inline float box_center(const AABB* box, int axis) {
+    const float* lo = &box->min.x;
+    const float* hi = &box->max.x;
+    return lo[axis] + hi[axis];
+}
+
+static int reserve_items(Bvh* bvh, int count) {
+    if (count <= bvh->item_capacity) {
+        return 1;
+    }
+    int capacity = bvh->item_capacity ? bvh->item_capacity * 2 : 64;
+    while (capacity < count) capacity *= 2;
+    int node_capacity = 2 * capacity; // Arbre binaire : moins de 2n nœuds
+#define GROW(field, type, n)                                                   \
+    do {                                                                       \
+        type* grown = (type*)mem_realloc(bvh->field, (size_t)(n) * sizeof(type));  \
+        if (grown == NULL) return 0;                                           \
+        bvh->field = grown;                                                    \
+    } while (0)
+    GROW(items, int, capacity);
+    GROW(leaf_of, int, capacity);
+    GROW(boxes, AABB, capacity);
+    GROW(nodes, BvhNode, node_capacity);
+    GROW(dirty, uint8_t, node_capacity);
+#undef GROW
+    bvh->item_capacity = capacity;
+    bvh->node_capacity = node_capacity;
+    return 1;
+}
+
+// Place l'objet de rang k (selon le centre sur `axis`) en items[k], les plus
+// petits avant, les plus grands après (sélection rapide, O(n) en moyenne)
+static void select_median(const Bvh* bvh, int* items, int count, int k, int axis) {
+    int lo = 0, hi = count - 1;
+    while (lo < hi) {
+        float pivot = box_center(&bvh->boxes[items[(lo + hi) / 2]], axis);
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (box_center(&bvh->boxes[items[i]], axis) < pivot) ++i;
+            while (box_center(&bvh->boxes[items[j]], axis) > pivot) --j;
+            if (i <= j) {
+                int t = items[i];
+                items[i++] = items[j];
+                items[j--] = t;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+}
+
+static void build_node(Bvh* bvh, int node, int first, int count) {
+    BvhNode* n = &bvh->nodes[node];
+    n->first = first;
+    n->count = count;
+    n->left = -1;
+    n->box = bvh->boxes[bvh->items[first]];
+    AABB centers = {{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+    for (int i = first; i < first + count; ++i) {
+        const AABB* box = &bvh->boxes[bvh->items[i]];
+        n->box = aabb_union(&n->box, box);
+        Vec3D c = {box_center(box, 0), box_center(box, 1), box_center(box, 2)};
+        centers.min = (Vec3D){fminf(centers.min.x, c.x), fminf(centers.min.y, c.y), fminf(centers.min.z, c.z)};
+        centers.max = (Vec3D){fmaxf(centers.max.x, c.x), fmaxf(centers.max.y, c.y), fmaxf(centers.max.z, c.z)};
+    }
+    bvh->dirty[node] = 0;
+    bvh->built_cost += aabb_area(&n->box);
+    if (count <= BVH_LEAF_SIZE) {
+        for (int i = first; i < first + count; ++i) {
+            bvh->leaf_of[bvh->items[i]] = node;
+        }
+        return;
+    }
+
+    Vec3D extent = vec3_sub(centers.max, centers.min);
+    int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int half = count / 2;
+    select_median(bvh, bvh->items + first, count, half, axis);
+    // Les deux enfants sont alloués ensemble, après tous les nœuds existants
+    int left = bvh->num_nodes;
+    bvh->num_nodes += 2;
+    bvh->nodes[node].left = left;
+    build_node(bvh, left, first, half);
+    build_node(bvh, left + 1, first + half, count - half);
+}
+
+int bvh_build(Bvh* bvh, const AABB* boxes, int count) {
+    if (!reserve_items(bvh, count)) {
+        return 0;
+    }
+    memcpy(bvh->boxes, boxes, (size_t)count * sizeof(AABB));
+    for (int i = 0; i < count; ++i) {
+        bvh->items[i] = i;
+    }
+    bvh->num_items = count;
+    bvh->num_nodes = 0;
+    bvh->built_cost = 0.0f;
+    if (count > 0) {
+        bvh->num_nodes = 1;
+        build_node(bvh, 0, 0, count);
+    }
+    bvh->cost = bvh->built_cost;
+    bvh->num_refit = bvh->num_nodes;
+    bvh->num_builds++;
+    return 1;
+}
+
+int bvh_update(Bvh* bvh, const AABB* boxes, int count) {
+    if (count != bvh->num_items || bvh->num_builds == 0) {
+        return bvh_build(bvh, boxes, count);
+    }
+    // Objets déplacés : leur feuille est à recalculer
+    for (int i = 0; i < count; ++i) {
+        if (memcmp(&boxes[i], &bvh->boxes[i], sizeof(AABB)) != 0) {
+            bvh->boxes[i] = boxes[i];
+            bvh->dirty[bvh->leaf_of[i]] = 1;
+        }
+    }
+    // Remontée : un parent n'est recalculé que si la boîte d'un enfant a changé
+    bvh->num_refit = 0;
+    for (int node = bvh->num_nodes - 1; node >= 0; --node) {
+        BvhNode* n = &bvh->nodes[node];
+        AABB box;
+        if (n->left < 0) {
+            if (!bvh->dirty[node]) continue;
+            box = bvh->boxes[bvh->items[n->first]];
+            for (int i = n->first + 1; i < n->first + n->count; ++i) {
+                box = aabb_union(&box, &bvh->boxes[bvh->items[i]]);
+            }
+        } else {
+            int changed = bvh->dirty[n->left] | bvh->dirty[n->left + 1];
+            bvh->dirty[n->left] = bvh->dirty[n->left + 1] = 0;
+            if (!changed) continue;
+            box = aabb_union(&bvh->nodes[n->left].box, &bvh->nodes[n->left + 1].box);
+        }
+        bvh->num_refit++;
+        bvh->dirty[node] = memcmp(&box, &n->box, sizeof(AABB)) != 0;
+        bvh->cost += aabb_area(&box) - aabb_area(&n->box);
+        n->box = box;
+    }
+    if (bvh->num_nodes > 0) {
+        bvh->dirty[0] = 0;
+    }
+    if (bvh->cost > BVH_REBUILD_RATIO * bvh->built_cost) {
+        return bvh_build(bvh, boxes, count);
+    }
+    return 1;
+}
+
+int bvh_query_frustum(const Bvh* bvh, const Frustum* f, int* out) {
+    if (bvh->num_nodes == 0) {
+        return 0;
+    }
+    // Pile de nœuds à visiter, chacun avec les plans que son parent chevauche
+    int stack[BVH_MAX_DEPTH + 1];
+    unsigned masks[BVH_MAX_DEPTH + 1];
+    int top = 0, count = 0;
+    stack[top] = 0;
+    masks[top++] = 0x3Fu;
+    while (top > 0) {
+        --top;
+        const BvhNode* n = &bvh->nodes[stack[top]];
+        unsigned mask = masks[top];
+        FrustumResult result = frustum_test_aabb(f, &n->box, &mask);
+        if (result == FRUSTUM_OUTSIDE) {
+            continue;
+        }
+        if (result == FRUSTUM_INSIDE) {
+            memcpy(out + count, bvh->items + n->first, (size_t)n->count * sizeof(int));
+            count += n->count;
+        } else if (n->left < 0) {
+            for (int i = n->first; i < n->first + n->count; ++i) {
+                unsigned item_mask = mask;
+                if (frustum_test_aabb(f, &bvh->boxes[bvh->items[i]], &item_mask) != FRUSTUM_OUTSIDE) {
+                    out[count++] = bvh->items[i];
+                }
+            }
+        } else {
+            // Droit empilé en premier : le gauche est visité d'abord
+            stack[top] = n->left + 1;
+            masks[top++] = mask;
+            stack[top] = n->left;
+            masks[top++] = mask;
+        }
+    }
+    return count;
+}
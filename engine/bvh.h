@@ -0,0 +1,60 @@
+#ifndef ENGINE_BVH_H
+#define ENGINE_BVH_H
+
+#include <stdint.h>
+#include "frustum.h"
+#include "math3d.h"
+
+// --- Configuration ---
+#define BVH_LEAF_SIZE 4          // Objets par feuille au plus
+#define BVH_REBUILD_RATIO 2.0f   // Reconstruction si la somme des aires a doublé depuis la construction
+#define BVH_MAX_DEPTH 64
+
+// Nœud de la hiérarchie. Les objets d'un sous-arbre sont contigus dans
+// `items`, si bien qu'un nœud entièrement visible se vide d'un bloc.
+typedef struct {
+    AABB box;
+    int first, count;   // Objets du sous-arbre : items[first..first + count)
+    int left;           // Premier enfant (le second est left + 1), -1 pour une feuille
+} BvhNode;
+
+// Hiérarchie de boîtes englobantes, construite une fois puis réajustée.
+// Les nœuds sont stockés en préordre : les enfants ont toujours un index
+// supérieur à leur parent, et un parcours à rebours réajuste l'arbre du bas
+// vers le haut. Seules les feuilles dont un objet a bougé, et leurs ancêtres
+// dont la boîte change réellement, sont recalculés.
+typedef struct {
+    BvhNode* nodes;
+    int num_nodes;
+    int node_capacity;
+    int* items;         // Index des objets, regroupés par sous-arbre
+    int* leaf_of;       // Feuille contenant chaque objet
+    AABB* boxes;        // Boîte de chaque objet à la dernière mise à jour
+    uint8_t* dirty;     // Par nœud : boîte à recalculer (feuilles) ou modifiée (remontée)
+    int num_items;
+    int item_capacity;
+    float built_cost;   // Somme des aires des nœuds juste après la construction
+    float cost;         // La même somme, tenue à jour au fil des réajustements
+    int num_refit;      // Nœuds recalculés par la dernière mise à jour
+    int num_builds;
+} Bvh;
+
+void bvh_init(Bvh* bvh);
+void bvh_free(Bvh* bvh);
+
+// Construction descendante : coupe à la médiane des centres, selon l'axe le
+// plus étendu. Retourne 0 en cas d'échec d'allocation.
+int bvh_build(Bvh* bvh, const AABB* boxes, int count);
+
+// Reprend les boîtes des objets : construction si leur nombre a changé,
+// réajustement incrémental sinon, et reconstruction quand la hiérarchie s'est
+// trop dégradée (BVH_REBUILD_RATIO). Retourne 0 en cas d'échec d'allocation.
+int bvh_update(Bvh* bvh, const AABB* boxes, int count);
+
+// Écrit dans `out` (num_items places) les objets dont la boîte n'est pas
+// entièrement hors du tronc et retourne leur nombre. Un sous-arbre hors du
+// tronc est écarté d'un seul test ; un sous-arbre entièrement dedans est
+// recopié sans plus aucun test.
+int bvh_query_frustum(const Bvh* bvh, const Frustum* f, int* out);
+
+#endif
@@ -0,0 +1,40 @@
+#include "ccd.h"
+
+static ConvexHull hull_at(const CcdBody* b, float t) {
+    return (ConvexHull){b->x, b->y, b->z, b->count,
+                        affine_from_trs(ccd_position_at(b, t), ccd_orientation_at(b, t), b->scale)};
+}
+
+int ccd_time_of_impact(const CcdBody* a, const CcdBody* b, float dt, TimeOfImpact* out) {
+    // Un point à distance r de l'origine d'un corps tournant à |w| rad/s
+    // avance d'au plus |w| r par seconde, dans toutes les directions
+    float spin = vec3_length(a->angular_velocity) * a->radius + vec3_length(b->angular_velocity) * b->radius;
+    Vec3D relative = vec3_sub(a->velocity, b->velocity);
+    Vec3D normal = {0.0f, 0.0f, 0.0f};
+    float t = 0.0f;
+    for (int iter = 0; iter < CCD_MAX_ITERATIONS; ++iter) {
+        ConvexHull hull_a = hull_at(a, t), hull_b = hull_at(b, t);
+        float dist = gjk_distance(&hull_a, &hull_b, &normal);
+        if (dist <= CCD_TOLERANCE) {
+            if (iter == 0) {
+                return 0;
+            }
+            *out = (TimeOfImpact){t, normal, iter + 1};
+            return 1;
+        }
+        float closing = vec3_dot(relative, normal) + spin;
+        if (closing <= 0.0f) {
+            return 0; // Ils s'éloignent : plus aucun contact possible pendant le pas
+        }
+        // Viser la moitié de la tolérance : l'avance ne peut jamais faire
+        // passer les enveloppes l'une dans l'autre
+        t += (dist - 0.5f * CCD_TOLERANCE) / closing;
+        if (t >= dt) {
+            return 0;
+        }
+    }
+    // Convergence trop lente (rotation rapide) : on s'arrête là où l'on est
+    // sûr qu'il n'y a pas encore de contact
+    *out = (TimeOfImpact){t, normal, CCD_MAX_ITERATIONS};
+    return 1;
+}
@@ -0,0 +1,56 @@
+#ifndef ENGINE_CCD_H
+#define ENGINE_CCD_H
+
+#include "gjk.h"
+#include "math3d.h"
+#include "transform.h"
+
+// --- Configuration ---
+#define CCD_MAX_ITERATIONS 32
+#define CCD_TOLERANCE 0.005f  // Distance (m) sous laquelle le contact est déclaré
+
+// --- Détection continue des collisions ---
+// Avance conservatrice : tant que les enveloppes sont à une distance d,
+// aucun point de l'une ne peut toucher l'autre avant d / v, où v borne la
+// vitesse de rapprochement le long de la normale (vitesse relative plus
+// rotation des deux corps). On avance de ce temps, on remesure, et l'on
+// s'arrête quand la distance passe sous CCD_TOLERANCE ou que le pas est
+// épuisé. Aucun contact n'est manqué, si mince que soit l'obstacle, tant que
+// les vitesses restent constantes pendant le pas, ce que fait l'intégration
+// des positions après le solveur.
+
+// Un corps pendant le pas : enveloppe, pose de départ et vitesses constantes
+typedef struct {
+    const float *x, *y, *z;   // Sommets locaux (ceux du MeshAsset partagé)
+    int count;
+    Vec3D scale;
+    Vec3D position;
+    Quat orientation;
+    Vec3D velocity;           // m/s
+    Vec3D angular_velocity;   // rad/s, repère monde
+    float radius;             // Distance maximale de l'origine du corps à ses sommets
+} CcdBody;
+
+typedef struct {
+    float t;           // Instant du contact, en secondes depuis le début du pas
+    Vec3D normal;      // De A vers B à cet instant
+    int iterations;
+} TimeOfImpact;
+
+// Position et orientation de `b` à l'instant t du pas, intégrées comme le
+// fait integrate_bodies : la pose en fin de pas est celle des noyaux
+static inline Vec3D ccd_position_at(const CcdBody* b, float t) {
+    return vec3_add(b->position, vec3_scale(b->velocity, t));
+}
+
+static inline Quat ccd_orientation_at(const CcdBody* b, float t) {
+    return quat_integrate(b->orientation, b->angular_velocity, t);
+}
+
+// Premier instant du pas [0, dt) où A et B passent à moins de
+// CCD_TOLERANCE l'un de l'autre. Retourne 0 s'ils restent séparés pendant
+// tout le pas, ou s'ils se touchent déjà au départ (la phase étroite s'en
+// charge) ; sinon 1, avec l'instant et la normale dans `out`.
+int ccd_time_of_impact(const CcdBody* a, const CcdBody* b, float dt, TimeOfImpact* out);
+
+#endif
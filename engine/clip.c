@@ -0,0 +1,73 @@
+#include "clip.h"
+
+// Sous ce w, la division perspective n'a plus de sens : le sommet est sur l'œil
+#define CLIP_MIN_W 1e-6f
+
+void clip_outcodes(const float* x, const float* y, const float* z, const float* w,
+                   uint8_t* codes, int n, ClipDepth depth) {
+    float z_scale = (depth == CLIP_DEPTH_ZERO_TO_ONE) ? 0.0f : 1.0f; // Plan proche : z >= -z_scale * w
+    for (int i = 0; i < n; ++i) {
+        float wi = w[i];
+        codes[i] = (uint8_t)((x[i] < -wi) * CLIP_LEFT | (x[i] > wi) * CLIP_RIGHT |
+                             (y[i] < -wi) * CLIP_BOTTOM | (y[i] > wi) * CLIP_TOP |
+                             (z[i] < -z_scale * wi) * CLIP_NEAR | (z[i] > wi) * CLIP_FAR);
+    }
+}
+
+// Distance signée (positive dedans) du point au plan `plane` (0..5)
+static float plane_distance(const float p[4], int plane, float z_scale) {
+    switch (plane) {
+        case 0: return p[3] + p[0];
+        case 1: return p[3] - p[0];
+        case 2: return p[3] + p[1];
+        case 3: return p[3] - p[1];
+        case 4: return p[2] + z_scale * p[3];
+        default: return p[3] - p[2];
+    }
+}
+
+// Liang-Barsky en coordonnées homogènes : l'intervalle [t0, t1] du paramètre
+// est réduit plan par plan, uniquement pour les plans traversés par le segment.
+ClipResult clip_segment(const float a[4], const float b[4], int code_a, int code_b,
+                        float out_a[4], float out_b[4], ClipDepth depth) {
+    if (code_a & code_b) {
+        return CLIP_CULLED;
+    }
+    if ((code_a | code_b) == 0) {
+        if (a[3] < CLIP_MIN_W || b[3] < CLIP_MIN_W) {
+            return CLIP_CULLED;
+        }
+        for (int k = 0; k < 4; ++k) {
+            out_a[k] = a[k];
+            out_b[k] = b[k];
+        }
+        return CLIP_ACCEPTED;
+    }
+    float z_scale = (depth == CLIP_DEPTH_ZERO_TO_ONE) ? 0.0f : 1.0f;
+    float t0 = 0.0f, t1 = 1.0f;
+    int crossed = code_a | code_b;
+    for (int plane = 0; plane < 6; ++plane) {
+        if (!(crossed & (1 << plane))) continue;
+        float da = plane_distance(a, plane, z_scale);
+        float db = plane_distance(b, plane, z_scale);
+        float t = da / (da - db);
+        if (da < 0.0f) {
+            if (t > t0) t0 = t;
+        } else {
+            if (t < t1) t1 = t;
+        }
+        if (t0 >= t1) {
+            return CLIP_CULLED; // Traverse les plans sans entrer dans le tronc
+        }
+    }
+    float d[4] = {b[0] - a[0], b[1] - a[1], b[2] - a[2], b[3] - a[3]};
+    float a0[4] = {a[0], a[1], a[2], a[3]};
+    for (int k = 0; k < 4; ++k) {
+        out_a[k] = a0[k] + t0 * d[k];
+        out_b[k] = a0[k] + t1 * d[k];
+    }
+    if (out_a[3] < CLIP_MIN_W || out_b[3] < CLIP_MIN_W) {
+        return CLIP_CULLED;
+    }
+    return CLIP_CLIPPED;
+}
@@ -0,0 +1,51 @@
+#ifndef ENGINE_CLIP_H
+#define ENGINE_CLIP_H
+
+#include <stdint.h>
+
+// Découpe en espace homogène (avant la division perspective) contre les six
+// plans du tronc de vue : -w <= x <= w, -w <= y <= w et, selon la convention
+// de profondeur, 0 <= z <= w ou -w <= z <= w.
+
+// Bits de sortie d'un sommet, un par plan
+enum {
+    CLIP_LEFT = 1, CLIP_RIGHT = 2,
+    CLIP_BOTTOM = 4, CLIP_TOP = 8,
+    CLIP_NEAR = 16, CLIP_FAR = 32
+};
+
+typedef enum {
+    CLIP_DEPTH_ZERO_TO_ONE = 0, // matrix_make_projection : z dans [0, w]
+    CLIP_DEPTH_MINUS_ONE_TO_ONE // Projection façon OpenGL : z dans [-w, w]
+} ClipDepth;
+
+// Sort d'une arête
+typedef enum {
+    CLIP_CULLED = 0,   // Entièrement hors du tronc
+    CLIP_ACCEPTED,     // Entièrement dedans, inchangée
+    CLIP_CLIPPED       // Raccourcie aux plans traversés
+} ClipResult;
+
+typedef struct {
+    int culled;
+    int clipped;
+    int accepted;
+} ClipStats;
+
+// Codes de sortie de n sommets en SoA (boucle sans branche, vectorisable)
+void clip_outcodes(const float* x, const float* y, const float* z, const float* w,
+                   uint8_t* codes, int n, ClipDepth depth);
+
+// Découpe le segment [a, b] (x, y, z, w) dont les codes sont code_a et code_b.
+// Les extrémités découpées sont écrites dans out_a / out_b, qui peuvent être a / b.
+ClipResult clip_segment(const float a[4], const float b[4], int code_a, int code_b,
+                        float out_a[4], float out_b[4], ClipDepth depth);
+
+// Tient à jour les compteurs pour un résultat de clip_segment
+static inline void clip_stats_add(ClipStats* stats, ClipResult result) {
+    if (result == CLIP_ACCEPTED) stats->accepted++;
+    else if (result == CLIP_CLIPPED) stats->clipped++;
+    else stats->culled++;
+}
+
+#endif
@@ -0,0 +1,28 @@
+#include <math.h>
+#include "contacts.h"
+
+int contact_from_aabbs(const AABB* box_a, const AABB* box_b, int a, int b, Contact* out) {
+    float ox = fminf(box_a->max.x, box_b->max.x) - fmaxf(box_a->min.x, box_b->min.x);
+    float oy = fminf(box_a->max.y, box_b->max.y) - fmaxf(box_a->min.y, box_b->min.y);
+    float oz = fminf(box_a->max.z, box_b->max.z) - fmaxf(box_a->min.z, box_b->min.z);
+    out->a = a;
+    out->b = b;
+    out->depth = 0.0f;
+    if (ox <= 0.0f || oy <= 0.0f || oz <= 0.0f) {
+        return 0;
+    }
+    float ca_x = box_a->min.x + box_a->max.x, cb_x = box_b->min.x + box_b->max.x;
+    float ca_y = box_a->min.y + box_a->max.y, cb_y = box_b->min.y + box_b->max.y;
+    float ca_z = box_a->min.z + box_a->max.z, cb_z = box_b->min.z + box_b->max.z;
+    if (ox <= oy && ox <= oz) {
+        out->normal = (Vec3D){cb_x >= ca_x ? 1.0f : -1.0f, 0.0f, 0.0f};
+        out->depth = ox;
+    } else if (oy <= oz) {
+        out->normal = (Vec3D){0.0f, cb_y >= ca_y ? 1.0f : -1.0f, 0.0f};
+        out->depth = oy;
+    } else {
+        out->normal = (Vec3D){0.0f, 0.0f, cb_z >= ca_z ? 1.0f : -1.0f};
+        out->depth = oz;
+    }
+    return 1;
+}
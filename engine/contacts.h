@@ -0,0 +1,18 @@
+#ifndef ENGINE_CONTACTS_H
+#define ENGINE_CONTACTS_H
+
+#include "broadphase.h"
+#include "soa.h"
+
+// Contact entre deux corps ; la normale va de `a` vers `b`
+typedef struct {
+    int a, b;
+    Vec3D normal;
+    float depth; // <= 0 : pas de contact
+} Contact;
+
+// Contact déduit du recouvrement de deux AABB, selon l'axe de moindre pénétration.
+// Retourne 1 si les boîtes se recouvrent.
+int contact_from_aabbs(const AABB* box_a, const AABB* box_b, int a, int b, Contact* out);
+
+#endif
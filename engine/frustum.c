@@ -0,0 +1,62 @@
+#include "frustum.h"
+
+void frustum_from_matrix(Frustum* f, const Mat4x4* view_proj, ClipDepth depth) {
+    const float (*m)[4] = view_proj->m;
+    // Colonne j : coefficients de la coordonnée de découpe j en fonction de (x, y, z, 1)
+    Vec4D col[4];
+    for (int j = 0; j < 4; ++j) {
+        col[j] = (Vec4D){m[0][j], m[1][j], m[2][j], m[3][j]};
+    }
+    Vec4D w = col[3];
+    f->planes[0] = (Vec4D){w.x + col[0].x, w.y + col[0].y, w.z + col[0].z, w.w + col[0].w}; // Gauche
+    f->planes[1] = (Vec4D){w.x - col[0].x, w.y - col[0].y, w.z - col[0].z, w.w - col[0].w}; // Droite
+    f->planes[2] = (Vec4D){w.x + col[1].x, w.y + col[1].y, w.z + col[1].z, w.w + col[1].w}; // Bas
+    f->planes[3] = (Vec4D){w.x - col[1].x, w.y - col[1].y, w.z - col[1].z, w.w - col[1].w}; // Haut
+    f->planes[4] = (depth == CLIP_DEPTH_ZERO_TO_ONE)                                        // Proche
+                       ? col[2]
+                       : (Vec4D){w.x + col[2].x, w.y + col[2].y, w.z + col[2].z, w.w + col[2].w};
+    f->planes[5] = (Vec4D){w.x - col[2].x, w.y - col[2].y, w.z - col[2].z, w.w - col[2].w}; // Lointain
+
+    // Normales unitaires : la distance signée d'un point au plan devient exacte,
+    // ce qu'exige le test de sphère
+    for (int p = 0; p < 6; ++p) {
+        Vec4D* pl = &f->planes[p];
+        float len = sqrtf(pl->x * pl->x + pl->y * pl->y + pl->z * pl->z);
+        float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        *pl = (Vec4D){pl->x * inv, pl->y * inv, pl->z * inv, pl->w * inv};
+    }
+}
+
+FrustumResult frustum_test_sphere(const Frustum* f, Vec3D center, float radius) {
+    FrustumResult result = FRUSTUM_INSIDE;
+    for (int p = 0; p < 6; ++p) {
+        const Vec4D* pl = &f->planes[p];
+        float dist = pl->x * center.x + pl->y * center.y + pl->z * center.z + pl->w;
+        if (dist < -radius) return FRUSTUM_OUTSIDE;
+        if (dist < radius) result = FRUSTUM_INTERSECT;
+    }
+    return result;
+}
+
+FrustumResult frustum_test_aabb(const Frustum* f, const AABB* box, unsigned* mask) {
+    unsigned planes = mask ? *mask : 0x3Fu;
+    FrustumResult result = FRUSTUM_INSIDE;
+    for (int p = 0; p < 6; ++p) {
+        if (!(planes & (1u << p))) continue;
+        const Vec4D* pl = &f->planes[p];
+        // Sommet le plus avancé le long de la normale (p) et le plus en retrait (n)
+        float px = pl->x >= 0.0f ? box->max.x : box->min.x, nx = pl->x >= 0.0f ? box->min.x : box->max.x;
+        float py = pl->y >= 0.0f ? box->max.y : box->min.y, ny = pl->y >= 0.0f ? box->min.y : box->max.y;
+        float pz = pl->z >= 0.0f ? box->max.z : box->min.z, nz = pl->z >= 0.0f ? box->min.z : box->max.z;
+        if (pl->x * px + pl->y * py + pl->z * pz + pl->w < 0.0f) {
+            return FRUSTUM_OUTSIDE;
+        }
+        if (pl->x * nx + pl->y * ny + pl->z * nz + pl->w < 0.0f) {
+            result = FRUSTUM_INTERSECT;
+        } else {
+            planes &= ~(1u << p);
+        }
+    }
+    if (mask) *mask = planes;
+    return result;
+}
@@ -0,0 +1,31 @@
+#ifndef ENGINE_FRUSTUM_H
+#define ENGINE_FRUSTUM_H
+
+#include "clip.h"
+#include "math3d.h"
+
+// Tronc de vue en repère monde : six plans a*x + b*y + c*z + d >= 0 à
+// l'intérieur, normales unitaires, dans l'ordre des bits CLIP_* (clip.h)
+typedef struct {
+    Vec4D planes[6];
+} Frustum;
+
+typedef enum {
+    FRUSTUM_OUTSIDE = 0, // Entièrement derrière au moins un plan
+    FRUSTUM_INTERSECT,   // Peut-être visible, coupe au moins un plan
+    FRUSTUM_INSIDE       // Entièrement dans le tronc
+} FrustumResult;
+
+// Plans extraits des colonnes de la matrice vue-projection (convention vecteur
+// ligne, celle de matrix_make_projection) : -w <= x <= w donne col3 + col0 et
+// col3 - col0, et ainsi de suite.
+void frustum_from_matrix(Frustum* f, const Mat4x4* view_proj, ClipDepth depth);
+
+FrustumResult frustum_test_sphere(const Frustum* f, Vec3D center, float radius);
+
+// `mask` (optionnel) : bits CLIP_* des plans encore à tester. Les plans que la
+// boîte laisse entièrement du bon côté en sont retirés, si bien que les enfants
+// d'un nœud de hiérarchie ne retestent que les plans qu'il chevauche.
+FrustumResult frustum_test_aabb(const Frustum* f, const AABB* box, unsigned* mask);
+
+#endif
@@ -0,0 +1,438 @@
+#include <float.h>
+#include "gjk.h"
+
+// Sommet le plus avancé dans la direction `d` (repère monde)
+static int hull_support(const ConvexHull* h, Vec3D d) {
+    d = hull_local_direction(h, d);
+    int best = 0;
+    float best_dot = -FLT_MAX;
+    for (int i = 0; i < h->count; ++i) {
+        float dot = h->x[i] * d.x + h->y[i] * d.y + h->z[i] * d.z;
+        if (dot > best_dot) {
+            best_dot = dot;
+            best = i;
+        }
+    }
+    return best;
+}
+
+static SupportPoint support(const ConvexHull* a, const ConvexHull* b, Vec3D d) {
+    SupportPoint p;
+    p.ia = hull_support(a, d);
+    p.ib = hull_support(b, vec3_scale(d, -1.0f));
+    p.w = vec3_sub(hull_vertex(a, p.ia), hull_vertex(b, p.ib));
+    return p;
+}
+
+// --- Point du simplexe le plus proche de l'origine ---
+// Chaque fonction réduit le simplexe à la plus petite face qui contient ce
+// point (sommet, arête, triangle), ce qui donne la direction de recherche
+// suivante sans hypothèse sur l'ordre d'ajout des sommets : un simplexe repris
+// du pas précédent est traité comme un autre.
+
+static Vec3D closest_segment(const SupportPoint* a, const SupportPoint* b, Simplex* out) {
+    Vec3D ab = vec3_sub(b->w, a->w);
+    float len_sq = vec3_dot(ab, ab);
+    float t = len_sq > 0.0f ? -vec3_dot(a->w, ab) / len_sq : 0.0f;
+    if (t <= 0.0f) {
+        out->v[0] = *a;
+        out->count = 1;
+        return a->w;
+    }
+    if (t >= 1.0f) {
+        out->v[0] = *b;
+        out->count = 1;
+        return b->w;
+    }
+    out->v[0] = *a;
+    out->v[1] = *b;
+    out->count = 2;
+    return vec3_add(a->w, vec3_scale(ab, t));
+}
+
+// Régions de Voronoï du triangle (Ericson, Real-Time Collision Detection, 5.1.5)
+static Vec3D closest_triangle(const SupportPoint* a, const SupportPoint* b, const SupportPoint* c,
+                              Simplex* out) {
+    Vec3D ab = vec3_sub(b->w, a->w), ac = vec3_sub(c->w, a->w);
+    Vec3D ap = vec3_scale(a->w, -1.0f);
+    float d1 = vec3_dot(ab, ap), d2 = vec3_dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        out->v[0] = *a;
+        out->count = 1;
+        return a->w;
+    }
+    Vec3D bp = vec3_scale(b->w, -1.0f);
+    float d3 = vec3_dot(ab, bp), d4 = vec3_dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        out->v[0] = *b;
+        out->count = 1;
+        return b->w;
+    }
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        float v = d1 / (d1 - d3);
+        out->v[0] = *a;
+        out->v[1] = *b;
+        out->count = 2;
+        return vec3_add(a->w, vec3_scale(ab, v));
+    }
+    Vec3D cp = vec3_scale(c->w, -1.0f);
+    float d5 = vec3_dot(ab, cp), d6 = vec3_dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        out->v[0] = *c;
+        out->count = 1;
+        return c->w;
+    }
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        float w = d2 / (d2 - d6);
+        out->v[0] = *a;
+        out->v[1] = *c;
+        out->count = 2;
+        return vec3_add(a->w, vec3_scale(ac, w));
+    }
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        out->v[0] = *b;
+        out->v[1] = *c;
+        out->count = 2;
+        return vec3_add(b->w, vec3_scale(vec3_sub(c->w, b->w), w));
+    }
+    float denom = va + vb + vc;
+    if (denom == 0.0f) { // Triangle dégénéré : on se rabat sur ses arêtes
+        Simplex s1, s2;
+        Vec3D p1 = closest_segment(a, b, &s1), p2 = closest_segment(a, c, &s2);
+        if (vec3_dot(p1, p1) <= vec3_dot(p2, p2)) {
+            *out = s1;
+            return p1;
+        }
+        *out = s2;
+        return p2;
+    }
+    float v = vb / denom, w = vc / denom;
+    out->v[0] = *a;
+    out->v[1] = *b;
+    out->v[2] = *c;
+    out->count = 3;
+    return vec3_add(a->w, vec3_add(vec3_scale(ab, v), vec3_scale(ac, w)));
+}
+
+// Tétraèdre : l'origine est dedans si elle est du côté du sommet opposé pour
+// les quatre faces ; sinon, la plus proche des faces qui la voient l'emporte
+static Vec3D closest_tetrahedron(const Simplex* s, Simplex* out) {
+    static const int faces[4][4] = {{0, 1, 2, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {1, 3, 2, 0}};
+    Vec3D best = {0.0f, 0.0f, 0.0f};
+    float best_dist = FLT_MAX;
+    int inside = 1;
+    for (int f = 0; f < 4; ++f) {
+        const SupportPoint *a = &s->v[faces[f][0]], *b = &s->v[faces[f][1]];
+        const SupportPoint *c = &s->v[faces[f][2]], *d = &s->v[faces[f][3]];
+        Vec3D n = vec3_cross(vec3_sub(b->w, a->w), vec3_sub(c->w, a->w));
+        float side_origin = -vec3_dot(n, a->w);
+        float side_opposite = vec3_dot(n, vec3_sub(d->w, a->w));
+        // Tétraèdre aplati : toutes les faces sont candidates
+        int degenerate = fabsf(side_opposite) <= 1e-12f;
+        if (!degenerate && side_origin * side_opposite >= 0.0f) {
+            continue;
+        }
+        inside = 0;
+        Simplex face;
+        Vec3D p = closest_triangle(a, b, c, &face);
+        float dist = vec3_dot(p, p);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = p;
+            *out = face;
+        }
+    }
+    if (inside) {
+        *out = *s;
+    }
+    return best;
+}
+
+static Vec3D closest_on_simplex(Simplex* s) {
+    Simplex reduced;
+    Vec3D p;
+    switch (s->count) {
+    case 1:
+        return s->v[0].w;
+    case 2:
+        p = closest_segment(&s->v[0], &s->v[1], &reduced);
+        break;
+    case 3:
+        p = closest_triangle(&s->v[0], &s->v[1], &s->v[2], &reduced);
+        break;
+    default:
+        p = closest_tetrahedron(s, &reduced);
+        break;
+    }
+    *s = reduced;
+    return p;
+}
+
+int gjk_intersect(const ConvexHull* a, const ConvexHull* b, Simplex* simplex, int* iterations) {
+    Simplex* s = simplex;
+    int iter = 0;
+    // Départ à chaud : mêmes sommets, positions du pas courant
+    int warm = s->count > 0 && s->count <= 4;
+    for (int k = 0; warm && k < s->count; ++k) {
+        if (s->v[k].ia >= a->count || s->v[k].ib >= b->count) warm = 0;
+    }
+    Vec3D v;
+    if (warm) {
+        for (int k = 0; k < s->count; ++k) {
+            s->v[k].w = vec3_sub(hull_vertex(a, s->v[k].ia), hull_vertex(b, s->v[k].ib));
+        }
+        v = closest_on_simplex(s);
+    } else {
+        s->v[0] = support(a, b, (Vec3D){1.0f, 0.0f, 0.0f});
+        s->count = 1;
+        v = s->v[0].w;
+    }
+
+    int result = 0;
+    while (iter < GJK_MAX_ITERATIONS) {
+        float dist_sq = vec3_dot(v, v);
+        if (dist_sq <= GJK_EPSILON) {
+            result = 1; // L'origine est sur le simplexe ou dedans
+            break;
+        }
+        ++iter;
+        SupportPoint p = support(a, b, vec3_scale(v, -1.0f));
+        float progress = dist_sq - vec3_dot(v, p.w);
+        // Plan séparateur trouvé, ou plus aucune progression : enveloppes disjointes
+        if (vec3_dot(p.w, v) > 0.0f || progress <= 1e-6f * dist_sq) {
+            break;
+        }
+        int duplicate = 0;
+        for (int k = 0; k < s->count; ++k) {
+            if (s->v[k].ia == p.ia && s->v[k].ib == p.ib) duplicate = 1;
+        }
+        if (duplicate) {
+            break;
+        }
+        s->v[s->count++] = p;
+        v = closest_on_simplex(s);
+    }
+    if (iterations) *iterations = iter;
+    return result;
+}
+
+float gjk_distance(const ConvexHull* a, const ConvexHull* b, Vec3D* normal) {
+    Simplex s;
+    s.v[0] = support(a, b, (Vec3D){1.0f, 0.0f, 0.0f});
+    s.count = 1;
+    Vec3D v = s.v[0].w;
+    for (int iter = 0; iter < GJK_MAX_ITERATIONS; ++iter) {
+        float dist_sq = vec3_dot(v, v);
+        if (dist_sq <= GJK_EPSILON) {
+            return 0.0f;
+        }
+        // |v|² - v.w borne l'écart entre |v| et la distance, multiplié par |v|
+        SupportPoint p = support(a, b, vec3_scale(v, -1.0f));
+        if (dist_sq - vec3_dot(v, p.w) <= GJK_DISTANCE_TOLERANCE * dist_sq) {
+            break;
+        }
+        int duplicate = 0;
+        for (int k = 0; k < s.count; ++k) {
+            if (s.v[k].ia == p.ia && s.v[k].ib == p.ib) duplicate = 1;
+        }
+        if (duplicate) {
+            break;
+        }
+        s.v[s.count++] = p;
+        v = closest_on_simplex(&s);
+    }
+    float dist = vec3_length(v);
+    if (dist * dist <= GJK_EPSILON) {
+        return 0.0f;
+    }
+    *normal = vec3_scale(v, -1.0f / dist); // v = a - b : A est du côté de v
+    return dist;
+}
+
+// --- EPA ---
+
+typedef struct {
+    int v[3];
+    Vec3D normal;
+    float dist;
+} EpaFace;
+
+typedef struct {
+    SupportPoint verts[EPA_MAX_VERTICES];
+    EpaFace faces[EPA_MAX_FACES];
+    int num_verts, num_faces;
+    Vec3D interior; // Point intérieur au polytope, pour orienter les faces
+} Polytope;
+
+static int add_face(Polytope* p, int a, int b, int c) {
+    if (p->num_faces == EPA_MAX_FACES) {
+        return 0;
+    }
+    EpaFace* f = &p->faces[p->num_faces++];
+    Vec3D wa = p->verts[a].w, wb = p->verts[b].w, wc = p->verts[c].w;
+    Vec3D n = vec3_cross(vec3_sub(wb, wa), vec3_sub(wc, wa));
+    float len = vec3_length(n);
+    if (len <= 1e-12f) {
+        // Face dégénérée : jamais choisie, mais garde le polytope fermé
+        f->v[0] = a; f->v[1] = b; f->v[2] = c;
+        f->normal = (Vec3D){0.0f, 0.0f, 0.0f};
+        f->dist = FLT_MAX;
+        return 1;
+    }
+    n = vec3_scale(n, 1.0f / len);
+    if (vec3_dot(n, vec3_sub(wa, p->interior)) < 0.0f) {
+        n = vec3_scale(n, -1.0f);
+        int t = b; b = c; c = t;
+    }
+    f->v[0] = a; f->v[1] = b; f->v[2] = c;
+    f->normal = n;
+    f->dist = vec3_dot(n, wa);
+    return 1;
+}
+
+static int closest_face(const Polytope* p) {
+    int closest = 0;
+    for (int f = 1; f < p->num_faces; ++f) {
+        if (p->faces[f].dist < p->faces[closest].dist) closest = f;
+    }
+    return closest;
+}
+
+// Complète un simplexe de contact tangent en tétraèdre, en cherchant des
+// supports dans des directions qui sortent de son enveloppe
+static int blow_up_simplex(const ConvexHull* a, const ConvexHull* b, Simplex* s) {
+    static const Vec3D axes[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    if (s->count == 1) {
+        for (int k = 0; k < 6 && s->count == 1; ++k) {
+            SupportPoint p = support(a, b, axes[k]);
+            Vec3D d = vec3_sub(p.w, s->v[0].w);
+            if (vec3_dot(d, d) > 1e-10f) s->v[s->count++] = p;
+        }
+    }
+    if (s->count == 2) {
+        Vec3D seg = vec3_sub(s->v[1].w, s->v[0].w);
+        for (int k = 0; k < 6 && s->count == 2; ++k) {
+            Vec3D dir = vec3_cross(seg, axes[k]);
+            if (vec3_dot(dir, dir) <= 1e-12f) continue;
+            SupportPoint p = support(a, b, dir);
+            Vec3D n = vec3_cross(seg, vec3_sub(p.w, s->v[0].w));
+            if (vec3_dot(n, n) > 1e-12f) s->v[s->count++] = p;
+        }
+    }
+    if (s->count == 3) {
+        Vec3D n = vec3_cross(vec3_sub(s->v[1].w, s->v[0].w), vec3_sub(s->v[2].w, s->v[0].w));
+        for (int k = 0; k < 2 && s->count == 3; ++k) {
+            SupportPoint p = support(a, b, k == 0 ? n : vec3_scale(n, -1.0f));
+            if (fabsf(vec3_dot(n, vec3_sub(p.w, s->v[0].w))) > 1e-10f) s->v[s->count++] = p;
+        }
+    }
+    return s->count == 4;
+}
+
+int epa_penetration(const ConvexHull* a, const ConvexHull* b, const Simplex* simplex, Penetration* out) {
+    Simplex s = *simplex;
+    if (s.count < 4 && !blow_up_simplex(a, b, &s)) {
+        return 0;
+    }
+    Polytope p;
+    p.num_verts = 4;
+    p.num_faces = 0;
+    p.interior = (Vec3D){0.0f, 0.0f, 0.0f};
+    for (int k = 0; k < 4; ++k) {
+        p.verts[k] = s.v[k];
+        p.interior = vec3_add(p.interior, vec3_scale(s.v[k].w, 0.25f));
+    }
+    add_face(&p, 0, 1, 2);
+    add_face(&p, 0, 3, 1);
+    add_face(&p, 0, 2, 3);
+    add_face(&p, 1, 3, 2);
+
+    for (int iter = 0; iter < EPA_MAX_VERTICES; ++iter) {
+        EpaFace face = p.faces[closest_face(&p)];
+        if (face.dist == FLT_MAX) {
+            return 0;
+        }
+        SupportPoint w = support(a, b, face.normal);
+        if (vec3_dot(w.w, face.normal) - face.dist < EPA_TOLERANCE || p.num_verts == EPA_MAX_VERTICES) {
+            break;
+        }
+        // Sommet déjà dans le polytope (faces coplanaires de la différence de
+        // Minkowski) : la face courante est déjà la bonne, à l'arrondi près
+        int duplicate = 0;
+        for (int k = 0; k < p.num_verts; ++k) {
+            if (p.verts[k].ia == w.ia && p.verts[k].ib == w.ib) duplicate = 1;
+        }
+        if (duplicate) {
+            break;
+        }
+
+        // Faces vues depuis le nouveau sommet : retirées, leur bord forme l'horizon.
+        // Une arête partagée par deux faces retirées apparaît dans les deux sens et s'annule.
+        int horizon[EPA_MAX_FACES * 3][2];
+        int num_edges = 0;
+        for (int f = 0; f < p.num_faces;) {
+            EpaFace* cur = &p.faces[f];
+            // Une face n'est vue que si le sommet est nettement devant elle : une face
+            // coplanaire retirée laisserait un polytope non convexe. Une face
+            // dégénérée est toujours retirée, le nouveau sommet la recouvre.
+            if (cur->dist != FLT_MAX &&
+                vec3_dot(cur->normal, vec3_sub(w.w, p.verts[cur->v[0]].w)) <= EPA_VISIBLE_EPSILON) {
+                ++f;
+                continue;
+            }
+            for (int e = 0; e < 3; ++e) {
+                int e0 = cur->v[e], e1 = cur->v[(e + 1) % 3];
+                int found = -1;
+                for (int k = 0; k < num_edges; ++k) {
+                    if (horizon[k][0] == e1 && horizon[k][1] == e0) found = k;
+                }
+                if (found >= 0) {
+                    horizon[found][0] = horizon[num_edges - 1][0];
+                    horizon[found][1] = horizon[num_edges - 1][1];
+                    --num_edges;
+                } else {
+                    horizon[num_edges][0] = e0;
+                    horizon[num_edges][1] = e1;
+                    ++num_edges;
+                }
+            }
+            p.faces[f] = p.faces[--p.num_faces];
+        }
+        int nv = p.num_verts++;
+        p.verts[nv] = w;
+        int full = 0;
+        for (int k = 0; k < num_edges && !full; ++k) {
+            full = !add_face(&p, horizon[k][0], horizon[k][1], nv);
+        }
+        if (full || p.num_faces == 0) {
+            break; // Plus de place : la meilleure face trouvée sert d'approximation
+        }
+    }
+
+    // Projeté de l'origine sur la face la plus proche, en coordonnées barycentriques
+    const EpaFace* face = &p.faces[closest_face(&p)];
+    if (p.num_faces == 0 || face->dist == FLT_MAX) {
+        return 0;
+    }
+    const SupportPoint *s0 = &p.verts[face->v[0]], *s1 = &p.verts[face->v[1]], *s2 = &p.verts[face->v[2]];
+    Vec3D proj = vec3_scale(face->normal, face->dist);
+    Vec3D e0 = vec3_sub(s1->w, s0->w), e1 = vec3_sub(s2->w, s0->w), ep = vec3_sub(proj, s0->w);
+    float d00 = vec3_dot(e0, e0), d01 = vec3_dot(e0, e1), d11 = vec3_dot(e1, e1);
+    float d20 = vec3_dot(ep, e0), d21 = vec3_dot(ep, e1);
+    float denom = d00 * d11 - d01 * d01;
+    float v = denom != 0.0f ? (d11 * d20 - d01 * d21) / denom : 0.0f;
+    float u = denom != 0.0f ? (d00 * d21 - d01 * d20) / denom : 0.0f;
+    float t = 1.0f - v - u;
+
+    out->normal = face->normal;
+    out->depth = face->dist;
+    out->point_a = vec3_add(vec3_add(vec3_scale(hull_vertex(a, s0->ia), t), vec3_scale(hull_vertex(a, s1->ia), v)),
+                            vec3_scale(hull_vertex(a, s2->ia), u));
+    out->point_b = vec3_add(vec3_add(vec3_scale(hull_vertex(b, s0->ib), t), vec3_scale(hull_vertex(b, s1->ib), v)),
+                            vec3_scale(hull_vertex(b, s2->ib), u));
+    return 1;
+}
@@ -0,0 +1,77 @@
+#ifndef ENGINE_GJK_H
+#define ENGINE_GJK_H
+
+#include "math3d.h"
+#include "transform.h"
+
+// --- Configuration ---
+#define GJK_MAX_ITERATIONS 64
+#define GJK_EPSILON 1e-8f        // Distance² sous laquelle l'origine est atteinte
+#define GJK_DISTANCE_TOLERANCE 1e-5f // Écart relatif toléré sur gjk_distance
+#define EPA_MAX_VERTICES 64
+#define EPA_MAX_FACES 128
+#define EPA_TOLERANCE 1e-4f      // Progression minimale de la face la plus proche
+#define EPA_VISIBLE_EPSILON 1e-6f // Distance minimale d'un nouveau sommet devant une face retirée
+
+// Enveloppe convexe donnée par ses sommets en repère local (SoA, typiquement
+// ceux du MeshAsset partagé par le corps) et la transformation du corps. Le
+// support est un parcours linéaire des sommets locaux le long de la direction
+// ramenée en repère local : seul le sommet retenu est transformé, aucun
+// sommet monde n'est stocké.
+typedef struct {
+    const float *x, *y, *z;
+    int count;
+    Affine3x4 to_world;
+} ConvexHull;
+
+static inline Vec3D hull_vertex(const ConvexHull* h, int i) {
+    return affine_apply_point(&h->to_world, (Vec3D){h->x[i], h->y[i], h->z[i]});
+}
+
+// Direction monde `d` en repère local, pour comparer les sommets locaux :
+// dot(v L + t, d) = dot(v, L d) + dot(t, d), et dot(t, d) est commun à tous
+// les sommets (les écarts restent en unités monde)
+static inline Vec3D hull_local_direction(const ConvexHull* h, Vec3D d) {
+    const float (*m)[3] = h->to_world.m;
+    return (Vec3D){m[0][0] * d.x + m[0][1] * d.y + m[0][2] * d.z,
+                   m[1][0] * d.x + m[1][1] * d.y + m[1][2] * d.z,
+                   m[2][0] * d.x + m[2][1] * d.y + m[2][2] * d.z};
+}
+
+// Sommet de la différence de Minkowski A - B, avec les sommets d'origine :
+// les index restent valides d'un pas à l'autre quand les corps bougent
+typedef struct {
+    Vec3D w;
+    int ia, ib;
+} SupportPoint;
+
+typedef struct {
+    SupportPoint v[4];
+    int count;
+} Simplex;
+
+typedef struct {
+    Vec3D normal;            // De A vers B : déplacer B de normal * depth sépare les corps
+    float depth;
+    Vec3D point_a, point_b;  // Point le plus profond de chaque corps dans l'autre
+} Penetration;
+
+// Test d'intersection GJK. `simplex` peut contenir le simplexe final d'un
+// appel précédent (count = 0 : départ à froid) : ses sommets sont relus aux
+// mêmes index, si bien qu'une paire peu déplacée conclut en une ou deux
+// itérations. Le simplexe final est écrit en retour.
+// Retourne 1 si les enveloppes se recouvrent ou se touchent.
+int gjk_intersect(const ConvexHull* a, const ConvexHull* b, Simplex* simplex, int* iterations);
+
+// Distance entre deux enveloppes : GJK mené jusqu'au point de A - B le plus
+// proche de l'origine, à GJK_DISTANCE_TOLERANCE près (par excès). Retourne 0
+// si les enveloppes se recouvrent ou se touchent ; sinon la distance, et
+// `normal` reçoit la direction unitaire de A vers B.
+float gjk_distance(const ConvexHull* a, const ConvexHull* b, Vec3D* normal);
+
+// Pénétration par EPA à partir du simplexe de gjk_intersect (complété en
+// tétraèdre si besoin). Retourne 0 si le contact est dégénéré (simple contact
+// tangent) : `out` n'est alors pas rempli.
+int epa_penetration(const ConvexHull* a, const ConvexHull* b, const Simplex* simplex, Penetration* out);
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "islands.h"
+
+void island_set_init(IslandSet* set) {
+    memset(set, 0, sizeof(*set));
+}
+
+void island_set_free(IslandSet* set) {
+    mem_free(set->body_island);
+    mem_free(set->bodies);
+    mem_free(set->body_start);
+    mem_free(set->pairs);
+    mem_free(set->pair_start);
+    mem_free(set->parent);
+    island_set_init(set);
+}
+
+static int find_root(int* parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]]; // Compression par division
+        i = parent[i];
+    }
+    return i;
+}
+
+// Îlot d'un corps, -1 pour un corps statique ou hors de [0, num_bodies)
+static inline int island_of(const IslandSet* set, int num_bodies, int i) {
+    return i < num_bodies ? set->body_island[i] : -1;
+}
+
+// Toujours au moins une allocation : body_start et pair_start servent même
+// sans corps éveillé (monde restauré tout endormi)
+static int reserve_bodies(IslandSet* set, int n) {
+    if (n <= set->body_capacity && set->body_start != NULL) {
+        return 1;
+    }
+    int cap = n + n / 2 + 16;
+    mem_free(set->body_island); mem_free(set->bodies); mem_free(set->body_start); mem_free(set->parent);
+    set->body_island = (int*)mem_alloc(cap * sizeof(int));
+    set->bodies = (int*)mem_alloc(cap * sizeof(int));
+    set->body_start = (int*)mem_alloc((cap + 1) * sizeof(int));
+    set->parent = (int*)mem_alloc(cap * sizeof(int));
+    set->pair_start = (int*)mem_realloc(set->pair_start, (cap + 1) * sizeof(int));
+    set->body_capacity = (set->body_island && set->bodies && set->body_start &&
+                          set->parent && set->pair_start) ? cap : 0;
+    return set->body_capacity != 0;
+}
+
+static int reserve_pairs(IslandSet* set, int n) {
+    if (n <= set->pair_capacity) {
+        return 1;
+    }
+    int cap = n + n / 2 + 16;
+    int* pairs = (int*)mem_realloc(set->pairs, cap * sizeof(int));
+    if (pairs == NULL) {
+        return 0;
+    }
+    set->pairs = pairs;
+    set->pair_capacity = cap;
+    return 1;
+}
+
+int build_islands(IslandSet* set, int num_bodies, const float* inv_mass,
+                  const BodyPair* pairs, int num_pairs) {
+    if (!reserve_bodies(set, num_bodies) || !reserve_pairs(set, num_pairs)) {
+        set->num_islands = 0;
+        return 0;
+    }
+
+    int* parent = set->parent;
+    for (int i = 0; i < num_bodies; ++i) {
+        parent[i] = i;
+    }
+    for (int p = 0; p < num_pairs; ++p) {
+        int a = pairs[p].a, b = pairs[p].b;
+        if (a >= num_bodies || b >= num_bodies || inv_mass[a] == 0.0f || inv_mass[b] == 0.0f) {
+            continue; // Un corps statique (ou endormi) ne propage pas la connexité
+        }
+        int ra = find_root(parent, a), rb = find_root(parent, b);
+        if (ra != rb) {
+            // La plus petite racine l'emporte : résultat indépendant de l'ordre des paires
+            if (ra < rb) parent[rb] = ra; else parent[ra] = rb;
+        }
+    }
+
+    // Numérotation des îlots dans l'ordre de leur plus petit corps dynamique
+    int num_islands = 0;
+    for (int i = 0; i < num_bodies; ++i) {
+        if (inv_mass[i] == 0.0f) {
+            set->body_island[i] = -1;
+            continue;
+        }
+        int root = find_root(parent, i);
+        if (root == i) {
+            set->body_island[i] = num_islands++;
+        } else {
+            set->body_island[i] = set->body_island[root];
+        }
+    }
+    set->num_islands = num_islands;
+
+    // Tri par dénombrement des corps, puis des paires (une paire appartient
+    // à l'îlot de son corps dynamique)
+    int* start = set->body_start;
+    memset(start, 0, (num_islands + 1) * sizeof(int));
+    for (int i = 0; i < num_bodies; ++i) {
+        if (set->body_island[i] >= 0) start[set->body_island[i] + 1]++;
+    }
+    for (int k = 0; k < num_islands; ++k) start[k + 1] += start[k];
+    for (int i = 0; i < num_bodies; ++i) {
+        int island = set->body_island[i];
+        if (island >= 0) set->bodies[start[island]++] = i;
+    }
+    for (int k = num_islands; k > 0; --k) start[k] = start[k - 1];
+    start[0] = 0;
+
+    int* pstart = set->pair_start;
+    memset(pstart, 0, (num_islands + 1) * sizeof(int));
+    for (int p = 0; p < num_pairs; ++p) {
+        int island = island_of(set, num_bodies, pairs[p].a);
+        if (island < 0) island = island_of(set, num_bodies, pairs[p].b);
+        if (island >= 0) pstart[island + 1]++;
+    }
+    for (int k = 0; k < num_islands; ++k) pstart[k + 1] += pstart[k];
+    for (int p = 0; p < num_pairs; ++p) {
+        int island = island_of(set, num_bodies, pairs[p].a);
+        if (island < 0) island = island_of(set, num_bodies, pairs[p].b);
+        if (island >= 0) set->pairs[pstart[island]++] = p;
+    }
+    for (int k = num_islands; k > 0; --k) pstart[k] = pstart[k - 1];
+    pstart[0] = 0;
+    return 1;
+}
@@ -0,0 +1,35 @@
+#ifndef ENGINE_ISLANDS_H
+#define ENGINE_ISLANDS_H
+
+#include "broadphase.h"
+
+// Îlots de simulation : composantes connexes du graphe corps/paires.
+// Les corps statiques ne relient pas les îlots entre eux, si bien que deux
+// piles posées sur le même sol restent indépendantes et peuvent être
+// résolues en parallèle sans verrou.
+typedef struct {
+    int num_islands;
+    int* body_island;  // Îlot de chaque corps (-1 pour un corps statique)
+    int* bodies;       // Corps regroupés par îlot, en ordre croissant dans chaque îlot
+    int* body_start;   // num_islands + 1 entrées
+    int* pairs;        // Index des paires regroupés par îlot, en ordre croissant
+    int* pair_start;   // num_islands + 1 entrées
+
+    int* parent;       // Union-find (interne)
+    int body_capacity;
+    int pair_capacity;
+} IslandSet;
+
+void island_set_init(IslandSet* set);
+void island_set_free(IslandSet* set);
+
+// Construit les îlots des corps [0, num_bodies). Un corps d'index supérieur
+// (statique ou endormi) est traité comme statique : ses paires rejoignent
+// l'îlot de l'autre corps. La numérotation suit le plus petit corps de chaque
+// îlot, ce qui rend le résultat indépendant de l'ordre des paires et du nombre
+// de threads.
+// Retourne 0 en cas d'échec d'allocation.
+int build_islands(IslandSet* set, int num_bodies, const float* inv_mass,
+                  const BodyPair* pairs, int num_pairs);
+
+#endif
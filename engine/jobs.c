@@ -0,0 +1,288 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "alloc.h"
+#include "jobs.h"
+#include "profile.h"
+
+typedef struct {
+    JobRangeFunc fn;
+    void* ctx;
+    int begin, end, chunk;
+    atomic_int* pending; // Compteur du lot auquel appartient la tâche
+} Job;
+
+// Deque de Chase-Lev : le propriétaire empile/dépile en bas, les voleurs prennent en haut
+typedef struct {
+    _Alignas(64) atomic_llong top;
+    _Alignas(64) atomic_llong bottom;
+    _Alignas(64) _Atomic(Job*) buffer[JOB_DEQUE_CAPACITY];
+} JobDeque;
+
+typedef struct {
+    JobDeque deque;
+    Job jobs[JOB_DEQUE_CAPACITY]; // Tâches allouées en pile par les lots imbriqués
+    int jobs_used;
+    uint32_t rng;                 // Choix des victimes de vol
+    pthread_t thread;
+    JobSystem* owner;
+    int index;
+} JobWorker;
+
+struct JobSystem {
+    JobWorker* workers;
+    int num_threads;
+    atomic_int shutdown;
+    atomic_int work_available;    // Tâches publiées non encore terminées (réveil)
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+static _Thread_local JobWorker* tls_worker = NULL;
+
+// --- Deque ---
+
+static int deque_push(JobDeque* d, Job* job) {
+    long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= JOB_DEQUE_CAPACITY) {
+        return 0;
+    }
+    atomic_store_explicit(&d->buffer[b & (JOB_DEQUE_CAPACITY - 1)], job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+static Job* deque_pop(JobDeque* d) {
+    long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    Job* job = atomic_load_explicit(&d->buffer[b & (JOB_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (t == b) {
+        // Dernier élément : course possible avec un voleur
+        if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            job = NULL;
+        }
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static Job* deque_steal(JobDeque* d) {
+    long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) {
+        return NULL;
+    }
+    Job* job = atomic_load_explicit(&d->buffer[t & (JOB_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return job;
+}
+
+// --- Exécution ---
+
+static void run_job(JobSystem* js, Job* job) {
+    job->fn(job->ctx, job->begin, job->end, job->chunk);
+    atomic_fetch_sub_explicit(job->pending, 1, memory_order_acq_rel);
+    atomic_fetch_sub_explicit(&js->work_available, 1, memory_order_relaxed);
+}
+
+// Prend une tâche dans sa propre file, sinon en vole une ailleurs
+static Job* find_job(JobWorker* self) {
+    Job* job = deque_pop(&self->deque);
+    if (job != NULL) {
+        return job;
+    }
+    JobSystem* js = self->owner;
+    int n = js->num_threads;
+    self->rng = self->rng * 1664525u + 1013904223u;
+    int start = (int)(self->rng >> 8) % n;
+    for (int k = 0; k < n; ++k) {
+        int victim = (start + k) % n;
+        if (victim == self->index) continue;
+        job = deque_steal(&js->workers[victim].deque);
+        if (job != NULL) {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+static void* worker_main(void* arg) {
+    JobWorker* self = (JobWorker*)arg;
+    JobSystem* js = self->owner;
+    tls_worker = self;
+    char name[32];
+    snprintf(name, sizeof(name), "worker %d", self->index);
+    profile_set_thread_name(name);
+
+    while (!atomic_load(&js->shutdown)) {
+        Job* job = find_job(self);
+        if (job != NULL) {
+            run_job(js, job);
+            continue;
+        }
+        // Rien à voler : on s'endort jusqu'à la publication d'un nouveau lot
+        pthread_mutex_lock(&js->lock);
+        while (atomic_load(&js->work_available) <= 0 && !atomic_load(&js->shutdown)) {
+            pthread_cond_wait(&js->wake, &js->lock);
+        }
+        pthread_mutex_unlock(&js->lock);
+    }
+    return NULL;
+}
+
+// --- API ---
+
+JobSystem* create_job_system(int num_threads) {
+    if (num_threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cores > 0 ? (int)cores : 1;
+    }
+    if (num_threads > JOB_MAX_THREADS) {
+        num_threads = JOB_MAX_THREADS;
+    }
+
+    JobSystem* js = (JobSystem*)mem_calloc(1, sizeof(JobSystem));
+    if (js == NULL) {
+        return NULL;
+    }
+    js->workers = (JobWorker*)mem_aligned_alloc(64, num_threads * sizeof(JobWorker));
+    if (js->workers == NULL) {
+        mem_free(js);
+        return NULL;
+    }
+    memset(js->workers, 0, num_threads * sizeof(JobWorker));
+    js->num_threads = num_threads;
+    pthread_mutex_init(&js->lock, NULL);
+    pthread_cond_init(&js->wake, NULL);
+
+    for (int i = 0; i < num_threads; ++i) {
+        JobWorker* w = &js->workers[i];
+        w->owner = js;
+        w->index = i;
+        w->rng = 0x9e3779b9u * (uint32_t)(i + 1);
+    }
+    // Le thread appelant est le travailleur 0
+    tls_worker = &js->workers[0];
+    for (int i = 1; i < num_threads; ++i) {
+        if (pthread_create(&js->workers[i].thread, NULL, worker_main, &js->workers[i]) != 0) {
+            js->num_threads = i;
+            break;
+        }
+    }
+    return js;
+}
+
+void free_job_system(JobSystem* js) {
+    if (js == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&js->lock);
+    atomic_store(&js->shutdown, 1);
+    pthread_cond_broadcast(&js->wake);
+    pthread_mutex_unlock(&js->lock);
+    for (int i = 1; i < js->num_threads; ++i) {
+        pthread_join(js->workers[i].thread, NULL);
+    }
+    if (tls_worker != NULL && tls_worker->owner == js) {
+        tls_worker = NULL;
+    }
+    pthread_cond_destroy(&js->wake);
+    pthread_mutex_destroy(&js->lock);
+    mem_free(js->workers);
+    mem_free(js);
+}
+
+int job_system_num_threads(const JobSystem* js) {
+    return js ? js->num_threads : 1;
+}
+
+int job_worker_index(void) {
+    return tls_worker ? tls_worker->index : 0;
+}
+
+int job_chunk_count(int count, int grain) {
+    if (count <= 0) return 0;
+    if (grain < 1) grain = 1;
+    return (count + grain - 1) / grain;
+}
+
+void job_parallel_for(JobSystem* js, int count, int grain, JobRangeFunc fn, void* ctx) {
+    int chunks = job_chunk_count(count, grain);
+    if (grain < 1) grain = 1;
+    JobWorker* self = tls_worker;
+
+    if (js == NULL || js->num_threads == 1 || chunks <= 1 || self == NULL || self->owner != js) {
+        for (int c = 0; c < chunks; ++c) {
+            int begin = c * grain;
+            int end = (begin + grain < count) ? begin + grain : count;
+            fn(ctx, begin, end, c);
+        }
+        return;
+    }
+
+    atomic_int pending;
+    atomic_init(&pending, 0);
+    int first_job = self->jobs_used;
+    int c = 0;
+    while (c < chunks) {
+        // Publie autant de morceaux que la file en accepte, puis aide
+        int published = 0;
+        for (; c < chunks && self->jobs_used < JOB_DEQUE_CAPACITY; ++c) {
+            Job* job = &self->jobs[self->jobs_used];
+            job->fn = fn;
+            job->ctx = ctx;
+            job->begin = c * grain;
+            job->end = (job->begin + grain < count) ? job->begin + grain : count;
+            job->chunk = c;
+            job->pending = &pending;
+            atomic_fetch_add_explicit(&pending, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&js->work_available, 1, memory_order_relaxed);
+            if (!deque_push(&self->deque, job)) {
+                atomic_fetch_sub_explicit(&pending, 1, memory_order_relaxed);
+                atomic_fetch_sub_explicit(&js->work_available, 1, memory_order_relaxed);
+                break;
+            }
+            self->jobs_used++;
+            published++;
+        }
+        if (published > 0) {
+            pthread_mutex_lock(&js->lock);
+            pthread_cond_broadcast(&js->wake);
+            pthread_mutex_unlock(&js->lock);
+        } else if (c < chunks) {
+            // File pleine (lots très imbriqués) : le morceau s'exécute sur place
+            int begin = c * grain;
+            fn(ctx, begin, (begin + grain < count) ? begin + grain : count, c);
+            ++c;
+        }
+
+        // Le thread appelant travaille aussi en attendant la fin du lot
+        while (atomic_load_explicit(&pending, memory_order_acquire) > 0) {
+            Job* job = find_job(self);
+            if (job != NULL) {
+                run_job(js, job);
+            } else {
+                sched_yield();
+            }
+        }
+        self->jobs_used = first_job;
+    }
+}
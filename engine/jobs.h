@@ -0,0 +1,33 @@
+#ifndef ENGINE_JOBS_H
+#define ENGINE_JOBS_H
+
+// --- Configuration ---
+#define JOB_MAX_THREADS 64
+#define JOB_DEQUE_CAPACITY 4096 // Puissance de 2 ; tâches en attente par thread
+
+// Traite les éléments [begin, end) ; `chunk` est l'index du morceau dans le lot,
+// indépendant du nombre de threads (utile pour des sorties par morceau).
+typedef void (*JobRangeFunc)(void* ctx, int begin, int end, int chunk);
+
+// Pool fixe de threads, une file à vol de tâches (deque de Chase-Lev) par thread.
+// Le thread qui crée le pool en est le thread 0 et participe au travail.
+typedef struct JobSystem JobSystem;
+
+// num_threads <= 0 : un thread par cœur
+JobSystem* create_job_system(int num_threads);
+void free_job_system(JobSystem* js);
+int job_system_num_threads(const JobSystem* js);
+
+// Index du thread courant dans son pool (0 hors des travailleurs)
+int job_worker_index(void);
+
+// Nombre de morceaux produits par job_parallel_for pour (count, grain)
+int job_chunk_count(int count, int grain);
+
+// Découpe [0, count) en morceaux de `grain` éléments et les répartit sur le pool.
+// Retourne quand tous les morceaux sont terminés. Peut être appelée depuis une
+// tâche (les sous-tâches vont dans la file du thread appelant). js == NULL :
+// exécution séquentielle avec le même découpage.
+void job_parallel_for(JobSystem* js, int count, int grain, JobRangeFunc fn, void* ctx);
+
+#endif
@@ -0,0 +1,612 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// --- Version scalaire (référence, toutes plateformes) ---
+
+static void transform_points_scalar(const Mat4x4* mat,
+                                    const float* x, const float* y, const float* z,
+                                    float* ox, float* oy, float* oz, float* ow, int n) {
+    const float (*m)[4] = mat->m;
+    for (int i = 0; i < n; ++i) {
+        float vx = x[i], vy = y[i], vz = z[i];
+        ox[i] = vx * m[0][0] + vy * m[1][0] + vz * m[2][0] + m[3][0];
+        oy[i] = vx * m[0][1] + vy * m[1][1] + vz * m[2][1] + m[3][1];
+        oz[i] = vx * m[0][2] + vy * m[1][2] + vz * m[2][2] + m[3][2];
+        if (ow) ow[i] = vx * m[0][3] + vy * m[1][3] + vz * m[2][3] + m[3][3];
+    }
+}
+
+static void integrate_bodies_scalar(BodySoA* b, Vec3D g, float dt, int begin, int end) {
+    // Pointeurs restrict : les tableaux SoA ne se recouvrent jamais
+    float* restrict px = b->px; float* restrict py = b->py; float* restrict pz = b->pz;
+    float* restrict vx = b->vx; float* restrict vy = b->vy; float* restrict vz = b->vz;
+    float* restrict qx = b->qx; float* restrict qy = b->qy;
+    float* restrict qz = b->qz; float* restrict qw = b->qw;
+    const float* restrict wx = b->wx; const float* restrict wy = b->wy; const float* restrict wz = b->wz;
+    const float* restrict inv_mass = b->inv_mass;
+    float gx = g.x * dt, gy = g.y * dt, gz = g.z * dt;
+    float h = 0.5f * dt;
+
+    for (int i = begin; i < end; ++i) {
+        if (inv_mass[i] == 0.0f) {
+            continue; // Corps statique
+        }
+        vx[i] += gx; vy[i] += gy; vz[i] += gz;
+        px[i] += vx[i] * dt; py[i] += vy[i] * dt; pz[i] += vz[i] * dt;
+        // q += dt/2 * (w, 0) * q, puis renormalisation (voir quat_integrate)
+        float x = qx[i], y = qy[i], z = qz[i], w = qw[i];
+        float nx = x + h * (w * wx[i] + wy[i] * z - wz[i] * y);
+        float ny = y + h * (w * wy[i] + wz[i] * x - wx[i] * z);
+        float nz = z + h * (w * wz[i] + wx[i] * y - wy[i] * x);
+        float nw = w - h * (wx[i] * x + wy[i] * y + wz[i] * z);
+        float inv = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz + nw * nw);
+        qx[i] = nx * inv; qy[i] = ny * inv; qz[i] = nz * inv; qw[i] = nw * inv;
+    }
+}
+
+static float solve_rows_scalar(SolverRows* r, SolverBodies* bodies, int begin, int end) {
+    float residual = 0.0f;
+    for (int i = begin * SOLVER_LANES; i < end * SOLVER_LANES; ++i) {
+        float* va = bodies->v + (size_t)r->a[i] * SOLVER_BODY_STRIDE;
+        float* vb = bodies->v + (size_t)r->b[i] * SOLVER_BODY_STRIDE;
+        float jv = r->nx[i] * (vb[0] - va[0]) + r->ny[i] * (vb[1] - va[1]) + r->nz[i] * (vb[2] - va[2]) +
+                   r->jax[i] * va[3] + r->jay[i] * va[4] + r->jaz[i] * va[5] +
+                   r->jbx[i] * vb[3] + r->jby[i] * vb[4] + r->jbz[i] * vb[5];
+        float lo = r->lo[i], hi = r->hi[i];
+        if (r->normal_row[i] >= 0) {
+            // Frottement de Coulomb : borne tirée de l'impulsion normale courante
+            hi = r->friction[i] * r->impulse[r->normal_row[i]];
+            lo = -hi;
+        }
+        float old = r->impulse[i];
+        float acc = fminf(fmaxf(old - r->eff_mass[i] * (jv + r->bias[i]), lo), hi);
+        float d = acc - old;
+        r->impulse[i] = acc;
+        float la = r->ima[i] * d, lb = r->imb[i] * d;
+        va[0] -= r->nx[i] * la; va[1] -= r->ny[i] * la; va[2] -= r->nz[i] * la;
+        va[3] += r->iax[i] * d; va[4] += r->iay[i] * d; va[5] += r->iaz[i] * d;
+        vb[0] += r->nx[i] * lb; vb[1] += r->ny[i] * lb; vb[2] += r->nz[i] * lb;
+        vb[3] += r->ibx[i] * d; vb[4] += r->iby[i] * d; vb[5] += r->ibz[i] * d;
+        residual += fabsf(d);
+    }
+    return residual;
+}
+
+static void integrate_particles_scalar(ParticleSoA* p, Vec3D g, float dt, float damping, int begin, int end) {
+    float* restrict x = p->x; float* restrict y = p->y; float* restrict z = p->z;
+    float* restrict ox = p->ox; float* restrict oy = p->oy; float* restrict oz = p->oz;
+    const float* restrict inv_mass = p->inv_mass;
+    float keep = 1.0f - damping;
+    float gx = g.x * dt * dt, gy = g.y * dt * dt, gz = g.z * dt * dt;
+
+    for (int i = begin; i < end; ++i) {
+        if (inv_mass[i] == 0.0f) {
+            continue; // Particule fixée
+        }
+        float cx = x[i], cy = y[i], cz = z[i];
+        x[i] = cx + ((cx - ox[i]) * keep + gx);
+        y[i] = cy + ((cy - oy[i]) * keep + gy);
+        z[i] = cz + ((cz - oz[i]) * keep + gz);
+        ox[i] = cx; oy[i] = cy; oz[i] = cz;
+    }
+}
+
+static void solve_distances_scalar(const DistanceBatches* c, ParticleSoA* p, int begin, int end) {
+    float* x = p->x; float* y = p->y; float* z = p->z;
+    for (int i = begin * PARTICLE_LANES; i < end * PARTICLE_LANES; ++i) {
+        int a = c->a[i], b = c->b[i];
+        float dx = x[b] - x[a], dy = y[b] - y[a], dz = z[b] - z[a];
+        float len = sqrtf(dx * dx + dy * dy + dz * dz);
+        // Écart relatif à la longueur au repos ; rien pour deux particules confondues
+        float s = len > 0.0f ? (len - c->rest[i]) / len : 0.0f;
+        float sa = c->ka[i] * s, sb = c->kb[i] * s;
+        x[a] += dx * sa; y[a] += dy * sa; z[a] += dz * sa;
+        x[b] -= dx * sb; y[b] -= dy * sb; z[b] -= dz * sb;
+    }
+}
+
+static const SimdKernels kernels_scalar = {
+    "scalar", SIMD_SCALAR, transform_points_scalar, integrate_bodies_scalar, solve_rows_scalar,
+    integrate_particles_scalar, solve_distances_scalar
+};
+
+#ifdef KERNELS_X86
+
+// --- SSE : 4 éléments par itération ---
+
+__attribute__((target("sse2")))
+static void transform_points_sse(const Mat4x4* mat,
+                                 const float* x, const float* y, const float* z,
+                                 float* ox, float* oy, float* oz, float* ow, int n) {
+    __m128 m[4][4];
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            m[r][c] = _mm_set1_ps(mat->m[r][c]);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+        for (int c = 0; c < 4; ++c) {
+            float* out = (c == 0) ? ox : (c == 1) ? oy : (c == 2) ? oz : ow;
+            if (out == NULL) continue;
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m[0][c]), _mm_mul_ps(vy, m[1][c])),
+                                  _mm_add_ps(_mm_mul_ps(vz, m[2][c]), m[3][c]));
+            _mm_storeu_ps(out + i, r);
+        }
+    }
+    if (i < n) {
+        transform_points_scalar(mat, x + i, y + i, z + i, ox + i, oy + i, oz + i,
+                                ow ? ow + i : NULL, n - i);
+    }
+}
+
+__attribute__((target("sse2")))
+static void integrate_bodies_sse(BodySoA* b, Vec3D g, float dt, int begin, int end) {
+    __m128 vdt = _mm_set1_ps(dt);
+    __m128 gx = _mm_set1_ps(g.x * dt), gy = _mm_set1_ps(g.y * dt), gz = _mm_set1_ps(g.z * dt);
+    __m128 zero = _mm_setzero_ps();
+    __m128 half = _mm_set1_ps(0.5f), one = _mm_set1_ps(1.0f);
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        // Masque des corps dynamiques : les statiques gardent vitesse et position
+        __m128 dyn = _mm_cmpneq_ps(_mm_loadu_ps(b->inv_mass + i), zero);
+        __m128 mdt = _mm_and_ps(dyn, vdt);
+
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(b->vx + i), _mm_and_ps(dyn, gx));
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(b->vy + i), _mm_and_ps(dyn, gy));
+        __m128 vz = _mm_add_ps(_mm_loadu_ps(b->vz + i), _mm_and_ps(dyn, gz));
+        _mm_storeu_ps(b->vx + i, vx);
+        _mm_storeu_ps(b->vy + i, vy);
+        _mm_storeu_ps(b->vz + i, vz);
+        _mm_storeu_ps(b->px + i, _mm_add_ps(_mm_loadu_ps(b->px + i), _mm_mul_ps(vx, mdt)));
+        _mm_storeu_ps(b->py + i, _mm_add_ps(_mm_loadu_ps(b->py + i), _mm_mul_ps(vy, mdt)));
+        _mm_storeu_ps(b->pz + i, _mm_add_ps(_mm_loadu_ps(b->pz + i), _mm_mul_ps(vz, mdt)));
+
+        // Orientation : h = dt/2 masqué, les statiques gardent leur quaternion
+        __m128 h = _mm_mul_ps(mdt, half);
+        __m128 x = _mm_loadu_ps(b->qx + i), y = _mm_loadu_ps(b->qy + i);
+        __m128 z = _mm_loadu_ps(b->qz + i), w = _mm_loadu_ps(b->qw + i);
+        __m128 wx = _mm_loadu_ps(b->wx + i), wy = _mm_loadu_ps(b->wy + i), wz = _mm_loadu_ps(b->wz + i);
+        __m128 nx = _mm_add_ps(x, _mm_mul_ps(h, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(w, wx), _mm_mul_ps(wy, z)), _mm_mul_ps(wz, y))));
+        __m128 ny = _mm_add_ps(y, _mm_mul_ps(h, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(w, wy), _mm_mul_ps(wz, x)), _mm_mul_ps(wx, z))));
+        __m128 nz = _mm_add_ps(z, _mm_mul_ps(h, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(w, wz), _mm_mul_ps(wx, y)), _mm_mul_ps(wy, x))));
+        __m128 nw = _mm_sub_ps(w, _mm_mul_ps(h, _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, x), _mm_mul_ps(wy, y)), _mm_mul_ps(wz, z))));
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)),
+                                 _mm_add_ps(_mm_mul_ps(nz, nz), _mm_mul_ps(nw, nw)));
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(len2));
+        _mm_storeu_ps(b->qx + i, _mm_or_ps(_mm_and_ps(dyn, _mm_mul_ps(nx, inv)), _mm_andnot_ps(dyn, x)));
+        _mm_storeu_ps(b->qy + i, _mm_or_ps(_mm_and_ps(dyn, _mm_mul_ps(ny, inv)), _mm_andnot_ps(dyn, y)));
+        _mm_storeu_ps(b->qz + i, _mm_or_ps(_mm_and_ps(dyn, _mm_mul_ps(nz, inv)), _mm_andnot_ps(dyn, z)));
+        _mm_storeu_ps(b->qw + i, _mm_or_ps(_mm_and_ps(dyn, _mm_mul_ps(nw, inv)), _mm_andnot_ps(dyn, w)));
+    }
+    integrate_bodies_scalar(b, g, dt, i, end);
+}
+
+// Vitesses des corps de 4 voies : deux moitiés de ligne par corps,
+// transposées en (vx, vy, vz, wx) et (wy, wz, -, -) par voie
+__attribute__((target("sse2")))
+static inline void load_bodies_sse(const float* v, const int* idx, __m128 c[8]) {
+    __m128 lo0 = _mm_load_ps(v + idx[0] * SOLVER_BODY_STRIDE), hi0 = _mm_load_ps(v + idx[0] * SOLVER_BODY_STRIDE + 4);
+    __m128 lo1 = _mm_load_ps(v + idx[1] * SOLVER_BODY_STRIDE), hi1 = _mm_load_ps(v + idx[1] * SOLVER_BODY_STRIDE + 4);
+    __m128 lo2 = _mm_load_ps(v + idx[2] * SOLVER_BODY_STRIDE), hi2 = _mm_load_ps(v + idx[2] * SOLVER_BODY_STRIDE + 4);
+    __m128 lo3 = _mm_load_ps(v + idx[3] * SOLVER_BODY_STRIDE), hi3 = _mm_load_ps(v + idx[3] * SOLVER_BODY_STRIDE + 4);
+    _MM_TRANSPOSE4_PS(lo0, lo1, lo2, lo3);
+    _MM_TRANSPOSE4_PS(hi0, hi1, hi2, hi3);
+    c[0] = lo0; c[1] = lo1; c[2] = lo2; c[3] = lo3;
+    c[4] = hi0; c[5] = hi1; c[6] = hi2; c[7] = hi3;
+}
+
+// Écriture inverse. Les corps dynamiques d'un lot sont tous distincts, et le
+// corps statique 0 reçoit ses propres valeurs (masse et inertie inverses nulles).
+__attribute__((target("sse2")))
+static inline void store_bodies_sse(float* v, const int* idx, const __m128 c[8]) {
+    __m128 lo0 = c[0], lo1 = c[1], lo2 = c[2], lo3 = c[3];
+    __m128 hi0 = c[4], hi1 = c[5], hi2 = c[6], hi3 = c[7];
+    _MM_TRANSPOSE4_PS(lo0, lo1, lo2, lo3);
+    _MM_TRANSPOSE4_PS(hi0, hi1, hi2, hi3);
+    _mm_store_ps(v + idx[0] * SOLVER_BODY_STRIDE, lo0); _mm_store_ps(v + idx[0] * SOLVER_BODY_STRIDE + 4, hi0);
+    _mm_store_ps(v + idx[1] * SOLVER_BODY_STRIDE, lo1); _mm_store_ps(v + idx[1] * SOLVER_BODY_STRIDE + 4, hi1);
+    _mm_store_ps(v + idx[2] * SOLVER_BODY_STRIDE, lo2); _mm_store_ps(v + idx[2] * SOLVER_BODY_STRIDE + 4, hi2);
+    _mm_store_ps(v + idx[3] * SOLVER_BODY_STRIDE, lo3); _mm_store_ps(v + idx[3] * SOLVER_BODY_STRIDE + 4, hi3);
+}
+
+__attribute__((target("sse2")))
+static float solve_rows_sse(SolverRows* r, SolverBodies* bodies, int begin, int end) {
+    __m128 residual = _mm_setzero_ps();
+    __m128 sign = _mm_set1_ps(-0.0f);
+    for (int i = begin * SOLVER_LANES; i < end * SOLVER_LANES; i += 4) {
+        __m128 a[8], b[8];
+        load_bodies_sse(bodies->v, r->a + i, a);
+        load_bodies_sse(bodies->v, r->b + i, b);
+        __m128 nx = _mm_loadu_ps(r->nx + i), ny = _mm_loadu_ps(r->ny + i), nz = _mm_loadu_ps(r->nz + i);
+
+        __m128 jv = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_sub_ps(b[0], a[0])), _mm_mul_ps(ny, _mm_sub_ps(b[1], a[1]))),
+                               _mm_mul_ps(nz, _mm_sub_ps(b[2], a[2])));
+        jv = _mm_add_ps(jv, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r->jax + i), a[3]),
+                                                  _mm_mul_ps(_mm_loadu_ps(r->jay + i), a[4])),
+                                       _mm_mul_ps(_mm_loadu_ps(r->jaz + i), a[5])));
+        jv = _mm_add_ps(jv, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r->jbx + i), b[3]),
+                                                  _mm_mul_ps(_mm_loadu_ps(r->jby + i), b[4])),
+                                       _mm_mul_ps(_mm_loadu_ps(r->jbz + i), b[5])));
+
+        float lo_lane[4], hi_lane[4];
+        for (int k = 0; k < 4; ++k) {
+            int normal = r->normal_row[i + k];
+            hi_lane[k] = normal >= 0 ? r->friction[i + k] * r->impulse[normal] : r->hi[i + k];
+            lo_lane[k] = normal >= 0 ? -hi_lane[k] : r->lo[i + k];
+        }
+        __m128 old = _mm_loadu_ps(r->impulse + i);
+        __m128 acc = _mm_sub_ps(old, _mm_mul_ps(_mm_loadu_ps(r->eff_mass + i),
+                                                _mm_add_ps(jv, _mm_loadu_ps(r->bias + i))));
+        acc = _mm_min_ps(_mm_max_ps(acc, _mm_loadu_ps(lo_lane)), _mm_loadu_ps(hi_lane));
+        __m128 d = _mm_sub_ps(acc, old);
+        _mm_storeu_ps(r->impulse + i, acc);
+        residual = _mm_add_ps(residual, _mm_andnot_ps(sign, d));
+
+        __m128 la = _mm_mul_ps(_mm_loadu_ps(r->ima + i), d), lb = _mm_mul_ps(_mm_loadu_ps(r->imb + i), d);
+        a[0] = _mm_sub_ps(a[0], _mm_mul_ps(nx, la));
+        a[1] = _mm_sub_ps(a[1], _mm_mul_ps(ny, la));
+        a[2] = _mm_sub_ps(a[2], _mm_mul_ps(nz, la));
+        a[3] = _mm_add_ps(a[3], _mm_mul_ps(_mm_loadu_ps(r->iax + i), d));
+        a[4] = _mm_add_ps(a[4], _mm_mul_ps(_mm_loadu_ps(r->iay + i), d));
+        a[5] = _mm_add_ps(a[5], _mm_mul_ps(_mm_loadu_ps(r->iaz + i), d));
+        b[0] = _mm_add_ps(b[0], _mm_mul_ps(nx, lb));
+        b[1] = _mm_add_ps(b[1], _mm_mul_ps(ny, lb));
+        b[2] = _mm_add_ps(b[2], _mm_mul_ps(nz, lb));
+        b[3] = _mm_add_ps(b[3], _mm_mul_ps(_mm_loadu_ps(r->ibx + i), d));
+        b[4] = _mm_add_ps(b[4], _mm_mul_ps(_mm_loadu_ps(r->iby + i), d));
+        b[5] = _mm_add_ps(b[5], _mm_mul_ps(_mm_loadu_ps(r->ibz + i), d));
+        store_bodies_sse(bodies->v, r->a + i, a);
+        store_bodies_sse(bodies->v, r->b + i, b);
+    }
+    float lane[4];
+    _mm_storeu_ps(lane, residual);
+    return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+}
+
+__attribute__((target("sse2")))
+static void integrate_particles_sse(ParticleSoA* p, Vec3D g, float dt, float damping, int begin, int end) {
+    __m128 keep = _mm_set1_ps(1.0f - damping);
+    __m128 gx = _mm_set1_ps(g.x * dt * dt), gy = _mm_set1_ps(g.y * dt * dt), gz = _mm_set1_ps(g.z * dt * dt);
+    __m128 zero = _mm_setzero_ps();
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        // Les particules fixées gardent leurs deux positions
+        __m128 dyn = _mm_cmpneq_ps(_mm_loadu_ps(p->inv_mass + i), zero);
+        __m128 x = _mm_loadu_ps(p->x + i), y = _mm_loadu_ps(p->y + i), z = _mm_loadu_ps(p->z + i);
+        __m128 ox = _mm_loadu_ps(p->ox + i), oy = _mm_loadu_ps(p->oy + i), oz = _mm_loadu_ps(p->oz + i);
+        __m128 dx = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(x, ox), keep), gx);
+        __m128 dy = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(y, oy), keep), gy);
+        __m128 dz = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(z, oz), keep), gz);
+        _mm_storeu_ps(p->x + i, _mm_add_ps(x, _mm_and_ps(dyn, dx)));
+        _mm_storeu_ps(p->y + i, _mm_add_ps(y, _mm_and_ps(dyn, dy)));
+        _mm_storeu_ps(p->z + i, _mm_add_ps(z, _mm_and_ps(dyn, dz)));
+        _mm_storeu_ps(p->ox + i, _mm_or_ps(_mm_and_ps(dyn, x), _mm_andnot_ps(dyn, ox)));
+        _mm_storeu_ps(p->oy + i, _mm_or_ps(_mm_and_ps(dyn, y), _mm_andnot_ps(dyn, oy)));
+        _mm_storeu_ps(p->oz + i, _mm_or_ps(_mm_and_ps(dyn, z), _mm_andnot_ps(dyn, oz)));
+    }
+    integrate_particles_scalar(p, g, dt, damping, i, end);
+}
+
+// Composante des particules de 4 voies, lue sans instruction de collecte
+__attribute__((target("sse2")))
+static inline __m128 gather4_sse(const float* v, const int* idx) {
+    return _mm_set_ps(v[idx[3]], v[idx[2]], v[idx[1]], v[idx[0]]);
+}
+
+// Écriture inverse. Dans un lot, seules les particules fixées et le puits
+// peuvent apparaître deux fois, et leur position n'y change pas.
+__attribute__((target("sse2")))
+static inline void scatter4_sse(float* v, const int* idx, __m128 values) {
+    float lane[4];
+    _mm_storeu_ps(lane, values);
+    v[idx[0]] = lane[0]; v[idx[1]] = lane[1]; v[idx[2]] = lane[2]; v[idx[3]] = lane[3];
+}
+
+__attribute__((target("sse2")))
+static void solve_distances_sse(const DistanceBatches* c, ParticleSoA* p, int begin, int end) {
+    __m128 zero = _mm_setzero_ps();
+    for (int i = begin * PARTICLE_LANES; i < end * PARTICLE_LANES; i += 4) {
+        const int* ia = c->a + i;
+        const int* ib = c->b + i;
+        __m128 xa = gather4_sse(p->x, ia), ya = gather4_sse(p->y, ia), za = gather4_sse(p->z, ia);
+        __m128 xb = gather4_sse(p->x, ib), yb = gather4_sse(p->y, ib), zb = gather4_sse(p->z, ib);
+        __m128 dx = _mm_sub_ps(xb, xa), dy = _mm_sub_ps(yb, ya), dz = _mm_sub_ps(zb, za);
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 valid = _mm_cmpgt_ps(len2, zero);
+        __m128 len = _mm_sqrt_ps(len2);
+        // Voies vides ou confondues : division par 1, résultat masqué
+        __m128 s = _mm_div_ps(_mm_sub_ps(len, _mm_loadu_ps(c->rest + i)),
+                              _mm_or_ps(_mm_and_ps(valid, len), _mm_andnot_ps(valid, _mm_set1_ps(1.0f))));
+        s = _mm_and_ps(valid, s);
+        __m128 sa = _mm_mul_ps(_mm_loadu_ps(c->ka + i), s), sb = _mm_mul_ps(_mm_loadu_ps(c->kb + i), s);
+        scatter4_sse(p->x, ia, _mm_add_ps(xa, _mm_mul_ps(dx, sa)));
+        scatter4_sse(p->y, ia, _mm_add_ps(ya, _mm_mul_ps(dy, sa)));
+        scatter4_sse(p->z, ia, _mm_add_ps(za, _mm_mul_ps(dz, sa)));
+        scatter4_sse(p->x, ib, _mm_sub_ps(xb, _mm_mul_ps(dx, sb)));
+        scatter4_sse(p->y, ib, _mm_sub_ps(yb, _mm_mul_ps(dy, sb)));
+        scatter4_sse(p->z, ib, _mm_sub_ps(zb, _mm_mul_ps(dz, sb)));
+    }
+}
+
+static const SimdKernels kernels_sse = {
+    "sse", SIMD_SSE, transform_points_sse, integrate_bodies_sse, solve_rows_sse,
+    integrate_particles_sse, solve_distances_sse
+};
+
+// --- AVX2 + FMA : 8 éléments par itération ---
+
+__attribute__((target("avx2,fma")))
+static void transform_points_avx2(const Mat4x4* mat,
+                                  const float* x, const float* y, const float* z,
+                                  float* ox, float* oy, float* oz, float* ow, int n) {
+    __m256 m[4][4];
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            m[r][c] = _mm256_set1_ps(mat->m[r][c]);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i), vy = _mm256_loadu_ps(y + i), vz = _mm256_loadu_ps(z + i);
+        for (int c = 0; c < 4; ++c) {
+            float* out = (c == 0) ? ox : (c == 1) ? oy : (c == 2) ? oz : ow;
+            if (out == NULL) continue;
+            __m256 r = _mm256_fmadd_ps(vx, m[0][c],
+                       _mm256_fmadd_ps(vy, m[1][c],
+                       _mm256_fmadd_ps(vz, m[2][c], m[3][c])));
+            _mm256_storeu_ps(out + i, r);
+        }
+    }
+    if (i < n) {
+        transform_points_sse(mat, x + i, y + i, z + i, ox + i, oy + i, oz + i,
+                             ow ? ow + i : NULL, n - i);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void integrate_bodies_avx2(BodySoA* b, Vec3D g, float dt, int begin, int end) {
+    __m256 vdt = _mm256_set1_ps(dt);
+    __m256 gx = _mm256_set1_ps(g.x * dt), gy = _mm256_set1_ps(g.y * dt), gz = _mm256_set1_ps(g.z * dt);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 half = _mm256_set1_ps(0.5f), one = _mm256_set1_ps(1.0f);
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 dyn = _mm256_cmp_ps(_mm256_loadu_ps(b->inv_mass + i), zero, _CMP_NEQ_OQ);
+        __m256 mdt = _mm256_and_ps(dyn, vdt);
+
+        __m256 vx = _mm256_add_ps(_mm256_loadu_ps(b->vx + i), _mm256_and_ps(dyn, gx));
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(b->vy + i), _mm256_and_ps(dyn, gy));
+        __m256 vz = _mm256_add_ps(_mm256_loadu_ps(b->vz + i), _mm256_and_ps(dyn, gz));
+        _mm256_storeu_ps(b->vx + i, vx);
+        _mm256_storeu_ps(b->vy + i, vy);
+        _mm256_storeu_ps(b->vz + i, vz);
+        _mm256_storeu_ps(b->px + i, _mm256_fmadd_ps(vx, mdt, _mm256_loadu_ps(b->px + i)));
+        _mm256_storeu_ps(b->py + i, _mm256_fmadd_ps(vy, mdt, _mm256_loadu_ps(b->py + i)));
+        _mm256_storeu_ps(b->pz + i, _mm256_fmadd_ps(vz, mdt, _mm256_loadu_ps(b->pz + i)));
+
+        __m256 h = _mm256_mul_ps(mdt, half);
+        __m256 x = _mm256_loadu_ps(b->qx + i), y = _mm256_loadu_ps(b->qy + i);
+        __m256 z = _mm256_loadu_ps(b->qz + i), w = _mm256_loadu_ps(b->qw + i);
+        __m256 wx = _mm256_loadu_ps(b->wx + i), wy = _mm256_loadu_ps(b->wy + i), wz = _mm256_loadu_ps(b->wz + i);
+        __m256 nx = _mm256_fmadd_ps(h, _mm256_fmsub_ps(w, wx, _mm256_fmsub_ps(wz, y, _mm256_mul_ps(wy, z))), x);
+        __m256 ny = _mm256_fmadd_ps(h, _mm256_fmsub_ps(w, wy, _mm256_fmsub_ps(wx, z, _mm256_mul_ps(wz, x))), y);
+        __m256 nz = _mm256_fmadd_ps(h, _mm256_fmsub_ps(w, wz, _mm256_fmsub_ps(wy, x, _mm256_mul_ps(wx, y))), z);
+        __m256 nw = _mm256_fnmadd_ps(h, _mm256_fmadd_ps(wx, x, _mm256_fmadd_ps(wy, y, _mm256_mul_ps(wz, z))), w);
+        __m256 len2 = _mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(ny, ny, _mm256_fmadd_ps(nz, nz, _mm256_mul_ps(nw, nw))));
+        __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(len2));
+        _mm256_storeu_ps(b->qx + i, _mm256_blendv_ps(x, _mm256_mul_ps(nx, inv), dyn));
+        _mm256_storeu_ps(b->qy + i, _mm256_blendv_ps(y, _mm256_mul_ps(ny, inv), dyn));
+        _mm256_storeu_ps(b->qz + i, _mm256_blendv_ps(z, _mm256_mul_ps(nz, inv), dyn));
+        _mm256_storeu_ps(b->qw + i, _mm256_blendv_ps(w, _mm256_mul_ps(nw, inv), dyn));
+    }
+    integrate_bodies_sse(b, g, dt, i, end);
+}
+
+// Transposition 8x8 : lignes (un corps chacune) <-> colonnes (une composante)
+__attribute__((target("avx2,fma")))
+static inline void transpose8_avx2(__m256 m[8]) {
+    __m256 t0 = _mm256_unpacklo_ps(m[0], m[1]), t1 = _mm256_unpackhi_ps(m[0], m[1]);
+    __m256 t2 = _mm256_unpacklo_ps(m[2], m[3]), t3 = _mm256_unpackhi_ps(m[2], m[3]);
+    __m256 t4 = _mm256_unpacklo_ps(m[4], m[5]), t5 = _mm256_unpackhi_ps(m[4], m[5]);
+    __m256 t6 = _mm256_unpacklo_ps(m[6], m[7]), t7 = _mm256_unpackhi_ps(m[6], m[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    m[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    m[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    m[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    m[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    m[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    m[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    m[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    m[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+__attribute__((target("avx2,fma")))
+static inline void load_bodies_avx2(const float* v, const int* idx, __m256 c[8]) {
+    for (int k = 0; k < 8; ++k) c[k] = _mm256_load_ps(v + idx[k] * SOLVER_BODY_STRIDE);
+    transpose8_avx2(c);
+}
+
+// Mêmes garanties que store_bodies_sse
+__attribute__((target("avx2,fma")))
+static inline void store_bodies_avx2(float* v, const int* idx, __m256 c[8]) {
+    transpose8_avx2(c);
+    for (int k = 0; k < 8; ++k) _mm256_store_ps(v + idx[k] * SOLVER_BODY_STRIDE, c[k]);
+}
+
+__attribute__((target("avx2,fma")))
+static float solve_rows_avx2(SolverRows* r, SolverBodies* bodies, int begin, int end) {
+    __m256 residual = _mm256_setzero_ps();
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256i none = _mm256_set1_epi32(-1), zero = _mm256_setzero_si256();
+    for (int i = begin * SOLVER_LANES; i < end * SOLVER_LANES; i += 8) {
+        __m256 a[8], b[8];
+        load_bodies_avx2(bodies->v, r->a + i, a);
+        load_bodies_avx2(bodies->v, r->b + i, b);
+        __m256 nx = _mm256_load_ps(r->nx + i), ny = _mm256_load_ps(r->ny + i), nz = _mm256_load_ps(r->nz + i);
+
+        __m256 jv = _mm256_mul_ps(nx, _mm256_sub_ps(b[0], a[0]));
+        jv = _mm256_fmadd_ps(ny, _mm256_sub_ps(b[1], a[1]), jv);
+        jv = _mm256_fmadd_ps(nz, _mm256_sub_ps(b[2], a[2]), jv);
+        jv = _mm256_fmadd_ps(_mm256_load_ps(r->jax + i), a[3], jv);
+        jv = _mm256_fmadd_ps(_mm256_load_ps(r->jay + i), a[4], jv);
+        jv = _mm256_fmadd_ps(_mm256_load_ps(r->jaz + i), a[5], jv);
+        jv = _mm256_fmadd_ps(_mm256_load_ps(r->jbx + i), b[3], jv);
+        jv = _mm256_fmadd_ps(_mm256_load_ps(r->jby + i), b[4], jv);
+        jv = _mm256_fmadd_ps(_mm256_load_ps(r->jbz + i), b[5], jv);
+
+        // Lignes de frottement : bornes tirées de l'impulsion de leur ligne normale
+        __m256i normal = _mm256_load_si256((const __m256i*)(r->normal_row + i));
+        __m256 is_friction = _mm256_castsi256_ps(_mm256_cmpgt_epi32(normal, none));
+        __m256 limit = _mm256_mul_ps(_mm256_load_ps(r->friction + i),
+                                     _mm256_i32gather_ps(r->impulse, _mm256_max_epi32(normal, zero), 4));
+        __m256 lo = _mm256_blendv_ps(_mm256_load_ps(r->lo + i), _mm256_xor_ps(limit, sign), is_friction);
+        __m256 hi = _mm256_blendv_ps(_mm256_load_ps(r->hi + i), limit, is_friction);
+
+        __m256 old = _mm256_load_ps(r->impulse + i);
+        __m256 acc = _mm256_fnmadd_ps(_mm256_load_ps(r->eff_mass + i),
+                                      _mm256_add_ps(jv, _mm256_load_ps(r->bias + i)), old);
+        acc = _mm256_min_ps(_mm256_max_ps(acc, lo), hi);
+        __m256 d = _mm256_sub_ps(acc, old);
+        _mm256_store_ps(r->impulse + i, acc);
+        residual = _mm256_add_ps(residual, _mm256_andnot_ps(sign, d));
+
+        __m256 la = _mm256_mul_ps(_mm256_load_ps(r->ima + i), d), lb = _mm256_mul_ps(_mm256_load_ps(r->imb + i), d);
+        a[0] = _mm256_fnmadd_ps(nx, la, a[0]);
+        a[1] = _mm256_fnmadd_ps(ny, la, a[1]);
+        a[2] = _mm256_fnmadd_ps(nz, la, a[2]);
+        a[3] = _mm256_fmadd_ps(_mm256_load_ps(r->iax + i), d, a[3]);
+        a[4] = _mm256_fmadd_ps(_mm256_load_ps(r->iay + i), d, a[4]);
+        a[5] = _mm256_fmadd_ps(_mm256_load_ps(r->iaz + i), d, a[5]);
+        b[0] = _mm256_fmadd_ps(nx, lb, b[0]);
+        b[1] = _mm256_fmadd_ps(ny, lb, b[1]);
+        b[2] = _mm256_fmadd_ps(nz, lb, b[2]);
+        b[3] = _mm256_fmadd_ps(_mm256_load_ps(r->ibx + i), d, b[3]);
+        b[4] = _mm256_fmadd_ps(_mm256_load_ps(r->iby + i), d, b[4]);
+        b[5] = _mm256_fmadd_ps(_mm256_load_ps(r->ibz + i), d, b[5]);
+        store_bodies_avx2(bodies->v, r->a + i, a);
+        store_bodies_avx2(bodies->v, r->b + i, b);
+    }
+    float lane[8];
+    _mm256_storeu_ps(lane, residual);
+    return ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+}
+
+__attribute__((target("avx2,fma")))
+static void integrate_particles_avx2(ParticleSoA* p, Vec3D g, float dt, float damping, int begin, int end) {
+    __m256 keep = _mm256_set1_ps(1.0f - damping);
+    __m256 gx = _mm256_set1_ps(g.x * dt * dt), gy = _mm256_set1_ps(g.y * dt * dt), gz = _mm256_set1_ps(g.z * dt * dt);
+    __m256 zero = _mm256_setzero_ps();
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 dyn = _mm256_cmp_ps(_mm256_loadu_ps(p->inv_mass + i), zero, _CMP_NEQ_OQ);
+        __m256 x = _mm256_loadu_ps(p->x + i), y = _mm256_loadu_ps(p->y + i), z = _mm256_loadu_ps(p->z + i);
+        __m256 ox = _mm256_loadu_ps(p->ox + i), oy = _mm256_loadu_ps(p->oy + i), oz = _mm256_loadu_ps(p->oz + i);
+        __m256 dx = _mm256_fmadd_ps(_mm256_sub_ps(x, ox), keep, gx);
+        __m256 dy = _mm256_fmadd_ps(_mm256_sub_ps(y, oy), keep, gy);
+        __m256 dz = _mm256_fmadd_ps(_mm256_sub_ps(z, oz), keep, gz);
+        _mm256_storeu_ps(p->x + i, _mm256_add_ps(x, _mm256_and_ps(dyn, dx)));
+        _mm256_storeu_ps(p->y + i, _mm256_add_ps(y, _mm256_and_ps(dyn, dy)));
+        _mm256_storeu_ps(p->z + i, _mm256_add_ps(z, _mm256_and_ps(dyn, dz)));
+        _mm256_storeu_ps(p->ox + i, _mm256_blendv_ps(ox, x, dyn));
+        _mm256_storeu_ps(p->oy + i, _mm256_blendv_ps(oy, y, dyn));
+        _mm256_storeu_ps(p->oz + i, _mm256_blendv_ps(oz, z, dyn));
+    }
+    integrate_particles_sse(p, g, dt, damping, i, end);
+}
+
+// Pas d'écriture dispersée en AVX2 : voies écrites une à une, mêmes
+// garanties que scatter4_sse
+__attribute__((target("avx2,fma")))
+static inline void scatter8_avx2(float* v, const int* idx, __m256 values) {
+    float lane[8];
+    _mm256_storeu_ps(lane, values);
+    for (int k = 0; k < 8; ++k) v[idx[k]] = lane[k];
+}
+
+__attribute__((target("avx2,fma")))
+static void solve_distances_avx2(const DistanceBatches* c, ParticleSoA* p, int begin, int end) {
+    __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    for (int i = begin * PARTICLE_LANES; i < end * PARTICLE_LANES; i += 8) {
+        __m256i ia = _mm256_load_si256((const __m256i*)(c->a + i));
+        __m256i ib = _mm256_load_si256((const __m256i*)(c->b + i));
+        __m256 xa = _mm256_i32gather_ps(p->x, ia, 4), ya = _mm256_i32gather_ps(p->y, ia, 4);
+        __m256 za = _mm256_i32gather_ps(p->z, ia, 4);
+        __m256 xb = _mm256_i32gather_ps(p->x, ib, 4), yb = _mm256_i32gather_ps(p->y, ib, 4);
+        __m256 zb = _mm256_i32gather_ps(p->z, ib, 4);
+        __m256 dx = _mm256_sub_ps(xb, xa), dy = _mm256_sub_ps(yb, ya), dz = _mm256_sub_ps(zb, za);
+        __m256 len2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+        __m256 valid = _mm256_cmp_ps(len2, zero, _CMP_GT_OQ);
+        __m256 len = _mm256_sqrt_ps(len2);
+        __m256 s = _mm256_div_ps(_mm256_sub_ps(len, _mm256_load_ps(c->rest + i)), _mm256_blendv_ps(one, len, valid));
+        s = _mm256_and_ps(valid, s);
+        __m256 sa = _mm256_mul_ps(_mm256_load_ps(c->ka + i), s), sb = _mm256_mul_ps(_mm256_load_ps(c->kb + i), s);
+        scatter8_avx2(p->x, c->a + i, _mm256_fmadd_ps(dx, sa, xa));
+        scatter8_avx2(p->y, c->a + i, _mm256_fmadd_ps(dy, sa, ya));
+        scatter8_avx2(p->z, c->a + i, _mm256_fmadd_ps(dz, sa, za));
+        scatter8_avx2(p->x, c->b + i, _mm256_fnmadd_ps(dx, sb, xb));
+        scatter8_avx2(p->y, c->b + i, _mm256_fnmadd_ps(dy, sb, yb));
+        scatter8_avx2(p->z, c->b + i, _mm256_fnmadd_ps(dz, sb, zb));
+    }
+}
+
+static const SimdKernels kernels_avx2 = {
+    "avx2", SIMD_AVX2, transform_points_avx2, integrate_bodies_avx2, solve_rows_avx2,
+    integrate_particles_avx2, solve_distances_avx2
+};
+
+#endif // KERNELS_X86
+
+// --- Sélection à l'exécution ---
+
+SimdLevel simd_detect(void) {
+    SimdLevel level = SIMD_SCALAR;
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) level = SIMD_SSE;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) level = SIMD_AVX2;
+#endif
+    const char* cap = getenv("PHYS_SIMD");
+    if (cap != NULL) {
+        SimdLevel max = strcmp(cap, "scalar") == 0 ? SIMD_SCALAR
+                      : strcmp(cap, "sse") == 0    ? SIMD_SSE
+                                                   : SIMD_AVX2;
+        if (max < level) level = max;
+    }
+    return level;
+}
+
+const SimdKernels* kernels_for_level(SimdLevel level) {
+#ifdef KERNELS_X86
+    if (level >= SIMD_AVX2) return &kernels_avx2;
+    if (level >= SIMD_SSE) return &kernels_sse;
+#else
+    (void)level;
+#endif
+    return &kernels_scalar;
+}
+
+const SimdKernels* kernels_get(void) {
+    static const SimdKernels* selected = NULL;
+    if (selected == NULL) {
+        selected = kernels_for_level(simd_detect());
+    }
+    return selected;
+}
@@ -0,0 +1,53 @@
+#ifndef ENGINE_KERNELS_H
+#define ENGINE_KERNELS_H
+
+#include "math3d.h"
+#include "particles.h"
+#include "soa.h"
+#include "solver.h"
+
+// Niveaux SIMD disponibles, du plus lent au plus rapide
+typedef enum {
+    SIMD_SCALAR = 0,
+    SIMD_SSE,
+    SIMD_AVX2,
+    SIMD_LEVEL_COUNT
+} SimdLevel;
+
+// Noyaux traitant N éléments par appel. La matrice est passée par pointeur
+// et lue une seule fois par lot au lieu d'une copie de 64 octets par sommet.
+typedef struct {
+    const char* name;
+    SimdLevel level;
+
+    // (x, y, z, 1) * mat -> (ox, oy, oz, ow) pour n sommets ; `ow` peut être NULL
+    void (*transform_points)(const Mat4x4* mat,
+                             const float* x, const float* y, const float* z,
+                             float* ox, float* oy, float* oz, float* ow, int n);
+
+    // Euler semi-implicite sur les corps [begin, end) ; les corps statiques sont ignorés
+    void (*integrate_bodies)(BodySoA* bodies, Vec3D gravity, float dt, int begin, int end);
+
+    // Une passe de Gauss-Seidel projeté sur les lots de lignes [begin, end).
+    // Retourne la somme des |variations d'impulsion|, mesure de convergence.
+    float (*solve_rows)(SolverRows* rows, SolverBodies* bodies, int begin, int end);
+
+    // Verlet sur les particules [begin, end) : x += (x - ox) * (1 - damping) + g dt² ;
+    // les particules fixées sont ignorées
+    void (*integrate_particles)(ParticleSoA* p, Vec3D gravity, float dt, float damping, int begin, int end);
+
+    // Une passe sur les lots de contraintes de distance [begin, end)
+    void (*solve_distances)(const DistanceBatches* c, ParticleSoA* p, int begin, int end);
+} SimdKernels;
+
+// Meilleur niveau supporté par le processeur (détection à l'exécution).
+// La variable d'environnement PHYS_SIMD=scalar|sse|avx2 permet de le plafonner.
+SimdLevel simd_detect(void);
+
+// Noyaux du niveau demandé, ou du meilleur niveau disponible inférieur
+const SimdKernels* kernels_for_level(SimdLevel level);
+
+// Noyaux sélectionnés une fois pour toutes au premier appel
+const SimdKernels* kernels_get(void);
+
+#endif
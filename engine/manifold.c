@@ -0,0 +1,434 @@
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "manifold.h"
+
+void manifold_cache_init(ManifoldCache* cache) {
+    memset(cache, 0, sizeof(*cache));
+    cache->warm_start = 1;
+}
+
+void manifold_cache_free(ManifoldCache* cache) {
+    mem_free(cache->manifolds);
+    mem_free(cache->previous);
+    mem_free(cache->table);
+    manifold_cache_init(cache);
+}
+
+static inline uint32_t pair_hash(int a, int b, int table_capacity) {
+    uint64_t key = ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+    key *= 0x9E3779B97F4A7C15ull; // Fibonacci : les bits hauts sont bien mélangés
+    return (uint32_t)(key >> 32) & (uint32_t)(table_capacity - 1);
+}
+
+static int reserve_manifolds(ContactManifold** array, int* capacity, int count) {
+    if (count <= *capacity) {
+        return 1;
+    }
+    int new_capacity = *capacity ? *capacity : 64;
+    while (new_capacity < count) new_capacity *= 2;
+    ContactManifold* grown = (ContactManifold*)mem_realloc(*array, (size_t)new_capacity * sizeof(ContactManifold));
+    if (grown == NULL) {
+        return 0;
+    }
+    mem_advise_huge_pages(grown, (size_t)new_capacity * sizeof(ContactManifold));
+    *array = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+int manifold_cache_begin(ManifoldCache* cache, const BodyPair* pairs, int num_pairs) {
+    // Les variétés du pas précédent deviennent la source de la correspondance
+    ContactManifold* swap = cache->previous;
+    int swap_capacity = cache->previous_capacity;
+    cache->previous = cache->manifolds;
+    cache->previous_capacity = cache->capacity;
+    cache->previous_count = cache->count;
+    cache->manifolds = swap;
+    cache->capacity = swap_capacity;
+    cache->count = 0;
+    if (!reserve_manifolds(&cache->manifolds, &cache->capacity, num_pairs)) {
+        return 0;
+    }
+
+    // Table à adressage ouvert, remplie au plus à moitié
+    int table_capacity = 16;
+    while (table_capacity < 2 * cache->previous_count) table_capacity *= 2;
+    if (table_capacity > cache->table_capacity) {
+        int* table = (int*)mem_realloc(cache->table, (size_t)table_capacity * sizeof(int));
+        if (table == NULL) {
+            return 0;
+        }
+        cache->table = table;
+        cache->table_capacity = table_capacity;
+    }
+    table_capacity = cache->table_capacity;
+    memset(cache->table, -1, (size_t)table_capacity * sizeof(int));
+    for (int i = 0; cache->warm_start && i < cache->previous_count; ++i) {
+        uint32_t slot = pair_hash(cache->previous[i].a, cache->previous[i].b, table_capacity);
+        while (cache->table[slot] >= 0) slot = (slot + 1) & (uint32_t)(table_capacity - 1);
+        cache->table[slot] = i;
+    }
+
+    cache->num_reused = 0;
+    for (int p = 0; p < num_pairs; ++p) {
+        int a = pairs[p].a, b = pairs[p].b;
+        ContactManifold* m = &cache->manifolds[p];
+        int found = -1;
+        uint32_t slot = pair_hash(a, b, table_capacity);
+        while (cache->warm_start && cache->table[slot] >= 0) {
+            const ContactManifold* old = &cache->previous[cache->table[slot]];
+            if (old->a == a && old->b == b) {
+                found = cache->table[slot];
+                break;
+            }
+            slot = (slot + 1) & (uint32_t)(table_capacity - 1);
+        }
+        if (found >= 0) {
+            *m = cache->previous[found];
+            m->reused = 1;
+            cache->num_reused++;
+        } else {
+            memset(m, 0, sizeof(*m));
+            m->a = a;
+            m->b = b;
+        }
+    }
+    cache->count = num_pairs;
+    return 1;
+}
+
+int manifold_cache_set(ManifoldCache* cache, const ContactManifold* manifolds, int count) {
+    if (!reserve_manifolds(&cache->manifolds, &cache->capacity, count)) {
+        return 0;
+    }
+    if (count > 0) {
+        memcpy(cache->manifolds, manifolds, (size_t)count * sizeof(ContactManifold));
+    }
+    cache->count = count;
+    return 1;
+}
+
+static inline Vec3D to_world(BodyPose pose, Vec3D local) {
+    return vec3_add(pose.position, quat_rotate(pose.orientation, local));
+}
+
+static inline Vec3D to_local(BodyPose pose, Vec3D world) {
+    return quat_rotate(quat_conjugate(pose.orientation), vec3_sub(world, pose.position));
+}
+
+// Aire (au carré, à un facteur près) du quadrilatère p0..p3, d'après ses diagonales
+static float quad_area(Vec3D p0, Vec3D p1, Vec3D p2, Vec3D p3) {
+    Vec3D c0 = vec3_cross(vec3_sub(p0, p1), vec3_sub(p2, p3));
+    Vec3D c1 = vec3_cross(vec3_sub(p0, p2), vec3_sub(p1, p3));
+    Vec3D c2 = vec3_cross(vec3_sub(p0, p3), vec3_sub(p1, p2));
+    float a0 = vec3_dot(c0, c0), a1 = vec3_dot(c1, c1), a2 = vec3_dot(c2, c2);
+    return fmaxf(a0, fmaxf(a1, a2));
+}
+
+// Variété pleine : le point remplacé est celui dont l'absence laisse la plus
+// grande surface couverte, sans jamais écarter le plus profond
+static int replacement_index(const ContactManifold* m, const ManifoldPoint* point) {
+    int deepest = -1;
+    float max_depth = point->depth;
+    for (int i = 0; i < MANIFOLD_MAX_POINTS; ++i) {
+        if (m->points[i].depth > max_depth) {
+            max_depth = m->points[i].depth;
+            deepest = i;
+        }
+    }
+    int best = 0;
+    float best_area = -1.0f;
+    for (int i = 0; i < MANIFOLD_MAX_POINTS; ++i) {
+        if (i == deepest) continue;
+        Vec3D p[MANIFOLD_MAX_POINTS];
+        for (int k = 0; k < MANIFOLD_MAX_POINTS; ++k) {
+            p[k] = (k == i) ? point->local_a : m->points[k].local_a;
+        }
+        float area = quad_area(p[0], p[1], p[2], p[3]);
+        if (area > best_area) {
+            best_area = area;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Points en cache : nouvelle profondeur le long de la normale, abandon
+// s'ils se sont séparés ou ont glissé l'un par rapport à l'autre.
+// Retourne 1 si tous les points ont été gardés.
+static int refresh_points(ContactManifold* m, BodyPose pose_a, BodyPose pose_b) {
+    int kept = 0;
+    for (int i = 0; i < m->num_points; ++i) {
+        ManifoldPoint* pt = &m->points[i];
+        Vec3D wa = to_world(pose_a, pt->local_a), wb = to_world(pose_b, pt->local_b);
+        Vec3D d = vec3_sub(wa, wb);
+        float depth = vec3_dot(d, m->normal);
+        Vec3D tangent = vec3_sub(d, vec3_scale(m->normal, depth));
+        if (depth < -MANIFOLD_BREAK_DISTANCE ||
+            vec3_dot(tangent, tangent) > MANIFOLD_BREAK_DISTANCE * MANIFOLD_BREAK_DISTANCE) {
+            continue;
+        }
+        pt->depth = depth;
+        pt->position = vec3_scale(vec3_add(wa, wb), 0.5f);
+        m->points[kept++] = *pt;
+    }
+    int all_kept = kept == m->num_points;
+    m->num_points = kept;
+    return all_kept;
+}
+
+// Sommets de `h` à MANIFOLD_FACE_TOLERANCE du plus avancé le long de `dir`,
+// ordonnés en polygone convexe dans la base (t1, t2) (chaîne monotone).
+// Retourne leur nombre : 1 (sommet), 2 (arête) ou plus (face).
+static int support_face(const ConvexHull* h, Vec3D dir, Vec3D t1, Vec3D t2, Vec3D* out) {
+    Vec3D local = hull_local_direction(h, dir);
+    float max = -FLT_MAX;
+    for (int i = 0; i < h->count; ++i) {
+        float d = h->x[i] * local.x + h->y[i] * local.y + h->z[i] * local.z;
+        if (d > max) max = d;
+    }
+    Vec3D pts[MANIFOLD_MAX_FACE_POINTS];
+    float u[MANIFOLD_MAX_FACE_POINTS], v[MANIFOLD_MAX_FACE_POINTS];
+    int n = 0;
+    for (int i = 0; i < h->count && n < MANIFOLD_MAX_FACE_POINTS; ++i) {
+        if (h->x[i] * local.x + h->y[i] * local.y + h->z[i] * local.z < max - MANIFOLD_FACE_TOLERANCE) continue;
+        Vec3D p = hull_vertex(h, i);
+        // Tri par insertion sur (u, v)
+        float pu = vec3_dot(p, t1), pv = vec3_dot(p, t2);
+        int k = n++;
+        while (k > 0 && (u[k - 1] > pu || (u[k - 1] == pu && v[k - 1] > pv))) {
+            pts[k] = pts[k - 1]; u[k] = u[k - 1]; v[k] = v[k - 1];
+            --k;
+        }
+        pts[k] = p; u[k] = pu; v[k] = pv;
+    }
+    if (n <= 2) {
+        for (int i = 0; i < n; ++i) out[i] = pts[i];
+        return n;
+    }
+    // Enveloppe inférieure puis supérieure, sens trigonométrique vu depuis t1 x t2
+    int idx[2 * MANIFOLD_MAX_FACE_POINTS];
+    int m = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        int start = m;
+        for (int j = 0; j < n; ++j) {
+            int i = pass == 0 ? j : n - 1 - j;
+            while (m >= start + 2) {
+                int a = idx[m - 2], b = idx[m - 1];
+                float cross = (u[b] - u[a]) * (v[i] - v[a]) - (v[b] - v[a]) * (u[i] - u[a]);
+                if (cross > 0.0f) break;
+                --m;
+            }
+            idx[m++] = i;
+        }
+        --m; // Le dernier point est le premier de l'autre passe
+    }
+    for (int i = 0; i < m; ++i) out[i] = pts[idx[i]];
+    return m;
+}
+
+// Garde la partie de `in` (polygone, segment ou point) du côté dot(p, normal) <= d
+static int clip_polygon(const Vec3D* in, int n, Vec3D normal, float d, Vec3D* out) {
+    if (n <= 2) {
+        float da = vec3_dot(in[0], normal) - d;
+        float db = vec3_dot(in[n - 1], normal) - d;
+        if (da > 0.0f && db > 0.0f) return 0;
+        if (n == 1) {
+            out[0] = in[0];
+            return 1;
+        }
+        out[0] = in[0];
+        out[1] = in[1];
+        if (da > 0.0f) out[0] = vec3_add(in[0], vec3_scale(vec3_sub(in[1], in[0]), da / (da - db)));
+        if (db > 0.0f) out[1] = vec3_add(in[0], vec3_scale(vec3_sub(in[1], in[0]), da / (da - db)));
+        return 2;
+    }
+    // Sutherland-Hodgman
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        Vec3D a = in[i], b = in[(i + 1) % n];
+        float da = vec3_dot(a, normal) - d, db = vec3_dot(b, normal) - d;
+        if (da <= 0.0f) out[m++] = a;
+        if ((da <= 0.0f) != (db <= 0.0f)) {
+            out[m++] = vec3_add(a, vec3_scale(vec3_sub(b, a), da / (da - db)));
+        }
+    }
+    return m;
+}
+
+// Points de contact par découpage de faces : la face de référence (A le long
+// de la normale, ou à défaut B le long de -normale) borne la face incidente de
+// l'autre corps par ses plans latéraux. Retourne 0 si aucun corps n'a de face.
+static int clip_faces(const ConvexHull* hull_a, const ConvexHull* hull_b, Vec3D normal,
+                      Vec3D* point_a, Vec3D* point_b, float* depth) {
+    Vec3D t1, t2;
+    vec3_basis(normal, &t1, &t2);
+    Vec3D face_a[MANIFOLD_MAX_FACE_POINTS], face_b[MANIFOLD_MAX_FACE_POINTS];
+    int na = support_face(hull_a, normal, t1, t2, face_a);
+    int nb = support_face(hull_b, vec3_scale(normal, -1.0f), t1, t2, face_b);
+    int ref_is_a = na >= 3;
+    if (!ref_is_a && nb < 3) {
+        return 0;
+    }
+    const Vec3D* ref = ref_is_a ? face_a : face_b;
+    int num_ref = ref_is_a ? na : nb;
+    Vec3D ref_normal = ref_is_a ? normal : vec3_scale(normal, -1.0f);
+    // Le polygone de B est parcouru dans l'autre sens vu depuis -normale
+    float orient = ref_is_a ? 1.0f : -1.0f;
+
+    Vec3D buffer[2][2 * MANIFOLD_MAX_FACE_POINTS + 4];
+    int count = ref_is_a ? nb : na;
+    memcpy(buffer[0], ref_is_a ? face_b : face_a, (size_t)count * sizeof(Vec3D));
+    int cur = 0;
+    for (int i = 0; i < num_ref && count > 0; ++i) {
+        Vec3D edge = vec3_sub(ref[(i + 1) % num_ref], ref[i]);
+        Vec3D side = vec3_scale(vec3_cross(edge, normal), orient);
+        count = clip_polygon(buffer[cur], count, side, vec3_dot(side, ref[i]), buffer[1 - cur]);
+        cur = 1 - cur;
+    }
+
+    float height = vec3_dot(ref[0], ref_normal);
+    int n = 0;
+    for (int i = 0; i < count && n < MANIFOLD_MAX_FACE_POINTS; ++i) {
+        Vec3D q = buffer[cur][i];
+        float d = height - vec3_dot(q, ref_normal);
+        if (d < -MANIFOLD_BREAK_DISTANCE) continue;
+        Vec3D on_ref = vec3_add(q, vec3_scale(ref_normal, d));
+        point_a[n] = ref_is_a ? on_ref : q;
+        point_b[n] = ref_is_a ? q : on_ref;
+        depth[n++] = d;
+    }
+    return n;
+}
+
+// Ajoute `point` à la variété, ou remplace un point existant trop proche
+// (dont il reprend les impulsions)
+static void add_point(ContactManifold* m, ManifoldPoint point) {
+    for (int i = 0; i < m->num_points; ++i) {
+        Vec3D d = vec3_sub(m->points[i].local_a, point.local_a);
+        if (vec3_dot(d, d) < MANIFOLD_MERGE_DISTANCE * MANIFOLD_MERGE_DISTANCE) {
+            point.normal_impulse = m->points[i].normal_impulse;
+            point.tangent_impulse[0] = m->points[i].tangent_impulse[0];
+            point.tangent_impulse[1] = m->points[i].tangent_impulse[1];
+            m->points[i] = point;
+            return;
+        }
+    }
+    if (m->num_points < MANIFOLD_MAX_POINTS) {
+        m->points[m->num_points++] = point;
+    } else {
+        m->points[replacement_index(m, &point)] = point;
+    }
+}
+
+void manifold_update(ContactManifold* m, const ConvexHull* hull_a, const ConvexHull* hull_b,
+                     BodyPose pose_a, BodyPose pose_b) {
+    // Pose de b vue depuis a : tant qu'elle ne bouge pas, la géométrie du contact non plus
+    Vec3D offset = to_local(pose_a, pose_b.position);
+    Quat rotation = quat_mul(quat_conjugate(pose_a.orientation), pose_b.orientation);
+    Vec3D moved = vec3_sub(offset, m->query_offset);
+    float cos_half = fabsf(rotation.x * m->query_rotation.x + rotation.y * m->query_rotation.y +
+                           rotation.z * m->query_rotation.z + rotation.w * m->query_rotation.w);
+    m->skipped = 0;
+    m->gjk_iterations = 0;
+    if (m->num_points > 0 && vec3_dot(moved, moved) < MANIFOLD_REUSE_DISTANCE * MANIFOLD_REUSE_DISTANCE &&
+        cos_half > MANIFOLD_REUSE_COS && refresh_points(m, pose_a, pose_b)) {
+        m->skipped = 1;
+        return;
+    }
+    m->query_offset = offset;
+    m->query_rotation = rotation;
+
+    if (!gjk_intersect(hull_a, hull_b, &m->simplex, &m->gjk_iterations)) {
+        m->num_points = 0;
+        return;
+    }
+    Penetration pen;
+    int has_new = epa_penetration(hull_a, hull_b, &m->simplex, &pen);
+    if (has_new) {
+        if (m->num_points > 0 && vec3_dot(pen.normal, m->normal) < MANIFOLD_NORMAL_COHERENCE) {
+            m->num_points = 0; // Face de contact différente : les anciens points ne valent plus
+        }
+        m->normal = pen.normal;
+    }
+
+    refresh_points(m, pose_a, pose_b);
+    if (!has_new) {
+        return; // Contact tangent : seuls les points en cache restent
+    }
+
+    Vec3D point_a[MANIFOLD_MAX_FACE_POINTS], point_b[MANIFOLD_MAX_FACE_POINTS];
+    float depth[MANIFOLD_MAX_FACE_POINTS];
+    int count = clip_faces(hull_a, hull_b, pen.normal, point_a, point_b, depth);
+    if (count > 0) {
+        // Variété complète : les anciens points ne servent plus qu'à transmettre leurs impulsions
+        ContactManifold previous = *m;
+        m->num_points = 0;
+        for (int i = 0; i < count; ++i) {
+            ManifoldPoint point = {to_local(pose_a, point_a[i]), to_local(pose_b, point_b[i]),
+                                   vec3_scale(vec3_add(point_a[i], point_b[i]), 0.5f), depth[i],
+                                   0.0f, {0.0f, 0.0f}};
+            for (int k = 0; k < previous.num_points; ++k) {
+                Vec3D d = vec3_sub(previous.points[k].local_a, point.local_a);
+                if (vec3_dot(d, d) < MANIFOLD_MERGE_DISTANCE * MANIFOLD_MERGE_DISTANCE) {
+                    point.normal_impulse = previous.points[k].normal_impulse;
+                    point.tangent_impulse[0] = previous.points[k].tangent_impulse[0];
+                    point.tangent_impulse[1] = previous.points[k].tangent_impulse[1];
+                    break;
+                }
+            }
+            if (m->num_points < MANIFOLD_MAX_POINTS) {
+                m->points[m->num_points++] = point;
+            } else {
+                m->points[replacement_index(m, &point)] = point;
+            }
+        }
+        return;
+    }
+
+    add_point(m, (ManifoldPoint){to_local(pose_a, pen.point_a), to_local(pose_b, pen.point_b),
+                                 vec3_scale(vec3_add(pen.point_a, pen.point_b), 0.5f), pen.depth,
+                                 0.0f, {0.0f, 0.0f}});
+}
+
+void manifold_from_contact(ContactManifold* m, const Contact* c, Vec3D point,
+                           BodyPose pose_a, BodyPose pose_b) {
+    ManifoldPoint kept = {0};
+    if (m->num_points > 0 && vec3_dot(m->normal, c->normal) >= MANIFOLD_NORMAL_COHERENCE) {
+        kept = m->points[0];
+    }
+    m->normal = c->normal;
+    m->num_points = 1;
+    m->skipped = 0;
+    m->gjk_iterations = 0;
+    ManifoldPoint* pt = &m->points[0];
+    *pt = (ManifoldPoint){to_local(pose_a, point), to_local(pose_b, point), point, c->depth,
+                          kept.normal_impulse, {kept.tangent_impulse[0], kept.tangent_impulse[1]}};
+}
+
+void manifold_swap_bodies(ContactManifold* m) {
+    int t = m->a;
+    m->a = m->b;
+    m->b = t;
+    m->normal = vec3_scale(m->normal, -1.0f);
+    for (int i = 0; i < m->num_points; ++i) {
+        ManifoldPoint* p = &m->points[i];
+        Vec3D local = p->local_a;
+        p->local_a = p->local_b;
+        p->local_b = local;
+        // Base tangente tirée de la normale, qui a changé de sens
+        p->tangent_impulse[0] = p->tangent_impulse[1] = 0.0f;
+    }
+    // Sommets de la différence b - a : mêmes paires de sommets, signe opposé
+    for (int k = 0; k < m->simplex.count; ++k) {
+        SupportPoint* v = &m->simplex.v[k];
+        int ia = v->ia;
+        v->ia = v->ib;
+        v->ib = ia;
+        v->w = vec3_scale(v->w, -1.0f);
+    }
+    // Pose de référence invalide : la prochaine mise à jour relance la requête
+    m->query_rotation = (Quat){0.0f, 0.0f, 0.0f, 0.0f};
+}
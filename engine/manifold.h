@@ -0,0 +1,102 @@
+#ifndef ENGINE_MANIFOLD_H
+#define ENGINE_MANIFOLD_H
+
+#include "broadphase.h"
+#include "contacts.h"
+#include "gjk.h"
+#include "math3d.h"
+#include "transform.h"
+
+// --- Configuration ---
+#define MANIFOLD_MAX_POINTS 4
+#define MANIFOLD_BREAK_DISTANCE 0.02f  // Séparation ou glissement au-delà duquel un point en cache est abandonné
+#define MANIFOLD_MERGE_DISTANCE 0.02f  // Un nouveau point plus proche remplace le point existant
+#define MANIFOLD_NORMAL_COHERENCE 0.95f // cos de l'angle au-delà duquel les anciens points sont invalidés
+#define MANIFOLD_REUSE_DISTANCE 0.005f  // Déplacement relatif sous lequel GJK/EPA ne sont pas relancés
+#define MANIFOLD_REUSE_COS 0.99995f     // cos(angle/2) minimal de la rotation relative (~1 degré)
+#define MANIFOLD_FACE_TOLERANCE 0.02f   // Écart le long de la normale sous lequel des sommets forment une face de contact
+#define MANIFOLD_MAX_FACE_POINTS 32     // Sommets retenus par face de contact
+
+// Point de contact persistant. Il est stocké dans le repère de chaque corps :
+// au pas suivant, sa position et sa profondeur sont recalculées depuis les
+// nouvelles poses, sans nouvelle requête géométrique.
+typedef struct {
+    Vec3D local_a, local_b;  // Repère local (rotation et translation seules)
+    Vec3D position;          // Milieu des deux points, repère monde
+    float depth;             // > 0 : pénétration le long de la normale
+    float normal_impulse;    // Impulsions cumulées, pour le démarrage à chaud du solveur
+    float tangent_impulse[2];
+} ManifoldPoint;
+
+// Variété de contact d'une paire de corps, conservée d'un pas à l'autre
+typedef struct {
+    int a, b;                // a < b, comme les paires de la phase large
+    Vec3D normal;            // De a vers b
+    ManifoldPoint points[MANIFOLD_MAX_POINTS];
+    int num_points;
+    Simplex simplex;         // Simplexe final de GJK, point de départ du pas suivant
+    int gjk_iterations;      // Itérations de GJK au dernier pas
+    int reused;              // 1 si la variété vient du pas précédent
+    int skipped;             // 1 si le dernier pas s'est contenté des points en cache
+    // Pose de b dans le repère de a lors de la dernière requête GJK/EPA
+    Vec3D query_offset;
+    Quat query_rotation;
+} ContactManifold;
+
+// Pose d'un corps pour le passage repère local <-> repère monde
+typedef struct {
+    Vec3D position;
+    Quat orientation;
+} BodyPose;
+
+// Variétés du pas courant, une par paire candidate et dans le même ordre.
+// Celles du pas précédent sont retrouvées par une table de hachage sur la
+// paire (a, b) ; la correspondance est faite une fois, séquentiellement, avant
+// la phase étroite, qui peut alors écrire chaque variété sans verrou.
+typedef struct {
+    ContactManifold* manifolds;
+    int count;
+    int capacity;
+    ContactManifold* previous;
+    int previous_count;
+    int previous_capacity;
+    int* table;              // Index dans `previous`, -1 pour une case vide
+    int table_capacity;      // Puissance de 2
+    int warm_start;          // 0 : chaque pas repart de zéro (mesures)
+    int num_reused;          // Variétés reprises par le dernier manifold_cache_begin
+} ManifoldCache;
+
+void manifold_cache_init(ManifoldCache* cache);
+void manifold_cache_free(ManifoldCache* cache);
+
+// Prépare une variété par paire : reprise du pas précédent si la paire y
+// figurait, vide sinon. Retourne 0 en cas d'échec d'allocation ; le cache
+// n'a alors aucune variété pour ce pas.
+int manifold_cache_begin(ManifoldCache* cache, const BodyPair* pairs, int num_pairs);
+
+// Remplace les variétés du dernier pas par une copie de `manifolds`
+// (restauration d'un instantané). Retourne 0 en cas d'échec d'allocation.
+int manifold_cache_set(ManifoldCache* cache, const ContactManifold* manifolds, int count);
+
+// Rafraîchit les points en cache avec les nouvelles poses, puis GJK (repris
+// du simplexe précédent) et, en cas de recouvrement, EPA donne la normale.
+// Si l'un des corps présente une face le long de cette normale, la face
+// opposée de l'autre y est découpée et la variété est reconstruite d'un coup ;
+// sinon (arête contre arête, sommet) le point le plus profond d'EPA s'ajoute
+// aux points en cache. Au plus MANIFOLD_MAX_POINTS points sont gardés : le
+// plus profond, et ceux qui couvrent la plus grande surface.
+// Si la pose relative des deux corps a à peine changé depuis la dernière
+// requête, les points en cache suffisent et ni GJK ni EPA ne sont lancés.
+void manifold_update(ContactManifold* m, const ConvexHull* hull_a, const ConvexHull* hull_b,
+                     BodyPose pose_a, BodyPose pose_b);
+
+// Variété d'un seul point, au centre `point` du recouvrement décrit par `c`
+// (phase étroite sur AABB). Les impulsions sont gardées si la normale n'a pas changé.
+void manifold_from_contact(ContactManifold* m, const Contact* c, Vec3D point,
+                           BodyPose pose_a, BodyPose pose_b);
+
+// Échange les rôles de a et b (nouvelle numérotation des corps) : normale,
+// points locaux et simplexe sont retournés, les impulsions normales gardées
+void manifold_swap_bodies(ContactManifold* m);
+
+#endif
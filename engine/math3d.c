@@ -0,0 +1,104 @@
+#include "math3d.h"
+
+// Matrice Identité
+Mat4x4 matrix_identity(void) {
+    Mat4x4 mat = {0};
+    mat.m[0][0] = 1.0f;
+    mat.m[1][1] = 1.0f;
+    mat.m[2][2] = 1.0f;
+    mat.m[3][3] = 1.0f;
+    return mat;
+}
+
+Vec4D matrix_multiply_vector(Mat4x4 mat, Vec3D vec) {
+    Vec4D result;
+    result.x = vec.x * mat.m[0][0] + vec.y * mat.m[1][0] + vec.z * mat.m[2][0] + mat.m[3][0]; // w=1
+    result.y = vec.x * mat.m[0][1] + vec.y * mat.m[1][1] + vec.z * mat.m[2][1] + mat.m[3][1];
+    result.z = vec.x * mat.m[0][2] + vec.y * mat.m[1][2] + vec.z * mat.m[2][2] + mat.m[3][2];
+    result.w = vec.x * mat.m[0][3] + vec.y * mat.m[1][3] + vec.z * mat.m[2][3] + mat.m[3][3];
+    return result;
+}
+
+void multiply_matrix_vector(Vec3D in, Vec3D* out, float* w_out, Mat4x4 mat) {
+    out->x = in.x * mat.m[0][0] + in.y * mat.m[1][0] + in.z * mat.m[2][0] + mat.m[3][0];
+    out->y = in.x * mat.m[0][1] + in.y * mat.m[1][1] + in.z * mat.m[2][1] + mat.m[3][1];
+    out->z = in.x * mat.m[0][2] + in.y * mat.m[1][2] + in.z * mat.m[2][2] + mat.m[3][2];
+    *w_out = in.x * mat.m[0][3] + in.y * mat.m[1][3] + in.z * mat.m[2][3] + mat.m[3][3];
+}
+
+Mat4x4 matrix_multiply_matrix(Mat4x4 a, Mat4x4 b) {
+    Mat4x4 result = {0};
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            result.m[r][c] = a.m[r][0] * b.m[0][c] +
+                             a.m[r][1] * b.m[1][c] +
+                             a.m[r][2] * b.m[2][c] +
+                             a.m[r][3] * b.m[3][c];
+        }
+    }
+    return result;
+}
+
+// Matrice de Translation
+Mat4x4 matrix_make_translation(float x, float y, float z) {
+    Mat4x4 mat = matrix_identity();
+    mat.m[3][0] = x;
+    mat.m[3][1] = y;
+    mat.m[3][2] = z;
+    return mat;
+}
+
+// Matrice de Rotation sur X
+Mat4x4 matrix_make_rotation_x(float angle_rad) {
+    Mat4x4 mat = matrix_identity();
+    mat.m[1][1] = cosf(angle_rad);
+    mat.m[1][2] = sinf(angle_rad);
+    mat.m[2][1] = -sinf(angle_rad);
+    mat.m[2][2] = cosf(angle_rad);
+    return mat;
+}
+
+// Matrice de Rotation sur Y
+Mat4x4 matrix_make_rotation_y(float angle_rad) {
+    Mat4x4 mat = matrix_identity();
+    mat.m[0][0] = cosf(angle_rad);
+    mat.m[0][2] = sinf(angle_rad);
+    mat.m[2][0] = -sinf(angle_rad);
+    mat.m[2][2] = cosf(angle_rad);
+    return mat;
+}
+
+// Matrice de Rotation sur Z
+Mat4x4 matrix_make_rotation_z(float angle_rad) {
+    Mat4x4 mat = matrix_identity();
+    mat.m[0][0] = cosf(angle_rad);
+    mat.m[0][1] = sinf(angle_rad);
+    mat.m[1][0] = -sinf(angle_rad);
+    mat.m[1][1] = cosf(angle_rad);
+    return mat;
+}
+
+// Matrice de Mise à l'échelle
+Mat4x4 matrix_make_scale(float x, float y, float z) {
+    Mat4x4 mat = matrix_identity();
+    mat.m[0][0] = x;
+    mat.m[1][1] = y;
+    mat.m[2][2] = z;
+    return mat;
+}
+
+Mat4x4 matrix_make_srt(Vec3D scale, Vec3D rotation, Vec3D position) {
+    // En convention vecteur ligne, la première matrice du produit est appliquée en premier
+    Mat4x4 mat = matrix_make_scale(scale.x, scale.y, scale.z);
+    mat = matrix_multiply_matrix(mat, matrix_make_rotation_x(rotation.x));
+    mat = matrix_multiply_matrix(mat, matrix_make_rotation_y(rotation.y));
+    mat = matrix_multiply_matrix(mat, matrix_make_rotation_z(rotation.z));
+    mat = matrix_multiply_matrix(mat, matrix_make_translation(position.x, position.y, position.z));
+    return mat;
+}
+
+Mat4x4 matrix_make_projection(float fov_deg, float aspect_ratio, float near, float far) {
+    float focal = 1.0f / tanf(fov_deg * 0.5f * (M_PI / 180.0f));
+    Mat4x4 mat = MAT4X4_PROJECTION_INIT(focal, aspect_ratio, near, far);
+    return mat;
+}
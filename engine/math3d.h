@@ -0,0 +1,90 @@
+#ifndef ENGINE_MATH3D_H
+#define ENGINE_MATH3D_H
+
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// --- Structures ---
+typedef struct {
+    float x, y;
+} Vec2D;
+
+typedef struct {
+    float x, y, z;
+} Vec3D;
+
+// Vecteur homogène (x', y', z', w') avant la division perspective
+typedef struct {
+    float x, y, z, w;
+} Vec4D;
+
+// Boîte englobante alignée sur les axes
+typedef struct {
+    Vec3D min, max;
+} AABB;
+
+// Convention "vecteur ligne" : v' = v * M, la translation est en m[3][0..2]
+typedef struct {
+    float m[4][4];
+} Mat4x4;
+
+// --- Fonctions Vectorielles ---
+static inline Vec3D vec3_add(Vec3D a, Vec3D b) { return (Vec3D){a.x + b.x, a.y + b.y, a.z + b.z}; }
+static inline Vec3D vec3_sub(Vec3D a, Vec3D b) { return (Vec3D){a.x - b.x, a.y - b.y, a.z - b.z}; }
+static inline Vec3D vec3_scale(Vec3D a, float s) { return (Vec3D){a.x * s, a.y * s, a.z * s}; }
+static inline float vec3_dot(Vec3D a, Vec3D b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static inline Vec3D vec3_cross(Vec3D a, Vec3D b) {
+    return (Vec3D){a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+static inline float vec3_length(Vec3D a) { return sqrtf(vec3_dot(a, a)); }
+
+// Base orthonormée (t1, t2) du plan normal au vecteur unitaire `n`, avec
+// t1 x t2 = n. Elle ne dépend que de `n` : une normale stable donne une base stable.
+static inline void vec3_basis(Vec3D n, Vec3D* t1, Vec3D* t2) {
+    Vec3D t = fabsf(n.x) >= 0.57735f ? (Vec3D){n.y, -n.x, 0.0f} : (Vec3D){0.0f, n.z, -n.y};
+    *t1 = vec3_scale(t, 1.0f / vec3_length(t));
+    *t2 = vec3_cross(n, *t1);
+}
+
+// --- Fonctions Matricielles ---
+
+// Matrice Identité
+Mat4x4 matrix_identity(void);
+
+// Multiplication Vec3D * Mat4x4 (w=1 en entrée), retourne x', y', z', w'
+Vec4D matrix_multiply_vector(Mat4x4 mat, Vec3D vec);
+
+// Multiplication Vecteur * Matrice (avec gestion de w pour la projection)
+// Le vecteur d'entrée est traité comme (v.x, v.y, v.z, 1.0)
+void multiply_matrix_vector(Vec3D in, Vec3D* out, float* w_out, Mat4x4 mat);
+
+// Multiplication Matrice * Matrice
+Mat4x4 matrix_multiply_matrix(Mat4x4 a, Mat4x4 b);
+
+Mat4x4 matrix_make_translation(float x, float y, float z);
+Mat4x4 matrix_make_rotation_x(float angle_rad);
+Mat4x4 matrix_make_rotation_y(float angle_rad);
+Mat4x4 matrix_make_rotation_z(float angle_rad);
+Mat4x4 matrix_make_scale(float x, float y, float z);
+
+// Scale -> Rotate (X, Y, Z) -> Translate, composé en convention vecteur ligne
+Mat4x4 matrix_make_srt(Vec3D scale, Vec3D rotation, Vec3D position);
+
+// Matrice de Projection Perspective (z dans [0, w] après projection, w = z vue)
+Mat4x4 matrix_make_projection(float fov_deg, float aspect_ratio, float near, float far);
+
+// La même matrice sous forme d'initialiseur constant, évaluée à la compilation
+// quand les paramètres sont fixes (`static const Mat4x4 proj = ...`).
+// `focal` vaut 1 / tan(fov / 2), tanf n'étant pas une expression constante.
+#define PROJECTION_FOCAL_60 1.7320508f
+#define PROJECTION_FOCAL_90 1.0f
+#define MAT4X4_PROJECTION_INIT(focal, aspect, near, far)                   \
+    {{{(aspect) * (focal), 0.0f, 0.0f, 0.0f},                              \
+      {0.0f, (focal), 0.0f, 0.0f},                                         \
+      {0.0f, 0.0f, (far) / ((far) - (near)), 1.0f},                        \
+      {0.0f, 0.0f, (-(far) * (near)) / ((far) - (near)), 0.0f}}}
+
+#endif
@@ -0,0 +1,141 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "alloc.h"
+#include "mesh.h"
+
+int mesh_alloc(Mesh* mesh, int num_vertices, int num_edges) {
+    size_t vertex_bytes = (size_t)num_vertices * sizeof(Vec3D);
+    size_t size = vertex_bytes + (size_t)num_edges * sizeof(Edge);
+    memset(mesh, 0, sizeof(*mesh));
+    if (size == 0) {
+        return 1;
+    }
+    char* block = (char*)mem_alloc(size);
+    if (block == NULL) {
+        return 0;
+    }
+    mesh->vertices = (Vec3D*)block;
+    mesh->edges = (Edge*)(block + vertex_bytes);
+    mesh->num_vertices = num_vertices;
+    mesh->num_edges = num_edges;
+    return 1;
+}
+
+Mesh create_cube_mesh(void) {
+    Mesh cube;
+    if (!mesh_alloc(&cube, 8, 12)) {
+        return cube;
+    }
+    // Définition des sommets du cube (centré à l'origine)
+    cube.vertices[0] = (Vec3D){-0.5f, -0.5f, -0.5f};
+    cube.vertices[1] = (Vec3D){ 0.5f, -0.5f, -0.5f};
+    cube.vertices[2] = (Vec3D){ 0.5f,  0.5f, -0.5f};
+    cube.vertices[3] = (Vec3D){-0.5f,  0.5f, -0.5f};
+    cube.vertices[4] = (Vec3D){-0.5f, -0.5f,  0.5f};
+    cube.vertices[5] = (Vec3D){ 0.5f, -0.5f,  0.5f};
+    cube.vertices[6] = (Vec3D){ 0.5f,  0.5f,  0.5f};
+    cube.vertices[7] = (Vec3D){-0.5f,  0.5f,  0.5f};
+
+    // Face avant
+    cube.edges[0] = (Edge){0, 1};
+    cube.edges[1] = (Edge){1, 2};
+    cube.edges[2] = (Edge){2, 3};
+    cube.edges[3] = (Edge){3, 0};
+    // Face arrière
+    cube.edges[4] = (Edge){4, 5};
+    cube.edges[5] = (Edge){5, 6};
+    cube.edges[6] = (Edge){6, 7};
+    cube.edges[7] = (Edge){7, 4};
+    // Liaisons entre faces
+    cube.edges[8] = (Edge){0, 4};
+    cube.edges[9] = (Edge){1, 5};
+    cube.edges[10] = (Edge){2, 6};
+    cube.edges[11] = (Edge){3, 7};
+
+    return cube;
+}
+
+Mesh create_grid_mesh(int cols, int rows, float spacing) {
+    Mesh grid;
+    if (cols < 1 || rows < 1) {
+        memset(&grid, 0, sizeof(grid));
+        return grid;
+    }
+    int num_edges = (cols - 1) * rows + cols * (rows - 1) + 2 * (cols - 1) * (rows - 1);
+    if (!mesh_alloc(&grid, cols * rows, num_edges)) {
+        return grid;
+    }
+    float x0 = -0.5f * (cols - 1) * spacing, z0 = -0.5f * (rows - 1) * spacing;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            grid.vertices[r * cols + c] = (Vec3D){x0 + c * spacing, 0.0f, z0 + r * spacing};
+        }
+    }
+    // Ligne par ligne : arêtes d'une case consécutives, sommets voisins en mémoire
+    int e = 0;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int v = r * cols + c;
+            if (c + 1 < cols) grid.edges[e++] = (Edge){v, v + 1};
+            if (r + 1 < rows) grid.edges[e++] = (Edge){v, v + cols};
+            if (c + 1 < cols && r + 1 < rows) {
+                grid.edges[e++] = (Edge){v, v + cols + 1};
+                grid.edges[e++] = (Edge){v + 1, v + cols};
+            }
+        }
+    }
+    return grid;
+}
+
+Mesh create_sphere_mesh(int rings, int segments, float radius) {
+    Mesh sphere;
+    if (rings < 2 || segments < 3) {
+        memset(&sphere, 0, sizeof(sphere));
+        return sphere;
+    }
+    int num_vertices = 2 + (rings - 1) * segments;
+    if (!mesh_alloc(&sphere, num_vertices, (2 * rings - 1) * segments)) {
+        return sphere;
+    }
+    // Pôle nord, parallèles du nord au sud, pôle sud
+    int south = num_vertices - 1;
+    sphere.vertices[0] = (Vec3D){0.0f, radius, 0.0f};
+    sphere.vertices[south] = (Vec3D){0.0f, -radius, 0.0f};
+    for (int r = 1; r < rings; ++r) {
+        float polar = (float)M_PI * r / rings;
+        float y = radius * cosf(polar), ring = radius * sinf(polar);
+        for (int k = 0; k < segments; ++k) {
+            float azimuth = 2.0f * (float)M_PI * k / segments;
+            sphere.vertices[1 + (r - 1) * segments + k] = (Vec3D){ring * cosf(azimuth), y, ring * sinf(azimuth)};
+        }
+    }
+    int e = 0;
+    for (int r = 1; r < rings; ++r) {
+        int first = 1 + (r - 1) * segments;
+        for (int k = 0; k < segments; ++k) {
+            sphere.edges[e++] = (Edge){first + k, first + (k + 1) % segments};             // Parallèle
+            sphere.edges[e++] = (Edge){r == 1 ? 0 : first + k - segments, first + k};      // Méridien
+        }
+    }
+    for (int k = 0; k < segments; ++k) {
+        sphere.edges[e++] = (Edge){south - segments + k, south};
+    }
+    return sphere;
+}
+
+void free_mesh(Mesh* mesh) {
+    if (mesh->mapping) {
+        // Sommets et arêtes pointent dans la projection : rien d'autre à libérer
+        munmap(mesh->mapping, mesh->mapping_size);
+    } else {
+        mem_free(mesh->vertices); // Les arêtes sont dans le même bloc
+    }
+    mesh->mapping = NULL;
+    mesh->mapping_size = 0;
+    mesh->vertices = NULL;
+    mesh->edges = NULL;
+    mesh->num_vertices = 0;
+    mesh->num_edges = 0;
+}
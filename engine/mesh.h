@@ -0,0 +1,40 @@
+#ifndef ENGINE_MESH_H
+#define ENGINE_MESH_H
+
+#include <stddef.h>
+#include "math3d.h"
+
+typedef struct {
+    int v1_idx; // Index du premier sommet
+    int v2_idx; // Index du second sommet
+} Edge;
+
+// Sommets puis arêtes dans un seul bloc (mesh_alloc), ou dans un fichier
+// projeté en mémoire
+typedef struct {
+    Vec3D* vertices;
+    int num_vertices;
+    Edge* edges;
+    int num_edges;
+    void* mapping;        // Fichier projeté en mémoire (load_mesh_binary), NULL si alloué
+    size_t mapping_size;
+} Mesh;
+
+// Bloc unique pour `num_vertices` sommets puis `num_edges` arêtes ;
+// 0 (maillage vide) en cas d'échec d'allocation
+int mesh_alloc(Mesh* mesh, int num_vertices, int num_edges);
+
+// Cube unité centré à l'origine (8 sommets, 12 arêtes)
+Mesh create_cube_mesh(void);
+// Grille de cols x rows sommets dans le plan xz, centrée à l'origine et
+// espacés de `spacing` : arêtes entre voisins directs, plus les deux
+// diagonales de chaque case. Avec rows == 1, une simple chaîne (corde).
+// Maillage vide en cas d'échec d'allocation.
+Mesh create_grid_mesh(int cols, int rows, float spacing);
+// Sphère UV de rayon `radius` centrée à l'origine : deux pôles et rings - 1
+// parallèles de `segments` sommets, reliés par parallèles et méridiens.
+// Maillage vide si rings < 2, segments < 3 ou en cas d'échec d'allocation.
+Mesh create_sphere_mesh(int rings, int segments, float radius);
+void free_mesh(Mesh* mesh);
+
+#endif
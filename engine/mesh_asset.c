@@ -0,0 +1,106 @@
+#include <pthread.h>
+#include <string.h>
+#include "alloc.h"
+#include "mesh_asset.h"
+#include "soa.h"
+
+// Cube partagé : la référence du pointeur statique n'est jamais rendue
+static MeshAsset* shared_cube;
+static pthread_mutex_t cube_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t align_block(size_t size) {
+    return (size + SOA_ALIGNMENT - 1) & ~(size_t)(SOA_ALIGNMENT - 1);
+}
+
+static void compute_bounds(MeshAsset* m) {
+    if (m->num_vertices == 0) {
+        m->bounds = (AABB){{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+        m->bound_radius = 0.0f;
+        return;
+    }
+    AABB box = {mesh_asset_vertex(m, 0), mesh_asset_vertex(m, 0)};
+    for (int i = 1; i < m->num_vertices; ++i) {
+        Vec3D v = mesh_asset_vertex(m, i);
+        box.min = (Vec3D){fminf(box.min.x, v.x), fminf(box.min.y, v.y), fminf(box.min.z, v.z)};
+        box.max = (Vec3D){fmaxf(box.max.x, v.x), fmaxf(box.max.y, v.y), fmaxf(box.max.z, v.z)};
+    }
+    Vec3D center = vec3_scale(vec3_add(box.min, box.max), 0.5f);
+    float radius_sq = 0.0f;
+    for (int i = 0; i < m->num_vertices; ++i) {
+        Vec3D d = vec3_sub(mesh_asset_vertex(m, i), center);
+        float dist_sq = vec3_dot(d, d);
+        if (dist_sq > radius_sq) radius_sq = dist_sq;
+    }
+    m->bounds = box;
+    m->bound_radius = sqrtf(radius_sq);
+}
+
+MeshAsset* mesh_asset_create(const Mesh* mesh) {
+    // En-tête, x, y, z (arrondis au multiple de 8 comme soa_alloc_floats),
+    // arêtes, flux d'index compressés
+    size_t header = align_block(sizeof(MeshAsset));
+    size_t coords = align_block((size_t)mesh->num_vertices * sizeof(float));
+    size_t edge_bytes = align_block((size_t)mesh->num_edges * sizeof(Edge));
+    size_t num_words;
+    EdgeIndexFormat format = edge_stream_format(mesh->edges, mesh->num_edges, mesh->num_vertices, &num_words);
+    size_t size = align_block(header + 3 * coords + edge_bytes + num_words * sizeof(uint16_t));
+    char* block = (char*)mem_aligned_alloc(SOA_ALIGNMENT, size);
+    if (block == NULL) {
+        return NULL;
+    }
+    MeshAsset* m = (MeshAsset*)block;
+    float* x = (float*)(block + header);
+    float* y = (float*)(block + header + coords);
+    float* z = (float*)(block + header + 2 * coords);
+    Edge* edges = (Edge*)(block + header + 3 * coords);
+    uint16_t* stream = (uint16_t*)(block + header + 3 * coords + edge_bytes);
+    for (int i = 0; i < mesh->num_vertices; ++i) {
+        x[i] = mesh->vertices[i].x;
+        y[i] = mesh->vertices[i].y;
+        z[i] = mesh->vertices[i].z;
+    }
+    if (mesh->num_edges > 0) {
+        memcpy(edges, mesh->edges, (size_t)mesh->num_edges * sizeof(Edge));
+    }
+    m->x = x;
+    m->y = y;
+    m->z = z;
+    m->num_vertices = mesh->num_vertices;
+    m->edges = edges;
+    m->num_edges = mesh->num_edges;
+    edge_stream_encode(mesh->edges, mesh->num_edges, format, stream);
+    m->edge_stream = format != EDGE_INDEX_32 ? stream : NULL;
+    m->edge_format = format;
+    m->size = size;
+    atomic_init(&m->refs, 1);
+    compute_bounds(m);
+    return m;
+}
+
+MeshAsset* mesh_asset_cube(void) {
+    pthread_mutex_lock(&cube_lock);
+    if (shared_cube == NULL) {
+        Mesh cube = create_cube_mesh();
+        if (cube.num_vertices > 0) {
+            shared_cube = mesh_asset_create(&cube);
+        }
+        free_mesh(&cube);
+    }
+    MeshAsset* m = mesh_asset_retain(shared_cube);
+    pthread_mutex_unlock(&cube_lock);
+    return m;
+}
+
+MeshAsset* mesh_asset_retain(MeshAsset* mesh) {
+    if (mesh != NULL) {
+        atomic_fetch_add_explicit(&mesh->refs, 1, memory_order_relaxed);
+    }
+    return mesh;
+}
+
+void mesh_asset_release(MeshAsset* mesh) {
+    // acq_rel : les lectures des autres détenteurs précèdent la libération
+    if (mesh != NULL && atomic_fetch_sub_explicit(&mesh->refs, 1, memory_order_acq_rel) == 1) {
+        mem_free(mesh);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ENGINE_MESH_ASSET_H
+#define ENGINE_MESH_ASSET_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "math3d.h"
+#include "mesh.h"
+#include "mesh_optimize.h"
+
+// --- Maillages partagés ---
+// Géométrie immuable (sommets en repère local, arêtes, volumes englobants)
+// référencée par autant de corps que voulu : un corps ne porte que sa
+// transformation et un pointeur vers son maillage. Dix mille cubes partagent
+// ainsi les mêmes 8 sommets et 12 arêtes. Le compteur de références est
+// atomique (corps créés et libérés depuis n'importe quel thread) ; le
+// maillage est libéré avec sa dernière référence.
+typedef struct {
+    // Sommets SoA alignés sur SOA_ALIGNMENT, lus tels quels par les noyaux,
+    // puis arêtes, dans le même bloc que l'en-tête
+    const float *x, *y, *z;
+    int num_vertices;
+    const Edge* edges;
+    int num_edges;
+    // Mêmes arêtes en index compressés (mesh_optimize.h), lues par le rendu
+    // à la place de `edges` ; NULL avec EDGE_INDEX_32
+    const uint16_t* edge_stream;
+    EdgeIndexFormat edge_format;
+    AABB bounds;          // Boîte en repère local (vide sans sommet)
+    float bound_radius;   // Sphère centrée sur le centre de `bounds`
+    size_t size;          // Octets du bloc
+    atomic_int refs;
+} MeshAsset;
+
+// Copie de `mesh`, avec une référence pour l'appelant. Les index des arêtes
+// sont aussi compressés au format le plus compact (edge_stream_format). Retourne NULL en cas
+// d'échec d'allocation.
+MeshAsset* mesh_asset_create(const Mesh* mesh);
+
+// Cube unité centré à l'origine (8 sommets, 12 arêtes), créé au premier
+// appel et partagé par tout le programme ; une référence de plus pour
+// l'appelant. NULL en cas d'échec d'allocation.
+MeshAsset* mesh_asset_cube(void);
+
+// Une référence de plus ; retourne `mesh` (NULL accepté)
+MeshAsset* mesh_asset_retain(MeshAsset* mesh);
+// Rend une référence (NULL accepté)
+void mesh_asset_release(MeshAsset* mesh);
+
+static inline Vec3D mesh_asset_vertex(const MeshAsset* mesh, int i) {
+    return (Vec3D){mesh->x[i], mesh->y[i], mesh->z[i]};
+}
+
+#endif
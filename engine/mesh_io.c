@@ -0,0 +1,336 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "alloc.h"
+#include "mesh_io.h"
+
+_Static_assert(sizeof(MeshFileHeader) == 64, "en-tête de maillage : 64 octets attendus");
+
+// --- Ensemble d'arêtes (adressage ouvert, clé = paire d'index triée) ---
+
+typedef struct {
+    uint64_t* keys;  // 0 = case vide (les clés stockées sont décalées de 1)
+    int capacity;    // Puissance de 2
+    int count;
+} EdgeSet;
+
+static uint64_t edge_key(int a, int b) {
+    uint32_t lo = (uint32_t)(a < b ? a : b), hi = (uint32_t)(a < b ? b : a);
+    return (((uint64_t)hi << 32) | lo) + 1;
+}
+
+static int edge_set_init(EdgeSet* set, int capacity) {
+    set->capacity = 1024;
+    while (set->capacity < capacity) set->capacity *= 2;
+    set->count = 0;
+    set->keys = (uint64_t*)mem_calloc((size_t)set->capacity, sizeof(uint64_t));
+    return set->keys != NULL;
+}
+
+static uint64_t* edge_set_slot(uint64_t* keys, int capacity, uint64_t key) {
+    uint32_t mask = (uint32_t)capacity - 1;
+    uint32_t i = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (keys[i] != 0 && keys[i] != key) {
+        i = (i + 1) & mask;
+    }
+    return &keys[i];
+}
+
+// 1 si la clé vient d'être ajoutée, 0 si elle était présente, -1 si l'allocation échoue
+static int edge_set_insert(EdgeSet* set, uint64_t key) {
+    if (2 * (set->count + 1) > set->capacity) {
+        int capacity = set->capacity * 2;
+        uint64_t* keys = (uint64_t*)mem_calloc((size_t)capacity, sizeof(uint64_t));
+        if (keys == NULL) {
+            return -1;
+        }
+        for (int i = 0; i < set->capacity; ++i) {
+            if (set->keys[i] != 0) *edge_set_slot(keys, capacity, set->keys[i]) = set->keys[i];
+        }
+        mem_free(set->keys);
+        set->keys = keys;
+        set->capacity = capacity;
+    }
+    uint64_t* slot = edge_set_slot(set->keys, set->capacity, key);
+    if (*slot == key) {
+        return 0;
+    }
+    *slot = key;
+    set->count++;
+    return 1;
+}
+
+// --- Import OBJ ---
+
+typedef struct {
+    Mesh* mesh;
+    int vertex_capacity;
+    int edge_capacity;
+    EdgeSet set;
+} ObjBuilder;
+
+static int obj_add_vertex(ObjBuilder* b, Vec3D v) {
+    Mesh* m = b->mesh;
+    if (m->num_vertices == b->vertex_capacity) {
+        int capacity = b->vertex_capacity ? b->vertex_capacity * 2 : 1024;
+        Vec3D* vertices = (Vec3D*)mem_realloc(m->vertices, (size_t)capacity * sizeof(Vec3D));
+        if (vertices == NULL) {
+            return 0;
+        }
+        m->vertices = vertices;
+        b->vertex_capacity = capacity;
+    }
+    m->vertices[m->num_vertices++] = v;
+    return 1;
+}
+
+static int obj_add_edge(ObjBuilder* b, int v1, int v2) {
+    if (v1 == v2) {
+        return 1; // Face dégénérée
+    }
+    int inserted = edge_set_insert(&b->set, edge_key(v1, v2));
+    if (inserted <= 0) {
+        return inserted == 0;
+    }
+    Mesh* m = b->mesh;
+    if (m->num_edges == b->edge_capacity) {
+        int capacity = b->edge_capacity ? b->edge_capacity * 2 : 1024;
+        Edge* edges = (Edge*)mem_realloc(m->edges, (size_t)capacity * sizeof(Edge));
+        if (edges == NULL) {
+            return 0;
+        }
+        m->edges = edges;
+        b->edge_capacity = capacity;
+    }
+    m->edges[m->num_edges++] = (Edge){v1, v2};
+    return 1;
+}
+
+// Lit l'index de sommet d'un élément "v", "v/vt", "v//vn" ou "v/vt/vn" ;
+// -1 s'il n'y a plus d'élément sur la ligne, -2 si l'index est invalide
+static int obj_parse_index(const char** cursor, int num_vertices) {
+    const char* p = *cursor;
+    while (*p == ' ' || *p == '\t') ++p;
+    if (*p == '\n' || *p == '\r' || *p == '\0' || *p == '#') {
+        *cursor = p;
+        return -1;
+    }
+    char* end;
+    long index = strtol(p, &end, 10);
+    if (end == p) {
+        return -2;
+    }
+    while (*end != '\0' && *end != ' ' && *end != '\t' && *end != '\n' && *end != '\r') ++end;
+    *cursor = end;
+    if (index < 0) index += num_vertices; // Relatif aux derniers sommets lus
+    else index -= 1;                      // Les index OBJ commencent à 1
+    return (index >= 0 && index < num_vertices) ? (int)index : -2;
+}
+
+static int read_file(const char* path, char** out_data, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        printf("Impossible d'ouvrir %s\n", path);
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* data = size >= 0 ? (char*)mem_alloc((size_t)size + 1) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        printf("Lecture impossible de %s\n", path);
+        mem_free(data);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    data[size] = '\0';
+    *out_data = data;
+    *out_size = (size_t)size;
+    return 1;
+}
+
+int load_mesh_obj(Mesh* mesh, const char* path) {
+    memset(mesh, 0, sizeof(*mesh));
+    char* data;
+    size_t size;
+    if (!read_file(path, &data, &size)) {
+        return 0;
+    }
+    // Estimation grossière pour éviter les premières réallocations de la table
+    ObjBuilder b = {mesh, 0, 0, {0}};
+    int ok = edge_set_init(&b.set, (int)(size / 16 < (1 << 26) ? size / 16 : (1 << 26)));
+    int line_number = 0;
+
+    for (const char* p = data; ok && *p != '\0'; ) {
+        ++line_number;
+        const char* line = p;
+        while (*line == ' ' || *line == '\t') ++line;
+        if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t')) {
+            char* end;
+            Vec3D v;
+            v.x = strtof(line + 2, &end);
+            v.y = strtof(end, &end);
+            v.z = strtof(end, &end);
+            ok = obj_add_vertex(&b, v);
+        } else if ((line[0] == 'f' || line[0] == 'l') && (line[1] == ' ' || line[1] == '\t')) {
+            // Polygone : arêtes entre sommets consécutifs, fermé pour une face
+            const char* cursor = line + 2;
+            int first = obj_parse_index(&cursor, mesh->num_vertices), prev = first, idx = first;
+            while (ok && idx >= 0) {
+                idx = obj_parse_index(&cursor, mesh->num_vertices);
+                if (idx >= 0) {
+                    ok = obj_add_edge(&b, prev, idx);
+                    prev = idx;
+                }
+            }
+            if (first == -2 || idx == -2) {
+                printf("%s:%d : index de sommet invalide\n", path, line_number);
+                ok = 0;
+            } else if (ok && line[0] == 'f' && prev != first) {
+                ok = obj_add_edge(&b, prev, first);
+            }
+        }
+        // Autres directives (vt, vn, o, g, usemtl, commentaires...) ignorées
+        while (*p != '\0' && *p != '\n') ++p;
+        if (*p == '\n') ++p;
+    }
+
+    mem_free(b.set.keys);
+    mem_free(data);
+    // Tableaux doublés pendant la lecture recopiés dans le bloc unique du maillage
+    Mesh packed;
+    ok = ok && mesh_alloc(&packed, mesh->num_vertices, mesh->num_edges);
+    if (ok) {
+        memcpy(packed.vertices, mesh->vertices, (size_t)mesh->num_vertices * sizeof(Vec3D));
+        memcpy(packed.edges, mesh->edges, (size_t)mesh->num_edges * sizeof(Edge));
+    }
+    mem_free(mesh->vertices);
+    mem_free(mesh->edges);
+    if (!ok) {
+        memset(mesh, 0, sizeof(*mesh));
+        return 0;
+    }
+    *mesh = packed;
+    return 1;
+}
+
+// --- Format binaire ---
+
+static uint64_t align_up(uint64_t value) {
+    return (value + MESH_FILE_ALIGN - 1) & ~(uint64_t)(MESH_FILE_ALIGN - 1);
+}
+
+int save_mesh_binary(const Mesh* mesh, const char* path) {
+    for (int i = 0; i < mesh->num_edges; ++i) {
+        const Edge* e = &mesh->edges[i];
+        if (e->v1_idx < 0 || e->v1_idx >= mesh->num_vertices ||
+            e->v2_idx < 0 || e->v2_idx >= mesh->num_vertices) {
+            printf("Arête %d hors limites : %s non écrit\n", i, path);
+            return 0;
+        }
+    }
+    MeshFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MESH_FILE_MAGIC, sizeof(header.magic));
+    header.version = MESH_FILE_VERSION;
+    header.header_size = sizeof(MeshFileHeader);
+    header.num_vertices = (uint32_t)mesh->num_vertices;
+    header.num_edges = (uint32_t)mesh->num_edges;
+    header.vertex_stride = sizeof(Vec3D);
+    header.edge_stride = sizeof(Edge);
+    header.vertex_offset = align_up(sizeof(MeshFileHeader));
+    header.edge_offset = align_up(header.vertex_offset + (uint64_t)mesh->num_vertices * sizeof(Vec3D));
+    header.file_size = align_up(header.edge_offset + (uint64_t)mesh->num_edges * sizeof(Edge));
+
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        printf("Impossible de créer %s\n", path);
+        return 0;
+    }
+    static const char padding[MESH_FILE_ALIGN] = {0};
+    uint64_t vertex_bytes = (uint64_t)mesh->num_vertices * sizeof(Vec3D);
+    uint64_t edge_bytes = (uint64_t)mesh->num_edges * sizeof(Edge);
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && fwrite(padding, 1, header.vertex_offset - sizeof(header), f) == header.vertex_offset - sizeof(header);
+    ok = ok && fwrite(mesh->vertices, 1, vertex_bytes, f) == vertex_bytes;
+    uint64_t pad = header.edge_offset - header.vertex_offset - vertex_bytes;
+    ok = ok && fwrite(padding, 1, pad, f) == pad;
+    ok = ok && fwrite(mesh->edges, 1, edge_bytes, f) == edge_bytes;
+    pad = header.file_size - header.edge_offset - edge_bytes;
+    ok = ok && fwrite(padding, 1, pad, f) == pad;
+    if (fclose(f) != 0 || !ok) {
+        printf("Écriture incomplète de %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+int load_mesh_binary(Mesh* mesh, const char* path) {
+    memset(mesh, 0, sizeof(*mesh));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Impossible d'ouvrir %s\n", path);
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MeshFileHeader)) {
+        printf("%s : fichier trop court\n", path);
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)st.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // La projection garde sa propre référence au fichier
+    if (mapping == MAP_FAILED) {
+        printf("Projection en mémoire impossible pour %s\n", path);
+        return 0;
+    }
+
+    const MeshFileHeader* h = (const MeshFileHeader*)mapping;
+    const char* error = NULL;
+    if (memcmp(h->magic, MESH_FILE_MAGIC, sizeof(h->magic)) != 0) error = "signature inconnue";
+    else if (h->version != MESH_FILE_VERSION) error = "version non prise en charge";
+    else if (h->header_size != sizeof(MeshFileHeader) || h->vertex_stride != sizeof(Vec3D) ||
+             h->edge_stride != sizeof(Edge)) error = "disposition incompatible";
+    else if (h->file_size != size || h->num_vertices > INT32_MAX || h->num_edges > INT32_MAX ||
+             h->vertex_offset % MESH_FILE_ALIGN != 0 || h->edge_offset % MESH_FILE_ALIGN != 0 ||
+             h->vertex_offset + (uint64_t)h->num_vertices * sizeof(Vec3D) > size ||
+             h->edge_offset + (uint64_t)h->num_edges * sizeof(Edge) > size) error = "en-tête incohérent";
+    if (error == NULL) {
+        // Fichier venu d'ailleurs : un index hors limites ferait lire le rendu
+        // et GJK hors des tableaux de sommets
+        const Edge* edges = (const Edge*)((const char*)mapping + h->edge_offset);
+        int num_vertices = (int)h->num_vertices;
+        for (uint32_t i = 0; i < h->num_edges && error == NULL; ++i) {
+            if (edges[i].v1_idx < 0 || edges[i].v1_idx >= num_vertices ||
+                edges[i].v2_idx < 0 || edges[i].v2_idx >= num_vertices) error = "index d'arête hors limites";
+        }
+    }
+    if (error != NULL) {
+        printf("%s : %s\n", path, error);
+        munmap(mapping, size);
+        return 0;
+    }
+
+    mesh->vertices = (Vec3D*)((char*)mapping + h->vertex_offset);
+    mesh->num_vertices = (int)h->num_vertices;
+    mesh->edges = (Edge*)((char*)mapping + h->edge_offset);
+    mesh->num_edges = (int)h->num_edges;
+    mesh->mapping = mapping;
+    mesh->mapping_size = size;
+    return 1;
+}
+
+int load_mesh_file(Mesh* mesh, const char* path) {
+    size_t len = strlen(path);
+    if (len >= 4 && strcasecmp(path + len - 4, ".obj") == 0) {
+        return load_mesh_obj(mesh, path);
+    }
+    return load_mesh_binary(mesh, path);
+}
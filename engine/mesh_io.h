@@ -0,0 +1,46 @@
+#ifndef ENGINE_MESH_IO_H
+#define ENGINE_MESH_IO_H
+
+#include <stdint.h>
+#include "mesh.h"
+
+// --- Format binaire ---
+// En-tête de 64 octets, puis les sommets (Vec3D) et les arêtes (Edge) tels
+// qu'ils sont en mémoire, chaque section alignée sur 64 octets. Le fichier est
+// projeté en mémoire et utilisé sur place : ni analyse ni copie au chargement,
+// seulement une vérification des index d'arêtes (un passage sur les arêtes).
+// Petit-boutiste uniquement.
+#define MESH_FILE_MAGIC "PHMESH\r\n"  // \r\n : détecte un transfert en mode texte
+#define MESH_FILE_VERSION 1
+#define MESH_FILE_ALIGN 64
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;     // sizeof(MeshFileHeader)
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    uint64_t vertex_offset;   // En octets depuis le début du fichier
+    uint64_t edge_offset;
+    uint64_t file_size;
+    uint32_t vertex_stride;   // sizeof(Vec3D)
+    uint32_t edge_stride;     // sizeof(Edge)
+    uint8_t reserved[8];
+} MeshFileHeader;
+
+// Importe un OBJ : sommets `v` et arêtes uniques des faces `f` et polylignes `l`
+// (dans l'ordre de première apparition). Index négatifs et formes v/vt/vn acceptés.
+// Retourne 1 en cas de succès, 0 sinon (message sur la sortie standard).
+int load_mesh_obj(Mesh* mesh, const char* path);
+
+// Écrit le maillage au format binaire ; 0 en cas d'erreur
+int save_mesh_binary(const Mesh* mesh, const char* path);
+
+// Projette un fichier binaire en mémoire (copie à l'écriture : le maillage reste
+// modifiable sans toucher au fichier). free_mesh() libère la projection.
+int load_mesh_binary(Mesh* mesh, const char* path);
+
+// Choisit le chargeur selon l'extension (.obj, sinon format binaire)
+int load_mesh_file(Mesh* mesh, const char* path);
+
+#endif
@@ -0,0 +1,212 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "mesh_optimize.h"
+#include "soa.h"
+
+typedef struct {
+    uint64_t key;
+    int index;  // Départage les clés égales : le tri devient stable
+} SortKey;
+
+static int compare_keys(const void* a, const void* b) {
+    const SortKey* x = (const SortKey*)a;
+    const SortKey* y = (const SortKey*)b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+// Étale les 21 bits de poids faible de v, un bit sur trois
+static uint64_t spread_bits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffull;
+    v = (v | v << 16) & 0x1f0000ff0000ffull;
+    v = (v | v << 8) & 0x100f00f00f00f00full;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+}
+
+static uint64_t quantize(float value, float origin, float scale) {
+    float q = (value - origin) * scale;
+    return q >= 0.0f ? (uint64_t)(q < 2097151.0f ? q : 2097151.0f) : 0; // NaN : 0
+}
+
+// Clés de Morton des sommets, sur le cube englobant (mêmes pas sur les trois
+// axes, pour que les cellules de la courbe restent cubiques)
+static void morton_keys(const Mesh* mesh, SortKey* keys) {
+    Vec3D lo = mesh->vertices[0], hi = mesh->vertices[0];
+    for (int i = 1; i < mesh->num_vertices; ++i) {
+        Vec3D v = mesh->vertices[i];
+        lo = (Vec3D){fminf(lo.x, v.x), fminf(lo.y, v.y), fminf(lo.z, v.z)};
+        hi = (Vec3D){fmaxf(hi.x, v.x), fmaxf(hi.y, v.y), fmaxf(hi.z, v.z)};
+    }
+    float extent = fmaxf(hi.x - lo.x, fmaxf(hi.y - lo.y, hi.z - lo.z));
+    float scale = extent > 0.0f ? 2097151.0f / extent : 0.0f;
+    for (int i = 0; i < mesh->num_vertices; ++i) {
+        Vec3D v = mesh->vertices[i];
+        keys[i].key = spread_bits(quantize(v.x, lo.x, scale)) | spread_bits(quantize(v.y, lo.y, scale)) << 1 |
+                      spread_bits(quantize(v.z, lo.z, scale)) << 2;
+        keys[i].index = i;
+    }
+}
+
+int mesh_optimize(Mesh* mesh) {
+    int num_vertices = mesh->num_vertices, num_edges = mesh->num_edges;
+    for (int i = 0; i < num_edges; ++i) {
+        const Edge* e = &mesh->edges[i];
+        if (e->v1_idx < 0 || e->v1_idx >= num_vertices || e->v2_idx < 0 || e->v2_idx >= num_vertices) {
+            return -1;
+        }
+    }
+    if (num_vertices == 0) {
+        return 0;
+    }
+    size_t num_keys = (size_t)(num_vertices > num_edges ? num_vertices : num_edges);
+    SortKey* keys = (SortKey*)mem_alloc(num_keys * sizeof(SortKey));
+    int* remap = (int*)mem_alloc((size_t)num_vertices * sizeof(int));
+    Vec3D* vertices = (Vec3D*)mem_alloc((size_t)num_vertices * sizeof(Vec3D));
+    Edge* edges = (Edge*)mem_alloc((size_t)(num_edges > 0 ? num_edges : 1) * sizeof(Edge));
+    if (keys == NULL || remap == NULL || vertices == NULL || edges == NULL) {
+        mem_free(keys);
+        mem_free(remap);
+        mem_free(vertices);
+        mem_free(edges);
+        return -1;
+    }
+
+    // 1. Sommets dans l'ordre de Morton
+    morton_keys(mesh, keys);
+    qsort(keys, (size_t)num_vertices, sizeof(SortKey), compare_keys);
+    for (int i = 0; i < num_vertices; ++i) {
+        remap[keys[i].index] = i;
+        vertices[i] = mesh->vertices[keys[i].index];
+    }
+    memcpy(mesh->vertices, vertices, (size_t)num_vertices * sizeof(Vec3D));
+
+    // 2. Arêtes renumérotées, triées par paire d'index ordonnée : les doublons
+    // se suivent et seule la première occurrence est gardée
+    int count = 0;
+    for (int i = 0; i < num_edges; ++i) {
+        int a = remap[mesh->edges[i].v1_idx], b = remap[mesh->edges[i].v2_idx];
+        edges[i] = (Edge){a, b};
+        if (a == b) continue;
+        uint32_t lo = (uint32_t)(a < b ? a : b), hi = (uint32_t)(a < b ? b : a);
+        keys[count++] = (SortKey){(uint64_t)lo << 32 | hi, i};
+    }
+    qsort(keys, (size_t)count, sizeof(SortKey), compare_keys);
+    int kept = 0;
+    for (int k = 0; k < count; ++k) {
+        if (k > 0 && keys[k].key == keys[k - 1].key) continue;
+        mesh->edges[kept++] = edges[keys[k].index];
+    }
+    mesh->num_edges = kept;
+
+    mem_free(keys);
+    mem_free(remap);
+    mem_free(vertices);
+    mem_free(edges);
+    return num_edges - kept;
+}
+
+// --- Simulation de cache ---
+
+typedef struct {
+    uint64_t* tags;  // sets x ways, de la plus récente à la plus ancienne ; 0 = vide
+    uint64_t set_mask;
+    int ways;
+    uint64_t accesses, misses;
+} CacheSim;
+
+static void cache_access(CacheSim* c, uint64_t address) {
+    uint64_t line = address / MESH_CACHE_LINE;
+    uint64_t* set = c->tags + (size_t)(line & c->set_mask) * (size_t)c->ways;
+    uint64_t tag = line + 1;
+    int w = 0;
+    while (w < c->ways - 1 && set[w] != tag) ++w;
+    c->misses += set[w] != tag;
+    c->accesses++;
+    memmove(set + 1, set, (size_t)w * sizeof(uint64_t)); // Sans succès, la plus ancienne sort
+    set[0] = tag;
+}
+
+double mesh_edge_miss_rate(const Edge* edges, int num_edges, int num_vertices, int cache_bytes, int ways) {
+    if (ways < 1) ways = 1;
+    uint64_t sets = 1;
+    while (sets * 2 * (uint64_t)ways * MESH_CACHE_LINE <= (uint64_t)cache_bytes) sets *= 2;
+    CacheSim c = {(uint64_t*)mem_calloc((size_t)(sets * (uint64_t)ways), sizeof(uint64_t)), sets - 1, ways, 0, 0};
+    if (c.tags == NULL) {
+        return -1.0;
+    }
+    // Disposition de alloc_vertices (render.c) : cx, cy, cz, cw, sx, sy, codes
+    uint64_t stride = ((uint64_t)num_vertices * sizeof(float) + SOA_ALIGNMENT - 1) & ~(uint64_t)(SOA_ALIGNMENT - 1);
+    uint64_t cw = 3 * stride, sx = 4 * stride, sy = 5 * stride, codes = 6 * stride;
+    for (int i = 0; i < num_edges; ++i) {
+        uint64_t a = (uint64_t)edges[i].v1_idx, b = (uint64_t)edges[i].v2_idx;
+        cache_access(&c, codes + a);
+        cache_access(&c, codes + b);
+        cache_access(&c, cw + 4 * a);
+        cache_access(&c, cw + 4 * b);
+        cache_access(&c, sx + 4 * a);
+        cache_access(&c, sy + 4 * a);
+        cache_access(&c, sx + 4 * b);
+        cache_access(&c, sy + 4 * b);
+    }
+    mem_free(c.tags);
+    return c.accesses > 0 ? (double)c.misses / (double)c.accesses : 0.0;
+}
+
+// --- Index compressés ---
+
+static int fits_delta(int64_t d) {
+    return d >= -32767 && d <= 32767;
+}
+
+EdgeIndexFormat edge_stream_format(const Edge* edges, int num_edges, int num_vertices, size_t* num_words) {
+    *num_words = 0;
+    if (num_edges == 0) {
+        return EDGE_INDEX_32;
+    }
+    if (num_vertices <= 65536) {
+        *num_words = 2 * (size_t)num_edges;
+        return EDGE_INDEX_16;
+    }
+    size_t words = 0;
+    int prev = 0;
+    for (int i = 0; i < num_edges; ++i) {
+        int a = edges[i].v1_idx, b = edges[i].v2_idx;
+        words += (fits_delta((int64_t)a - prev) && fits_delta((int64_t)b - a)) ? 2 : 5;
+        prev = a;
+    }
+    if (words > 3 * (size_t)num_edges) {
+        return EDGE_INDEX_32;
+    }
+    *num_words = words;
+    return EDGE_INDEX_DELTA;
+}
+
+void edge_stream_encode(const Edge* edges, int num_edges, EdgeIndexFormat format, uint16_t* out) {
+    if (format == EDGE_INDEX_16) {
+        for (int i = 0; i < num_edges; ++i) {
+            out[2 * i] = (uint16_t)edges[i].v1_idx;
+            out[2 * i + 1] = (uint16_t)edges[i].v2_idx;
+        }
+    } else if (format == EDGE_INDEX_DELTA) {
+        int prev = 0;
+        for (int i = 0; i < num_edges; ++i) {
+            int a = edges[i].v1_idx, b = edges[i].v2_idx;
+            if (fits_delta((int64_t)a - prev) && fits_delta((int64_t)b - a)) {
+                *out++ = (uint16_t)(int16_t)(a - prev);
+                *out++ = (uint16_t)(int16_t)(b - a);
+            } else {
+                *out++ = EDGE_DELTA_ESCAPE;
+                *out++ = (uint16_t)((uint32_t)a & 0xffff);
+                *out++ = (uint16_t)((uint32_t)a >> 16);
+                *out++ = (uint16_t)((uint32_t)b & 0xffff);
+                *out++ = (uint16_t)((uint32_t)b >> 16);
+            }
+            prev = a;
+        }
+    }
+}
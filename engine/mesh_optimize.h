@@ -0,0 +1,69 @@
+#ifndef ENGINE_MESH_OPTIMIZE_H
+#define ENGINE_MESH_OPTIMIZE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mesh.h"
+
+// --- Configuration ---
+#define MESH_CACHE_LINE 64
+#define EDGE_DELTA_ESCAPE 0x8000u  // Mot d'échappement du format EDGE_INDEX_DELTA
+
+// --- Préparation des maillages ---
+// Les arêtes d'un maillage importé suivent l'ordre des faces du fichier :
+// le découpage des arêtes (render.c) saute alors d'un bout à l'autre des
+// tableaux de sommets transformés. mesh_optimize range les sommets le long
+// d'une courbe de Morton (des sommets proches dans l'espace deviennent
+// voisins en mémoire), puis les arêtes par premier sommet : la lecture des
+// sommets devient un balayage presque séquentiel.
+
+// Retire les arêtes dégénérées et en double (dans un sens ou dans l'autre),
+// renumérote les sommets dans l'ordre de Morton et trie les arêtes par
+// (plus petit index, plus grand index). Chaque arête garde son orientation,
+// donc l'image filaire est identique au pixel près. Retourne le nombre
+// d'arêtes retirées, ou -1 (index hors limites, échec d'allocation : le
+// maillage n'est alors pas modifié).
+int mesh_optimize(Mesh* mesh);
+
+// Taux d'échec (0 à 1) d'un cache LRU de `cache_bytes` octets à `ways`
+// voies et lignes de MESH_CACHE_LINE octets, sur les lectures que fait le
+// découpage d'une arête acceptée (codes, w et coordonnées écran des deux
+// sommets), les arêtes étant parcourues dans l'ordre. Les tableaux par
+// sommet sont disposés comme dans le rendu. -1 en cas d'échec d'allocation.
+double mesh_edge_miss_rate(const Edge* edges, int num_edges, int num_vertices, int cache_bytes, int ways);
+
+// --- Index compressés ---
+typedef enum {
+    EDGE_INDEX_32 = 0,  // Edge tel quel : deux index 32 bits, 8 octets par arête
+    EDGE_INDEX_16,      // Deux index 16 bits : maillages d'au plus 65536 sommets
+    // Par arête, deux mots 16 bits signés : écart du premier sommet à celui
+    // de l'arête précédente, puis du second au premier. Si l'un ne tient pas,
+    // EDGE_DELTA_ESCAPE suivi des deux index en 32 bits (4 mots, poids faible
+    // d'abord). Retenu pour les grands maillages quand le flux ne dépasse pas
+    // 6 octets par arête, ce qui suppose des arêtes rangées par mesh_optimize.
+    EDGE_INDEX_DELTA
+} EdgeIndexFormat;
+
+// Format le plus compact pour ces arêtes, et taille du flux en mots de
+// 16 bits (0 pour EDGE_INDEX_32 : pas de flux, `edges` est lu tel quel)
+EdgeIndexFormat edge_stream_format(const Edge* edges, int num_edges, int num_vertices, size_t* num_words);
+
+// Écrit le flux (edge_stream_format donne sa taille) ; rien pour EDGE_INDEX_32
+void edge_stream_encode(const Edge* edges, int num_edges, EdgeIndexFormat format, uint16_t* out);
+
+// Arête suivante d'un flux EDGE_INDEX_DELTA ; `prev` vaut 0 avant la première
+static inline const uint16_t* edge_delta_next(const uint16_t* s, int* prev, int* a, int* b) {
+    if (s[0] == EDGE_DELTA_ESCAPE) {
+        *a = (int)((uint32_t)s[1] | (uint32_t)s[2] << 16);
+        *b = (int)((uint32_t)s[3] | (uint32_t)s[4] << 16);
+        s += 5;
+    } else {
+        *a = *prev + (int16_t)s[0];
+        *b = *a + (int16_t)s[1];
+        s += 2;
+    }
+    *prev = *a;
+    return s;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include <string.h>
+#include "object3d.h"
+
+// Corps dynamique de masse 1 au repos à l'origine, sans toucher à `mesh`
+static void init_body(Object3D* obj) {
+    obj->position = (Vec3D){0.0f, 0.0f, 0.0f}; // Positionné à l'origine
+    obj->orientation = quat_identity(); // Pas de rotation initiale
+    obj->scale    = (Vec3D){1.0f, 1.0f, 1.0f}; // Echelle unité
+
+    obj->velocity = (Vec3D){0.0f, 0.0f, 0.0f};
+    obj->angular_velocity = (Vec3D){0.0f, 0.0f, 0.0f};
+    object_set_mass(obj, 1.0f);
+    obj->ccd = 0;
+}
+
+void create_cube(Object3D* obj, float size) {
+    obj->mesh = mesh_asset_cube();
+    init_body(obj);
+    obj->scale = (Vec3D){size, size, size}; // Cube unité partagé, mis à la taille voulue
+}
+
+void create_object_instance(Object3D* obj, MeshAsset* mesh) {
+    obj->mesh = mesh_asset_retain(mesh);
+    init_body(obj);
+}
+
+int create_object_from_mesh(Object3D* obj, const Mesh* mesh) {
+    memset(obj, 0, sizeof(*obj));
+    obj->mesh = mesh_asset_create(mesh);
+    if (obj->mesh == NULL) {
+        return 0;
+    }
+    init_body(obj);
+    return 1;
+}
+
+void free_object(Object3D* obj) {
+    mesh_asset_release(obj->mesh);
+    obj->mesh = NULL;
+}
+
+void object_set_mass(Object3D* obj, float mass) {
+    obj->mass = mass;
+    obj->inv_mass = (mass > 0.0f) ? 1.0f / mass : 0.0f;
+}
+
+Affine3x4 object_world_matrix(const Object3D* obj) {
+    return affine_from_trs(obj->position, obj->orientation, obj->scale);
+}
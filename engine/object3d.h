@@ -0,0 +1,42 @@
+#ifndef ENGINE_OBJECT3D_H
+#define ENGINE_OBJECT3D_H
+
+#include "math3d.h"
+#include "mesh.h"
+#include "mesh_asset.h"
+#include "transform.h"
+
+typedef struct {
+    // Géométrie partagée : le corps en détient une référence (NULL si la
+    // création a échoué). Sommets, arêtes et volumes englobants en repère
+    // local sont ceux du maillage, communs à toutes ses instances.
+    MeshAsset* mesh;
+    Vec3D position;
+    Quat orientation;
+    Vec3D scale;
+
+    // Corps rigide
+    Vec3D velocity;         // m/s
+    Vec3D angular_velocity; // rad/s, axe de rotation en repère monde
+    float mass;             // 0 = corps statique (masse infinie)
+    float inv_mass;
+    int ccd;                // 1 : détection continue à chaque pas (sinon selon world->ccd_threshold)
+} Object3D;
+
+// Cube de côté `size`, centré à l'origine, corps dynamique de masse 1 : une
+// instance du cube unité partagé (mesh_asset_cube) à l'échelle `size`
+void create_cube(Object3D* obj, float size);
+// Corps dynamique de masse 1, instance de `mesh` (une référence de plus)
+void create_object_instance(Object3D* obj, MeshAsset* mesh);
+// Corps dynamique de masse 1 dont la géométrie est une copie privée de
+// `mesh`. Retourne 0 si l'allocation échoue.
+int create_object_from_mesh(Object3D* obj, const Mesh* mesh);
+// Rend la référence au maillage
+void free_object(Object3D* obj);
+
+void object_set_mass(Object3D* obj, float mass);
+
+// Matrice Monde (Model Matrix) : Scale -> Rotate -> Translate
+Affine3x4 object_world_matrix(const Object3D* obj);
+
+#endif
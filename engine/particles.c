@@ -0,0 +1,422 @@
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "alloc.h"
+#include "kernels.h"
+#include "particles.h"
+#include "timer.h"
+
+static int reserve_array(void** p, int* capacity, int count, size_t size) {
+    if (count <= *capacity) {
+        return 1;
+    }
+    int new_capacity = *capacity ? *capacity : 64;
+    while (new_capacity < count) new_capacity *= 2;
+    void* grown = mem_realloc(*p, (size_t)new_capacity * size);
+    if (grown == NULL) {
+        return 0;
+    }
+    *p = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+// --- Lots de contraintes ---
+
+#define DISTANCE_FLOATS(X) X(rest) X(ka) X(kb)
+
+static void batches_free(DistanceBatches* c) {
+    soa_free_floats(c->storage);
+    memset(c, 0, sizeof(*c));
+}
+
+// Reconstruits à chaque changement : rien à conserver. `a` et `b` partagent
+// le bloc des flottants.
+static int batches_reserve(DistanceBatches* c, int count) {
+    if (count <= c->capacity) {
+        return 1;
+    }
+    int capacity = c->capacity ? c->capacity : 256;
+    while (capacity < count) capacity *= 2;
+    batches_free(c);
+    c->storage = soa_alloc_floats(capacity * 5);
+    if (c->storage == NULL) {
+        return 0;
+    }
+    float* next = c->storage;
+#define ASSIGN(f) c->f = next; next += capacity;
+    DISTANCE_FLOATS(ASSIGN)
+#undef ASSIGN
+    c->a = (int*)next; next += capacity;
+    c->b = (int*)next;
+    c->capacity = capacity;
+    return 1;
+}
+
+// --- Cycle de vie ---
+
+void particle_system_init(ParticleSystem* ps) {
+    memset(ps, 0, sizeof(*ps));
+    particle_soa_init(&ps->particles);
+    ps->iterations = PARTICLE_DEFAULT_ITERATIONS;
+    ps->damping = PARTICLE_DEFAULT_DAMPING;
+    ps->radius = PARTICLE_DEFAULT_RADIUS;
+    ps->friction = PARTICLE_DEFAULT_FRICTION;
+}
+
+void particle_system_free(ParticleSystem* ps) {
+    particle_soa_free(&ps->particles);
+    mem_free(ps->edges);
+    mem_free(ps->rest);
+    mem_free(ps->stiffness);
+    batches_free(&ps->batches);
+    mem_free(ps->colliders);
+    mem_free(ps->chunks);
+    particle_system_init(ps);
+}
+
+int particle_system_add_mesh(ParticleSystem* ps, const Mesh* mesh, const Affine3x4* transform,
+                             float particle_mass, float stiffness) {
+    ParticleSoA* p = &ps->particles;
+    int first = p->count ? p->count : 1; // Puits créé avec le premier maillage
+    int count = first + mesh->num_vertices;
+    int num_constraints = ps->num_constraints + mesh->num_edges;
+    int capacity = p->capacity ? p->capacity : 64;
+    while (capacity < count) capacity *= 2;
+    int edge_capacity = ps->constraint_capacity;
+    int rest_capacity = ps->constraint_capacity;
+    if (!particle_soa_reserve(p, capacity) ||
+        !reserve_array((void**)&ps->edges, &edge_capacity, num_constraints, sizeof(Edge)) ||
+        !reserve_array((void**)&ps->rest, &rest_capacity, num_constraints, sizeof(float)) ||
+        !reserve_array((void**)&ps->stiffness, &ps->constraint_capacity, num_constraints, sizeof(float))) {
+        return -1;
+    }
+    if (p->count == 0) {
+        p->x[0] = p->y[0] = p->z[0] = 0.0f;
+        p->ox[0] = p->oy[0] = p->oz[0] = 0.0f;
+        p->inv_mass[0] = 0.0f;
+    }
+    float inv_mass = particle_mass > 0.0f ? 1.0f / particle_mass : 0.0f;
+    for (int i = 0; i < mesh->num_vertices; ++i) {
+        Vec3D v = affine_apply_point(transform, mesh->vertices[i]);
+        int k = first + i;
+        p->x[k] = p->ox[k] = v.x;
+        p->y[k] = p->oy[k] = v.y;
+        p->z[k] = p->oz[k] = v.z;
+        p->inv_mass[k] = inv_mass;
+    }
+    p->count = count;
+    float k = fminf(fmaxf(stiffness, 0.0f), 1.0f);
+    for (int e = 0; e < mesh->num_edges; ++e) {
+        int j = ps->num_constraints++;
+        Edge edge = {first + mesh->edges[e].v1_idx, first + mesh->edges[e].v2_idx};
+        ps->edges[j] = edge;
+        ps->rest[j] = vec3_length(vec3_sub(particle_position(ps, edge.v2_idx), particle_position(ps, edge.v1_idx)));
+        ps->stiffness[j] = k;
+    }
+    ps->prepared_iterations = 0;
+    return first;
+}
+
+void particle_system_set_inv_mass(ParticleSystem* ps, int index, float inv_mass) {
+    ParticleSoA* p = &ps->particles;
+    if (index < 1 || index >= p->count) {
+        return;
+    }
+    // Repart sans vitesse : fixée, elle ne garderait pas celle d'avant
+    p->inv_mass[index] = inv_mass;
+    p->ox[index] = p->x[index];
+    p->oy[index] = p->y[index];
+    p->oz[index] = p->z[index];
+    ps->prepared_iterations = 0; // Parts de correction et couleurs à refaire
+}
+
+// --- Coloration et rangement en lots ---
+
+// Première couleur libre pour les deux particules. Les particules fixées ne
+// sont jamais marquées : leur position ne change pas, deux voies d'un lot
+// peuvent la partager.
+static int prepare(ParticleSystem* ps) {
+    int n = ps->num_constraints;
+    const ParticleSoA* p = &ps->particles;
+    uint64_t* mask = (uint64_t*)mem_calloc((size_t)p->count, sizeof(uint64_t));
+    unsigned char* color = (unsigned char*)mem_alloc((size_t)n + 1);
+    if (mask == NULL || color == NULL) {
+        mem_free(mask);
+        mem_free(color);
+        return 0;
+    }
+    int count[PARTICLE_MAX_COLORS + 1] = {0};
+    for (int i = 0; i < n; ++i) {
+        int a = ps->edges[i].v1_idx, b = ps->edges[i].v2_idx;
+        uint64_t used = mask[a] | mask[b];
+        int c = (used == ~0ull) ? PARTICLE_MAX_COLORS : __builtin_ctzll(~used);
+        if (c < PARTICLE_MAX_COLORS) {
+            if (p->inv_mass[a] != 0.0f) mask[a] |= 1ull << c;
+            if (p->inv_mass[b] != 0.0f) mask[b] |= 1ull << c;
+        }
+        color[i] = (unsigned char)c;
+        count[c]++;
+    }
+    mem_free(mask);
+
+    // Chaque couleur remplit ses lots de PARTICLE_LANES contraintes ; les
+    // contraintes en excès de couleurs ont chacune leur lot
+    int cursor[PARTICLE_MAX_COLORS + 1];
+    int num_batches = 0;
+    ps->num_colors = 0;
+    for (int c = 0; c <= PARTICLE_MAX_COLORS; ++c) {
+        ps->color_start[c] = num_batches;
+        cursor[c] = num_batches * PARTICLE_LANES;
+        num_batches += (c < PARTICLE_MAX_COLORS) ? (count[c] + PARTICLE_LANES - 1) / PARTICLE_LANES : count[c];
+        if (count[c] > 0) ps->num_colors++;
+    }
+    ps->color_start[PARTICLE_MAX_COLORS + 1] = num_batches;
+    int num_slots = num_batches * PARTICLE_LANES;
+    DistanceBatches* b = &ps->batches;
+    if (!batches_reserve(b, num_slots)) {
+        mem_free(color);
+        return 0;
+    }
+    b->num_batches = num_batches;
+    memset(b->a, 0, (size_t)num_slots * sizeof(int));
+    memset(b->b, 0, (size_t)num_slots * sizeof(int));
+    memset(b->rest, 0, (size_t)num_slots * sizeof(float));
+    memset(b->ka, 0, (size_t)num_slots * sizeof(float));
+    memset(b->kb, 0, (size_t)num_slots * sizeof(float));
+
+    // Raideur par itération : n passes à k' corrigent autant qu'une à k
+    float inv_iterations = 1.0f / (float)(ps->iterations > 0 ? ps->iterations : 1);
+    for (int i = 0; i < n; ++i) {
+        int c = color[i];
+        int j = cursor[c];
+        cursor[c] += (c < PARTICLE_MAX_COLORS) ? 1 : PARTICLE_LANES;
+        int ia = ps->edges[i].v1_idx, ib = ps->edges[i].v2_idx;
+        float wa = p->inv_mass[ia], wb = p->inv_mass[ib];
+        float k = 1.0f - powf(1.0f - ps->stiffness[i], inv_iterations);
+        b->a[j] = ia;
+        b->b[j] = ib;
+        b->rest[j] = ps->rest[i];
+        b->ka[j] = wa + wb > 0.0f ? k * wa / (wa + wb) : 0.0f;
+        b->kb[j] = wa + wb > 0.0f ? k * wb / (wa + wb) : 0.0f;
+    }
+    mem_free(color);
+    ps->prepared_iterations = ps->iterations;
+    return 1;
+}
+
+// --- Pas ---
+
+typedef struct {
+    ParticleSystem* ps;
+    Vec3D gravity;
+    float dt;
+    int first;   // Décalage des index de job_parallel_for
+} ParticleJob;
+
+static AABB empty_bounds(void) {
+    return (AABB){{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+}
+
+// Comparaisons plutôt que fminf/fmaxf : sans -ffast-math, ce sont des appels
+// de bibliothèque qui empêchent la vectorisation
+static void bounds_range(const ParticleSoA* p, int begin, int end, AABB* box) {
+    float x0 = box->min.x, y0 = box->min.y, z0 = box->min.z;
+    float x1 = box->max.x, y1 = box->max.y, z1 = box->max.z;
+    for (int i = begin; i < end; ++i) {
+        float x = p->x[i], y = p->y[i], z = p->z[i];
+        x0 = x < x0 ? x : x0; y0 = y < y0 ? y : y0; z0 = z < z0 ? z : z0;
+        x1 = x > x1 ? x : x1; y1 = y > y1 ? y : y1; z1 = z > z1 ? z : z1;
+    }
+    *box = (AABB){{x0, y0, z0}, {x1, y1, z1}};
+}
+
+static void integrate_range(void* ctx, int begin, int end, int chunk) {
+    ParticleJob* job = (ParticleJob*)ctx;
+    ParticleSystem* ps = job->ps;
+    begin += job->first;
+    end += job->first;
+    kernels_get()->integrate_particles(&ps->particles, job->gravity, job->dt, ps->damping, begin, end);
+    AABB box = empty_bounds();
+    bounds_range(&ps->particles, begin, end, &box);
+    ps->chunks[chunk].bounds = box;
+}
+
+static int reserve_chunks(ParticleSystem* ps, int count) {
+    return reserve_array((void**)&ps->chunks, &ps->chunk_capacity, count, sizeof(ParticleChunk));
+}
+
+int particle_system_integrate(ParticleSystem* ps, Vec3D gravity, float dt, JobSystem* jobs) {
+    uint64_t t0 = timer_now_ns();
+    int n = ps->particles.count - 1;
+    memset(&ps->stats, 0, sizeof(ps->stats));
+    ps->bounds = empty_bounds();
+    if (n <= 0) {
+        return 1;
+    }
+    int num_chunks = job_chunk_count(n, PARTICLE_GRAIN);
+    if (!reserve_chunks(ps, num_chunks)) {
+        return 0;
+    }
+    ParticleJob job = {ps, gravity, dt, 1};
+    job_parallel_for(jobs, n, PARTICLE_GRAIN, integrate_range, &job);
+    for (int c = 0; c < num_chunks; ++c) {
+        const AABB* box = &ps->chunks[c].bounds;
+        ps->bounds.min = (Vec3D){fminf(ps->bounds.min.x, box->min.x), fminf(ps->bounds.min.y, box->min.y),
+                                 fminf(ps->bounds.min.z, box->min.z)};
+        ps->bounds.max = (Vec3D){fmaxf(ps->bounds.max.x, box->max.x), fmaxf(ps->bounds.max.y, box->max.y),
+                                 fmaxf(ps->bounds.max.z, box->max.z)};
+    }
+    ps->stats.integrate_ns = timer_now_ns() - t0;
+    return 1;
+}
+
+void particle_system_clear_colliders(ParticleSystem* ps) {
+    ps->num_colliders = 0;
+}
+
+ParticleCollider* particle_system_push_collider(ParticleSystem* ps) {
+    if (!reserve_array((void**)&ps->colliders, &ps->collider_capacity, ps->num_colliders + 1,
+                       sizeof(ParticleCollider))) {
+        return NULL;
+    }
+    return &ps->colliders[ps->num_colliders++];
+}
+
+static void solve_range(void* ctx, int begin, int end, int chunk) {
+    ParticleJob* job = (ParticleJob*)ctx;
+    (void)chunk;
+    kernels_get()->solve_distances(&job->ps->batches, &job->ps->particles, job->first + begin, job->first + end);
+}
+
+// Repousse la particule hors de la boîte par la face la plus proche. La
+// vitesse (position moins position précédente) perd sa composante entrante
+// et la fraction `friction` du reste.
+static int collide_particle(ParticleSoA* p, int i, const ParticleCollider* c, float radius, float friction) {
+    Vec3D pos = {p->x[i], p->y[i], p->z[i]};
+    Vec3D d = vec3_sub(pos, c->center);
+    float reach = c->radius + radius;
+    if (vec3_dot(d, d) >= reach * reach) {
+        return 0;
+    }
+    Vec3D l = quat_rotate(quat_conjugate(c->orientation), d);
+    Vec3D h = {c->half.x + radius, c->half.y + radius, c->half.z + radius};
+    Vec3D depth = {h.x - fabsf(l.x), h.y - fabsf(l.y), h.z - fabsf(l.z)};
+    if (depth.x <= 0.0f || depth.y <= 0.0f || depth.z <= 0.0f) {
+        return 0;
+    }
+    Vec3D axis;
+    if (depth.x <= depth.y && depth.x <= depth.z) {
+        l.x = copysignf(h.x, l.x);
+        axis = (Vec3D){copysignf(1.0f, l.x), 0.0f, 0.0f};
+    } else if (depth.y <= depth.z) {
+        l.y = copysignf(h.y, l.y);
+        axis = (Vec3D){0.0f, copysignf(1.0f, l.y), 0.0f};
+    } else {
+        l.z = copysignf(h.z, l.z);
+        axis = (Vec3D){0.0f, 0.0f, copysignf(1.0f, l.z)};
+    }
+    Vec3D n = quat_rotate(c->orientation, axis);
+    Vec3D moved = vec3_add(c->center, quat_rotate(c->orientation, l));
+    Vec3D v = vec3_sub(pos, (Vec3D){p->ox[i], p->oy[i], p->oz[i]});
+    float vn = vec3_dot(v, n);
+    if (vn < 0.0f) {
+        v = vec3_sub(v, vec3_scale(n, vn));
+    }
+    v = vec3_scale(v, 1.0f - friction);
+    p->x[i] = moved.x; p->y[i] = moved.y; p->z[i] = moved.z;
+    p->ox[i] = moved.x - v.x; p->oy[i] = moved.y - v.y; p->oz[i] = moved.z - v.z;
+    return 1;
+}
+
+// Boîtes par paquets : seules celles qui touchent la boîte du morceau sont
+// gardées, puis, parmi elles, celles qui touchent la boîte de chaque groupe
+// de COLLIDER_GROUP particules. Les morceaux suivent l'ordre des sommets,
+// souvent proches dans l'espace (grille, chaîne).
+#define COLLIDER_BLOCK 64
+#define COLLIDER_GROUP 16
+
+static int touches(const ParticleCollider* c, const AABB* box, float radius) {
+    float reach = c->radius + radius;
+    return c->center.x + reach > box->min.x && c->center.x - reach < box->max.x &&
+           c->center.y + reach > box->min.y && c->center.y - reach < box->max.y &&
+           c->center.z + reach > box->min.z && c->center.z - reach < box->max.z;
+}
+
+static void collide_range(void* ctx, int begin, int end, int chunk) {
+    ParticleJob* job = (ParticleJob*)ctx;
+    ParticleSystem* ps = job->ps;
+    ParticleSoA* p = &ps->particles;
+    begin += job->first;
+    end += job->first;
+    AABB box = empty_bounds();
+    bounds_range(p, begin, end, &box);
+    float r = ps->radius;
+    int contacts = 0;
+    int near[COLLIDER_BLOCK], nearest[COLLIDER_BLOCK];
+    for (int first = 0; first < ps->num_colliders; first += COLLIDER_BLOCK) {
+        int last = first + COLLIDER_BLOCK < ps->num_colliders ? first + COLLIDER_BLOCK : ps->num_colliders;
+        int num_near = 0;
+        for (int k = first; k < last; ++k) {
+            if (touches(&ps->colliders[k], &box, r)) near[num_near++] = k;
+        }
+        for (int g = begin; g < end && num_near > 0; g += COLLIDER_GROUP) {
+            int g_end = g + COLLIDER_GROUP < end ? g + COLLIDER_GROUP : end;
+            AABB group = empty_bounds();
+            bounds_range(p, g, g_end, &group);
+            int num_nearest = 0;
+            for (int k = 0; k < num_near; ++k) {
+                if (touches(&ps->colliders[near[k]], &group, r)) nearest[num_nearest++] = near[k];
+            }
+            for (int i = g; i < g_end && num_nearest > 0; ++i) {
+                if (p->inv_mass[i] == 0.0f) continue;
+                for (int k = 0; k < num_nearest; ++k) {
+                    contacts += collide_particle(p, i, &ps->colliders[nearest[k]], r, ps->friction);
+                }
+            }
+        }
+    }
+    ps->chunks[chunk].contacts = contacts;
+}
+
+int particle_system_solve(ParticleSystem* ps, JobSystem* jobs) {
+    int n = ps->particles.count - 1;
+    if (n <= 0) {
+        return 1;
+    }
+    if (ps->prepared_iterations != ps->iterations && !prepare(ps)) {
+        return 0;
+    }
+    uint64_t t0 = timer_now_ns();
+    const SimdKernels* k = kernels_get();
+    ParticleJob job = {ps, {0.0f, 0.0f, 0.0f}, 0.0f, 0};
+    for (int it = 0; it < ps->iterations; ++it) {
+        // Les lots d'une couleur sont indépendants ; les couleurs se suivent
+        for (int c = 0; c < PARTICLE_MAX_COLORS; ++c) {
+            int count = ps->color_start[c + 1] - ps->color_start[c];
+            if (count == 0) continue;
+            job.first = ps->color_start[c];
+            job_parallel_for(jobs, count, PARTICLE_BATCH_GRAIN, solve_range, &job);
+        }
+        // Contraintes en excès de couleurs : un lot à la fois
+        k->solve_distances(&ps->batches, &ps->particles, ps->color_start[PARTICLE_MAX_COLORS],
+                           ps->color_start[PARTICLE_MAX_COLORS + 1]);
+    }
+    uint64_t t1 = timer_now_ns();
+    ps->stats.solve_ns = t1 - t0;
+
+    ps->stats.num_colliders = ps->num_colliders;
+    if (ps->num_colliders > 0) {
+        int num_chunks = job_chunk_count(n, PARTICLE_GRAIN);
+        if (!reserve_chunks(ps, num_chunks)) {
+            return 0;
+        }
+        job.first = 1;
+        job_parallel_for(jobs, n, PARTICLE_GRAIN, collide_range, &job);
+        for (int c = 0; c < num_chunks; ++c) {
+            ps->stats.num_contacts += ps->chunks[c].contacts;
+        }
+        ps->stats.collide_ns = timer_now_ns() - t1;
+    }
+    return 1;
+}
@@ -0,0 +1,137 @@
+#ifndef ENGINE_PARTICLES_H
+#define ENGINE_PARTICLES_H
+
+#include <stdint.h>
+#include "jobs.h"
+#include "math3d.h"
+#include "mesh.h"
+#include "soa.h"
+#include "transform.h"
+
+// --- Configuration ---
+#define PARTICLE_LANES 8                // Contraintes par lot : un registre AVX, deux registres SSE
+#define PARTICLE_MAX_COLORS 64          // Au-delà, une contrainte est résolue seule dans son lot
+#define PARTICLE_DEFAULT_ITERATIONS 8
+#define PARTICLE_DEFAULT_DAMPING 0.01f  // Fraction de la vitesse perdue à chaque pas
+#define PARTICLE_DEFAULT_RADIUS 0.02f   // Épaisseur gardée contre les corps rigides
+#define PARTICLE_DEFAULT_FRICTION 0.5f  // Fraction de la vitesse perdue au contact d'un corps
+#define PARTICLE_GRAIN 4096             // Particules par tâche
+#define PARTICLE_BATCH_GRAIN 256        // Lots par tâche
+
+// --- Particules et ressorts (tissus, cordes, corps mous) ---
+// Dynamique par positions : intégration de Verlet (la vitesse est implicite,
+// position moins position précédente), puis projection des contraintes de
+// distance, une par arête des maillages ajoutés, et enfin des particules
+// hors des corps rigides. Les corps rigides ne reçoivent rien en retour.
+//
+// Les contraintes ne changent pas d'un pas à l'autre : elles sont colorées
+// une fois (aucune particule partagée dans une couleur), puis rangées en
+// lots de PARTICLE_LANES. Un lot se résout en SIMD sans conflit d'écriture,
+// et les lots d'une même couleur se répartissent sur les threads ; les
+// couleurs se suivent, comme les passes de Gauss-Seidel qu'elles forment.
+//
+// La particule 0 est un puits, de masse inverse nulle : les cases vides des
+// lots la désignent des deux côtés. Les particules ajoutées commencent à 1.
+// Ni les particules ni leurs contraintes ne font partie des instantanés et
+// du journal des entrées.
+
+// Contraintes rangées par lots, en SoA. Chaque extrémité est déplacée de sa
+// part de la correction, raideur par itération comprise : ka + kb vaut la
+// raideur, répartie selon les masses inverses (0 pour une case vide).
+typedef struct {
+    int *a, *b;
+    float* rest;           // Longueur au repos
+    float *ka, *kb;
+    float* storage;        // Bloc commun à tous les tableaux ci-dessus
+    int num_batches;
+    int capacity;          // En places
+} DistanceBatches;
+
+// Boîte orientée d'un corps rigide, contre laquelle les particules sont projetées
+typedef struct {
+    Vec3D center;
+    Quat orientation;
+    Vec3D half;            // Demi-côtés, échelle comprise
+    float radius;          // Sphère englobante, rejet rapide
+} ParticleCollider;
+
+typedef struct {
+    AABB bounds;
+    int contacts;
+} ParticleChunk;
+
+// Durées (ns) et volumes du dernier pas
+typedef struct {
+    uint64_t integrate_ns;
+    uint64_t solve_ns;     // Toutes les itérations
+    uint64_t collide_ns;
+    int num_colliders;     // Corps dont la boîte touche celle des particules
+    int num_contacts;      // Particules repoussées hors d'un corps
+} ParticleStats;
+
+typedef struct {
+    ParticleSoA particles;   // Puits compris
+
+    // Contraintes dans l'ordre d'ajout : particules, longueur au repos, raideur
+    Edge* edges;
+    float* rest;
+    float* stiffness;
+    int num_constraints;
+    int constraint_capacity;
+
+    // Lots : couleur c dans [color_start[c], color_start[c + 1]) ; la
+    // dernière entrée regroupe les contraintes en excès de couleurs, une par lot
+    DistanceBatches batches;
+    int color_start[PARTICLE_MAX_COLORS + 2];
+    int num_colors;
+    int prepared_iterations; // 0 : lots à reconstruire
+
+    // Boîtes des corps rigides du pas en cours (remplies par le monde)
+    ParticleCollider* colliders;
+    int num_colliders;
+    int collider_capacity;
+
+    // Boîte englobante des particules après l'intégration
+    AABB bounds;
+    ParticleChunk* chunks;   // Résultats par morceau de job_parallel_for
+    int chunk_capacity;
+
+    int iterations;
+    float damping;
+    float radius;
+    float friction;
+    ParticleStats stats;
+} ParticleSystem;
+
+void particle_system_init(ParticleSystem* ps);
+void particle_system_free(ParticleSystem* ps);
+
+// Une particule par sommet de `mesh`, placée par `transform`, et une
+// contrainte de distance par arête (longueur au repos : celle de l'arête
+// placée). `stiffness` dans [0, 1] : 1 rétablit la longueur en une
+// itération. Retourne l'index de la particule du sommet 0, ou -1 en cas
+// d'échec d'allocation (rien n'est alors ajouté).
+int particle_system_add_mesh(ParticleSystem* ps, const Mesh* mesh, const Affine3x4* transform,
+                             float particle_mass, float stiffness);
+
+// Masse inverse d'une particule (0 : fixée à sa position actuelle)
+void particle_system_set_inv_mass(ParticleSystem* ps, int index, float inv_mass);
+
+static inline Vec3D particle_position(const ParticleSystem* ps, int i) {
+    const ParticleSoA* p = &ps->particles;
+    return (Vec3D){p->x[i], p->y[i], p->z[i]};
+}
+
+// Un pas en trois temps. particle_system_integrate avance les particules
+// (Verlet, gravité) et calcule `bounds` ; l'appelant ajoute ensuite les
+// boîtes des corps qui la touchent ; particle_system_solve projette les
+// contraintes puis les particules hors des boîtes. Le découpage du travail
+// ne dépend pas du pool : le résultat est identique au bit près quel que
+// soit le nombre de threads. Retourne 0 en cas d'échec d'allocation.
+int particle_system_integrate(ParticleSystem* ps, Vec3D gravity, float dt, JobSystem* jobs);
+// Vide la liste des boîtes, puis en ajoute une ; NULL en cas d'échec d'allocation
+void particle_system_clear_colliders(ParticleSystem* ps);
+ParticleCollider* particle_system_push_collider(ParticleSystem* ps);
+int particle_system_solve(ParticleSystem* ps, JobSystem* jobs);
+
+#endif
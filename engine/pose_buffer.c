@@ -0,0 +1,137 @@
+#include <math.h>
+#include <string.h>
+#include "pose_buffer.h"
+#include "soa.h"
+#include "timer.h"
+
+#define POSE_FIELDS(X) X(px) X(py) X(pz) X(qx) X(qy) X(qz) X(qw)
+
+void pose_buffer_init(PoseBuffer* b, float fixed_dt) {
+    memset(b, 0, sizeof(*b));
+    b->fixed_dt = fixed_dt;
+    b->back = 0;
+    atomic_init(&b->shared, 1);
+    b->front = 2;
+    b->previous = 3;
+}
+
+void pose_buffer_free(PoseBuffer* b) {
+    for (int i = 0; i < POSE_BUFFER_SLOTS; ++i) {
+#define FREE(f) soa_free_floats(b->slots[i].f);
+        POSE_FIELDS(FREE)
+#undef FREE
+    }
+    memset(b, 0, sizeof(*b));
+}
+
+static int reserve_snapshot(PoseSnapshot* s, int count) {
+    if (count <= s->capacity) {
+        return 1;
+    }
+    int capacity = s->capacity ? s->capacity : 64;
+    while (capacity < count) capacity *= 2;
+    PoseSnapshot grown = *s;
+#define ALLOC(f) grown.f = soa_alloc_floats(capacity);
+    POSE_FIELDS(ALLOC)
+#undef ALLOC
+    int ok = 1;
+#define CHECK(f) ok = ok && grown.f != NULL;
+    POSE_FIELDS(CHECK)
+#undef CHECK
+    // Pas de recopie : l'emplacement est entièrement réécrit à chaque publication
+#define RELEASE(f) soa_free_floats(ok ? s->f : grown.f);
+    POSE_FIELDS(RELEASE)
+#undef RELEASE
+    if (!ok) {
+        return 0;
+    }
+    grown.capacity = capacity;
+    *s = grown;
+    return 1;
+}
+
+int pose_buffer_publish(PoseBuffer* b, const World* world) {
+    PoseSnapshot* s = &b->slots[b->back];
+    int n = world->num_bodies;
+    if (!reserve_snapshot(s, n)) {
+        return 0;
+    }
+    const BodySoA* st = &world->state;
+    for (int id = 0; id < n; ++id) {
+        int k = world->body_slot[id];
+#define COPY(f) s->f[id] = st->f[k];
+        POSE_FIELDS(COPY)
+#undef COPY
+    }
+    s->num_bodies = n;
+    s->step = world->step_count;
+    s->published_ns = timer_now_ns();
+    // acq_rel : les poses écrites sont visibles du lecteur qui prendra cet
+    // emplacement, et l'emplacement rendu n'est plus lu par lui
+    int old = atomic_exchange_explicit(&b->shared, b->back | POSE_BUFFER_FRESH, memory_order_acq_rel);
+    b->back = old & (POSE_BUFFER_FRESH - 1);
+    return 1;
+}
+
+int pose_buffer_acquire(PoseBuffer* b) {
+    if (!(atomic_load_explicit(&b->shared, memory_order_relaxed) & POSE_BUFFER_FRESH)) {
+        return 0;
+    }
+    // L'état le plus ancien retourne à l'écrivain ; le dernier lu devient le précédent
+    int old = atomic_exchange_explicit(&b->shared, b->previous, memory_order_acq_rel);
+    b->previous = b->front;
+    b->front = old & (POSE_BUFFER_FRESH - 1);
+    return 1;
+}
+
+const PoseSnapshot* pose_buffer_latest(const PoseBuffer* b) {
+    const PoseSnapshot* s = &b->slots[b->front];
+    return s->published_ns != 0 ? s : NULL;
+}
+
+float pose_buffer_apply(const PoseBuffer* b, uint64_t now_ns, World* view) {
+    const PoseSnapshot* cur = pose_buffer_latest(b);
+    if (cur == NULL) {
+        return -1.0f;
+    }
+    const PoseSnapshot* prev = &b->slots[b->previous];
+    float alpha = 1.0f;
+    if (prev->published_ns != 0 && prev->step < cur->step) {
+        // Instant affiché : un pas derrière le dernier état, plus le temps écoulé depuis sa publication
+        double span = (double)(cur->step - prev->step) * b->fixed_dt;
+        double behind = (double)b->fixed_dt - (now_ns > cur->published_ns ? (now_ns - cur->published_ns) * 1e-9 : 0.0);
+        double t = span - (behind > 0.0 ? behind : 0.0);
+        alpha = t <= 0.0 ? 0.0f : (float)(t / span);
+    }
+    int n = cur->num_bodies < view->num_bodies ? cur->num_bodies : view->num_bodies;
+    int shared = alpha < 1.0f && prev->published_ns != 0 ? (prev->num_bodies < n ? prev->num_bodies : n) : 0;
+    BodySoA* st = &view->state;
+    float beta = 1.0f - alpha;
+    for (int id = 0; id < shared; ++id) {
+        int k = view->body_slot[id];
+        st->px[k] = prev->px[id] * beta + cur->px[id] * alpha;
+        st->py[k] = prev->py[id] * beta + cur->py[id] * alpha;
+        st->pz[k] = prev->pz[id] * beta + cur->pz[id] * alpha;
+        // Plus court chemin : q et -q sont la même rotation
+        float dot = prev->qx[id] * cur->qx[id] + prev->qy[id] * cur->qy[id] + prev->qz[id] * cur->qz[id] +
+                    prev->qw[id] * cur->qw[id];
+        float a = dot < 0.0f ? -alpha : alpha;
+        float qx = prev->qx[id] * beta + cur->qx[id] * a;
+        float qy = prev->qy[id] * beta + cur->qy[id] * a;
+        float qz = prev->qz[id] * beta + cur->qz[id] * a;
+        float qw = prev->qw[id] * beta + cur->qw[id] * a;
+        float len = sqrtf(qx * qx + qy * qy + qz * qz + qw * qw);
+        float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        st->qx[k] = qx * inv;
+        st->qy[k] = qy * inv;
+        st->qz[k] = qz * inv;
+        st->qw[k] = qw * inv;
+    }
+    for (int id = shared; id < n; ++id) {
+        int k = view->body_slot[id];
+#define COPY(f) st->f[k] = cur->f[id];
+        POSE_FIELDS(COPY)
+#undef COPY
+    }
+    return alpha;
+}
@@ -0,0 +1,57 @@
+#ifndef ENGINE_POSE_BUFFER_H
+#define ENGINE_POSE_BUFFER_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "world.h"
+
+// --- Tampon de poses ---
+// Passage des poses des corps du thread de simulation au thread de rendu,
+// sans verrou : un tampon triple (l'écrivain remplit son emplacement, l'échange
+// contre l'emplacement partagé, le lecteur prend le plus récent) complété d'un
+// quatrième emplacement que le lecteur garde pour interpoler entre ses deux
+// derniers états. Aucun des deux threads n'attend l'autre : une image lente
+// ne retarde pas la simulation, elle saute seulement des états.
+#define POSE_BUFFER_SLOTS 4
+#define POSE_BUFFER_FRESH 0x4 // Bit de l'emplacement partagé : publié, pas encore lu
+
+// État publié : poses par identifiant de corps
+typedef struct {
+    uint64_t step;          // world->step_count au moment de la publication
+    uint64_t published_ns;  // timer_now_ns() ; 0 : emplacement encore vide
+    int num_bodies;
+    int capacity;
+    float *px, *py, *pz;
+    float *qx, *qy, *qz, *qw;
+} PoseSnapshot;
+
+typedef struct {
+    PoseSnapshot slots[POSE_BUFFER_SLOTS];
+    float fixed_dt;
+    _Alignas(64) atomic_int shared; // Emplacement offert (| POSE_BUFFER_FRESH)
+    _Alignas(64) int back;          // Écrivain seul
+    _Alignas(64) int front;         // Lecteur seul : dernier état lu
+    int previous;                   // Lecteur seul : état lu avant `front`
+} PoseBuffer;
+
+void pose_buffer_init(PoseBuffer* b, float fixed_dt);
+void pose_buffer_free(PoseBuffer* b);
+
+// Écrivain : recopie les poses du monde et les publie. Retourne 0 si
+// l'allocation échoue (rien n'est publié).
+int pose_buffer_publish(PoseBuffer* b, const World* world);
+
+// Lecteur : prend l'état le plus récent s'il y en a un nouveau (retourne 1)
+int pose_buffer_acquire(PoseBuffer* b);
+
+// Lecteur : dernier état lu, NULL avant le premier
+const PoseSnapshot* pose_buffer_latest(const PoseBuffer* b);
+
+// Lecteur : écrit dans `view` (monde jamais simulé qui a les mêmes corps) les
+// poses à l'instant now_ns, un pas de simulation en retard sur le dernier
+// état lu : interpolation linéaire des positions et normalisée des
+// orientations entre les deux derniers états lus. Retourne la fraction
+// utilisée (1 : dernier état seul), ou -1 avant le premier état.
+float pose_buffer_apply(const PoseBuffer* b, uint64_t now_ns, World* view);
+
+#endif
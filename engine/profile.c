@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "profile.h"
+
+#if PHYS_PROFILE
+
+typedef struct {
+    uint64_t start_ns;
+    uint64_t end_ns;
+    const char* name;
+} ProfileEvent;
+
+typedef struct {
+    ProfileEvent events[PROFILE_RING_SIZE];
+    atomic_ullong count;  // Événements écrits depuis le début (index = count % taille)
+    int tid;
+    char name[32];
+} ProfileThread;
+
+atomic_int profile_enabled_flag = 0;
+
+static ProfileThread* threads[PROFILE_MAX_THREADS];
+static atomic_int num_threads = 0;
+static uint64_t origin_ns = 0;  // Origine des temps de la trace
+static _Thread_local ProfileThread* tls_thread = NULL;
+static _Thread_local int tls_registered = 0;  // 1 : déjà tenté (succès ou non)
+static _Thread_local char tls_name[32];       // Nom donné avant le premier événement
+
+static ProfileThread* current_thread(void) {
+    if (tls_registered) {
+        return tls_thread;
+    }
+    tls_registered = 1;
+    int tid = atomic_fetch_add(&num_threads, 1);
+    if (tid >= PROFILE_MAX_THREADS) {
+        return NULL; // Trop de threads : les événements de celui-ci sont perdus
+    }
+    ProfileThread* t = (ProfileThread*)mem_calloc(1, sizeof(ProfileThread));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->tid = tid;
+    if (tls_name[0] != '\0') {
+        memcpy(t->name, tls_name, sizeof(t->name));
+    } else {
+        snprintf(t->name, sizeof(t->name), "thread %d", tid);
+    }
+    threads[tid] = t;
+    tls_thread = t;
+    return t;
+}
+
+void profile_record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    ProfileThread* t = current_thread();
+    if (t == NULL) {
+        return;
+    }
+    unsigned long long n = atomic_load_explicit(&t->count, memory_order_relaxed);
+    ProfileEvent* e = &t->events[n & (PROFILE_RING_SIZE - 1)];
+    e->start_ns = start_ns;
+    e->end_ns = end_ns;
+    e->name = name;
+    atomic_store_explicit(&t->count, n + 1, memory_order_release);
+}
+
+void profile_set_enabled(int enabled) {
+    if (enabled && origin_ns == 0) {
+        origin_ns = timer_now_ns();
+    }
+    atomic_store(&profile_enabled_flag, enabled ? 1 : 0);
+}
+
+// Le tampon du thread n'est alloué qu'à son premier événement : nommer un
+// thread qui n'enregistre jamais rien ne coûte rien
+void profile_set_thread_name(const char* name) {
+    snprintf(tls_name, sizeof(tls_name), "%s", name);
+    if (tls_thread != NULL) {
+        memcpy(tls_thread->name, tls_name, sizeof(tls_name));
+    }
+}
+
+// Parcourt les événements conservés du thread t, du plus ancien au plus récent
+#define FOR_EACH_EVENT(t, e) \
+    for (unsigned long long n_ = atomic_load_explicit(&(t)->count, memory_order_acquire), \
+         i_ = n_ > PROFILE_RING_SIZE ? n_ - PROFILE_RING_SIZE : 0; i_ < n_; ++i_) \
+        for (const ProfileEvent* e = &(t)->events[i_ & (PROFILE_RING_SIZE - 1)]; e; e = NULL)
+
+static int registered_threads(void) {
+    int n = atomic_load(&num_threads);
+    return n < PROFILE_MAX_THREADS ? n : PROFILE_MAX_THREADS;
+}
+
+static void write_json_string(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+int profile_write_chrome_trace(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("Impossible de créer %s\n", path);
+        return 0;
+    }
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    int first = 1;
+    for (int k = 0; k < registered_threads(); ++k) {
+        const ProfileThread* t = threads[k];
+        if (t == NULL) continue;
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                first ? "" : ",\n", t->tid);
+        write_json_string(f, t->name);
+        fprintf(f, "}}");
+        first = 0;
+        FOR_EACH_EVENT(t, e) {
+            // Événement complet ("X") : début et durée en microsecondes
+            fprintf(f, ",\n{\"name\":");
+            write_json_string(f, e->name);
+            fprintf(f, ",\"cat\":\"phys\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    t->tid, (double)(e->start_ns - origin_ns) * 1e-3,
+                    (double)(e->end_ns - e->start_ns) * 1e-3);
+        }
+    }
+    fprintf(f, "\n]}\n");
+    if (fclose(f) != 0) {
+        printf("Écriture incomplète de %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+void profile_print_summary(FILE* out) {
+    size_t total = 0;
+    for (int k = 0; k < registered_threads(); ++k) {
+        if (threads[k] == NULL) continue;
+        unsigned long long n = atomic_load(&threads[k]->count);
+        total += n < PROFILE_RING_SIZE ? n : PROFILE_RING_SIZE;
+    }
+    if (total == 0) {
+        return;
+    }
+    const char** names = (const char**)mem_alloc(total * sizeof(const char*));
+    uint64_t* durations = (uint64_t*)mem_alloc(total * sizeof(uint64_t));
+    if (names == NULL || durations == NULL) {
+        mem_free(names);
+        mem_free(durations);
+        return;
+    }
+    // Liste des portées distinctes (les noms sont des littéraux : comparaison de contenu
+    // pour regrouper les mêmes noms venant de plusieurs unités de compilation)
+    size_t num_names = 0;
+    for (int k = 0; k < registered_threads(); ++k) {
+        if (threads[k] == NULL) continue;
+        FOR_EACH_EVENT(threads[k], e) {
+            size_t j = 0;
+            while (j < num_names && names[j] != e->name && strcmp(names[j], e->name) != 0) ++j;
+            if (j == num_names) names[num_names++] = e->name;
+        }
+    }
+
+    fprintf(out, "%-24s %8s %10s %10s %10s\n", "portée", "nombre", "p50 (ms)", "p99 (ms)", "max (ms)");
+    for (size_t j = 0; j < num_names; ++j) {
+        size_t count = 0;
+        for (int k = 0; k < registered_threads(); ++k) {
+            if (threads[k] == NULL) continue;
+            FOR_EACH_EVENT(threads[k], e) {
+                if (e->name == names[j] || strcmp(e->name, names[j]) == 0) {
+                    durations[count++] = e->end_ns - e->start_ns;
+                }
+            }
+        }
+        qsort(durations, count, sizeof(uint64_t), compare_u64);
+        fprintf(out, "%-24s %8zu %10.3f %10.3f %10.3f\n", names[j], count,
+                timer_ns_to_ms(durations[(count - 1) / 2]),
+                timer_ns_to_ms(durations[(count - 1) * 99 / 100]),
+                timer_ns_to_ms(durations[count - 1]));
+    }
+    mem_free(names);
+    mem_free(durations);
+}
+
+#else
+
+void profile_set_enabled(int enabled) { (void)enabled; }
+void profile_set_thread_name(const char* name) { (void)name; }
+int profile_write_chrome_trace(const char* path) {
+    printf("Profilage retiré à la compilation (PHYS_PROFILE=0) : %s non écrit\n", path);
+    return 0;
+}
+void profile_print_summary(FILE* out) { (void)out; }
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef ENGINE_PROFILE_H
+#define ENGINE_PROFILE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "timer.h"
+
+// Instrumentation par portées chronométrées. Chaque thread écrit dans son
+// propre tampon circulaire (aucun verrou sur le chemin chaud) ; les derniers
+// événements sont exportés au format Chrome trace (chrome://tracing, Perfetto)
+// ou résumés en p50/p99 par portée.
+//
+// -DPHYS_PROFILE=0 (option CMake PHYS_ENABLE_PROFILING=OFF) retire tout le code
+// d'instrumentation. Compilée mais désactivée à l'exécution, une portée coûte
+// une lecture atomique et un branchement.
+
+#ifndef PHYS_PROFILE
+#define PHYS_PROFILE 1
+#endif
+
+// --- Configuration ---
+#define PROFILE_RING_SIZE 16384  // Événements conservés par thread (puissance de 2)
+#define PROFILE_MAX_THREADS 64
+
+typedef struct {
+    const char* name;   // Chaîne statique (littéral)
+    uint64_t start_ns;  // 0 : portée ouverte alors que le profilage était désactivé
+} ProfileScope;
+
+#if PHYS_PROFILE
+
+extern atomic_int profile_enabled_flag;
+
+static inline int profile_enabled(void) {
+    return atomic_load_explicit(&profile_enabled_flag, memory_order_relaxed);
+}
+
+// Enregistre un événement terminé dans le tampon du thread courant
+void profile_record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+static inline ProfileScope profile_scope_begin(const char* name) {
+    return (ProfileScope){name, profile_enabled() ? timer_now_ns() : 0};
+}
+
+static inline void profile_scope_end(ProfileScope* scope) {
+    if (scope->start_ns != 0) {
+        profile_record(scope->name, scope->start_ns, timer_now_ns());
+    }
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Chronomètre la fin du bloc englobant (fermeture automatique en sortie de bloc)
+#define PROFILE_SCOPE(name) \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__) \
+        __attribute__((cleanup(profile_scope_end))) = profile_scope_begin(name)
+
+// Portée délimitée à la main, pour les étapes qui ne forment pas un bloc
+#define PROFILE_BEGIN(var, name) ProfileScope var = profile_scope_begin(name)
+#define PROFILE_END(var) profile_scope_end(&(var))
+
+#else
+
+static inline int profile_enabled(void) { return 0; }
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_BEGIN(var, name) ((void)0)
+#define PROFILE_END(var) ((void)0)
+
+#endif
+
+// Active ou suspend l'enregistrement (désactivé au départ)
+void profile_set_enabled(int enabled);
+
+// Nom affiché pour le thread courant dans la trace (copié, 31 caractères au plus)
+void profile_set_thread_name(const char* name);
+
+// Les deux fonctions suivantes lisent les tampons de tous les threads : à
+// appeler quand les autres threads n'enregistrent pas (entre deux images).
+
+// Écrit les événements conservés au format Chrome trace JSON ; 0 en cas d'erreur
+int profile_write_chrome_trace(const char* path);
+
+// Résumé par portée (nombre, p50, p99, max) sur les événements conservés
+void profile_print_summary(FILE* out);
+
+#endif
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "alloc.h"
+#include "raster.h"
+
+int create_framebuffer(Framebuffer* fb, int width, int height) {
+    fb->width = width;
+    fb->height = height;
+    fb->pitch = width;
+    fb->pixels = (uint32_t*)mem_aligned_alloc(64, ((size_t)width * height * sizeof(uint32_t) + 63) & ~(size_t)63);
+    return fb->pixels != NULL;
+}
+
+void free_framebuffer(Framebuffer* fb) {
+    mem_free(fb->pixels);
+    fb->pixels = NULL;
+    fb->width = fb->height = fb->pitch = 0;
+}
+
+void framebuffer_clear(Framebuffer* fb, uint32_t color) {
+    for (int y = 0; y < fb->height; ++y) {
+        uint32_t* row = fb->pixels + (size_t)y * fb->pitch;
+        for (int x = 0; x < fb->width; ++x) {
+            row[x] = color;
+        }
+    }
+}
+
+// --- Découpe de Cohen-Sutherland ---
+enum { OUT_LEFT = 1, OUT_RIGHT = 2, OUT_TOP = 4, OUT_BOTTOM = 8 };
+
+static int outcode(float x, float y, float xmin, float ymin, float xmax, float ymax) {
+    int code = 0;
+    if (x < xmin) code |= OUT_LEFT; else if (x > xmax) code |= OUT_RIGHT;
+    if (y < ymin) code |= OUT_TOP; else if (y > ymax) code |= OUT_BOTTOM;
+    return code;
+}
+
+int clip_line_rect(ScreenLine* l, float xmin, float ymin, float xmax, float ymax) {
+    if (l->x0 != l->x0 || l->y0 != l->y0 || l->x1 != l->x1 || l->y1 != l->y1) {
+        return 0; // NaN : rien de traçable
+    }
+    int c0 = outcode(l->x0, l->y0, xmin, ymin, xmax, ymax);
+    int c1 = outcode(l->x1, l->y1, xmin, ymin, xmax, ymax);
+    for (;;) {
+        if (!(c0 | c1)) return 1;  // Entièrement dedans
+        if (c0 & c1) return 0;     // Entièrement du même côté dehors
+        int c = c0 ? c0 : c1;
+        float x, y;
+        float dx = l->x1 - l->x0, dy = l->y1 - l->y0;
+        if (c & OUT_BOTTOM)     { x = l->x0 + dx * (ymax - l->y0) / dy; y = ymax; }
+        else if (c & OUT_TOP)   { x = l->x0 + dx * (ymin - l->y0) / dy; y = ymin; }
+        else if (c & OUT_RIGHT) { y = l->y0 + dy * (xmax - l->x0) / dx; x = xmax; }
+        else                    { y = l->y0 + dy * (xmin - l->x0) / dx; x = xmin; }
+        if (c == c0) {
+            l->x0 = x; l->y0 = y;
+            c0 = outcode(x, y, xmin, ymin, xmax, ymax);
+        } else {
+            l->x1 = x; l->y1 = y;
+            c1 = outcode(x, y, xmin, ymin, xmax, ymax);
+        }
+    }
+}
+
+// --- Bresenham ---
+// Le segment est toujours découpé contre l'écran entier, puis seuls les pixels
+// du rectangle sont écrits : le tracé ne dépend pas du rectangle, si bien que
+// des tuiles voisines se raccordent sans trou ni doublon.
+void raster_line_rect(Framebuffer* fb, ScreenLine line, uint32_t color,
+                      int rx0, int ry0, int rx1, int ry1) {
+    if (!clip_line_rect(&line, 0.0f, 0.0f, (float)fb->width - 0.001f, (float)fb->height - 0.001f)) {
+        return;
+    }
+    int x0 = (int)line.x0, y0 = (int)line.y0, x1 = (int)line.x1, y1 = (int)line.y1;
+    // Axe principal : u (un pixel par pas), axe secondaire : v
+    int x_major = abs(x1 - x0) >= abs(y1 - y0);
+    int u0 = x_major ? x0 : y0, u1 = x_major ? x1 : y1;
+    int v0 = x_major ? y0 : x0, v1 = x_major ? y1 : x1;
+    if (u1 < u0) {
+        int t = u0; u0 = u1; u1 = t;
+        t = v0; v0 = v1; v1 = t;
+    }
+    int umin = x_major ? rx0 : ry0, umax = x_major ? rx1 : ry1; // [umin, umax)
+    int vmin = x_major ? ry0 : rx0, vmax = x_major ? ry1 : rx1;
+    int ua = u0 > umin ? u0 : umin;
+    int ub = u1 < umax - 1 ? u1 : umax - 1;
+    if (ua > ub) {
+        return;
+    }
+    int du = u1 - u0, dv = abs(v1 - v0), sv = v1 < v0 ? -1 : 1;
+    // v(u) = v0 + sv * floor((2*dv*(u - u0) + du) / (2*du)) : on reprend l'erreur
+    // de Bresenham directement au premier pixel du rectangle
+    int v = v0, err = 0;
+    if (du > 0) {
+        long long num = 2LL * dv * (ua - u0) + du;
+        v = v0 + sv * (int)(num / (2LL * du));
+        err = (int)(num % (2LL * du));
+    }
+    uint32_t* pixels = fb->pixels;
+    size_t step_u = x_major ? 1 : (size_t)fb->pitch;
+    size_t step_v = x_major ? (size_t)fb->pitch : 1;
+    for (int u = ua; u <= ub; ++u) {
+        if (v >= vmin && v < vmax) {
+            pixels[u * step_u + v * step_v] = color;
+        } else if ((sv > 0) == (v >= vmax)) {
+            break; // Sorti du rectangle sans retour possible
+        }
+        err += 2 * dv;
+        if (err >= 2 * du) {
+            err -= 2 * du;
+            v += sv;
+        }
+    }
+}
+
+void raster_line(Framebuffer* fb, ScreenLine line, uint32_t color) {
+    raster_line_rect(fb, line, color, 0, 0, fb->width, fb->height);
+}
+
+void raster_lines(Framebuffer* fb, const ScreenLine* lines, int count, uint32_t color) {
+    for (int i = 0; i < count; ++i) {
+        raster_line_rect(fb, lines[i], color, 0, 0, fb->width, fb->height);
+    }
+}
+
+int framebuffer_write_ppm(const Framebuffer* fb, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        return 0;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", fb->width, fb->height);
+    unsigned char* row = (unsigned char*)mem_alloc((size_t)fb->width * 3);
+    int ok = row != NULL;
+    for (int y = 0; ok && y < fb->height; ++y) {
+        const uint32_t* src = fb->pixels + (size_t)y * fb->pitch;
+        for (int x = 0; x < fb->width; ++x) {
+            row[3 * x + 0] = (unsigned char)(src[x] >> 24);
+            row[3 * x + 1] = (unsigned char)(src[x] >> 16);
+            row[3 * x + 2] = (unsigned char)(src[x] >> 8);
+        }
+        ok = fwrite(row, 3, (size_t)fb->width, f) == (size_t)fb->width;
+    }
+    mem_free(row);
+    return (fclose(f) == 0) && ok;
+}
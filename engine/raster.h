@@ -0,0 +1,42 @@
+#ifndef ENGINE_RASTER_H
+#define ENGINE_RASTER_H
+
+#include <stdint.h>
+
+// Couleur RGBA empaquetée 0xRRGGBBAA (SDL_PIXELFORMAT_RGBA8888)
+#define RGBA(r, g, b, a) \
+    (((uint32_t)(r) << 24) | ((uint32_t)(g) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(a))
+
+// Tampon d'image en mémoire centrale, indépendant de SDL
+typedef struct {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch; // Pixels par ligne
+} Framebuffer;
+
+// Segment en coordonnées écran (pixels, origine en haut à gauche)
+typedef struct {
+    float x0, y0, x1, y1;
+} ScreenLine;
+
+int create_framebuffer(Framebuffer* fb, int width, int height);
+void free_framebuffer(Framebuffer* fb);
+void framebuffer_clear(Framebuffer* fb, uint32_t color);
+
+// Découpe de Cohen-Sutherland contre [xmin, xmax] x [ymin, ymax].
+// Retourne 0 si le segment est entièrement dehors.
+int clip_line_rect(ScreenLine* line, float xmin, float ymin, float xmax, float ymax);
+
+// Bresenham dans le rectangle [x0, x1) x [y0, y1) du tampon ; le segment y est découpé
+void raster_line_rect(Framebuffer* fb, ScreenLine line, uint32_t color,
+                      int x0, int y0, int x1, int y1);
+void raster_line(Framebuffer* fb, ScreenLine line, uint32_t color);
+
+// Trace un lot de segments sans aller-retour par segment vers un pilote
+void raster_lines(Framebuffer* fb, const ScreenLine* lines, int count, uint32_t color);
+
+// Écrit le tampon au format PPM binaire (P6) ; 0 en cas d'erreur
+int framebuffer_write_ppm(const Framebuffer* fb, const char* path);
+
+#endif
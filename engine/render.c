@@ -0,0 +1,513 @@
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "kernels.h"
+#include "profile.h"
+#include "render.h"
+#include "timer.h"
+
+void wire_renderer_init(WireRenderer* r, int width, int height) {
+    memset(r, 0, sizeof(*r));
+    r->width = width;
+    r->height = height;
+    r->tile_size = RENDER_DEFAULT_TILE;
+}
+
+void wire_renderer_free(WireRenderer* r) {
+    arena_free(&r->frame);
+    mem_free(r->lines);
+    mem_free(r->models);
+    mem_free(r->mvps);
+    mem_free(r->draw_list);
+    mem_free(r->bounds);
+    mem_free(r->visible_list);
+    mem_free(r->visible);
+    bvh_free(&r->bvh);
+    mem_free(r->tile_start);
+    mem_free(r->tile_lines);
+    mem_free(r->chunk_counts);
+    memset(r, 0, sizeof(*r));
+}
+
+void wire_renderer_set_tiling(WireRenderer* r, JobSystem* jobs, int tile_size) {
+    r->jobs = jobs;
+    r->tile_size = tile_size;
+}
+
+void wire_renderer_set_culling(WireRenderer* r, int enabled) {
+    r->culling = enabled;
+}
+
+void wire_renderer_begin(WireRenderer* r) {
+    r->num_lines = 0;
+    arena_reset(&r->frame);
+    memset(&r->stats, 0, sizeof(r->stats));
+}
+
+// Tampons de sommets d'une soumission, pris dans l'arène de l'image et
+// arrondis à un multiple de 8 comme ceux de soa_alloc_floats
+static int alloc_vertices(WireRenderer* r, int count) {
+    size_t n = (size_t)((count + 7) & ~7);
+    if (n == 0) n = 8;
+    float** fields[6] = {&r->cx, &r->cy, &r->cz, &r->cw, &r->sx, &r->sy};
+    for (int k = 0; k < 6; ++k) {
+        *fields[k] = (float*)arena_alloc(&r->frame, n * sizeof(float), SOA_ALIGNMENT);
+        if (*fields[k] == NULL) {
+            return 0;
+        }
+    }
+    r->codes = (uint8_t*)arena_alloc(&r->frame, n, 1);
+    return r->codes != NULL;
+}
+
+static int reserve_ints(int** array, int* capacity, int count) {
+    if (count <= *capacity) {
+        return 1;
+    }
+    int new_capacity = *capacity ? *capacity : 256;
+    while (new_capacity < count) new_capacity *= 2;
+    int* grown = (int*)mem_realloc(*array, (size_t)new_capacity * sizeof(int));
+    if (grown == NULL) {
+        return 0;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+static int reserve_lines(WireRenderer* r, int count) {
+    if (count <= r->line_capacity) {
+        return 1;
+    }
+    int capacity = r->line_capacity ? r->line_capacity : 256;
+    while (capacity < count) capacity *= 2;
+    ScreenLine* lines = (ScreenLine*)mem_realloc(r->lines, capacity * sizeof(ScreenLine));
+    if (lines == NULL) {
+        return 0;
+    }
+    r->lines = lines;
+    r->line_capacity = capacity;
+    return 1;
+}
+
+// Division perspective et viewport des sommets [first, first + count), pour
+// les seuls sommets dans le tronc (les autres ne sont jamais divisés)
+static void project_vertices(WireRenderer* r, int first, int count) {
+    clip_outcodes(r->cx + first, r->cy + first, r->cz + first, r->cw + first, r->codes + first,
+                  count, CLIP_DEPTH_ZERO_TO_ONE);
+    float half_w = 0.5f * (float)r->width, half_h = 0.5f * (float)r->height;
+    for (int i = first; i < first + count; ++i) {
+        float inv_w = r->codes[i] ? 0.0f : 1.0f / r->cw[i];
+        r->sx[i] = (r->cx[i] * inv_w + 1.0f) * half_w;
+        r->sy[i] = (1.0f - r->cy[i] * inv_w) * half_h; // Y inversé
+    }
+}
+
+// Une arête (sommets a et b des tampons) : acceptée telle quelle, rejetée, ou
+// découpée aux plans traversés
+static inline void clip_edge(WireRenderer* r, int a, int b, float half_w, float half_h) {
+    int code_a = r->codes[a], code_b = r->codes[b];
+    if ((code_a | code_b) == 0 && r->cw[a] > 0.0f && r->cw[b] > 0.0f) {
+        r->stats.clip.accepted++;
+        r->lines[r->num_lines++] = (ScreenLine){r->sx[a], r->sy[a], r->sx[b], r->sy[b]};
+        return;
+    }
+    float pa[4] = {r->cx[a], r->cy[a], r->cz[a], r->cw[a]};
+    float pb[4] = {r->cx[b], r->cy[b], r->cz[b], r->cw[b]};
+    ClipResult result = clip_segment(pa, pb, code_a, code_b, pa, pb, CLIP_DEPTH_ZERO_TO_ONE);
+    clip_stats_add(&r->stats.clip, result);
+    if (result == CLIP_CULLED) return;
+    float inv_a = 1.0f / pa[3], inv_b = 1.0f / pb[3];
+    r->lines[r->num_lines++] = (ScreenLine){(pa[0] * inv_a + 1.0f) * half_w, (1.0f - pa[1] * inv_a) * half_h,
+                                            (pb[0] * inv_b + 1.0f) * half_w, (1.0f - pb[1] * inv_b) * half_h};
+}
+
+// Arêtes (indices relatifs à `base`)
+static void clip_edges(WireRenderer* r, int base, const Edge* edges, int num_edges) {
+    float half_w = 0.5f * (float)r->width, half_h = 0.5f * (float)r->height;
+    for (int i = 0; i < num_edges; ++i) {
+        clip_edge(r, base + edges[i].v1_idx, base + edges[i].v2_idx, half_w, half_h);
+    }
+    r->stats.num_edges += num_edges;
+    r->stats.num_lines = r->num_lines;
+}
+
+// Arêtes d'un maillage partagé, lues dans son flux d'index compressés
+// (deux fois moins d'octets que `edges`) quand il en a un
+static void clip_mesh_edges(WireRenderer* r, int base, const MeshAsset* mesh) {
+    float half_w = 0.5f * (float)r->width, half_h = 0.5f * (float)r->height;
+    const uint16_t* s = mesh->edge_stream;
+    if (mesh->edge_format == EDGE_INDEX_16) {
+        for (int i = 0; i < mesh->num_edges; ++i, s += 2) {
+            clip_edge(r, base + s[0], base + s[1], half_w, half_h);
+        }
+    } else if (mesh->edge_format == EDGE_INDEX_DELTA) {
+        int prev = 0, a, b;
+        for (int i = 0; i < mesh->num_edges; ++i) {
+            s = edge_delta_next(s, &prev, &a, &b);
+            clip_edge(r, base + a, base + b, half_w, half_h);
+        }
+    } else {
+        clip_edges(r, base, mesh->edges, mesh->num_edges);
+        return;
+    }
+    r->stats.num_edges += mesh->num_edges;
+    r->stats.num_lines = r->num_lines;
+}
+
+int wire_renderer_add_mesh(WireRenderer* r, const Mat4x4* mvp,
+                           const float* x, const float* y, const float* z, int num_vertices,
+                           const Edge* edges, int num_edges) {
+    if (!alloc_vertices(r, num_vertices) || !reserve_lines(r, r->num_lines + num_edges)) {
+        return 0;
+    }
+    uint64_t start = timer_now_ns();
+
+    // 1-2. Transformation Modèle-Vue-Projection en un lot
+    PROFILE_BEGIN(transform, "transform");
+    kernels_get()->transform_points(mvp, x, y, z, r->cx, r->cy, r->cz, r->cw, num_vertices);
+    PROFILE_END(transform);
+
+    PROFILE_BEGIN(clip, "clip");
+    project_vertices(r, 0, num_vertices);
+    clip_edges(r, 0, edges, num_edges);
+    PROFILE_END(clip);
+    r->stats.transform_ns += timer_now_ns() - start;
+    return 1;
+}
+
+// Réserve les tampons par corps du monde (liste, matrices, boîtes) ; ceux
+// des sommets et des segments le sont par add_bodies, pour les seuls corps retenus
+static int reserve_world(WireRenderer* r, const World* world) {
+    if (!reserve_ints(&r->draw_list, &r->draw_list_capacity, world->num_bodies)) {
+        return 0;
+    }
+    if (world->num_bodies > r->body_capacity) {
+        int capacity = world->num_bodies;
+#define GROW(field, type)                                                      \
+    do {                                                                       \
+        type* grown = (type*)mem_realloc(r->field, (size_t)capacity * sizeof(type)); \
+        if (grown == NULL) return 0;                                           \
+        r->field = grown;                                                      \
+    } while (0)
+        GROW(models, Affine3x4);
+        GROW(mvps, Mat4x4);
+        GROW(bounds, AABB);
+        GROW(visible_list, int);
+        GROW(visible, uint8_t);
+#undef GROW
+        r->body_capacity = capacity;
+    }
+    return 1;
+}
+
+// Ne garde de draw_list[0..count) que les corps dont la boîte monde (r->bounds)
+// n'est pas entièrement hors du tronc, dans le même ordre. Retourne le nouveau
+// compte, ou -1 en cas d'échec d'allocation.
+static int cull_bodies(WireRenderer* r, int num_bodies, int count, const Mat4x4* view_proj) {
+    PROFILE_SCOPE("cull");
+    uint64_t start = timer_now_ns();
+    if (!bvh_update(&r->bvh, r->bounds, num_bodies)) {
+        return -1;
+    }
+    Frustum frustum;
+    frustum_from_matrix(&frustum, view_proj, CLIP_DEPTH_ZERO_TO_ONE);
+    int num_visible = bvh_query_frustum(&r->bvh, &frustum, r->visible_list);
+    memset(r->visible, 0, (size_t)num_bodies);
+    for (int k = 0; k < num_visible; ++k) {
+        r->visible[r->visible_list[k]] = 1;
+    }
+    int kept = 0;
+    for (int j = 0; j < count; ++j) {
+        int i = r->draw_list[j];
+        if (r->visible[i]) r->draw_list[kept++] = i;
+    }
+    r->stats.num_culled += count - kept;
+    r->stats.num_refit += r->bvh.num_refit;
+    r->stats.cull_ns += timer_now_ns() - start;
+    return kept;
+}
+
+// Matrices MVP des corps retenus, à partir de leur matrice monde
+static void compute_mvps(WireRenderer* r, int count, const Mat4x4* view_proj) {
+    PROFILE_SCOPE("mvp");
+    for (int j = 0; j < count; ++j) {
+        int i = r->draw_list[j];
+        r->mvps[i] = affine_mul_mat4(&r->models[i], view_proj);
+    }
+}
+
+// Transforme puis découpe les corps de draw_list, avec les matrices de r->mvps.
+// Les corps sont d'abord groupés par maillage (tri par dénombrement, ordre de
+// draw_list conservé dans chaque groupe) : les sommets et les arêtes d'un
+// maillage restent en cache pendant que toutes ses instances sont traitées,
+// et les sommets transformés de chaque instance se suivent dans les tampons.
+// Chaque étape est appliquée à tous les corps avant la suivante : elle reste
+// une boucle serrée et apparaît d'un bloc dans le profil. Retourne 0 en cas
+// d'échec d'allocation.
+static int add_bodies(WireRenderer* r, const World* world, int count) {
+    int num_meshes = world->num_meshes;
+    int* group_start = ARENA_NEW(&r->frame, int, num_meshes + 1);
+    int* grouped = ARENA_NEW(&r->frame, int, count);
+    if (group_start == NULL || grouped == NULL) {
+        return 0;
+    }
+    memset(group_start, 0, (size_t)(num_meshes + 1) * sizeof(int));
+    for (int j = 0; j < count; ++j) {
+        group_start[world->body_mesh[r->draw_list[j]] + 1]++;
+    }
+    int num_vertices = 0, num_edges = 0;
+    for (int m = 0; m < num_meshes; ++m) {
+        num_vertices += group_start[m + 1] * world->meshes[m]->num_vertices;
+        num_edges += group_start[m + 1] * world->meshes[m]->num_edges;
+        group_start[m + 1] += group_start[m];
+    }
+    for (int j = 0; j < count; ++j) {
+        int i = r->draw_list[j];
+        grouped[group_start[world->body_mesh[i]]++] = i;
+    }
+    // group_start[m] pointe maintenant sur la fin du groupe m
+    if (!alloc_vertices(r, num_vertices) || !reserve_lines(r, r->num_lines + num_edges)) {
+        return 0;
+    }
+
+    PROFILE_BEGIN(transform, "transform");
+    const SimdKernels* k = kernels_get();
+    for (int m = 0, j = 0, base = 0; m < num_meshes; ++m) {
+        const MeshAsset* mesh = world->meshes[m];
+        for (; j < group_start[m]; ++j, base += mesh->num_vertices) {
+            k->transform_points(&r->mvps[grouped[j]], mesh->x, mesh->y, mesh->z,
+                                r->cx + base, r->cy + base, r->cz + base, r->cw + base,
+                                mesh->num_vertices);
+        }
+    }
+    PROFILE_END(transform);
+
+    PROFILE_BEGIN(clip, "clip");
+    for (int m = 0, j = 0, base = 0; m < num_meshes; ++m) {
+        const MeshAsset* mesh = world->meshes[m];
+        for (; j < group_start[m]; ++j, base += mesh->num_vertices) {
+            project_vertices(r, base, mesh->num_vertices);
+            clip_mesh_edges(r, base, mesh);
+        }
+    }
+    PROFILE_END(clip);
+    return 1;
+}
+
+int wire_renderer_add_world(WireRenderer* r, const World* world, const Mat4x4* view_proj) {
+    if (!reserve_world(r, world)) {
+        return 0;
+    }
+    const BodySoA* s = &world->state;
+    uint64_t start = timer_now_ns();
+
+    PROFILE_BEGIN(matrices, "matrices");
+    for (int i = 0; i < world->num_bodies; ++i) {
+        r->models[i] = affine_from_trs((Vec3D){s->px[i], s->py[i], s->pz[i]},
+                                       (Quat){s->qx[i], s->qy[i], s->qz[i], s->qw[i]},
+                                       world->bodies[i].scale);
+        r->draw_list[i] = i;
+    }
+    if (r->culling) {
+        for (int i = 0; i < world->num_bodies; ++i) {
+            r->bounds[i] = affine_transform_aabb(&r->models[i], &world->bodies[i].mesh->bounds);
+        }
+    }
+    PROFILE_END(matrices);
+
+    int count = world->num_bodies;
+    r->stats.num_bodies += count;
+    if (r->culling && (count = cull_bodies(r, world->num_bodies, count, view_proj)) < 0) {
+        return 0;
+    }
+    compute_mvps(r, count, view_proj);
+    int ok = add_bodies(r, world, count);
+    r->stats.transform_ns += timer_now_ns() - start;
+    return ok;
+}
+
+int wire_renderer_add_scene(WireRenderer* r, const World* world, const SceneGraph* sg,
+                            const Mat4x4* view_proj) {
+    if (!reserve_world(r, world)) {
+        return 0;
+    }
+    uint64_t start = timer_now_ns();
+
+    // Les matrices monde viennent du cache du graphe : un seul produit affine par corps
+    PROFILE_BEGIN(matrices, "matrices");
+    if (r->culling) {
+        // Corps sans nœud : boîte vide, jamais visible
+        AABB empty = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+        for (int i = 0; i < world->num_bodies; ++i) {
+            r->bounds[i] = empty;
+        }
+    }
+    int count = 0;
+    for (int n = 0; n < sg->count; ++n) {
+        int i = world_body_slot(world, sg->body[n]);
+        if (i < 0) continue;
+        r->models[i] = sg->world[n];
+        if (r->culling) {
+            r->bounds[i] = affine_transform_aabb(&sg->world[n], &world->bodies[i].mesh->bounds);
+        }
+        r->draw_list[count++] = i;
+    }
+    PROFILE_END(matrices);
+
+    r->stats.num_bodies += count;
+    if (r->culling && (count = cull_bodies(r, world->num_bodies, count, view_proj)) < 0) {
+        return 0;
+    }
+    compute_mvps(r, count, view_proj);
+    int ok = add_bodies(r, world, count);
+    r->stats.transform_ns += timer_now_ns() - start;
+    return ok;
+}
+
+// --- Tuilage ---
+
+typedef struct {
+    WireRenderer* r;
+    Framebuffer* fb;
+    uint32_t color;
+    int num_tiles;
+} TileContext;
+
+// Tuile d'une coordonnée pixel : décalage si la taille est une puissance de 2
+static inline int tile_of(const WireRenderer* r, int v) {
+    return r->tile_shift >= 0 ? v >> r->tile_shift : v / r->tile_size;
+}
+
+// Parcourt les tuiles réellement touchées par le segment i. Sans `cursor`,
+// incrémente counts[t] ; sinon écrit i en tile_lines[cursor[t]++].
+static void bin_line(WireRenderer* r, const Framebuffer* fb, int i, int* counts, int* cursor) {
+    ScreenLine* line = &r->lines[i];
+    if (cursor == NULL) {
+        // Première passe : le segment est découpé une fois pour toutes contre l'écran
+        if (!clip_line_rect(line, 0.0f, 0.0f, (float)fb->width - 0.001f, (float)fb->height - 0.001f)) {
+            line->x0 = line->x1 = -1.0f; // Invisible : rejeté aussi au tramage
+            return;
+        }
+    } else if (line->x0 < 0.0f) {
+        return;
+    }
+    // Les pixels tracés restent dans la boîte des extrémités entières
+    int x0 = (int)line->x0, y0 = (int)line->y0, x1 = (int)line->x1, y1 = (int)line->y1;
+    int ts = r->tile_size;
+    int tx0 = tile_of(r, x0 < x1 ? x0 : x1), tx1 = tile_of(r, x0 < x1 ? x1 : x0);
+    int ty0 = tile_of(r, y0 < y1 ? y0 : y1), ty1 = tile_of(r, y0 < y1 ? y1 : y0);
+    // Segment en diagonale sur plusieurs tuiles : on écarte celles qu'il ne fait
+    // que frôler par sa boîte. Le tracé s'écarte d'au plus un demi-pixel de la
+    // droite entre extrémités entières, d'où la marge d'un pixel.
+    int exact = tx0 != tx1 && ty0 != ty1;
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            if (exact) {
+                ScreenLine probe = {(float)x0, (float)y0, (float)x1, (float)y1};
+                if (!clip_line_rect(&probe, (float)(tx * ts - 1), (float)(ty * ts - 1),
+                                    (float)((tx + 1) * ts), (float)((ty + 1) * ts))) {
+                    continue;
+                }
+            }
+            int t = ty * r->tiles_x + tx;
+            if (cursor == NULL) counts[t]++;
+            else r->tile_lines[cursor[t]++] = i;
+        }
+    }
+}
+
+static void count_lines_job(void* ctx, int begin, int end, int chunk) {
+    TileContext* c = (TileContext*)ctx;
+    int* counts = c->r->chunk_counts + (size_t)chunk * c->num_tiles;
+    memset(counts, 0, (size_t)c->num_tiles * sizeof(int));
+    for (int i = begin; i < end; ++i) {
+        bin_line(c->r, c->fb, i, counts, NULL);
+    }
+}
+
+static void fill_lines_job(void* ctx, int begin, int end, int chunk) {
+    TileContext* c = (TileContext*)ctx;
+    int* cursor = c->r->chunk_counts + (size_t)chunk * c->num_tiles;
+    for (int i = begin; i < end; ++i) {
+        bin_line(c->r, c->fb, i, NULL, cursor);
+    }
+}
+
+static void raster_tiles_job(void* ctx, int begin, int end, int chunk) {
+    TileContext* c = (TileContext*)ctx;
+    const WireRenderer* r = c->r;
+    int ts = r->tile_size;
+    (void)chunk;
+    PROFILE_SCOPE("raster_tiles");
+    for (int t = begin; t < end; ++t) {
+        int x0 = (t % r->tiles_x) * ts, y0 = (t / r->tiles_x) * ts;
+        int x1 = x0 + ts < c->fb->width ? x0 + ts : c->fb->width;
+        int y1 = y0 + ts < c->fb->height ? y0 + ts : c->fb->height;
+        for (int k = r->tile_start[t]; k < r->tile_start[t + 1]; ++k) {
+            raster_line_rect(c->fb, r->lines[r->tile_lines[k]], c->color, x0, y0, x1, y1);
+        }
+    }
+}
+
+// Répartition en deux passes parallèles (comptage puis remplissage) : chaque
+// morceau de segments a sa propre ligne de compteurs, et l'ordre des segments
+// dans une tuile reste celui de soumission, quel que soit le nombre de threads.
+static int bin_lines(WireRenderer* r, TileContext* c) {
+    PROFILE_SCOPE("bin");
+    int num_chunks = job_chunk_count(r->num_lines, RENDER_BIN_GRAIN);
+    int num_tiles = c->num_tiles;
+    if (!reserve_ints(&r->tile_start, &r->tile_capacity, num_tiles + 1) ||
+        !reserve_ints(&r->chunk_counts, &r->chunk_count_capacity, num_chunks * num_tiles)) {
+        return 0;
+    }
+    job_parallel_for(r->jobs, r->num_lines, RENDER_BIN_GRAIN, count_lines_job, c);
+
+    // Comptes -> positions de départ, tuile par tuile puis morceau par morceau
+    int offset = 0;
+    for (int t = 0; t < num_tiles; ++t) {
+        r->tile_start[t] = offset;
+        for (int k = 0; k < num_chunks; ++k) {
+            int* slot = &r->chunk_counts[(size_t)k * num_tiles + t];
+            int n = *slot;
+            *slot = offset;
+            offset += n;
+        }
+    }
+    r->tile_start[num_tiles] = offset;
+    if (!reserve_ints(&r->tile_lines, &r->tile_line_capacity, offset)) {
+        return 0;
+    }
+    job_parallel_for(r->jobs, r->num_lines, RENDER_BIN_GRAIN, fill_lines_job, c);
+    r->stats.num_binned = offset;
+    return 1;
+}
+
+void wire_renderer_draw(WireRenderer* r, Framebuffer* fb, uint32_t color) {
+    uint64_t start = timer_now_ns();
+    if (r->tile_size > 0) {
+        r->tiles_x = (fb->width + r->tile_size - 1) / r->tile_size;
+        r->tiles_y = (fb->height + r->tile_size - 1) / r->tile_size;
+        r->tile_shift = -1;
+        for (int k = 0; k < 31; ++k) {
+            if (r->tile_size == 1 << k) r->tile_shift = k;
+        }
+        TileContext c = {r, fb, color, r->tiles_x * r->tiles_y};
+        if (bin_lines(r, &c)) {
+            uint64_t binned = timer_now_ns();
+            r->stats.bin_ns += binned - start;
+            r->stats.num_tiles = c.num_tiles;
+            int grain = c.num_tiles / (8 * job_system_num_threads(r->jobs));
+            PROFILE_SCOPE("raster");
+            job_parallel_for(r->jobs, c.num_tiles, grain > 0 ? grain : 1, raster_tiles_job, &c);
+            r->stats.raster_ns += timer_now_ns() - binned;
+            return;
+        }
+        // Allocation impossible : tramage séquentiel sans tuiles
+    }
+    PROFILE_BEGIN(raster, "raster");
+    raster_lines(fb, r->lines, r->num_lines, color);
+    PROFILE_END(raster);
+    r->stats.raster_ns += timer_now_ns() - start;
+}
@@ -0,0 +1,114 @@
+#ifndef ENGINE_RENDER_H
+#define ENGINE_RENDER_H
+
+#include <stdint.h>
+#include "alloc.h"
+#include "bvh.h"
+#include "clip.h"
+#include "jobs.h"
+#include "math3d.h"
+#include "mesh.h"
+#include "raster.h"
+#include "scene.h"
+#include "world.h"
+
+// --- Configuration ---
+#define RENDER_DEFAULT_TILE 64   // Côté des tuiles en pixels
+#define RENDER_BIN_GRAIN 4096    // Segments par tâche de répartition
+
+typedef struct {
+    int num_bodies;     // Corps soumis
+    int num_culled;     // Corps écartés par le tronc avant toute transformation de sommets
+    int num_refit;      // Nœuds de la hiérarchie recalculés
+    uint64_t cull_ns;   // Boîtes monde, réajustement et parcours (compris dans transform_ns)
+    int num_edges;      // Arêtes soumises
+    ClipStats clip;     // Arêtes rejetées / raccourcies / acceptées par la découpe
+    int num_lines;      // Segments envoyés au tramage
+    int num_tiles;      // Tuiles de l'écran (0 sans tuilage)
+    int num_binned;     // Références segment -> tuile après répartition
+    uint64_t transform_ns;
+    uint64_t bin_ns;    // Répartition des segments dans les tuiles
+    uint64_t raster_ns;
+} RenderStats;
+
+// Rendu filaire logiciel : les sommets sont transformés par lots (noyaux SoA),
+// les arêtes sont découpées contre le tronc de vue en espace homogène, et
+// seules les arêtes visibles, projetées, s'accumulent dans une liste de segments, puis toute la
+// liste est tramée d'un coup dans un Framebuffer.
+// Avec le tuilage, les segments sont d'abord répartis dans des tuiles carrées ;
+// chaque tuile est ensuite tramée par un seul thread, qui est le seul à écrire
+// dans ses pixels (aucune opération atomique).
+typedef struct {
+    Arena frame;              // Tampons de l'image en cours, rendus par wire_renderer_begin
+    float *cx, *cy, *cz, *cw; // Sommets en espace de découpe (pris dans `frame` à chaque soumission)
+    float *sx, *sy;           // Sommets projetés à l'écran (valides si code == 0)
+    uint8_t* codes;           // Codes de sortie des sommets
+    Affine3x4* models;        // Matrice monde de chaque corps
+    Mat4x4* mvps;             // Matrice modèle-vue-projection de chaque corps
+    int body_capacity;
+    int* draw_list;           // Corps à projeter, dans l'ordre de soumission
+    int draw_list_capacity;
+
+    // Élagage par le tronc de vue (culling = 0 : tous les corps sont projetés)
+    int culling;
+    Bvh bvh;                  // Sur les boîtes monde des corps, réajustée à chaque image
+    AABB* bounds;             // Boîte monde de chaque corps
+    int* visible_list;        // Résultat du parcours de la hiérarchie
+    uint8_t* visible;         // Drapeau par corps, pour garder l'ordre de soumission
+    ScreenLine* lines;
+    int num_lines;
+    int line_capacity;
+    int width, height;        // Fenêtre d'affichage en pixels
+
+    // Tuilage (tile_size <= 0 : tramage séquentiel de toute la liste)
+    JobSystem* jobs;          // Non possédé ; NULL = tuiles traitées par le thread appelant
+    int tile_size;
+    int tile_shift;           // log2(tile_size) si puissance de 2, sinon -1
+    int tiles_x, tiles_y;
+    int* tile_start;          // tiles + 1 entrées : segments de la tuile t = tile_lines[tile_start[t]..tile_start[t+1])
+    int* tile_lines;          // Index dans `lines`, dans l'ordre de soumission
+    int* chunk_counts;        // Comptes par (morceau de segments, tuile) pour la répartition parallèle
+    int tile_capacity;
+    int tile_line_capacity;
+    int chunk_count_capacity;
+    RenderStats stats;
+} WireRenderer;
+
+void wire_renderer_init(WireRenderer* r, int width, int height);
+void wire_renderer_free(WireRenderer* r);
+
+// Active le tuilage (tile_size > 0) et le pool de threads utilisé pour la
+// répartition et le tramage. Le pool n'est pas possédé par le rendu.
+void wire_renderer_set_tiling(WireRenderer* r, JobSystem* jobs, int tile_size);
+
+// Active l'élagage : chaque corps est enfermé dans la boîte monde de la boîte
+// locale de son maillage (MeshAsset.bounds), et les corps dont la boîte est hors du tronc ne
+// sont ni transformés ni découpés. L'image est identique au pixel près.
+void wire_renderer_set_culling(WireRenderer* r, int enabled);
+
+// Vide la liste de segments, rend les tampons de l'image précédente et remet
+// les statistiques à zéro. À appeler à chaque image : les tampons de sommets
+// de chaque soumission s'accumulent jusque-là.
+void wire_renderer_begin(WireRenderer* r);
+
+// Projette un maillage (sommets SoA en repère local) ; 0 en cas d'échec d'allocation
+int wire_renderer_add_mesh(WireRenderer* r, const Mat4x4* mvp,
+                           const float* x, const float* y, const float* z, int num_vertices,
+                           const Edge* edges, int num_edges);
+
+// Projette tous les corps du monde avec la matrice vue-projection donnée.
+// Les instances d'un même maillage sont traitées d'un bloc, pendant que ses
+// sommets et ses arêtes sont en cache.
+int wire_renderer_add_world(WireRenderer* r, const World* world, const Mat4x4* view_proj);
+
+// Projette les corps pilotés par les nœuds du graphe, avec leurs matrices monde
+// en cache (scene_graph_update doit avoir été appelé). Les corps sans nœud ne
+// sont pas dessinés.
+int wire_renderer_add_scene(WireRenderer* r, const World* world, const SceneGraph* sg,
+                            const Mat4x4* view_proj);
+
+// Trame les segments accumulés dans `fb` ; le résultat est identique au pixel
+// près avec ou sans tuilage, quel que soit le nombre de threads
+void wire_renderer_draw(WireRenderer* r, Framebuffer* fb, uint32_t color);
+
+#endif
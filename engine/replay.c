@@ -0,0 +1,385 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "alloc.h"
+#include "replay.h"
+
+_Static_assert(sizeof(ReplayFileHeader) == 64, "en-tête de journal : 64 octets attendus");
+_Static_assert(sizeof(ReplayEventHeader) % REPLAY_EVENT_ALIGN == 0, "en-tête d'événement mal aligné");
+
+// --- Contenu des événements ---
+
+// REPLAY_ADD_BODY (body = -1) et REPLAY_UPDATE_BODY. Un ajout désigne le
+// maillage du corps par son index dans world->meshes ; la première instance
+// d'un maillage est suivie de ses sommets puis de ses arêtes.
+typedef struct {
+    int32_t body;
+    int32_t mesh;
+    int32_t has_geometry;
+    int32_t num_vertices;
+    int32_t num_edges;
+    Vec3D position, velocity;
+    Quat orientation;
+    Vec3D angular_velocity;
+    Vec3D scale;
+    float mass, inv_mass;
+    int32_t ccd;
+} BodyEvent;
+
+// REPLAY_WAKE_BODY et REPLAY_IMPULSE
+typedef struct {
+    int32_t body;
+    Vec3D impulse, point;
+} ImpulseEvent;
+
+typedef struct {
+    int32_t type, a, b;
+    Vec3D anchor, axis;
+} JointEvent;
+
+// REPLAY_REMOVE_JOINT
+typedef struct {
+    int32_t joint;
+} RemoveJointEvent;
+
+static size_t align_event(size_t size) {
+    return (size + REPLAY_EVENT_ALIGN - 1) & ~(size_t)(REPLAY_EVENT_ALIGN - 1);
+}
+
+void replay_init(ReplayLog* log, uint64_t start_step) {
+    memset(log, 0, sizeof(*log));
+    log->start_step = start_step;
+    log->size = sizeof(ReplayFileHeader);
+    log->cursor = sizeof(ReplayFileHeader);
+}
+
+void replay_free(ReplayLog* log) {
+    mem_free(log->data);
+    replay_init(log, 0);
+}
+
+// Place d'un événement de `payload` octets, en-tête rempli ; NULL en cas
+// d'échec d'allocation (le journal est alors marqué comme incomplet)
+static void* append_event(ReplayLog* log, uint64_t step, ReplayEventType type, size_t payload) {
+    size_t size = align_event(sizeof(ReplayEventHeader) + payload);
+    if (log->failed || size > UINT32_MAX) {
+        log->failed = 1;
+        return NULL;
+    }
+    if (log->size + size > log->capacity) {
+        size_t capacity = log->capacity ? log->capacity : 4096;
+        while (capacity < log->size + size) capacity *= 2;
+        unsigned char* data = (unsigned char*)mem_realloc(log->data, capacity);
+        if (data == NULL) {
+            log->failed = 1;
+            return NULL;
+        }
+        log->data = data;
+        log->capacity = capacity;
+    }
+    unsigned char* event = log->data + log->size;
+    memset(event, 0, size);
+    ReplayEventHeader header = {step, (uint32_t)type, (uint32_t)size};
+    memcpy(event, &header, sizeof(header));
+    log->size += size;
+    log->num_events++;
+    return event + sizeof(header);
+}
+
+static BodyEvent body_event(int body, const Object3D* obj) {
+    return (BodyEvent){body, -1, 0, 0, 0, obj->position, obj->velocity, obj->orientation,
+                       obj->angular_velocity, obj->scale, obj->mass, obj->inv_mass, obj->ccd};
+}
+
+void replay_record_add_body(ReplayLog* log, uint64_t step, const Object3D* obj, int mesh, int new_mesh) {
+    const MeshAsset* m = obj->mesh;
+    int num_vertices = new_mesh ? m->num_vertices : 0;
+    int num_edges = new_mesh ? m->num_edges : 0;
+    size_t vertex_bytes = (size_t)num_vertices * sizeof(Vec3D);
+    size_t edge_bytes = (size_t)num_edges * sizeof(Edge);
+    char* p = (char*)append_event(log, step, REPLAY_ADD_BODY, sizeof(BodyEvent) + vertex_bytes + edge_bytes);
+    if (p == NULL) {
+        return;
+    }
+    BodyEvent e = body_event(-1, obj);
+    e.mesh = mesh;
+    e.has_geometry = new_mesh != 0;
+    e.num_vertices = num_vertices;
+    e.num_edges = num_edges;
+    memcpy(p, &e, sizeof(e));
+    Vec3D* vertices = (Vec3D*)(p + sizeof(e));
+    for (int i = 0; i < num_vertices; ++i) {
+        vertices[i] = mesh_asset_vertex(m, i);
+    }
+    if (edge_bytes > 0) {
+        memcpy(p + sizeof(e) + vertex_bytes, m->edges, edge_bytes);
+    }
+}
+
+void replay_record_update_body(ReplayLog* log, uint64_t step, int body, const Object3D* obj) {
+    void* p = append_event(log, step, REPLAY_UPDATE_BODY, sizeof(BodyEvent));
+    if (p != NULL) {
+        BodyEvent e = body_event(body, obj);
+        memcpy(p, &e, sizeof(e));
+    }
+}
+
+void replay_record_wake_body(ReplayLog* log, uint64_t step, int body) {
+    void* p = append_event(log, step, REPLAY_WAKE_BODY, sizeof(ImpulseEvent));
+    if (p != NULL) {
+        ImpulseEvent e = {body, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+        memcpy(p, &e, sizeof(e));
+    }
+}
+
+void replay_record_impulse(ReplayLog* log, uint64_t step, int body, Vec3D impulse, Vec3D point) {
+    void* p = append_event(log, step, REPLAY_IMPULSE, sizeof(ImpulseEvent));
+    if (p != NULL) {
+        ImpulseEvent e = {body, impulse, point};
+        memcpy(p, &e, sizeof(e));
+    }
+}
+
+void replay_record_joint(ReplayLog* log, uint64_t step, JointType type, int a, int b,
+                         Vec3D anchor, Vec3D axis) {
+    void* p = append_event(log, step, REPLAY_JOINT, sizeof(JointEvent));
+    if (p != NULL) {
+        JointEvent e = {(int32_t)type, a, b, anchor, axis};
+        memcpy(p, &e, sizeof(e));
+    }
+}
+
+void replay_record_remove_joint(ReplayLog* log, uint64_t step, int joint) {
+    void* p = append_event(log, step, REPLAY_REMOVE_JOINT, sizeof(RemoveJointEvent));
+    if (p != NULL) {
+        RemoveJointEvent e = {joint};
+        memcpy(p, &e, sizeof(e));
+    }
+}
+
+// --- Fichier ---
+
+int replay_save(ReplayLog* log, const char* path) {
+    if (log->failed) {
+        printf("Journal incomplet (allocation impossible) : %s non écrit\n", path);
+        return 0;
+    }
+    ReplayFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_FILE_VERSION;
+    header.header_size = sizeof(ReplayFileHeader);
+    header.start_step = log->start_step;
+    header.num_events = (uint64_t)log->num_events;
+    header.data_size = log->size - sizeof(ReplayFileHeader);
+    if (log->data == NULL) {
+        // Journal sans événement : seul l'en-tête est écrit
+        log->data = (unsigned char*)mem_alloc(sizeof(header));
+        if (log->data == NULL) {
+            return 0;
+        }
+        log->capacity = sizeof(header);
+    }
+    memcpy(log->data, &header, sizeof(header));
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("Impossible de créer %s\n", path);
+        return 0;
+    }
+    size_t done = 0;
+    while (done < log->size) {
+        ssize_t n = write(fd, log->data + done, log->size - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    if (close(fd) != 0 || done != log->size) {
+        printf("Écriture incomplète de %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+// Vérifie l'enchaînement des événements : tailles, types et pas croissants
+static int check_events(const unsigned char* data, size_t size) {
+    uint64_t last_step = 0;
+    for (size_t at = sizeof(ReplayFileHeader); at < size; ) {
+        ReplayEventHeader h;
+        if (size - at < sizeof(h)) {
+            return 0;
+        }
+        memcpy(&h, data + at, sizeof(h));
+        if (h.size < sizeof(h) || h.size % REPLAY_EVENT_ALIGN != 0 || h.size > size - at ||
+            h.type < REPLAY_ADD_BODY || h.type > REPLAY_REMOVE_JOINT || h.step < last_step) {
+            return 0;
+        }
+        size_t payload = h.size - sizeof(h);
+        size_t needed = h.type == REPLAY_ADD_BODY || h.type == REPLAY_UPDATE_BODY ? sizeof(BodyEvent)
+                        : h.type == REPLAY_JOINT                                 ? sizeof(JointEvent)
+                        : h.type == REPLAY_REMOVE_JOINT                          ? sizeof(RemoveJointEvent)
+                                                                                  : sizeof(ImpulseEvent);
+        if (payload < needed) {
+            return 0;
+        }
+        if (h.type == REPLAY_ADD_BODY) {
+            BodyEvent e;
+            memcpy(&e, data + at + sizeof(h), sizeof(e));
+            if (e.mesh < 0 || e.has_geometry < 0 || e.has_geometry > 1 || e.num_vertices < 0 || e.num_edges < 0 ||
+                (uint64_t)e.num_vertices * sizeof(Vec3D) + (uint64_t)e.num_edges * sizeof(Edge) >
+                    payload - sizeof(e)) {
+                return 0;
+            }
+        }
+        last_step = h.step;
+        at += h.size;
+    }
+    return 1;
+}
+
+int replay_load(ReplayLog* log, const char* path) {
+    replay_init(log, 0);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Impossible d'ouvrir %s\n", path);
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ReplayFileHeader)) {
+        printf("%s : fichier trop court\n", path);
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)st.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("Projection en mémoire impossible pour %s\n", path);
+        return 0;
+    }
+
+    const ReplayFileHeader* h = (const ReplayFileHeader*)mapping;
+    const char* error = NULL;
+    if (memcmp(h->magic, REPLAY_FILE_MAGIC, sizeof(h->magic)) != 0) error = "signature inconnue";
+    else if (h->version != REPLAY_FILE_VERSION) error = "version non prise en charge";
+    else if (h->header_size != sizeof(ReplayFileHeader)) error = "disposition incompatible";
+    else if (h->data_size != size - sizeof(ReplayFileHeader) || h->num_events > INT32_MAX ||
+             !check_events((const unsigned char*)mapping, size)) error = "événements incohérents";
+    if (error == NULL) {
+        log->data = (unsigned char*)mem_alloc(size);
+        if (log->data == NULL) error = "allocation impossible";
+    }
+    if (error != NULL) {
+        printf("%s : %s\n", path, error);
+        munmap(mapping, size);
+        return 0;
+    }
+    memcpy(log->data, mapping, size);
+    log->size = log->capacity = size;
+    log->start_step = h->start_step;
+    log->num_events = (int)h->num_events;
+    munmap(mapping, size);
+    return 1;
+}
+
+// --- Rejeu ---
+
+static int apply_event(World* world, const ReplayEventHeader* h, const unsigned char* payload) {
+    switch ((ReplayEventType)h->type) {
+    case REPLAY_ADD_BODY: {
+        BodyEvent e;
+        memcpy(&e, payload, sizeof(e));
+        Object3D obj;
+        if (e.has_geometry) {
+            // Nouveau maillage : géométrie lue sur place dans le journal,
+            // recopiée par create_object_from_mesh, ajoutée au monde en dernier
+            Mesh geometry = {(Vec3D*)(payload + sizeof(e)), e.num_vertices,
+                             (Edge*)(payload + sizeof(e) + (size_t)e.num_vertices * sizeof(Vec3D)),
+                             e.num_edges, NULL, 0};
+            if (e.mesh != world->num_meshes || !create_object_from_mesh(&obj, &geometry)) {
+                return 0;
+            }
+        } else if (e.mesh < world->num_meshes) {
+            create_object_instance(&obj, world->meshes[e.mesh]);
+        } else {
+            return 0;
+        }
+        obj.position = e.position;
+        obj.velocity = e.velocity;
+        obj.orientation = e.orientation;
+        obj.angular_velocity = e.angular_velocity;
+        obj.scale = e.scale;
+        obj.mass = e.mass;
+        obj.inv_mass = e.inv_mass;
+        obj.ccd = e.ccd;
+        if (world_add_body(world, &obj) < 0) {
+            free_object(&obj);
+            return 0;
+        }
+        return 1;
+    }
+    case REPLAY_UPDATE_BODY: {
+        BodyEvent e;
+        memcpy(&e, payload, sizeof(e));
+        Object3D* body = world_get_body(world, e.body);
+        if (body == NULL) {
+            return 0;
+        }
+        body->position = e.position;
+        body->velocity = e.velocity;
+        body->orientation = e.orientation;
+        body->angular_velocity = e.angular_velocity;
+        body->scale = e.scale;
+        body->mass = e.mass;
+        body->inv_mass = e.inv_mass;
+        body->ccd = e.ccd;
+        world_update_body(world, e.body);
+        return 1;
+    }
+    case REPLAY_WAKE_BODY:
+    case REPLAY_IMPULSE: {
+        ImpulseEvent e;
+        memcpy(&e, payload, sizeof(e));
+        if (world_body_slot(world, e.body) < 0) {
+            return 0;
+        }
+        if (h->type == REPLAY_WAKE_BODY) world_wake_body(world, e.body);
+        else world_apply_impulse(world, e.body, e.impulse, e.point);
+        return 1;
+    }
+    case REPLAY_JOINT: {
+        JointEvent e;
+        memcpy(&e, payload, sizeof(e));
+        return !pool_handle_is_null(world_add_joint(world, (JointType)e.type, e.a, e.b, e.anchor, e.axis));
+    }
+    case REPLAY_REMOVE_JOINT: {
+        RemoveJointEvent e;
+        memcpy(&e, payload, sizeof(e));
+        if (e.joint < 0 || e.joint >= world->num_joints) {
+            return 0;
+        }
+        return world_remove_joint(world, world->joint_list[e.joint]);
+    }
+    }
+    return 0;
+}
+
+int replay_apply(ReplayLog* log, World* world) {
+    int applied = 0;
+    while (log->cursor < log->size) {
+        ReplayEventHeader h;
+        memcpy(&h, log->data + log->cursor, sizeof(h));
+        if (h.step > world->step_count) {
+            break;
+        }
+        if (h.step < world->step_count ||
+            !apply_event(world, &h, log->data + log->cursor + sizeof(h))) {
+            return -1;
+        }
+        log->cursor += h.size;
+        applied++;
+    }
+    return applied;
+}
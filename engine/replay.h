@@ -0,0 +1,97 @@
+#ifndef ENGINE_REPLAY_H
+#define ENGINE_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "math3d.h"
+#include "object3d.h"
+#include "solver.h"
+#include "world.h"
+
+// --- Journal des entrées ---
+// Un monde dont `recorder` désigne un journal y inscrit chaque appel qui
+// modifie son état en dehors de world_step (world_add_body, world_update_body,
+// world_wake_body, world_apply_impulse, world_add_joint, world_remove_joint),
+// avec son step_count
+// au moment de l'appel. Rejoués aux mêmes pas depuis le même état (instantané
+// de snapshot.h) et avec les mêmes réglages, ces appels redonnent le même état
+// au bit près : world_step ne dépend de rien d'autre, en mode déterministe
+// avec un pool de threads. Les réglages modifiés en cours de route (gravité,
+// itérations, phase large...) ne sont pas consignés.
+//
+// Fichier : en-tête de 64 octets puis les événements tels qu'ils sont en
+// mémoire, chacun précédé d'un ReplayEventHeader et de taille multiple de 8.
+// Petit-boutiste uniquement.
+#define REPLAY_FILE_MAGIC "PHRLOG\r\n" // \r\n : détecte un transfert en mode texte
+#define REPLAY_FILE_VERSION 3
+#define REPLAY_EVENT_ALIGN 8
+
+typedef enum {
+    REPLAY_ADD_BODY = 1,
+    REPLAY_UPDATE_BODY,
+    REPLAY_WAKE_BODY,
+    REPLAY_IMPULSE,
+    REPLAY_JOINT,
+    REPLAY_REMOVE_JOINT  // Articulation désignée par sa position dans world->joint_list
+} ReplayEventType;
+
+typedef struct {
+    uint64_t step;   // step_count du monde au moment de l'appel
+    uint32_t type;   // ReplayEventType
+    uint32_t size;   // Octets de l'événement, en-tête compris
+} ReplayEventHeader;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;  // sizeof(ReplayFileHeader)
+    uint64_t start_step;   // step_count du monde au début de l'enregistrement
+    uint64_t num_events;
+    uint64_t data_size;    // Octets d'événements après l'en-tête
+    uint8_t reserved[24];
+} ReplayFileHeader;
+
+// Le tampon est l'image du fichier : en-tête (rempli à l'écriture) puis
+// événements, écrits d'un seul bloc par replay_save
+struct ReplayLog {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    uint64_t start_step;
+    int num_events;
+    int failed;      // Un événement n'a pas pu être consigné (allocation)
+    size_t cursor;   // Prochain événement à rejouer, en octets depuis le début
+};
+
+// Journal vide dont le premier pas est `start_step` (world->step_count)
+void replay_init(ReplayLog* log, uint64_t start_step);
+void replay_free(ReplayLog* log);
+
+// Inscription (appelée par world.c quand world->recorder est défini)
+// `mesh` : index du maillage de `obj` dans world->meshes ; sa géométrie n'est
+// consignée que pour sa première instance (`new_mesh`)
+void replay_record_add_body(ReplayLog* log, uint64_t step, const Object3D* obj, int mesh, int new_mesh);
+void replay_record_update_body(ReplayLog* log, uint64_t step, int body, const Object3D* obj);
+void replay_record_wake_body(ReplayLog* log, uint64_t step, int body);
+void replay_record_impulse(ReplayLog* log, uint64_t step, int body, Vec3D impulse, Vec3D point);
+void replay_record_joint(ReplayLog* log, uint64_t step, JointType type, int a, int b,
+                         Vec3D anchor, Vec3D axis);
+void replay_record_remove_joint(ReplayLog* log, uint64_t step, int joint);
+
+// Écrit le journal d'un seul bloc ; 0 en cas d'erreur (ou si un événement a été perdu)
+int replay_save(ReplayLog* log, const char* path);
+
+// Charge un journal (projeté en mémoire puis recopié) ; 0 en cas d'erreur,
+// message sur la sortie standard
+int replay_load(ReplayLog* log, const char* path);
+
+// Applique les événements consignés pour le pas world->step_count, à appeler
+// avant chaque world_step. Retourne le nombre d'événements appliqués, ou -1 si
+// le journal est incohérent avec le monde (pas déjà dépassé, corps invalide).
+// Le journal rejoué ne doit pas être world->recorder.
+int replay_apply(ReplayLog* log, World* world);
+
+// 1 quand tous les événements ont été rejoués
+static inline int replay_done(const ReplayLog* log) { return log->cursor >= log->size; }
+
+#endif
@@ -0,0 +1,102 @@
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "profile.h"
+#include "scene.h"
+
+void scene_graph_init(SceneGraph* sg) {
+    memset(sg, 0, sizeof(*sg));
+}
+
+void scene_graph_free(SceneGraph* sg) {
+    mem_free(sg->parent);
+    mem_free(sg->body);
+    mem_free(sg->local);
+    mem_free(sg->world);
+    mem_free(sg->dirty);
+    mem_free(sg->changed);
+    scene_graph_init(sg);
+}
+
+static int reserve_nodes(SceneGraph* sg, int count) {
+    if (count <= sg->capacity) {
+        return 1;
+    }
+    int capacity = sg->capacity ? sg->capacity * 2 : 64;
+    while (capacity < count) capacity *= 2;
+    // Chaque tableau est agrandi séparément : en cas d'échec, ceux déjà
+    // agrandis restent valides et la capacité n'est pas modifiée
+#define GROW(field, type)                                                      \
+    do {                                                                       \
+        type* grown = (type*)mem_realloc(sg->field, (size_t)capacity * sizeof(type)); \
+        if (grown == NULL) return 0;                                           \
+        sg->field = grown;                                                     \
+    } while (0)
+    GROW(parent, int);
+    GROW(body, int);
+    GROW(local, SceneTransform);
+    GROW(world, Affine3x4);
+    GROW(dirty, uint8_t);
+    GROW(changed, uint8_t);
+#undef GROW
+    sg->capacity = capacity;
+    return 1;
+}
+
+int scene_graph_add_node(SceneGraph* sg, int parent, int body, SceneTransform local) {
+    if (parent < -1 || parent >= sg->count || !reserve_nodes(sg, sg->count + 1)) {
+        return -1;
+    }
+    int node = sg->count++;
+    sg->parent[node] = parent;
+    sg->body[node] = body;
+    sg->local[node] = local;
+    sg->dirty[node] = 1;
+    sg->changed[node] = 0;
+    return node;
+}
+
+void scene_graph_set_local(SceneGraph* sg, int node, SceneTransform local) {
+    if (node < 0 || node >= sg->count) {
+        return;
+    }
+    sg->local[node] = local;
+    sg->dirty[node] = 1;
+}
+
+void scene_graph_sync_world(SceneGraph* sg, const World* world) {
+    const BodySoA* s = &world->state;
+    for (int i = 0; i < sg->count; ++i) {
+        int b = world_body_slot(world, sg->body[i]);
+        if (b < 0) continue;
+        SceneTransform* t = &sg->local[i];
+        Vec3D position = {s->px[b], s->py[b], s->pz[b]};
+        Quat orientation = {s->qx[b], s->qy[b], s->qz[b], s->qw[b]};
+        if (memcmp(&t->position, &position, sizeof(Vec3D)) != 0 ||
+            memcmp(&t->orientation, &orientation, sizeof(Quat)) != 0 ||
+            memcmp(&t->scale, &world->bodies[b].scale, sizeof(Vec3D)) != 0) {
+            t->position = position;
+            t->orientation = orientation;
+            t->scale = world->bodies[b].scale;
+            sg->dirty[i] = 1;
+        }
+    }
+}
+
+void scene_graph_update(SceneGraph* sg) {
+    PROFILE_SCOPE("scene_update");
+    int updated = 0;
+    for (int i = 0; i < sg->count; ++i) {
+        int p = sg->parent[i];
+        // Le parent précède toujours l'enfant : son drapeau est déjà à jour
+        int recompute = sg->dirty[i] || (p >= 0 && sg->changed[p]);
+        sg->changed[i] = (uint8_t)recompute;
+        if (!recompute) continue;
+        const SceneTransform* t = &sg->local[i];
+        Affine3x4 local = affine_from_trs(t->position, t->orientation, t->scale);
+        sg->world[i] = (p >= 0) ? affine_mul(&local, &sg->world[p]) : local;
+        sg->dirty[i] = 0;
+        updated++;
+    }
+    sg->num_updated = updated;
+}
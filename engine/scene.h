@@ -0,0 +1,56 @@
+#ifndef ENGINE_SCENE_H
+#define ENGINE_SCENE_H
+
+#include <stdint.h>
+#include "math3d.h"
+#include "transform.h"
+#include "world.h"
+
+// Transformation locale d'un nœud : Scale -> Rotate -> Translate
+typedef struct {
+    Vec3D position;
+    Quat orientation;
+    Vec3D scale;
+} SceneTransform;
+
+// Graphe de scène hiérarchique, stocké à plat dans l'ordre topologique : le
+// parent d'un nœud a toujours un index inférieur au sien, si bien qu'une
+// seule passe du début à la fin met à jour tout l'arbre.
+// Chaque nœud garde sa matrice monde en cache. Seuls les nœuds modifiés
+// depuis la dernière mise à jour, et leurs descendants, sont recalculés ;
+// un nœud immobile ne coûte qu'un test de drapeaux.
+typedef struct {
+    int* parent;            // -1 pour une racine
+    int* body;              // Corps du monde piloté par le nœud, -1 si aucun
+    SceneTransform* local;
+    Affine3x4* world;       // local puis world[parent]
+    uint8_t* dirty;         // Transformation locale modifiée depuis la mise à jour
+    uint8_t* changed;       // Matrice monde recalculée à la dernière mise à jour
+    int count;
+    int capacity;
+    int num_updated;        // Nœuds recalculés par la dernière mise à jour
+} SceneGraph;
+
+void scene_graph_init(SceneGraph* sg);
+void scene_graph_free(SceneGraph* sg);
+
+// Ajoute un nœud sous `parent` (-1 : racine, sinon un nœud existant).
+// Le nœud peut piloter le corps `body` du monde (-1 : nœud de regroupement).
+// Retourne l'index du nœud, ou -1 (parent invalide ou échec d'allocation).
+int scene_graph_add_node(SceneGraph* sg, int parent, int body, SceneTransform local);
+
+// Remplace la transformation locale et marque le nœud comme modifié
+void scene_graph_set_local(SceneGraph* sg, int node, SceneTransform local);
+
+// Reprend la pose des corps du monde (position, orientation) comme transformation
+// locale de leur nœud ; seuls les nœuds dont la pose a changé sont marqués.
+void scene_graph_sync_world(SceneGraph* sg, const World* world);
+
+// Recalcule les matrices monde des nœuds modifiés et de leurs descendants
+void scene_graph_update(SceneGraph* sg);
+
+static inline const Affine3x4* scene_graph_world_matrix(const SceneGraph* sg, int node) {
+    return &sg->world[node];
+}
+
+#endif
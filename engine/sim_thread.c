@@ -0,0 +1,109 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+#include "alloc.h"
+#include "profile.h"
+#include "sim_thread.h"
+#include "timer.h"
+
+struct SimThread {
+    World* world;
+    PoseBuffer* poses;
+    pthread_t thread;
+    pthread_mutex_t lock;   // Monde et statistiques
+    atomic_int stop;
+    SimThreadStats stats;
+};
+
+static void sleep_until(uint64_t deadline_ns) {
+    struct timespec ts = {(time_t)(deadline_ns / 1000000000ull), (long)(deadline_ns % 1000000000ull)};
+    // Même horloge que timer_now_ns ; réveil anticipé par un signal : la boucle recalcule
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static void* sim_main(void* arg) {
+    SimThread* t = (SimThread*)arg;
+    World* world = t->world;
+    profile_set_thread_name("simulation");
+    uint64_t dt_ns = (uint64_t)((double)world->fixed_dt * 1e9);
+    if (dt_ns == 0) dt_ns = 1;
+    uint64_t next = timer_now_ns() + dt_ns; // Échéance du prochain pas
+    while (!atomic_load_explicit(&t->stop, memory_order_relaxed)) {
+        uint64_t now = timer_now_ns();
+        if (now < next) {
+            sleep_until(next);
+            continue;
+        }
+        pthread_mutex_lock(&t->lock);
+        t->stats.lock_wait_ns += timer_now_ns() - now;
+        int steps = 0;
+        while (now >= next && steps < world->max_substeps) {
+            uint64_t t0 = timer_now_ns();
+            world_step(world);
+            t->stats.step_ns += timer_now_ns() - t0;
+            next += dt_ns;
+            steps++;
+        }
+        if (now >= next) {
+            // Trop de retard : on abandonne le temps restant plutôt que de ralentir davantage
+            uint64_t dropped = (now - next) / dt_ns + 1;
+            t->stats.dropped_steps += dropped;
+            next += dropped * dt_ns;
+        }
+        t->stats.steps += (uint64_t)steps;
+        uint64_t t0 = timer_now_ns();
+        if (pose_buffer_publish(t->poses, world)) {
+            t->stats.publishes++;
+        }
+        t->stats.publish_ns += timer_now_ns() - t0;
+        pthread_mutex_unlock(&t->lock);
+    }
+    return NULL;
+}
+
+SimThread* create_sim_thread(World* world, PoseBuffer* poses) {
+    SimThread* t = (SimThread*)mem_calloc(1, sizeof(SimThread));
+    if (t == NULL || !pose_buffer_publish(poses, world)) {
+        printf("Allocation impossible pour le thread de simulation\n");
+        mem_free(t);
+        return NULL;
+    }
+    t->world = world;
+    t->poses = poses;
+    t->stats.publishes = 1;
+    atomic_init(&t->stop, 0);
+    pthread_mutex_init(&t->lock, NULL);
+    if (pthread_create(&t->thread, NULL, sim_main, t) != 0) {
+        printf("Impossible de créer le thread de simulation\n");
+        pthread_mutex_destroy(&t->lock);
+        mem_free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void sim_thread_lock(SimThread* t) {
+    pthread_mutex_lock(&t->lock);
+}
+
+void sim_thread_unlock(SimThread* t) {
+    pthread_mutex_unlock(&t->lock);
+}
+
+SimThreadStats sim_thread_stats(SimThread* t) {
+    pthread_mutex_lock(&t->lock);
+    SimThreadStats st = t->stats;
+    pthread_mutex_unlock(&t->lock);
+    return st;
+}
+
+void free_sim_thread(SimThread* t) {
+    if (t == NULL) {
+        return;
+    }
+    atomic_store_explicit(&t->stop, 1, memory_order_relaxed);
+    pthread_join(t->thread, NULL);
+    pthread_mutex_destroy(&t->lock);
+    mem_free(t);
+}
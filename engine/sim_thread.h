@@ -0,0 +1,43 @@
+#ifndef ENGINE_SIM_THREAD_H
+#define ENGINE_SIM_THREAD_H
+
+#include <stdint.h>
+#include "pose_buffer.h"
+#include "world.h"
+
+// --- Simulation sur son propre thread ---
+// Le thread avance le monde par pas fixes au rythme de l'horloge (un pas tous
+// les fixed_dt), publie les poses dans un PoseBuffer après chaque rattrapage
+// et dort jusqu'au pas suivant. La cadence d'affichage n'a aucune influence
+// sur la simulation : le rendu lit les poses publiées sans jamais attendre.
+// En retard de plus de world->max_substeps pas, le temps restant est
+// abandonné (compté dans dropped_steps), comme dans world_advance.
+
+typedef struct {
+    uint64_t steps;
+    uint64_t dropped_steps;  // Pas abandonnés faute de temps
+    uint64_t publishes;
+    uint64_t step_ns;        // Temps passé dans world_step
+    uint64_t publish_ns;     // Recopie des poses
+    uint64_t lock_wait_ns;   // Attente du verrou tenu par un autre thread
+} SimThreadStats;
+
+typedef struct SimThread SimThread; // Défini dans sim_thread.c
+
+// Publie l'état initial puis démarre le thread. Le monde et le tampon
+// appartiennent au thread jusqu'à free_sim_thread ; les autres threads ne
+// touchent au monde qu'entre sim_thread_lock et sim_thread_unlock. NULL si
+// le thread ne peut pas être créé (message sur la sortie standard).
+SimThread* create_sim_thread(World* world, PoseBuffer* poses);
+
+// Accès exclusif au monde (entrées : impulsions, corps déplacés...). Le
+// thread de simulation ne l'attend qu'entre deux pas.
+void sim_thread_lock(SimThread* t);
+void sim_thread_unlock(SimThread* t);
+
+SimThreadStats sim_thread_stats(SimThread* t);
+
+// Arrête le thread après son pas en cours et le libère
+void free_sim_thread(SimThread* t);
+
+#endif
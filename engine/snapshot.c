@@ -0,0 +1,536 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "alloc.h"
+#include "snapshot.h"
+
+_Static_assert(sizeof(SnapshotHeader) == 512, "en-tête d'instantané : 512 octets attendus");
+_Static_assert(sizeof(SnapshotBody) == 32, "corps d'instantané : 32 octets attendus");
+_Static_assert(sizeof(SnapshotMesh) == 16, "maillage d'instantané : 16 octets attendus");
+
+#define COUNT_FIELD(f) +1
+#define SNAPSHOT_STATE_FIELDS (0 BODY_SOA_FIELDS(COUNT_FIELD))
+
+static uint64_t align_up(uint64_t value) {
+    return (value + SNAPSHOT_FILE_ALIGN - 1) & ~(uint64_t)(SNAPSHOT_FILE_ALIGN - 1);
+}
+
+// Un tableau de float (champ de BodySoA) dans sa section, remplissage compris
+static uint64_t float_array_bytes(uint32_t count) {
+    return align_up((uint64_t)count * sizeof(float));
+}
+
+// Table des sections d'après les effectifs de l'en-tête ; la taille de l'état
+// de la phase large est la seule à ne pas s'en déduire
+static void layout(SnapshotHeader* h, uint64_t broadphase_size) {
+    uint64_t sizes[SNAPSHOT_NUM_SECTIONS] = {
+        [SNAPSHOT_BODIES] = (uint64_t)h->num_bodies * sizeof(SnapshotBody),
+        [SNAPSHOT_STATE] = SNAPSHOT_STATE_FIELDS * float_array_bytes(h->num_bodies),
+        [SNAPSHOT_MESHES] = (uint64_t)h->num_meshes * sizeof(SnapshotMesh),
+        [SNAPSHOT_VERTICES] = (uint64_t)h->num_vertices * sizeof(Vec3D),
+        [SNAPSHOT_EDGES] = (uint64_t)h->num_edges * sizeof(Edge),
+        [SNAPSHOT_AABBS] = (uint64_t)h->num_bodies * sizeof(AABB),
+        [SNAPSHOT_BODY_SLOT] = (uint64_t)h->num_bodies * sizeof(int32_t),
+        [SNAPSHOT_WAKE_REQUEST] = h->num_bodies,
+        [SNAPSHOT_JOINTS] = (uint64_t)h->num_joints * sizeof(Joint),
+        [SNAPSHOT_JOINT_HANDLES] = (uint64_t)h->num_joints * sizeof(PoolHandle),
+        [SNAPSHOT_MANIFOLDS] = (uint64_t)h->num_manifolds * sizeof(ContactManifold),
+        [SNAPSHOT_BROADPHASE] = broadphase_size,
+    };
+    uint64_t at = align_up(sizeof(SnapshotHeader));
+    for (int s = 0; s < SNAPSHOT_NUM_SECTIONS; ++s) {
+        h->sections[s] = (SnapshotSection){at, sizes[s]};
+        at = align_up(at + sizes[s]);
+    }
+    h->file_size = at;
+}
+
+static void fill_header(const World* world, SnapshotHeader* h) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, SNAPSHOT_FILE_MAGIC, sizeof(h->magic));
+    h->version = SNAPSHOT_FILE_VERSION;
+    h->header_size = sizeof(SnapshotHeader);
+    h->num_bodies = (uint32_t)world->num_bodies;
+    h->num_awake = (uint32_t)world->num_awake;
+    h->num_asleep = (uint32_t)world->num_asleep;
+    h->num_meshes = (uint32_t)world->num_meshes;
+    uint64_t num_vertices = 0, num_edges = 0;
+    for (int m = 0; m < world->num_meshes; ++m) {
+        num_vertices += (uint64_t)world->meshes[m]->num_vertices;
+        num_edges += (uint64_t)world->meshes[m]->num_edges;
+    }
+    h->num_vertices = (uint32_t)num_vertices;
+    h->num_edges = (uint32_t)num_edges;
+    h->num_joints = (uint32_t)world->num_joints;
+    h->num_manifolds = (uint32_t)(world->broadphase != NULL ? world->manifolds.count : 0);
+    h->num_state_fields = SNAPSHOT_STATE_FIELDS;
+    h->body_stride = sizeof(SnapshotBody);
+    h->mesh_stride = sizeof(SnapshotMesh);
+    h->joint_stride = sizeof(Joint);
+    h->manifold_stride = sizeof(ContactManifold);
+    h->num_sections = SNAPSHOT_NUM_SECTIONS;
+
+    h->gravity = world->gravity;
+    h->fixed_dt = world->fixed_dt;
+    h->accumulator = world->accumulator;
+    h->friction = world->friction;
+    h->max_substeps = world->max_substeps;
+    h->solver_iterations = world->solver_iterations;
+    h->narrowphase = (int32_t)world->narrowphase;
+    h->warm_start = world->manifolds.warm_start;
+    h->allow_sleep = world->allow_sleep;
+    h->ccd_threshold = world->ccd_threshold;
+    h->activity_dirty = world->activity_dirty;
+    h->step_count = world->step_count;
+    if (world->broadphase != NULL) {
+        strncpy(h->broadphase, world->broadphase->name, SNAPSHOT_NAME_SIZE - 1);
+    }
+    layout(h, broadphase_state_size(world->broadphase));
+}
+
+size_t world_snapshot_size(const World* world) {
+    SnapshotHeader h;
+    fill_header(world, &h);
+    return (size_t)h.file_size;
+}
+
+// --- Écriture ---
+
+// Le fichier en morceaux consécutifs pour writev : tableaux du monde pris tels
+// quels, parties rassemblées dans un tampon et remplissage
+#define SNAPSHOT_MAX_PARTS (2 * (SNAPSHOT_NUM_SECTIONS + SNAPSHOT_STATE_FIELDS + 3) + 1)
+
+typedef struct {
+    struct iovec parts[SNAPSHOT_MAX_PARTS];
+    int count;
+    uint64_t size; // Octets couverts jusqu'ici
+} PartList;
+
+static const char zeros[SNAPSHOT_FILE_ALIGN];
+
+static void add_part(PartList* list, const void* data, uint64_t size) {
+    if (size > 0) {
+        list->parts[list->count++] = (struct iovec){(void*)data, (size_t)size};
+        list->size += size;
+    }
+}
+
+// Zéros jusqu'à `offset` (moins de SNAPSHOT_FILE_ALIGN octets) : contenu du
+// fichier reproductible d'une sauvegarde à l'autre
+static void pad_to(PartList* list, uint64_t offset) {
+    add_part(list, zeros, offset - list->size);
+}
+
+// Ce qui n'existe pas tel quel dans le monde : en-tête, index des corps et
+// des maillages, géométrie des maillages, articulations (chacune dans son
+// bloc du pool) et état de la phase large
+static uint64_t staging_size(const SnapshotHeader* h) {
+    const SnapshotSection* sec = h->sections;
+    return align_up(sizeof(SnapshotHeader)) + align_up(sec[SNAPSHOT_BODIES].size) +
+           align_up(sec[SNAPSHOT_MESHES].size) + align_up(sec[SNAPSHOT_VERTICES].size) +
+           align_up(sec[SNAPSHOT_EDGES].size) + align_up(sec[SNAPSHOT_JOINTS].size) +
+           align_up(sec[SNAPSHOT_BROADPHASE].size);
+}
+
+static void gather(const World* world, const SnapshotHeader* h, char* staging, PartList* list) {
+    const SnapshotSection* sec = h->sections;
+    int n = world->num_bodies;
+    char* at = staging;
+    memcpy(at, h, sizeof(*h));
+    at += align_up(sizeof(*h));
+    SnapshotBody* records = (SnapshotBody*)at;
+    at += align_up(sec[SNAPSHOT_BODIES].size);
+    SnapshotMesh* meshes = (SnapshotMesh*)at;
+    at += align_up(sec[SNAPSHOT_MESHES].size);
+    Vec3D* vertices = (Vec3D*)at;
+    at += align_up(sec[SNAPSHOT_VERTICES].size);
+    Edge* edges = (Edge*)at;
+    at += align_up(sec[SNAPSHOT_EDGES].size);
+    Joint* joints = (Joint*)at;
+    at += align_up(sec[SNAPSHOT_JOINTS].size);
+    broadphase_save_state(world->broadphase, at);
+
+    for (int k = 0; k < n; ++k) {
+        const Object3D* body = &world->bodies[k];
+        records[k] = (SnapshotBody){world->body_id[k], world->sleep_group[k], world->body_mesh[k],
+                                    body->scale, body->mass, body->ccd};
+    }
+    int vertex_offset = 0, edge_offset = 0;
+    for (int m = 0; m < world->num_meshes; ++m) {
+        const MeshAsset* mesh = world->meshes[m];
+        meshes[m] = (SnapshotMesh){vertex_offset, mesh->num_vertices, edge_offset, mesh->num_edges};
+        for (int i = 0; i < mesh->num_vertices; ++i) {
+            vertices[vertex_offset + i] = mesh_asset_vertex(mesh, i);
+        }
+        if (mesh->num_edges > 0) {
+            memcpy(edges + edge_offset, mesh->edges, (size_t)mesh->num_edges * sizeof(Edge));
+        }
+        vertex_offset += mesh->num_vertices;
+        edge_offset += mesh->num_edges;
+    }
+    for (int j = 0; j < world->num_joints; ++j) {
+        joints[j] = *world_get_joint(world, world->joint_list[j]);
+    }
+
+    list->count = 0;
+    list->size = 0;
+    add_part(list, staging, sizeof(*h));
+    pad_to(list, sec[SNAPSHOT_BODIES].offset);
+    add_part(list, records, sec[SNAPSHOT_BODIES].size);
+
+    uint64_t field = 0, stride = float_array_bytes(h->num_bodies);
+#define ADD_FIELD(f) \
+    pad_to(list, sec[SNAPSHOT_STATE].offset + field++ * stride); \
+    add_part(list, world->state.f, (uint64_t)n * sizeof(float));
+    BODY_SOA_FIELDS(ADD_FIELD)
+#undef ADD_FIELD
+
+    pad_to(list, sec[SNAPSHOT_MESHES].offset);
+    add_part(list, meshes, sec[SNAPSHOT_MESHES].size);
+    pad_to(list, sec[SNAPSHOT_VERTICES].offset);
+    add_part(list, vertices, sec[SNAPSHOT_VERTICES].size);
+    pad_to(list, sec[SNAPSHOT_EDGES].offset);
+    add_part(list, edges, sec[SNAPSHOT_EDGES].size);
+
+    pad_to(list, sec[SNAPSHOT_AABBS].offset);
+    add_part(list, world->aabbs, sec[SNAPSHOT_AABBS].size);
+    pad_to(list, sec[SNAPSHOT_BODY_SLOT].offset);
+    add_part(list, world->body_slot, sec[SNAPSHOT_BODY_SLOT].size);
+    pad_to(list, sec[SNAPSHOT_WAKE_REQUEST].offset);
+    add_part(list, world->wake_request, sec[SNAPSHOT_WAKE_REQUEST].size);
+    pad_to(list, sec[SNAPSHOT_JOINTS].offset);
+    add_part(list, joints, sec[SNAPSHOT_JOINTS].size);
+    pad_to(list, sec[SNAPSHOT_JOINT_HANDLES].offset);
+    add_part(list, world->joint_list, sec[SNAPSHOT_JOINT_HANDLES].size);
+    pad_to(list, sec[SNAPSHOT_MANIFOLDS].offset);
+    add_part(list, world->manifolds.manifolds, sec[SNAPSHOT_MANIFOLDS].size);
+    pad_to(list, sec[SNAPSHOT_BROADPHASE].offset);
+    add_part(list, at, sec[SNAPSHOT_BROADPHASE].size);
+    pad_to(list, h->file_size);
+}
+
+// --- Validation ---
+
+static const char* check_header(const SnapshotHeader* h, size_t size) {
+    if (memcmp(h->magic, SNAPSHOT_FILE_MAGIC, sizeof(h->magic)) != 0) return "signature inconnue";
+    if (h->version != SNAPSHOT_FILE_VERSION) return "version non prise en charge";
+    if (h->header_size != sizeof(SnapshotHeader) || h->body_stride != sizeof(SnapshotBody) ||
+        h->mesh_stride != sizeof(SnapshotMesh) ||
+        h->joint_stride != sizeof(Joint) || h->manifold_stride != sizeof(ContactManifold) ||
+        h->num_state_fields != SNAPSHOT_STATE_FIELDS || h->num_sections != SNAPSHOT_NUM_SECTIONS) {
+        return "disposition incompatible";
+    }
+    if (h->num_bodies > INT32_MAX || h->num_meshes > INT32_MAX || h->num_vertices > INT32_MAX ||
+        h->num_edges > INT32_MAX ||
+        h->num_joints > INT32_MAX || h->num_manifolds > INT32_MAX ||
+        h->num_awake + (uint64_t)h->num_asleep > h->num_bodies || !(h->fixed_dt > 0.0f)) {
+        return "en-tête incohérent";
+    }
+    // La table doit être exactement celle que donnent les effectifs
+    SnapshotHeader expected = *h;
+    layout(&expected, h->sections[SNAPSHOT_BROADPHASE].size);
+    if (memcmp(expected.sections, h->sections, sizeof(h->sections)) != 0 ||
+        expected.file_size != h->file_size || h->file_size != size) {
+        return "table des sections incohérente";
+    }
+    return NULL;
+}
+
+// Index d'un instantané : plages de sommets et d'arêtes contiguës, maillages
+// des corps existants, places et identifiants en bijection, corps des
+// articulations et des variétés valides
+static const char* check_contents(const SnapshotHeader* h, const char* data) {
+    const SnapshotSection* sec = h->sections;
+    const SnapshotBody* records = (const SnapshotBody*)(data + sec[SNAPSHOT_BODIES].offset);
+    const SnapshotMesh* meshes = (const SnapshotMesh*)(data + sec[SNAPSHOT_MESHES].offset);
+    const int32_t* body_slot = (const int32_t*)(data + sec[SNAPSHOT_BODY_SLOT].offset);
+    int n = (int)h->num_bodies;
+    int64_t vertices = 0, edges = 0;
+    for (uint32_t m = 0; m < h->num_meshes; ++m) {
+        const SnapshotMesh* r = &meshes[m];
+        if (r->vertex_offset != vertices || r->edge_offset != edges || r->num_vertices < 0 || r->num_edges < 0) {
+            return "plages de sommets incohérentes";
+        }
+        vertices += r->num_vertices;
+        edges += r->num_edges;
+    }
+    if (vertices != h->num_vertices || edges != h->num_edges) {
+        return "plages de sommets incohérentes";
+    }
+    const Edge* edge_data = (const Edge*)(data + sec[SNAPSHOT_EDGES].offset);
+    for (uint32_t m = 0; m < h->num_meshes; ++m) {
+        const SnapshotMesh* r = &meshes[m];
+        for (int e = r->edge_offset; e < r->edge_offset + r->num_edges; ++e) {
+            if (edge_data[e].v1_idx < 0 || edge_data[e].v1_idx >= r->num_vertices || edge_data[e].v2_idx < 0 ||
+                edge_data[e].v2_idx >= r->num_vertices) {
+                return "arête invalide";
+            }
+        }
+    }
+    for (int k = 0; k < n; ++k) {
+        const SnapshotBody* r = &records[k];
+        if (r->mesh < 0 || (uint32_t)r->mesh >= h->num_meshes) {
+            return "maillage invalide";
+        }
+        if (r->id < 0 || r->id >= n || body_slot[r->id] != k || r->sleep_group < -1 || r->sleep_group >= n) {
+            return "identifiants incohérents";
+        }
+    }
+    const Joint* joints = (const Joint*)(data + sec[SNAPSHOT_JOINTS].offset);
+    const PoolHandle* handles = (const PoolHandle*)(data + sec[SNAPSHOT_JOINT_HANDLES].offset);
+    for (uint32_t j = 0; j < h->num_joints; ++j) {
+        const Joint* joint = &joints[j];
+        if (joint->a < 0 || joint->a >= n || joint->b < 0 || joint->b >= n || joint->a == joint->b ||
+            joint->type < JOINT_BALL || joint->type > JOINT_FIXED || pool_handle_is_null(handles[j]) ||
+            handles[j].index >= (uint32_t)INT32_MAX) {
+            return "articulation invalide";
+        }
+    }
+    const ContactManifold* manifolds = (const ContactManifold*)(data + sec[SNAPSHOT_MANIFOLDS].offset);
+    for (uint32_t p = 0; p < h->num_manifolds; ++p) {
+        const ContactManifold* m = &manifolds[p];
+        if (m->a < 0 || m->a >= m->b || m->b >= n || m->num_points < 0 ||
+            m->num_points > MANIFOLD_MAX_POINTS || m->simplex.count < 0 || m->simplex.count > 4) {
+            return "variété de contact invalide";
+        }
+        for (int k = 0; k < m->simplex.count; ++k) {
+            const SupportPoint* v = &m->simplex.v[k];
+            if (v->ia < 0 || v->ia >= meshes[records[m->a].mesh].num_vertices || v->ib < 0 ||
+                v->ib >= meshes[records[m->b].mesh].num_vertices) {
+                return "variété de contact invalide";
+            }
+        }
+    }
+    return NULL;
+}
+
+// --- Restauration ---
+
+// memcpy sans tableau de destination quand il n'y a rien à copier (monde vide)
+static void copy_bytes(void* out, const void* in, size_t size) {
+    if (size > 0) {
+        memcpy(out, in, size);
+    }
+}
+
+// Monde vide avec les réglages d'exécution de `world` (phase large, pool, journal)
+static void reset_world(World* world, float fixed_dt) {
+    BroadPhase* bp = world->broadphase;
+    JobSystem* jobs = world->jobs;
+    int deterministic = world->deterministic;
+    ReplayLog* recorder = world->recorder;
+    world->broadphase = NULL;
+    free_world(world);
+    create_world(world, fixed_dt);
+    world_set_job_system(world, jobs, deterministic);
+    world_set_broadphase(world, bp);
+    world->recorder = recorder;
+}
+
+static int restore(World* world, const SnapshotHeader* h, const char* data) {
+    const SnapshotSection* sec = h->sections;
+    int n = (int)h->num_bodies;
+    if (!world_reserve(world, n) ||
+        !manifold_cache_set(&world->manifolds, (const ContactManifold*)(data + sec[SNAPSHOT_MANIFOLDS].offset),
+                            (int)h->num_manifolds)) {
+        return 0;
+    }
+    if (h->num_joints > 0) {
+        // Mêmes blocs et mêmes générations : les poignées d'avant la
+        // sauvegarde désignent les mêmes articulations
+        const PoolHandle* handles = (const PoolHandle*)(data + sec[SNAPSHOT_JOINT_HANDLES].offset);
+        const Joint* joints = (const Joint*)(data + sec[SNAPSHOT_JOINTS].offset);
+        world->joint_list = (PoolHandle*)mem_alloc(sec[SNAPSHOT_JOINT_HANDLES].size);
+        if (world->joint_list == NULL || !pool_restore(&world->joints, handles, (int)h->num_joints)) {
+            return 0;
+        }
+        memcpy(world->joint_list, handles, sec[SNAPSHOT_JOINT_HANDLES].size);
+        for (uint32_t j = 0; j < h->num_joints; ++j) {
+            *world_get_joint(world, handles[j]) = joints[j];
+        }
+        world->num_joints = world->joint_capacity = (int)h->num_joints;
+    }
+
+    BodySoA* s = &world->state;
+    uint64_t field = 0, stride = float_array_bytes(h->num_bodies);
+#define GET_FIELD(f) \
+    copy_bytes(s->f, data + sec[SNAPSHOT_STATE].offset + field * stride, (size_t)n * sizeof(float)); \
+    field++;
+    BODY_SOA_FIELDS(GET_FIELD)
+#undef GET_FIELD
+    s->count = n;
+
+    // Maillages dans le même ordre, donc aux mêmes index : le monde en garde
+    // la seule référence jusqu'à ce que les corps prennent la leur
+    const SnapshotMesh* meshes = (const SnapshotMesh*)(data + sec[SNAPSHOT_MESHES].offset);
+    const Vec3D* vertices = (const Vec3D*)(data + sec[SNAPSHOT_VERTICES].offset);
+    const Edge* edges = (const Edge*)(data + sec[SNAPSHOT_EDGES].offset);
+    for (uint32_t m = 0; m < h->num_meshes; ++m) {
+        const SnapshotMesh* r = &meshes[m];
+        Mesh geometry = {(Vec3D*)(vertices + r->vertex_offset), r->num_vertices,
+                         (Edge*)(edges + r->edge_offset), r->num_edges, NULL, 0};
+        MeshAsset* mesh = mesh_asset_create(&geometry);
+        int index = mesh != NULL ? world_mesh_index(world, mesh) : -1;
+        mesh_asset_release(mesh);
+        if (index < 0) {
+            return 0;
+        }
+    }
+
+    // AABB telles qu'à la sauvegarde : celles des corps éveillés seront
+    // recalculées au prochain pas, celles des autres sont à leur pose
+    copy_bytes(world->aabbs, data + sec[SNAPSHOT_AABBS].offset, sec[SNAPSHOT_AABBS].size);
+
+    const SnapshotBody* records = (const SnapshotBody*)(data + sec[SNAPSHOT_BODIES].offset);
+    for (int k = 0; k < n; ++k) {
+        const SnapshotBody* r = &records[k];
+        Object3D* body = &world->bodies[k];
+        *body = (Object3D){.mesh = mesh_asset_retain(world->meshes[r->mesh]),
+                           .position = {s->px[k], s->py[k], s->pz[k]},
+                           .orientation = {s->qx[k], s->qy[k], s->qz[k], s->qw[k]},
+                           .scale = r->scale,
+                           .velocity = {s->vx[k], s->vy[k], s->vz[k]},
+                           .angular_velocity = {s->wx[k], s->wy[k], s->wz[k]},
+                           .mass = r->mass,
+                           .inv_mass = s->inv_mass[k],
+                           .ccd = r->ccd};
+        world->body_mesh[k] = r->mesh;
+        world->body_id[k] = r->id;
+        world->sleep_group[k] = r->sleep_group;
+        world->solver_slot[k] = 0;
+    }
+    world->num_bodies = n;
+    copy_bytes(world->body_slot, data + sec[SNAPSHOT_BODY_SLOT].offset, sec[SNAPSHOT_BODY_SLOT].size);
+    copy_bytes(world->wake_request, data + sec[SNAPSHOT_WAKE_REQUEST].offset, sec[SNAPSHOT_WAKE_REQUEST].size);
+    world->num_awake = (int)h->num_awake;
+    world->num_asleep = (int)h->num_asleep;
+    world->activity_dirty = h->activity_dirty;
+
+    world->gravity = h->gravity;
+    world->accumulator = h->accumulator;
+    world->friction = h->friction;
+    world->max_substeps = h->max_substeps;
+    world->solver_iterations = h->solver_iterations;
+    world->narrowphase = (NarrowPhaseKind)h->narrowphase;
+    world->manifolds.warm_start = h->warm_start;
+    world->allow_sleep = h->allow_sleep;
+    world->ccd_threshold = h->ccd_threshold;
+    world->step_count = h->step_count;
+    return 1;
+}
+
+int world_snapshot_read(World* world, const void* data, size_t size, const char* name) {
+    SnapshotHeader h;
+    if (size < sizeof(h)) {
+        printf("%s : instantané trop court\n", name);
+        return 0;
+    }
+    memcpy(&h, data, sizeof(h));
+    const char* error = check_header(&h, size);
+    if (error == NULL) error = check_contents(&h, (const char*)data);
+    if (error != NULL) {
+        printf("%s : %s\n", name, error);
+        return 0;
+    }
+
+    reset_world(world, h.fixed_dt);
+    if (!restore(world, &h, (const char*)data)) {
+        printf("%s : allocation impossible\n", name);
+        reset_world(world, h.fixed_dt);
+        return 0;
+    }
+    BroadPhase* bp = world->broadphase;
+    const SnapshotSection* state = &h.sections[SNAPSHOT_BROADPHASE];
+    h.broadphase[SNAPSHOT_NAME_SIZE - 1] = '\0';
+    if (bp != NULL && strcmp(bp->name, h.broadphase) == 0) {
+        if (!broadphase_load_state(bp, (const char*)data + state->offset, state->size, world->num_bodies)) {
+            printf("%s : état de la phase large %s ignoré\n", name, bp->name);
+        }
+    } else if (bp != NULL && h.broadphase[0] != '\0') {
+        printf("%s : phase large %s au lieu de %s, son état n'est pas repris\n", name, bp->name, h.broadphase);
+    }
+    return 1;
+}
+
+// --- Fichier ---
+
+// writev peut n'en prendre qu'une partie (2 Gio au plus par appel sous Linux)
+static int write_parts(int fd, struct iovec* parts, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, parts, count);
+        if (written <= 0) {
+            return 0;
+        }
+        size_t left = (size_t)written;
+        while (count > 0 && left >= parts->iov_len) {
+            left -= parts->iov_len;
+            parts++;
+            count--;
+        }
+        if (count > 0) {
+            parts->iov_base = (char*)parts->iov_base + left;
+            parts->iov_len -= left;
+        }
+    }
+    return 1;
+}
+
+int world_save_snapshot(const World* world, const char* path) {
+    SnapshotHeader h;
+    fill_header(world, &h);
+    size_t staging_bytes = (size_t)staging_size(&h);
+    char* staging = (char*)mem_aligned_alloc(SNAPSHOT_FILE_ALIGN, staging_bytes);
+    if (staging == NULL) {
+        printf("Allocation impossible : %s non écrit\n", path);
+        return 0;
+    }
+    mem_advise_huge_pages(staging, staging_bytes);
+    PartList list;
+    gather(world, &h, staging, &list);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("Impossible de créer %s\n", path);
+        mem_free(staging);
+        return 0;
+    }
+    int ok = write_parts(fd, list.parts, list.count);
+    mem_free(staging);
+    if (close(fd) != 0 || !ok) {
+        printf("Écriture incomplète de %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+int world_load_snapshot(World* world, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Impossible d'ouvrir %s\n", path);
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        printf("%s : fichier trop court\n", path);
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)st.st_size;
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE; // Tout est lu une fois : pages chargées d'avance plutôt qu'à chaque défaut
+#endif
+    void* mapping = mmap(NULL, size, PROT_READ, flags, fd, 0);
+    close(fd); // La projection garde sa propre référence au fichier
+    if (mapping == MAP_FAILED) {
+        printf("Projection en mémoire impossible pour %s\n", path);
+        return 0;
+    }
+    int ok = world_snapshot_read(world, mapping, size, path);
+    munmap(mapping, size);
+    return ok;
+}
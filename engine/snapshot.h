@@ -0,0 +1,127 @@
+#ifndef ENGINE_SNAPSHOT_H
+#define ENGINE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "math3d.h"
+#include "world.h"
+
+// --- Instantané du monde ---
+// Tout ce dont dépend la suite de la simulation : état des corps (SoA, dans
+// l'ordre des places), maillages (une fois chacun, quel que soit le nombre de
+// leurs instances), identifiants, sommeil, articulations,
+// variétés de contact avec leurs impulsions (démarrage à chaud) et état de la
+// phase large. Restauré dans un monde dont les réglages d'exécution (pool de
+// threads, mode déterministe, phase large du même type) sont ceux de la
+// sauvegarde, il donne les mêmes pas au bit près que le monde d'origine.
+//
+// Fichier : en-tête de 512 octets avec la table des sections, puis chaque
+// section alignée sur 64 octets, telle qu'elle est en mémoire. Il est écrit
+// d'un seul appel à writev, directement depuis les tableaux du monde (seuls
+// les index, les articulations et la géométrie des maillages sont rassemblés
+// dans un tampon), et
+// relu par projection en mémoire puis recopié dans les tableaux du monde,
+// AABB comprises : rien n'est recalculé.
+// Petit-boutiste uniquement.
+#define SNAPSHOT_FILE_MAGIC "PHSNAP\r\n" // \r\n : détecte un transfert en mode texte
+#define SNAPSHOT_FILE_VERSION 3
+#define SNAPSHOT_FILE_ALIGN 64
+#define SNAPSHOT_NAME_SIZE 16
+
+typedef enum {
+    SNAPSHOT_BODIES = 0,     // SnapshotBody par place
+    SNAPSHOT_STATE,          // Champs de BodySoA (BODY_SOA_FIELDS) l'un après l'autre, chacun aligné
+    SNAPSHOT_MESHES,         // SnapshotMesh par maillage, dans l'ordre de world->meshes
+    SNAPSHOT_VERTICES,       // Sommets locaux (Vec3D) de tous les maillages, dans le même ordre
+    SNAPSHOT_EDGES,          // Arêtes (Edge) de tous les maillages, dans le même ordre
+    SNAPSHOT_AABBS,          // AABB monde par place
+    SNAPSHOT_BODY_SLOT,      // int32 par identifiant : place du corps
+    SNAPSHOT_WAKE_REQUEST,   // uint8 par identifiant de groupe
+    SNAPSHOT_JOINTS,         // Joint, dans l'ordre de world->joint_list
+    SNAPSHOT_JOINT_HANDLES,  // PoolHandle de chaque articulation, dans le même ordre
+    SNAPSHOT_MANIFOLDS,      // ContactManifold du dernier pas, dans l'ordre des paires
+    SNAPSHOT_BROADPHASE,     // État opaque de la phase large (broadphase_save_state)
+    SNAPSHOT_NUM_SECTIONS
+} SnapshotSectionId;
+
+typedef struct {
+    uint64_t offset;       // En octets depuis le début du fichier
+    uint64_t size;         // En octets, sans le remplissage
+} SnapshotSection;
+
+// Ce que le SoA ne contient pas pour un corps
+typedef struct {
+    int32_t id;            // Identifiant stable (body_id)
+    int32_t sleep_group;
+    int32_t mesh;          // Index dans la section des maillages
+    Vec3D scale;
+    float mass;
+    int32_t ccd;           // Object3D.ccd (0 dans les fichiers antérieurs à la détection continue)
+} SnapshotBody;
+
+// Plages d'un maillage dans les sections des sommets et des arêtes
+typedef struct {
+    int32_t vertex_offset;
+    int32_t num_vertices;
+    int32_t edge_offset;
+    int32_t num_edges;
+} SnapshotMesh;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;      // sizeof(SnapshotHeader)
+    uint32_t num_bodies;
+    uint32_t num_awake;
+    uint32_t num_asleep;
+    uint32_t num_meshes;
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    uint32_t num_joints;
+    uint32_t num_manifolds;
+    uint32_t num_state_fields; // Champs de BodySoA
+    uint32_t body_stride;      // sizeof(SnapshotBody)
+    uint32_t mesh_stride;      // sizeof(SnapshotMesh)
+    uint32_t joint_stride;     // sizeof(Joint)
+    uint32_t manifold_stride;  // sizeof(ContactManifold)
+    uint32_t num_sections;     // SNAPSHOT_NUM_SECTIONS
+
+    // Réglages et horloge du monde
+    Vec3D gravity;
+    float fixed_dt;
+    float accumulator;
+    float friction;
+    int32_t max_substeps;
+    int32_t solver_iterations;
+    int32_t narrowphase;
+    int32_t warm_start;
+    int32_t allow_sleep;
+    int32_t activity_dirty;
+    uint64_t step_count;
+    uint64_t file_size;
+    char broadphase[SNAPSHOT_NAME_SIZE]; // Nom de la phase large sauvegardée ("" sans phase large)
+
+    SnapshotSection sections[SNAPSHOT_NUM_SECTIONS];
+    float ccd_threshold;       // 0 dans les fichiers antérieurs : détection continue inactive
+    uint8_t reserved[164];
+} SnapshotHeader;
+
+// Taille de l'instantané de `world`, en octets
+size_t world_snapshot_size(const World* world);
+
+// Remplace le contenu de `world` (créé par create_world) par l'instantané
+// `data`. La phase large et le pool installés sont conservés ; l'état de la
+// phase large n'est repris que si elle est du même type que celle de
+// l'instantané. Retourne 0 si les données sont incohérentes (monde inchangé)
+// ou en cas d'échec d'allocation (monde vidé), avec un message sur la sortie
+// standard préfixé par `name`.
+int world_snapshot_read(World* world, const void* data, size_t size, const char* name);
+
+// Écrit l'instantané d'un seul bloc ; 0 en cas d'erreur, message sur la
+// sortie standard
+int world_save_snapshot(const World* world, const char* path);
+
+// Projette le fichier en mémoire et le restaure par world_snapshot_read
+int world_load_snapshot(World* world, const char* path);
+
+#endif
@@ -0,0 +1,133 @@
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "soa.h"
+
+float* soa_alloc_floats(int count) {
+    size_t n = (size_t)((count + 7) & ~7);
+    if (n == 0) n = 8;
+    float* p = (float*)mem_aligned_alloc(SOA_ALIGNMENT, n * sizeof(float));
+    mem_advise_huge_pages(p, n * sizeof(float));
+    return p;
+}
+
+void soa_free_floats(float* p) {
+    mem_free(p);
+}
+
+// Réalloue un tableau aligné en conservant les `count` premiers éléments
+static int grow_floats(float** p, int count, int capacity) {
+    float* q = soa_alloc_floats(capacity);
+    if (q == NULL) {
+        return 0;
+    }
+    if (*p != NULL) {
+        memcpy(q, *p, (size_t)count * sizeof(float));
+        soa_free_floats(*p);
+    }
+    *p = q;
+    return 1;
+}
+
+// --- Sommets ---
+void vertex_soa_init(VertexSoA* soa) {
+    memset(soa, 0, sizeof(*soa));
+}
+
+int vertex_soa_reserve(VertexSoA* soa, int capacity) {
+    if (capacity <= soa->capacity) {
+        return 1;
+    }
+    if (!grow_floats(&soa->x, soa->count, capacity) ||
+        !grow_floats(&soa->y, soa->count, capacity) ||
+        !grow_floats(&soa->z, soa->count, capacity)) {
+        return 0;
+    }
+    soa->capacity = capacity;
+    return 1;
+}
+
+int vertex_soa_append(VertexSoA* soa, const Vec3D* vertices, int count) {
+    int first = soa->count;
+    if (first + count > soa->capacity) {
+        int capacity = soa->capacity ? soa->capacity : 64;
+        while (capacity < first + count) capacity *= 2;
+        if (!vertex_soa_reserve(soa, capacity)) {
+            return -1;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        soa->x[first + i] = vertices[i].x;
+        soa->y[first + i] = vertices[i].y;
+        soa->z[first + i] = vertices[i].z;
+    }
+    soa->count += count;
+    return first;
+}
+
+void vertex_soa_free(VertexSoA* soa) {
+    soa_free_floats(soa->x);
+    soa_free_floats(soa->y);
+    soa_free_floats(soa->z);
+    vertex_soa_init(soa);
+}
+
+// --- Corps ---
+void body_soa_init(BodySoA* soa) {
+    memset(soa, 0, sizeof(*soa));
+}
+
+int body_soa_reserve(BodySoA* soa, int capacity) {
+    if (capacity <= soa->capacity) {
+        return 1;
+    }
+#define GROW(f) if (!grow_floats(&soa->f, soa->count, capacity)) return 0;
+    BODY_SOA_FIELDS(GROW)
+#undef GROW
+    soa->capacity = capacity;
+    return 1;
+}
+
+int body_soa_push(BodySoA* soa) {
+    if (soa->count == soa->capacity) {
+        if (!body_soa_reserve(soa, soa->capacity ? soa->capacity * 2 : 64)) {
+            return -1;
+        }
+    }
+    int i = soa->count++;
+#define ZERO(f) soa->f[i] = 0.0f;
+    BODY_SOA_FIELDS(ZERO)
+#undef ZERO
+    soa->qw[i] = 1.0f;
+    return i;
+}
+
+void body_soa_free(BodySoA* soa) {
+#define FREE(f) soa_free_floats(soa->f);
+    BODY_SOA_FIELDS(FREE)
+#undef FREE
+    body_soa_init(soa);
+}
+
+// --- Particules ---
+void particle_soa_init(ParticleSoA* soa) {
+    memset(soa, 0, sizeof(*soa));
+}
+
+int particle_soa_reserve(ParticleSoA* soa, int capacity) {
+    if (capacity <= soa->capacity) {
+        return 1;
+    }
+#define GROW(f) if (!grow_floats(&soa->f, soa->count, capacity)) return 0;
+    PARTICLE_SOA_FIELDS(GROW)
+#undef GROW
+    soa->capacity = capacity;
+    return 1;
+}
+
+void particle_soa_free(ParticleSoA* soa) {
+#define FREE(f) soa_free_floats(soa->f);
+    PARTICLE_SOA_FIELDS(FREE)
+#undef FREE
+    particle_soa_init(soa);
+}
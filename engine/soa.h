@@ -0,0 +1,68 @@
+#ifndef ENGINE_SOA_H
+#define ENGINE_SOA_H
+
+#include "math3d.h"
+
+// Alignement des tableaux SoA : une ligne AVX (8 floats)
+#define SOA_ALIGNMENT 32
+
+// Sommets en "structure de tableaux" : x[], y[], z[] séparés et alignés
+typedef struct {
+    float* x;
+    float* y;
+    float* z;
+    int count;
+    int capacity;
+} VertexSoA;
+
+// État cinématique des corps, un tableau aligné par composante
+typedef struct {
+    float *px, *py, *pz;    // Position
+    float *vx, *vy, *vz;    // Vitesse linéaire
+    float *qx, *qy, *qz, *qw; // Orientation (quaternion unitaire)
+    float *wx, *wy, *wz;    // Vitesse angulaire
+    float *inv_mass;        // 0 = statique
+    float *iix, *iiy, *iiz; // Inertie inverse sur les axes du repère local (0 = statique)
+    float *sleep_time;      // Temps passé sous les seuils de sommeil (World)
+    int count;
+    int capacity;
+} BodySoA;
+
+// Liste des champs de BodySoA, pour les opérations appliquées à chaque tableau
+#define BODY_SOA_FIELDS(X) \
+    X(px) X(py) X(pz) X(vx) X(vy) X(vz) X(qx) X(qy) X(qz) X(qw) X(wx) X(wy) X(wz) X(inv_mass) \
+    X(iix) X(iiy) X(iiz) X(sleep_time)
+
+// Particules (particles.h) : positions courante et précédente, l'écart des
+// deux tenant lieu de vitesse (intégration de Verlet)
+typedef struct {
+    float *x, *y, *z;      // Position
+    float *ox, *oy, *oz;   // Position au pas précédent
+    float *inv_mass;       // 0 = particule fixée
+    int count;
+    int capacity;
+} ParticleSoA;
+
+#define PARTICLE_SOA_FIELDS(X) X(x) X(y) X(z) X(ox) X(oy) X(oz) X(inv_mass)
+
+// Tableau de floats aligné sur SOA_ALIGNMENT, taille arrondie au multiple de 8
+float* soa_alloc_floats(int count);
+void soa_free_floats(float* p);
+
+void vertex_soa_init(VertexSoA* soa);
+int vertex_soa_reserve(VertexSoA* soa, int capacity);
+// Ajoute `count` sommets AoS à la fin, retourne l'index du premier (-1 si échec)
+int vertex_soa_append(VertexSoA* soa, const Vec3D* vertices, int count);
+void vertex_soa_free(VertexSoA* soa);
+
+void body_soa_init(BodySoA* soa);
+int body_soa_reserve(BodySoA* soa, int capacity);
+// Ajoute un corps (tout à zéro, orientation identité), retourne son index (-1 si échec)
+int body_soa_push(BodySoA* soa);
+void body_soa_free(BodySoA* soa);
+
+void particle_soa_init(ParticleSoA* soa);
+int particle_soa_reserve(ParticleSoA* soa, int capacity);
+void particle_soa_free(ParticleSoA* soa);
+
+#endif
@@ -0,0 +1,472 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "kernels.h"
+#include "solver.h"
+#include "timer.h"
+
+struct SolverBodyInfo {
+    int index;             // Corps dans BodySoA
+    float inv_mass;
+    float inv_inertia[6];  // I^-1 monde, symétrique : xx, yy, zz, xy, xz, yz
+};
+
+// Ligne telle qu'ajoutée, avant coloration et rangement en SoA
+struct SolverRowDesc {
+    int a, b;
+    Vec3D n, ja, jb;
+    float bias, lo, hi, friction, impulse;
+    int normal_row;        // Index dans `descs` de la ligne normale (frottement), -1 sinon
+    float* target;
+};
+
+static int reserve_array(void** p, int* capacity, int count, size_t size) {
+    if (count <= *capacity) {
+        return 1;
+    }
+    int new_capacity = *capacity ? *capacity : 64;
+    while (new_capacity < count) new_capacity *= 2;
+    void* grown = mem_realloc(*p, (size_t)new_capacity * size);
+    if (grown == NULL) {
+        return 0;
+    }
+    *p = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+// --- Tableaux SoA ---
+
+#define SOLVER_ROW_FLOATS(X) \
+    X(nx) X(ny) X(nz) X(jax) X(jay) X(jaz) X(jbx) X(jby) X(jbz) \
+    X(iax) X(iay) X(iaz) X(ibx) X(iby) X(ibz) X(ima) X(imb) \
+    X(eff_mass) X(bias) X(lo) X(hi) X(friction) X(impulse)
+
+// Décalage d'une ligne de cache entre deux tableaux : à capacité égale, ils
+// commenceraient tous au même décalage dans la page, et la même place de
+// chacun tomberait dans le même ensemble du cache L1
+#define SOLVER_ROW_STAGGER 16
+
+static void rows_free(SolverRows* r) {
+    soa_free_floats(r->storage);
+    mem_free(r->target);
+    memset(r, 0, sizeof(*r));
+}
+
+// Le contenu est reconstruit à chaque pas : rien à conserver. Tous les
+// tableaux partagent un seul bloc, `a`, `b` et `normal_row` compris.
+static int rows_reserve(SolverRows* r, int count) {
+    if (count <= r->capacity) {
+        return 1;
+    }
+    int capacity = r->capacity ? r->capacity : 256;
+    while (capacity < count) capacity *= 2;
+    rows_free(r);
+    int num_arrays = 3;
+#define COUNT(f) ++num_arrays;
+    SOLVER_ROW_FLOATS(COUNT)
+#undef COUNT
+    size_t stride = (size_t)capacity + SOLVER_ROW_STAGGER;
+    r->storage = soa_alloc_floats((int)(stride * num_arrays));
+    r->target = (float**)mem_alloc((size_t)capacity * sizeof(float*));
+    if (r->storage == NULL || r->target == NULL) {
+        rows_free(r);
+        return 0;
+    }
+    float* next = r->storage;
+#define ASSIGN(f) r->f = next; next += stride;
+    SOLVER_ROW_FLOATS(ASSIGN)
+#undef ASSIGN
+    r->a = (int*)next; next += stride;
+    r->b = (int*)next; next += stride;
+    r->normal_row = (int*)next;
+    r->capacity = capacity;
+    return 1;
+}
+
+static void bodies_free(SolverBodies* v) {
+    soa_free_floats(v->v);
+    memset(v, 0, sizeof(*v));
+}
+
+static int bodies_reserve(SolverBodies* v, int count) {
+    if (count <= v->capacity) {
+        return 1;
+    }
+    int capacity = v->capacity ? v->capacity * 2 : 64;
+    while (capacity < count) capacity *= 2;
+    float* grown = soa_alloc_floats(capacity * SOLVER_BODY_STRIDE);
+    if (grown == NULL) {
+        return 0;
+    }
+    if (v->v != NULL) {
+        memcpy(grown, v->v, (size_t)v->count * SOLVER_BODY_STRIDE * sizeof(float));
+        soa_free_floats(v->v);
+    }
+    v->v = grown;
+    v->capacity = capacity;
+    return 1;
+}
+
+// --- Cycle de vie ---
+
+void solver_init(Solver* s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void solver_free(Solver* s) {
+    rows_free(&s->rows);
+    bodies_free(&s->bodies);
+    mem_free(s->info);
+    mem_free(s->descs);
+    mem_free(s->color_mask);
+    mem_free(s->color);
+    mem_free(s->slot);
+    mem_free(s->order);
+    solver_init(s);
+}
+
+void solver_begin(Solver* s) {
+    s->num_descs = 0;
+    s->bodies.count = 0;
+    s->rows.num_batches = 0;
+    s->num_colors = 0;
+    s->iterations = 0;
+    s->iterate_ns = 0;
+    // Entrée 0 : tous les corps statiques
+    if (bodies_reserve(&s->bodies, 1) &&
+        reserve_array((void**)&s->info, &s->info_capacity, 1, sizeof(SolverBodyInfo))) {
+        memset(s->bodies.v, 0, SOLVER_BODY_STRIDE * sizeof(float));
+        memset(&s->info[0], 0, sizeof(SolverBodyInfo));
+        s->info[0].index = -1;
+        s->bodies.count = 1;
+    }
+}
+
+// --- Construction des lignes ---
+
+static inline Vec3D inertia_mul(const float* I, Vec3D v) {
+    return (Vec3D){I[0] * v.x + I[3] * v.y + I[4] * v.z,
+                   I[3] * v.x + I[1] * v.y + I[5] * v.z,
+                   I[4] * v.x + I[5] * v.y + I[2] * v.z};
+}
+
+int solver_add_body(Solver* s, const BodySoA* bodies, int index, int* slot) {
+    if (s->bodies.count == 0 || !bodies_reserve(&s->bodies, s->bodies.count + 1) ||
+        !reserve_array((void**)&s->info, &s->info_capacity, s->bodies.count + 1, sizeof(SolverBodyInfo))) {
+        return 0;
+    }
+    int k = s->bodies.count++;
+    float* v = s->bodies.v + (size_t)k * SOLVER_BODY_STRIDE;
+    v[0] = bodies->vx[index]; v[1] = bodies->vy[index]; v[2] = bodies->vz[index];
+    v[3] = bodies->wx[index]; v[4] = bodies->wy[index]; v[5] = bodies->wz[index];
+    v[6] = v[7] = 0.0f;
+
+    // I^-1 monde = R diag(I^-1 local) R^T, R ayant pour colonnes les axes locaux
+    Quat q = {bodies->qx[index], bodies->qy[index], bodies->qz[index], bodies->qw[index]};
+    Vec3D c[3] = {quat_rotate(q, (Vec3D){1, 0, 0}), quat_rotate(q, (Vec3D){0, 1, 0}),
+                  quat_rotate(q, (Vec3D){0, 0, 1})};
+    float d[3] = {bodies->iix[index], bodies->iiy[index], bodies->iiz[index]};
+    SolverBodyInfo* info = &s->info[k];
+    memset(info->inv_inertia, 0, sizeof(info->inv_inertia));
+    for (int axis = 0; axis < 3; ++axis) {
+        Vec3D u = c[axis];
+        float* I = info->inv_inertia;
+        I[0] += d[axis] * u.x * u.x; I[1] += d[axis] * u.y * u.y; I[2] += d[axis] * u.z * u.z;
+        I[3] += d[axis] * u.x * u.y; I[4] += d[axis] * u.x * u.z; I[5] += d[axis] * u.y * u.z;
+    }
+    info->index = index;
+    info->inv_mass = bodies->inv_mass[index];
+    slot[index] = k;
+    return 1;
+}
+
+static inline int body_slot(const BodySoA* bodies, const int* slot, int index) {
+    return bodies->inv_mass[index] == 0.0f ? 0 : slot[index];
+}
+
+static SolverRowDesc* push_desc(Solver* s) {
+    if (!reserve_array((void**)&s->descs, &s->desc_capacity, s->num_descs + 1, sizeof(SolverRowDesc))) {
+        return NULL;
+    }
+    return &s->descs[s->num_descs++];
+}
+
+// Ligne agissant sur la vitesse de l'ancre (ra, rb) le long de `n`
+static SolverRowDesc* push_linear(Solver* s, int a, int b, Vec3D n, Vec3D ra, Vec3D rb) {
+    SolverRowDesc* d = push_desc(s);
+    if (d != NULL) {
+        d->a = a; d->b = b;
+        d->n = n;
+        d->ja = vec3_cross(n, ra); // -(ra x n)
+        d->jb = vec3_cross(rb, n);
+        d->bias = 0.0f;
+        d->lo = -FLT_MAX; d->hi = FLT_MAX;
+        d->friction = 0.0f;
+        d->normal_row = -1;
+    }
+    return d;
+}
+
+// Ligne sur la vitesse angulaire relative autour de `axis`
+static SolverRowDesc* push_angular(Solver* s, int a, int b, Vec3D axis) {
+    SolverRowDesc* d = push_desc(s);
+    if (d != NULL) {
+        d->a = a; d->b = b;
+        d->n = (Vec3D){0.0f, 0.0f, 0.0f};
+        d->ja = vec3_scale(axis, -1.0f);
+        d->jb = axis;
+        d->bias = 0.0f;
+        d->lo = -FLT_MAX; d->hi = FLT_MAX;
+        d->friction = 0.0f;
+        d->normal_row = -1;
+    }
+    return d;
+}
+
+static inline Vec3D body_position(const BodySoA* bodies, int i) {
+    return (Vec3D){bodies->px[i], bodies->py[i], bodies->pz[i]};
+}
+
+static inline Quat body_orientation(const BodySoA* bodies, int i) {
+    return (Quat){bodies->qx[i], bodies->qy[i], bodies->qz[i], bodies->qw[i]};
+}
+
+int solver_add_manifold(Solver* s, ContactManifold* m, const BodySoA* bodies, const int* slot,
+                        float friction, float inv_dt) {
+    int a = body_slot(bodies, slot, m->a), b = body_slot(bodies, slot, m->b);
+    if (a == 0 && b == 0) {
+        return 1;
+    }
+    Vec3D pa = body_position(bodies, m->a), pb = body_position(bodies, m->b);
+    Vec3D t[2];
+    vec3_basis(m->normal, &t[0], &t[1]); // Stable tant que la normale l'est : frottement repris
+    for (int i = 0; i < m->num_points; ++i) {
+        ManifoldPoint* pt = &m->points[i];
+        Vec3D ra = vec3_sub(pt->position, pa), rb = vec3_sub(pt->position, pb);
+        int normal = s->num_descs;
+        SolverRowDesc* d = push_linear(s, a, b, m->normal, ra, rb);
+        if (d == NULL) {
+            return 0;
+        }
+        // Sans rebond : seule la pénétration au-delà de la tolérance est corrigée.
+        // Un point encore séparé laisse les corps se rapprocher de son écart en un pas.
+        d->bias = (pt->depth < 0.0f) ? -pt->depth * inv_dt
+                                     : -SOLVER_BAUMGARTE * inv_dt * fmaxf(pt->depth - SOLVER_SLOP, 0.0f);
+        d->lo = 0.0f;
+        d->impulse = pt->normal_impulse;
+        d->target = &pt->normal_impulse;
+        for (int k = 0; k < 2; ++k) {
+            d = push_linear(s, a, b, t[k], ra, rb);
+            if (d == NULL) {
+                return 0;
+            }
+            d->lo = d->hi = 0.0f; // Bornes tirées de l'impulsion normale à chaque itération
+            d->friction = friction;
+            d->normal_row = normal;
+            d->impulse = pt->tangent_impulse[k];
+            d->target = &pt->tangent_impulse[k];
+        }
+    }
+    return 1;
+}
+
+int solver_add_joint(Solver* s, Joint* joint, int index_a, int index_b, const BodySoA* bodies,
+                     const int* slot, float inv_dt) {
+    int a = body_slot(bodies, slot, index_a), b = body_slot(bodies, slot, index_b);
+    if (a == 0 && b == 0) {
+        return 1;
+    }
+    Quat qa = body_orientation(bodies, index_a), qb = body_orientation(bodies, index_b);
+    Vec3D ra = quat_rotate(qa, joint->local_anchor_a), rb = quat_rotate(qb, joint->local_anchor_b);
+    Vec3D error = vec3_sub(vec3_add(body_position(bodies, index_b), rb),
+                           vec3_add(body_position(bodies, index_a), ra));
+    float k = SOLVER_BAUMGARTE * inv_dt;
+    int row = 0;
+
+    // Ancre commune : trois lignes selon les axes du monde
+    const Vec3D axes[3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    const float errors[3] = {error.x, error.y, error.z};
+    for (int i = 0; i < 3; ++i, ++row) {
+        SolverRowDesc* d = push_linear(s, a, b, axes[i], ra, rb);
+        if (d == NULL) {
+            return 0;
+        }
+        d->bias = k * errors[i];
+        d->impulse = joint->impulses[row];
+        d->target = &joint->impulses[row];
+    }
+
+    if (joint->type == JOINT_HINGE) {
+        // Axes alignés : axis_a x axis_b s'annule, et sa dérivée est la vitesse
+        // angulaire relative projetée sur le plan normal à l'axe
+        Vec3D axis_a = quat_rotate(qa, joint->local_axis_a), axis_b = quat_rotate(qb, joint->local_axis_b);
+        Vec3D drift = vec3_cross(axis_a, axis_b);
+        Vec3D p[2];
+        vec3_basis(axis_a, &p[0], &p[1]);
+        for (int i = 0; i < 2; ++i, ++row) {
+            SolverRowDesc* d = push_angular(s, a, b, p[i]);
+            if (d == NULL) {
+                return 0;
+            }
+            d->bias = k * vec3_dot(drift, p[i]);
+            d->impulse = joint->impulses[row];
+            d->target = &joint->impulses[row];
+        }
+    } else if (joint->type == JOINT_FIXED) {
+        // Rotation de l'orientation cible vers l'orientation actuelle de b ;
+        // aux petits angles, 2 * sa partie vectorielle vaut angle * axe
+        Quat e = quat_mul(qb, quat_conjugate(quat_mul(qa, joint->rest_rotation)));
+        float sign = e.w < 0.0f ? -2.0f : 2.0f;
+        const float drift[3] = {sign * e.x, sign * e.y, sign * e.z};
+        for (int i = 0; i < 3; ++i, ++row) {
+            SolverRowDesc* d = push_angular(s, a, b, axes[i]);
+            if (d == NULL) {
+                return 0;
+            }
+            d->bias = k * drift[i];
+            d->impulse = joint->impulses[row];
+            d->target = &joint->impulses[row];
+        }
+    }
+    return 1;
+}
+
+// --- Coloration et rangement en lots ---
+
+static void clear_slot(SolverRows* r, int i) {
+#define ZERO(f) r->f[i] = 0.0f;
+    SOLVER_ROW_FLOATS(ZERO)
+#undef ZERO
+    r->a[i] = r->b[i] = 0;
+    r->normal_row[i] = -1;
+    r->target[i] = NULL;
+}
+
+int solver_prepare(Solver* s, int warm_start) {
+    int n = s->num_descs;
+    if (n == 0) {
+        return 1;
+    }
+    int index_capacity = s->index_capacity;
+    if (!reserve_array((void**)&s->color_mask, &s->mask_capacity, s->bodies.count, sizeof(uint64_t)) ||
+        !reserve_array((void**)&s->color, &index_capacity, n, sizeof(int)) ||
+        !reserve_array((void**)&s->slot, &s->index_capacity, n, sizeof(int))) {
+        return 0;
+    }
+    int* color = s->color;
+    int* slot = s->slot;
+    memset(s->color_mask, 0, (size_t)s->bodies.count * sizeof(uint64_t));
+
+    // Première couleur libre pour les deux corps. Le corps 0 (statique) n'est
+    // jamais marqué : ses vitesses ne changent pas, deux voies peuvent le partager.
+    int count[SOLVER_MAX_COLORS + 1] = {0};
+    for (int i = 0; i < n; ++i) {
+        int a = s->descs[i].a, b = s->descs[i].b;
+        uint64_t used = s->color_mask[a] | s->color_mask[b];
+        int c = (used == ~0ull) ? SOLVER_MAX_COLORS : __builtin_ctzll(~used);
+        if (c < SOLVER_MAX_COLORS) {
+            if (a != 0) s->color_mask[a] |= 1ull << c;
+            if (b != 0) s->color_mask[b] |= 1ull << c;
+        }
+        color[i] = c;
+        count[c]++;
+    }
+
+    // Lots : chaque couleur remplit ses lots de SOLVER_LANES lignes ; les lignes
+    // en excès de couleurs ont chacune leur lot
+    int cursor[SOLVER_MAX_COLORS + 1];
+    int num_batches = 0;
+    s->num_colors = 0;
+    for (int c = 0; c <= SOLVER_MAX_COLORS; ++c) {
+        cursor[c] = num_batches * SOLVER_LANES;
+        num_batches += (c < SOLVER_MAX_COLORS) ? (count[c] + SOLVER_LANES - 1) / SOLVER_LANES : count[c];
+        if (count[c] > 0) s->num_colors++;
+    }
+    int num_slots = num_batches * SOLVER_LANES;
+    SolverRows* r = &s->rows;
+    if (!rows_reserve(r, num_slots) ||
+        !reserve_array((void**)&s->order, &s->order_capacity, num_slots, sizeof(int))) {
+        return 0;
+    }
+    r->num_batches = num_batches;
+    int* order = s->order;
+    memset(order, -1, (size_t)num_slots * sizeof(int));
+    for (int i = 0; i < n; ++i) {
+        int c = color[i];
+        slot[i] = cursor[c];
+        order[cursor[c]] = i;
+        cursor[c] += (c < SOLVER_MAX_COLORS) ? 1 : SOLVER_LANES;
+    }
+
+    // Écriture dans l'ordre des places : les tableaux SoA sont remplis
+    // séquentiellement, seules les descriptions sont lues dans le désordre
+    float* v = s->bodies.v;
+    for (int j = 0; j < num_slots; ++j) {
+        if (order[j] < 0) {
+            clear_slot(r, j);
+            continue;
+        }
+        const SolverRowDesc* d = &s->descs[order[j]];
+        const SolverBodyInfo* ia = &s->info[d->a];
+        const SolverBodyInfo* ib = &s->info[d->b];
+        Vec3D ka = inertia_mul(ia->inv_inertia, d->ja), kb = inertia_mul(ib->inv_inertia, d->jb);
+        float k = (ia->inv_mass + ib->inv_mass) * vec3_dot(d->n, d->n) +
+                  vec3_dot(d->ja, ka) + vec3_dot(d->jb, kb);
+        r->a[j] = d->a; r->b[j] = d->b;
+        r->nx[j] = d->n.x; r->ny[j] = d->n.y; r->nz[j] = d->n.z;
+        r->jax[j] = d->ja.x; r->jay[j] = d->ja.y; r->jaz[j] = d->ja.z;
+        r->jbx[j] = d->jb.x; r->jby[j] = d->jb.y; r->jbz[j] = d->jb.z;
+        r->iax[j] = ka.x; r->iay[j] = ka.y; r->iaz[j] = ka.z;
+        r->ibx[j] = kb.x; r->iby[j] = kb.y; r->ibz[j] = kb.z;
+        r->ima[j] = ia->inv_mass; r->imb[j] = ib->inv_mass;
+        r->eff_mass[j] = k > 0.0f ? 1.0f / k : 0.0f;
+        r->bias[j] = d->bias;
+        r->lo[j] = d->lo; r->hi[j] = d->hi;
+        r->friction[j] = d->friction;
+        r->normal_row[j] = d->normal_row >= 0 ? slot[d->normal_row] : -1;
+        r->impulse[j] = warm_start ? d->impulse : 0.0f;
+        r->target[j] = d->target;
+
+        // Démarrage à chaud : les impulsions du pas précédent sont appliquées d'emblée
+        float lambda = r->impulse[j];
+        if (lambda != 0.0f) {
+            float* va = v + (size_t)d->a * SOLVER_BODY_STRIDE;
+            float* vb = v + (size_t)d->b * SOLVER_BODY_STRIDE;
+            float la = ia->inv_mass * lambda, lb = ib->inv_mass * lambda;
+            va[0] -= d->n.x * la; va[1] -= d->n.y * la; va[2] -= d->n.z * la;
+            va[3] += ka.x * lambda; va[4] += ka.y * lambda; va[5] += ka.z * lambda;
+            vb[0] += d->n.x * lb; vb[1] += d->n.y * lb; vb[2] += d->n.z * lb;
+            vb[3] += kb.x * lambda; vb[4] += kb.y * lambda; vb[5] += kb.z * lambda;
+        }
+    }
+    return 1;
+}
+
+void solver_iterate(Solver* s, int iterations) {
+    const SimdKernels* k = kernels_get();
+    uint64_t t0 = timer_now_ns();
+    for (int it = 0; it < iterations; ++it) {
+        float residual = k->solve_rows(&s->rows, &s->bodies, 0, s->rows.num_batches);
+        if (it < SOLVER_MAX_TRACKED_ITERATIONS) {
+            s->residual[it] = residual;
+        }
+    }
+    s->iterate_ns = timer_now_ns() - t0;
+    s->iterations = iterations;
+}
+
+void solver_finish(Solver* s, BodySoA* bodies) {
+    for (int k = 1; k < s->bodies.count; ++k) {
+        int i = s->info[k].index;
+        const float* v = s->bodies.v + (size_t)k * SOLVER_BODY_STRIDE;
+        bodies->vx[i] = v[0]; bodies->vy[i] = v[1]; bodies->vz[i] = v[2];
+        bodies->wx[i] = v[3]; bodies->wy[i] = v[4]; bodies->wz[i] = v[5];
+    }
+    const SolverRows* r = &s->rows;
+    for (int j = 0; j < r->num_batches * SOLVER_LANES; ++j) {
+        if (r->target[j] != NULL) *r->target[j] = r->impulse[j];
+    }
+}
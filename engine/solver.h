@@ -0,0 +1,139 @@
+#ifndef ENGINE_SOLVER_H
+#define ENGINE_SOLVER_H
+
+#include <stdint.h>
+#include "manifold.h"
+#include "math3d.h"
+#include "soa.h"
+#include "transform.h"
+
+// --- Configuration ---
+#define SOLVER_LANES 8                  // Lignes par lot : un registre AVX, deux registres SSE
+#define SOLVER_MAX_COLORS 64            // Au-delà, une ligne est résolue seule dans son lot
+#define SOLVER_BAUMGARTE 0.2f           // Fraction de l'erreur de position corrigée par pas
+#define SOLVER_SLOP 0.005f              // Pénétration tolérée, évite les oscillations au repos
+#define SOLVER_DEFAULT_FRICTION 0.5f
+#define SOLVER_MAX_TRACKED_ITERATIONS 32 // Itérations dont la convergence est mesurée
+
+// Articulations. Une rotule bloque les 3 translations relatives de l'ancre,
+// une charnière y ajoute 2 rotations (seule celle autour de l'axe reste libre),
+// une liaison fixe bloque les 6 degrés de liberté.
+typedef enum {
+    JOINT_BALL = 0,
+    JOINT_HINGE,
+    JOINT_FIXED
+} JointType;
+
+// Ancres et axes sont stockés dans le repère local de chaque corps (rotation
+// et translation seules, comme les points de contact des variétés)
+typedef struct {
+    JointType type;
+    int a, b;                         // Identifiants des corps (world_add_body)
+    Vec3D local_anchor_a, local_anchor_b;
+    Vec3D local_axis_a, local_axis_b; // JOINT_HINGE : axe de rotation libre
+    Quat rest_rotation;               // JOINT_FIXED : orientation de b vue depuis a à la création
+    float impulses[6];                // Impulsions cumulées, pour le démarrage à chaud
+} Joint;
+
+// Lignes de contrainte en SoA. Chacune agit sur la vitesse relative
+// J v = n.(vb - va) + ja.wa + jb.wb et garde son impulsion cumulée dans [lo, hi].
+// Les lignes sont rangées par lots de SOLVER_LANES qui ne partagent aucun
+// corps dynamique (coloration du graphe corps-lignes) : un lot se résout d'un
+// bloc en SIMD, sans conflit d'écriture sur les vitesses.
+typedef struct {
+    int *a, *b;              // Corps dans SolverBodies (0 : corps statique)
+    float *nx, *ny, *nz;     // Jacobienne linéaire (nulle pour une ligne angulaire)
+    float *jax, *jay, *jaz;  // Jacobienne angulaire côté a
+    float *jbx, *jby, *jbz;  // Jacobienne angulaire côté b
+    float *iax, *iay, *iaz;  // I_a^-1 ja (repère monde)
+    float *ibx, *iby, *ibz;  // I_b^-1 jb
+    float *ima, *imb;        // Masses inverses
+    float *eff_mass;         // 1 / (J M^-1 J^T) ; 0 pour une case vide
+    float *bias;             // Correction de position (Baumgarte), en vitesse
+    float *lo, *hi;          // Bornes de l'impulsion cumulée
+    float *friction;         // Frottement : |impulsion| <= friction * impulsion de normal_row
+    int *normal_row;         // -1 sauf pour les lignes de frottement
+    float *impulse;          // Impulsion cumulée
+    float** target;          // Où ranger l'impulsion finale (NULL pour une case vide)
+    float* storage;          // Bloc commun à tous les tableaux ci-dessus, sauf `target`
+    int num_batches;
+    int capacity;            // En lignes
+} SolverRows;
+
+// Vitesses des corps d'un solveur, indexées par SolverRows.a/b : une ligne
+// AVX alignée par corps (vx vy vz wx wy wz, deux cases libres), que les
+// noyaux chargent puis transposent au lieu de lire chaque composante
+// séparément. L'entrée 0 représente tous les corps statiques : vitesse et
+// masse inverse nulles.
+#define SOLVER_BODY_STRIDE 8
+typedef struct {
+    float* v;
+    int count;
+    int capacity;
+} SolverBodies;
+
+typedef struct SolverBodyInfo SolverBodyInfo; // Définis dans solver.c
+typedef struct SolverRowDesc SolverRowDesc;
+
+// Solveur à impulsions séquentielles (Gauss-Seidel projeté) : un par tâche,
+// réutilisé d'un pas à l'autre. Les îlots qu'il reçoit sont résolus ensemble,
+// ce qui remplit mieux les lots ; les coloriages de deux îlots ne dépendent
+// pas l'un de l'autre, donc le regroupement n'influe pas sur le résultat.
+typedef struct {
+    SolverBodies bodies;
+    SolverBodyInfo* info;    // Index global et inertie inverse monde de chaque corps
+    int info_capacity;
+    SolverRowDesc* descs;    // Lignes dans l'ordre d'ajout, avant coloration
+    int num_descs;
+    int desc_capacity;
+    uint64_t* color_mask;    // Couleurs déjà prises par chaque corps
+    int mask_capacity;
+    int* color;              // Couleur de chaque ligne
+    int* slot;               // Place de chaque ligne dans `rows`
+    int index_capacity;
+    int* order;              // Ligne rangée à chaque place, -1 pour une case vide
+    int order_capacity;
+    SolverRows rows;
+
+    // Statistiques de la dernière résolution
+    int num_colors;
+    int iterations;
+    uint64_t iterate_ns;     // Total des itérations, sans la préparation
+    float residual[SOLVER_MAX_TRACKED_ITERATIONS]; // Somme des |delta impulsion| par itération
+} Solver;
+
+void solver_init(Solver* s);
+void solver_free(Solver* s);
+
+// Vide le solveur avant d'ajouter les corps et les contraintes d'un groupe d'îlots
+void solver_begin(Solver* s);
+
+// Ajoute le corps dynamique `index` ; slot[index] reçoit sa place dans le solveur.
+// Un corps dynamique non ajouté doit avoir slot[index] == 0 : il est alors
+// traité comme statique (corps endormi touché par un corps actif).
+// Retourne 0 en cas d'échec d'allocation.
+int solver_add_body(Solver* s, const BodySoA* bodies, int index, int* slot);
+
+// Une ligne normale et deux lignes de frottement par point de contact.
+// Les corps dynamiques de la variété doivent avoir été ajoutés.
+int solver_add_manifold(Solver* s, ContactManifold* m, const BodySoA* bodies, const int* slot,
+                        float friction, float inv_dt);
+
+// `index_a` et `index_b` : places des corps de l'articulation dans `bodies`
+int solver_add_joint(Solver* s, Joint* joint, int index_a, int index_b, const BodySoA* bodies,
+                     const int* slot, float inv_dt);
+
+// Coloration, rangement en lots et masses effectives ; applique les impulsions
+// du pas précédent si `warm_start`. Retourne 0 en cas d'échec d'allocation.
+int solver_prepare(Solver* s, int warm_start);
+
+// `iterations` passes sur tous les lots, avec les noyaux SIMD sélectionnés
+void solver_iterate(Solver* s, int iterations);
+
+// Recopie les vitesses dans `bodies` et les impulsions dans les variétés et articulations
+void solver_finish(Solver* s, BodySoA* bodies);
+
+// Nombre de lignes rangées (sans les cases vides)
+static inline int solver_num_rows(const Solver* s) { return s->num_descs; }
+
+#endif
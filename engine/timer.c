@@ -0,0 +1,8 @@
+#include <time.h>
+#include "timer.h"
+
+uint64_t timer_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,11 @@
+#ifndef ENGINE_TIMER_H
+#define ENGINE_TIMER_H
+
+#include <stdint.h>
+
+// Horloge monotone en nanosecondes (indépendante de SDL_GetTicks)
+uint64_t timer_now_ns(void);
+
+static inline double timer_ns_to_ms(uint64_t ns) { return (double)ns * 1e-6; }
+
+#endif
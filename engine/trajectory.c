@@ -0,0 +1,792 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "alloc.h"
+#include "timer.h"
+#include "trajectory.h"
+
+_Static_assert(sizeof(TrajectoryTransform) == 28, "pose de trajectoire : 7 mots attendus");
+_Static_assert(sizeof(TrajectoryFrameHeader) == 16, "en-tête d'image : 16 octets attendus");
+_Static_assert(sizeof(TrajectoryFileHeader) == 64, "en-tête de trajectoire : 64 octets attendus");
+_Static_assert(sizeof(TrajectoryChunkHeader) == 32, "en-tête de morceau : 32 octets attendus");
+_Static_assert(sizeof(TrajectoryIndexFooter) == 64, "épilogue de trajectoire : 64 octets attendus");
+
+#define ZERO_RUN_MIN 16       // Suite de zéros plus courte : laissée dans les octets littéraux
+#define TRANSPOSE_BLOCK 1024  // Corps transposés ensemble (28 Kio de poses)
+
+// --- Codage d'une image ---
+// Les mots de l'image (ou exclusif avec l'image précédente du morceau quand
+// elle a la même taille) sont transposés en 4 plans d'octets, les poses
+// rangées champ par champ (tous les x, puis tous les y...) : les octets de
+// poids fort et les champs qui ne changent pas d'un pas à l'autre se
+// retrouvent à la suite. Le flux est ensuite une suite de jetons
+// varint((longueur << 1) | zéro), chacun suivi de ses octets s'il s'agit
+// d'une suite littérale.
+#define POSE_WORDS (sizeof(TrajectoryTransform) / 4)
+#define HEADER_WORDS (sizeof(TrajectoryFrameHeader) / 4)
+
+// Préfixe de chaque image codée dans un morceau
+typedef struct {
+    uint32_t words;
+    uint32_t num_bodies;
+    uint32_t encoded_size;
+} EncodedFrame;
+
+// Octets codés au plus pour `bytes` octets : chaque suite de zéros en couvre
+// au moins ZERO_RUN_MIN, et chaque jeton tient en 5 octets
+static size_t encode_bound(size_t bytes) {
+    return bytes + (bytes / ZERO_RUN_MIN) * 10 + 16;
+}
+
+static inline uint32_t load_word(const unsigned char* p, size_t i) {
+    uint32_t v;
+    memcpy(&v, p + 4 * i, sizeof(v));
+    return v;
+}
+
+static inline void store_word(unsigned char* p, size_t i, uint32_t v) {
+    memcpy(p + 4 * i, &v, sizeof(v));
+}
+
+// Les 4 octets d'un mot, au rang `d` de chaque plan
+static inline void put_planes(unsigned char* planes, size_t words, size_t d, uint32_t v) {
+    planes[d] = (unsigned char)v;
+    planes[words + d] = (unsigned char)(v >> 8);
+    planes[2 * words + d] = (unsigned char)(v >> 16);
+    planes[3 * words + d] = (unsigned char)(v >> 24);
+}
+
+static inline uint32_t get_planes(const unsigned char* planes, size_t words, size_t d) {
+    return (uint32_t)planes[d] | (uint32_t)planes[words + d] << 8 | (uint32_t)planes[2 * words + d] << 16 |
+           (uint32_t)planes[3 * words + d] << 24;
+}
+
+// Rangs dans les plans : en-tête, poses champ par champ, puis pixels dans l'ordre
+static void to_planes(const unsigned char* cur, const unsigned char* prev, size_t words, size_t num_bodies,
+                      unsigned char* planes) {
+    size_t pose_end = HEADER_WORDS + num_bodies * POSE_WORDS;
+#define DELTA(i) (load_word(cur, i) ^ (prev != NULL ? load_word(prev, i) : 0))
+    for (size_t i = 0; i < HEADER_WORDS; ++i) put_planes(planes, words, i, DELTA(i));
+    // Par blocs de corps : les poses du bloc restent en cache pendant que
+    // chaque champ remplit ses 4 plans à la suite
+    for (size_t first = 0; first < num_bodies; first += TRANSPOSE_BLOCK) {
+        size_t last = first + TRANSPOSE_BLOCK < num_bodies ? first + TRANSPOSE_BLOCK : num_bodies;
+        for (size_t k = 0; k < POSE_WORDS; ++k) {
+            for (size_t body = first; body < last; ++body) {
+                put_planes(planes, words, HEADER_WORDS + k * num_bodies + body,
+                           DELTA(HEADER_WORDS + body * POSE_WORDS + k));
+            }
+        }
+    }
+    for (size_t i = pose_end; i < words; ++i) put_planes(planes, words, i, DELTA(i));
+#undef DELTA
+}
+
+static void from_planes(const unsigned char* planes, const unsigned char* prev, size_t words, size_t num_bodies,
+                        unsigned char* out) {
+    size_t pose_end = HEADER_WORDS + num_bodies * POSE_WORDS;
+#define BASE(i) (prev != NULL ? load_word(prev, i) : 0)
+    for (size_t i = 0; i < HEADER_WORDS; ++i) store_word(out, i, get_planes(planes, words, i) ^ BASE(i));
+    for (size_t first = 0; first < num_bodies; first += TRANSPOSE_BLOCK) {
+        size_t last = first + TRANSPOSE_BLOCK < num_bodies ? first + TRANSPOSE_BLOCK : num_bodies;
+        for (size_t k = 0; k < POSE_WORDS; ++k) {
+            for (size_t body = first; body < last; ++body) {
+                size_t i = HEADER_WORDS + body * POSE_WORDS + k;
+                store_word(out, i, get_planes(planes, words, HEADER_WORDS + k * num_bodies + body) ^ BASE(i));
+            }
+        }
+    }
+    for (size_t i = pose_end; i < words; ++i) store_word(out, i, get_planes(planes, words, i) ^ BASE(i));
+#undef BASE
+}
+
+static size_t put_token(unsigned char* out, uint64_t length, int zero) {
+    uint64_t v = (length << 1) | (uint64_t)zero;
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (unsigned char)v;
+    return n;
+}
+
+static size_t put_literal(unsigned char* out, const unsigned char* data, size_t length) {
+    if (length == 0) {
+        return 0;
+    }
+    size_t n = put_token(out, length, 0);
+    memcpy(out + n, data, length);
+    return n + length;
+}
+
+static inline uint64_t load_u64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Vrai si l'un des 8 octets de `v` est nul
+static inline int has_zero_byte(uint64_t v) {
+    return ((v - 0x0101010101010101ull) & ~v & 0x8080808080808080ull) != 0;
+}
+
+static size_t encode_frame(const unsigned char* cur, const unsigned char* prev, size_t words, size_t num_bodies,
+                           unsigned char* planes, unsigned char* out) {
+    to_planes(cur, prev, words, num_bodies, planes);
+    // Octets non nuls et suites de zéros parcourus 8 par 8 quand c'est possible
+    size_t bytes = 4 * words, o = 0, literal = 0, i = 0;
+    while (i < bytes) {
+        while (i + 8 <= bytes && !has_zero_byte(load_u64(planes + i))) i += 8;
+        while (i < bytes && planes[i] != 0) i++;
+        if (i == bytes) {
+            break;
+        }
+        size_t j = i;
+        while (j + 8 <= bytes && load_u64(planes + j) == 0) j += 8;
+        while (j < bytes && planes[j] == 0) j++;
+        if (j - i >= ZERO_RUN_MIN) {
+            o += put_literal(out + o, planes + literal, i - literal);
+            o += put_token(out + o, j - i, 1);
+            literal = j;
+        }
+        i = j;
+    }
+    o += put_literal(out + o, planes + literal, bytes - literal);
+    return o;
+}
+
+// 0 si le flux ne reconstitue pas exactement `words` mots
+static int decode_frame(const unsigned char* in, size_t size, const unsigned char* prev, size_t words,
+                        size_t num_bodies, unsigned char* planes, unsigned char* out) {
+    size_t bytes = 4 * words, filled = 0, pos = 0;
+    while (pos < size) {
+        uint64_t v = 0;
+        int shift = 0;
+        for (;;) {
+            if (pos >= size || shift > 35) return 0;
+            unsigned char c = in[pos++];
+            v |= (uint64_t)(c & 0x7f) << shift;
+            shift += 7;
+            if (!(c & 0x80)) break;
+        }
+        uint64_t length = v >> 1;
+        if (length > bytes - filled) return 0;
+        if (v & 1) {
+            memset(planes + filled, 0, length);
+        } else {
+            if (length > size - pos) return 0;
+            memcpy(planes + filled, in + pos, length);
+            pos += length;
+        }
+        filled += length;
+    }
+    if (filled != bytes) {
+        return 0;
+    }
+    from_planes(planes, prev, words, num_bodies, out);
+    return 1;
+}
+
+// Mots d'une image d'après son en-tête
+static size_t frame_words(const TrajectoryFrameHeader* h) {
+    return HEADER_WORDS + (size_t)h->num_bodies * POSE_WORDS + h->num_pixels;
+}
+
+static int reserve_bytes(unsigned char** data, size_t* capacity, size_t size) {
+    if (size <= *capacity) {
+        return 1;
+    }
+    size_t grown = *capacity ? *capacity : 4096;
+    while (grown < size) grown *= 2;
+    unsigned char* p = (unsigned char*)mem_realloc(*data, grown);
+    if (p == NULL) {
+        return 0;
+    }
+    mem_advise_huge_pages(p, grown);
+    *data = p;
+    *capacity = grown;
+    return 1;
+}
+
+static int write_all(int fd, const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size > 0) {
+        ssize_t written = write(fd, p, size);
+        if (written <= 0) {
+            return 0;
+        }
+        p += written;
+        size -= (size_t)written;
+    }
+    return 1;
+}
+
+// --- Écriture ---
+
+// Images brutes d'un morceau, à la suite
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    uint64_t first_frame;
+    uint32_t num_frames;
+} ChunkBuffer;
+
+struct TrajectoryWriter {
+    int fd;
+    TrajectoryFileHeader header;
+    size_t chunk_bytes;
+    uint32_t frames_per_chunk; // Fixé à la première image
+    uint64_t first_step;
+    uint64_t next_step;
+    uint64_t num_frames;
+    ChunkBuffer buffers[2];
+    int filling;               // Tampon rempli par la simulation
+    int finished;              // trajectory_finish déjà appelé
+
+    // Partagé avec le thread d'écriture, sous `lock`
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int pending;               // Tampon à écrire (-1 : aucun)
+    int stop;
+    int failed;
+    TrajectoryStats stats;
+
+    // Thread d'écriture seul
+    unsigned char* encoded;
+    size_t encoded_capacity;
+    unsigned char* planes;
+    size_t planes_capacity;
+    uint64_t* chunk_offsets;
+    uint64_t chunk_capacity;
+    uint64_t num_chunks;
+    uint64_t file_offset;
+};
+
+// Code le morceau dans `encoded` (en-tête compris) ; 0 en cas d'échec d'allocation
+static int encode_chunk(TrajectoryWriter* w, const ChunkBuffer* c, size_t* size) {
+    size_t bound = sizeof(TrajectoryChunkHeader) + (size_t)c->num_frames * (sizeof(EncodedFrame) + 16) +
+                   encode_bound(c->size);
+    if (!reserve_bytes(&w->encoded, &w->encoded_capacity, bound)) {
+        return 0;
+    }
+    size_t o = sizeof(TrajectoryChunkHeader), pos = 0, prev_pos = 0, prev_words = 0;
+    for (uint32_t f = 0; f < c->num_frames; ++f) {
+        TrajectoryFrameHeader h;
+        memcpy(&h, c->data + pos, sizeof(h));
+        size_t words = frame_words(&h);
+        if (!reserve_bytes(&w->planes, &w->planes_capacity, 4 * words)) {
+            return 0;
+        }
+        const unsigned char* prev = (f > 0 && prev_words == words) ? c->data + prev_pos : NULL;
+        EncodedFrame e = {(uint32_t)words, h.num_bodies, 0};
+        e.encoded_size = (uint32_t)encode_frame(c->data + pos, prev, words, h.num_bodies, w->planes,
+                                                w->encoded + o + sizeof(e));
+        memcpy(w->encoded + o, &e, sizeof(e));
+        o += sizeof(e) + e.encoded_size;
+        prev_pos = pos;
+        prev_words = words;
+        pos += 4 * words;
+    }
+    TrajectoryChunkHeader ch = {c->first_frame, c->num_frames, 0, c->size, o - sizeof(ch)};
+    memcpy(w->encoded, &ch, sizeof(ch));
+    *size = o;
+    return 1;
+}
+
+static int write_chunk(TrajectoryWriter* w, const ChunkBuffer* c, uint64_t* encode_ns, uint64_t* write_ns) {
+    uint64_t t0 = timer_now_ns();
+    size_t size;
+    if (!encode_chunk(w, c, &size)) {
+        return 0;
+    }
+    if (w->num_chunks == w->chunk_capacity) {
+        uint64_t capacity = w->chunk_capacity ? w->chunk_capacity * 2 : 64;
+        uint64_t* offsets = (uint64_t*)mem_realloc(w->chunk_offsets, capacity * sizeof(uint64_t));
+        if (offsets == NULL) {
+            return 0;
+        }
+        w->chunk_offsets = offsets;
+        w->chunk_capacity = capacity;
+    }
+    uint64_t t1 = timer_now_ns();
+    *encode_ns = t1 - t0;
+    if (!write_all(w->fd, w->encoded, size)) {
+        return 0;
+    }
+    *write_ns = timer_now_ns() - t1;
+    w->chunk_offsets[w->num_chunks++] = w->file_offset;
+    w->file_offset += size;
+    return 1;
+}
+
+static void* writer_main(void* arg) {
+    TrajectoryWriter* w = (TrajectoryWriter*)arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->pending < 0 && !w->stop) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        if (w->pending < 0) {
+            break;
+        }
+        const ChunkBuffer* c = &w->buffers[w->pending];
+        int ok = !w->failed;
+        pthread_mutex_unlock(&w->lock);
+
+        uint64_t encode_ns = 0, write_ns = 0;
+        ok = ok && write_chunk(w, c, &encode_ns, &write_ns);
+
+        pthread_mutex_lock(&w->lock);
+        if (ok) {
+            w->stats.num_chunks = w->num_chunks;
+            w->stats.file_bytes = w->file_offset;
+            w->stats.encode_ns += encode_ns;
+            w->stats.write_ns += write_ns;
+        } else {
+            w->failed = 1;
+        }
+        w->pending = -1;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+TrajectoryWriter* create_trajectory_writer(const char* path, int stride, int width, int height,
+                                           float fixed_dt, size_t chunk_bytes) {
+    TrajectoryWriter* w = (TrajectoryWriter*)mem_calloc(1, sizeof(TrajectoryWriter));
+    if (w == NULL) {
+        printf("Allocation impossible : %s non écrit\n", path);
+        return NULL;
+    }
+    memcpy(w->header.magic, TRAJECTORY_FILE_MAGIC, sizeof(w->header.magic));
+    w->header.version = TRAJECTORY_FILE_VERSION;
+    w->header.header_size = sizeof(TrajectoryFileHeader);
+    w->header.stride = (uint32_t)(stride > 0 ? stride : 1);
+    w->header.width = (uint32_t)(width > 0 && height > 0 ? width : 0);
+    w->header.height = (uint32_t)(width > 0 && height > 0 ? height : 0);
+    w->header.fixed_dt = fixed_dt;
+    w->header.transform_stride = sizeof(TrajectoryTransform);
+    w->chunk_bytes = chunk_bytes > 0 ? chunk_bytes : TRAJECTORY_DEFAULT_CHUNK_BYTES;
+    w->pending = -1;
+
+    w->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (w->fd < 0) {
+        printf("Impossible de créer %s\n", path);
+        mem_free(w);
+        return NULL;
+    }
+    if (!write_all(w->fd, &w->header, sizeof(w->header))) {
+        printf("Écriture impossible dans %s\n", path);
+        close(w->fd);
+        mem_free(w);
+        return NULL;
+    }
+    w->file_offset = sizeof(w->header);
+    w->stats.file_bytes = w->file_offset;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, writer_main, w) != 0) {
+        printf("Thread d'écriture impossible pour %s\n", path);
+        pthread_cond_destroy(&w->cond);
+        pthread_mutex_destroy(&w->lock);
+        close(w->fd);
+        mem_free(w);
+        return NULL;
+    }
+    return w;
+}
+
+// Passe le morceau rempli au thread d'écriture, une fois le précédent écrit
+static int submit(TrajectoryWriter* w) {
+    uint64_t t0 = timer_now_ns();
+    pthread_mutex_lock(&w->lock);
+    while (w->pending >= 0) {
+        pthread_cond_wait(&w->cond, &w->lock);
+    }
+    w->stats.stall_ns += timer_now_ns() - t0;
+    int ok = !w->failed;
+    w->pending = w->filling;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+
+    w->filling ^= 1;
+    w->buffers[w->filling].size = 0;
+    w->buffers[w->filling].num_frames = 0;
+    return ok;
+}
+
+int trajectory_append(TrajectoryWriter* w, const World* world, const Framebuffer* fb) {
+    if (w->finished) {
+        return 0;
+    }
+    uint64_t step = world->step_count;
+    if (w->num_frames == 0) {
+        w->first_step = w->next_step = step;
+    }
+    if (step < w->next_step) {
+        return 1;
+    }
+    if (step > w->next_step) {
+        printf("Trajectoire : pas %llu attendu, pas %llu reçu\n", (unsigned long long)w->next_step,
+               (unsigned long long)step);
+        return 0;
+    }
+    uint32_t num_pixels = w->header.width * w->header.height;
+    if (num_pixels > 0 && (fb == NULL || fb->width != (int)w->header.width || fb->height != (int)w->header.height)) {
+        printf("Trajectoire : image de %ux%u attendue\n", w->header.width, w->header.height);
+        return 0;
+    }
+
+    uint64_t t0 = timer_now_ns();
+    int n = world->num_bodies;
+    TrajectoryFrameHeader h = {step, (uint32_t)n, num_pixels};
+    size_t bytes = 4 * frame_words(&h);
+    if (w->frames_per_chunk == 0) {
+        size_t frames = w->chunk_bytes / bytes;
+        if (frames < TRAJECTORY_MIN_FRAMES_PER_CHUNK) frames = TRAJECTORY_MIN_FRAMES_PER_CHUNK;
+        if (frames > TRAJECTORY_MAX_FRAMES_PER_CHUNK) frames = TRAJECTORY_MAX_FRAMES_PER_CHUNK;
+        w->frames_per_chunk = (uint32_t)frames;
+    }
+    ChunkBuffer* c = &w->buffers[w->filling];
+    if (!reserve_bytes(&c->data, &c->capacity, c->size + bytes)) {
+        printf("Trajectoire : allocation impossible\n");
+        return 0;
+    }
+    unsigned char* out = c->data + c->size;
+    memcpy(out, &h, sizeof(h));
+    TrajectoryTransform* poses = (TrajectoryTransform*)(out + sizeof(h));
+    const BodySoA* s = &world->state;
+    for (int id = 0; id < n; ++id) {
+        int k = world->body_slot[id];
+        poses[id] = (TrajectoryTransform){{s->px[k], s->py[k], s->pz[k]}, {s->qx[k], s->qy[k], s->qz[k], s->qw[k]}};
+    }
+    if (num_pixels > 0) {
+        uint32_t* pixels = (uint32_t*)(poses + n);
+        for (int y = 0; y < fb->height; ++y) {
+            memcpy(pixels + (size_t)y * fb->width, fb->pixels + (size_t)y * fb->pitch,
+                   (size_t)fb->width * sizeof(uint32_t));
+        }
+    }
+    if (c->num_frames == 0) {
+        c->first_frame = w->num_frames;
+    }
+    c->size += bytes;
+    c->num_frames++;
+    w->num_frames++;
+    w->next_step = step + w->header.stride;
+    w->stats.num_frames = w->num_frames;
+    w->stats.raw_bytes += bytes;
+    w->stats.capture_ns += timer_now_ns() - t0;
+
+    if (c->num_frames == w->frames_per_chunk && !submit(w)) {
+        printf("Trajectoire : écriture impossible\n");
+        return 0;
+    }
+    return 1;
+}
+
+TrajectoryStats trajectory_writer_stats(TrajectoryWriter* w) {
+    pthread_mutex_lock(&w->lock);
+    TrajectoryStats st = w->stats;
+    pthread_mutex_unlock(&w->lock);
+    return st;
+}
+
+int trajectory_finish(TrajectoryWriter* w) {
+    if (w->finished) {
+        return !w->failed;
+    }
+    w->finished = 1;
+    int ok = w->buffers[w->filling].num_frames == 0 || submit(w);
+    pthread_mutex_lock(&w->lock);
+    w->stop = 1;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    ok = ok && !w->failed;
+
+    if (ok) {
+        TrajectoryIndexFooter footer;
+        memset(&footer, 0, sizeof(footer));
+        memcpy(footer.magic, TRAJECTORY_INDEX_MAGIC, sizeof(footer.magic));
+        footer.first_step = w->first_step;
+        footer.num_frames = w->num_frames;
+        footer.num_chunks = w->num_chunks;
+        footer.index_offset = w->file_offset;
+        footer.frames_per_chunk = w->frames_per_chunk;
+        ok = (w->num_chunks == 0 || write_all(w->fd, w->chunk_offsets, w->num_chunks * sizeof(uint64_t))) &&
+             write_all(w->fd, &footer, sizeof(footer));
+        w->stats.file_bytes += w->num_chunks * sizeof(uint64_t) + sizeof(footer);
+    }
+    if (close(w->fd) != 0) {
+        ok = 0;
+    }
+    if (!ok) {
+        printf("Trajectoire : écriture impossible\n");
+    }
+    w->failed = !ok;
+    return ok;
+}
+
+int free_trajectory_writer(TrajectoryWriter* w) {
+    if (w == NULL) {
+        return 1;
+    }
+    int ok = trajectory_finish(w);
+    for (int b = 0; b < 2; ++b) {
+        mem_free(w->buffers[b].data);
+    }
+    mem_free(w->encoded);
+    mem_free(w->planes);
+    mem_free(w->chunk_offsets);
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->lock);
+    mem_free(w);
+    return ok;
+}
+
+// --- Lecture ---
+
+static int read_chunk_header(const TrajectoryReader* r, uint64_t offset, TrajectoryChunkHeader* ch) {
+    if (offset < sizeof(TrajectoryFileHeader) || offset > r->size || r->size - offset < sizeof(*ch)) {
+        return 0;
+    }
+    memcpy(ch, (const char*)r->mapping + offset, sizeof(*ch));
+    return ch->encoded_size <= r->size - offset - sizeof(*ch);
+}
+
+// Table de l'épilogue ; 0 s'il est absent ou incohérent
+static int read_footer(TrajectoryReader* r) {
+    TrajectoryIndexFooter footer;
+    if (r->size < sizeof(TrajectoryFileHeader) + sizeof(footer)) {
+        return 0;
+    }
+    memcpy(&footer, (const char*)r->mapping + r->size - sizeof(footer), sizeof(footer));
+    if (memcmp(footer.magic, TRAJECTORY_INDEX_MAGIC, sizeof(footer.magic)) != 0 ||
+        footer.num_chunks > (r->size - sizeof(footer)) / sizeof(uint64_t) ||
+        footer.index_offset + footer.num_chunks * sizeof(uint64_t) + sizeof(footer) != r->size ||
+        footer.frames_per_chunk == 0 ||
+        footer.num_frames > footer.num_chunks * (uint64_t)footer.frames_per_chunk) {
+        return 0;
+    }
+    r->chunk_offsets = (uint64_t*)mem_alloc(footer.num_chunks * sizeof(uint64_t) + 1);
+    if (r->chunk_offsets == NULL) {
+        return 0;
+    }
+    memcpy(r->chunk_offsets, (const char*)r->mapping + footer.index_offset, footer.num_chunks * sizeof(uint64_t));
+    for (uint64_t c = 0; c < footer.num_chunks; ++c) {
+        if (r->chunk_offsets[c] < sizeof(TrajectoryFileHeader) ||
+            r->chunk_offsets[c] + sizeof(TrajectoryChunkHeader) > footer.index_offset) {
+            mem_free(r->chunk_offsets);
+            r->chunk_offsets = NULL;
+            return 0;
+        }
+    }
+    r->first_step = footer.first_step;
+    r->num_frames = footer.num_frames;
+    r->num_chunks = footer.num_chunks;
+    r->frames_per_chunk = footer.frames_per_chunk;
+    return 1;
+}
+
+// Sans épilogue : les morceaux complets se suivent depuis l'en-tête du fichier
+static int recover_index(TrajectoryReader* r) {
+    uint64_t capacity = 64, offset = sizeof(TrajectoryFileHeader);
+    r->chunk_offsets = (uint64_t*)mem_alloc(capacity * sizeof(uint64_t));
+    if (r->chunk_offsets == NULL) {
+        return 0;
+    }
+    TrajectoryChunkHeader ch;
+    while (read_chunk_header(r, offset, &ch) && ch.first_frame == r->num_frames && ch.num_frames > 0 &&
+           (r->num_chunks == 0 || ch.num_frames <= r->frames_per_chunk)) {
+        if (r->num_chunks == 0) {
+            r->frames_per_chunk = ch.num_frames;
+        } else if (r->num_frames % r->frames_per_chunk != 0) {
+            break; // Seul le dernier morceau peut être incomplet
+        }
+        if (r->num_chunks == capacity) {
+            capacity *= 2;
+            uint64_t* offsets = (uint64_t*)mem_realloc(r->chunk_offsets, capacity * sizeof(uint64_t));
+            if (offsets == NULL) {
+                return 0;
+            }
+            r->chunk_offsets = offsets;
+        }
+        r->chunk_offsets[r->num_chunks++] = offset;
+        r->num_frames += ch.num_frames;
+        offset += sizeof(ch) + ch.encoded_size;
+    }
+    r->recovered = 1;
+    return 1;
+}
+
+int trajectory_reader_open(TrajectoryReader* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+    r->cached_chunk = -1;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Impossible d'ouvrir %s\n", path);
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TrajectoryFileHeader)) {
+        printf("%s : fichier trop court\n", path);
+        close(fd);
+        return 0;
+    }
+    r->size = (size_t)st.st_size;
+    r->mapping = mmap(NULL, r->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // La projection garde sa propre référence au fichier
+    if (r->mapping == MAP_FAILED) {
+        printf("Projection en mémoire impossible pour %s\n", path);
+        r->mapping = NULL;
+        return 0;
+    }
+
+    memcpy(&r->header, r->mapping, sizeof(r->header));
+    const TrajectoryFileHeader* h = &r->header;
+    const char* error = NULL;
+    if (memcmp(h->magic, TRAJECTORY_FILE_MAGIC, sizeof(h->magic)) != 0) error = "signature inconnue";
+    else if (h->version != TRAJECTORY_FILE_VERSION) error = "version non prise en charge";
+    else if (h->header_size != sizeof(TrajectoryFileHeader) || h->transform_stride != sizeof(TrajectoryTransform) ||
+             h->stride == 0 || (uint64_t)h->width * h->height > UINT32_MAX) error = "en-tête incohérent";
+    else if (!read_footer(r) && !recover_index(r)) error = "allocation impossible";
+    TrajectoryFrame first;
+    if (error == NULL && r->recovered && r->num_frames > 0) {
+        // Premier pas : celui de la première image
+        if (trajectory_read_frame(r, 0, &first)) r->first_step = first.step;
+        else error = "premier morceau corrompu";
+    }
+    if (error != NULL) {
+        printf("%s : %s\n", path, error);
+        trajectory_reader_close(r);
+        return 0;
+    }
+    return 1;
+}
+
+void trajectory_reader_close(TrajectoryReader* r) {
+    if (r->mapping != NULL) {
+        munmap(r->mapping, r->size);
+    }
+    mem_free(r->chunk_offsets);
+    mem_free(r->frames);
+    mem_free(r->frame_start);
+    mem_free(r->planes);
+    memset(r, 0, sizeof(*r));
+    r->cached_chunk = -1;
+}
+
+// Prépare le décodage du morceau : images décodées ensuite à la demande
+static int open_chunk(TrajectoryReader* r, uint64_t chunk) {
+    r->cached_chunk = -1;
+    TrajectoryChunkHeader ch;
+    if (!read_chunk_header(r, r->chunk_offsets[chunk], &ch) || ch.first_frame != chunk * r->frames_per_chunk ||
+        ch.num_frames == 0 || ch.num_frames > r->frames_per_chunk || ch.raw_size > SIZE_MAX / 2 ||
+        !reserve_bytes(&r->frames, &r->frames_capacity, (size_t)ch.raw_size)) {
+        return 0;
+    }
+    if (ch.num_frames > r->frame_start_capacity) {
+        size_t* starts = (size_t*)mem_realloc(r->frame_start, ch.num_frames * sizeof(size_t));
+        if (starts == NULL) {
+            return 0;
+        }
+        r->frame_start = starts;
+        r->frame_start_capacity = ch.num_frames;
+    }
+    r->cached_chunk = (int64_t)chunk;
+    r->cached_frames = ch.num_frames;
+    r->decoded_frames = 0;
+    r->chunk_raw_size = ch.raw_size;
+    r->chunk_encoded_size = ch.encoded_size;
+    r->decode_pos = 0;
+    r->decode_raw = 0;
+    return 1;
+}
+
+// Décode les images du morceau en cache jusqu'à `index` compris : chaque
+// image dépend de la précédente, mais pas des suivantes
+static int decode_frames(TrajectoryReader* r, uint32_t index) {
+    const unsigned char* in =
+        (const unsigned char*)r->mapping + r->chunk_offsets[r->cached_chunk] + sizeof(TrajectoryChunkHeader);
+    size_t pos = r->decode_pos, raw = r->decode_raw;
+    while (r->decoded_frames <= index) {
+        uint32_t f = r->decoded_frames;
+        EncodedFrame e;
+        TrajectoryFrameHeader h;
+        if (r->chunk_encoded_size - pos < sizeof(e)) return 0;
+        memcpy(&e, in + pos, sizeof(e));
+        pos += sizeof(e);
+        size_t bytes = 4 * (size_t)e.words;
+        if (e.encoded_size > r->chunk_encoded_size - pos || bytes > r->chunk_raw_size - raw || bytes < sizeof(h) ||
+            (uint64_t)e.num_bodies * POSE_WORDS > e.words - HEADER_WORDS ||
+            !reserve_bytes(&r->planes, &r->planes_capacity, bytes)) {
+            return 0;
+        }
+        unsigned char* out = r->frames + raw;
+        const unsigned char* prev =
+            (f > 0 && raw - r->frame_start[f - 1] == bytes) ? r->frames + r->frame_start[f - 1] : NULL;
+        if (!decode_frame(in + pos, e.encoded_size, prev, e.words, e.num_bodies, r->planes, out)) {
+            return 0;
+        }
+        memcpy(&h, out, sizeof(h));
+        if (frame_words(&h) != e.words || h.num_bodies != e.num_bodies ||
+            (h.num_pixels != 0 && h.num_pixels != r->header.width * r->header.height)) {
+            return 0;
+        }
+        r->frame_start[f] = raw;
+        raw += bytes;
+        pos += e.encoded_size;
+        r->decoded_frames++;
+        r->decode_pos = pos;
+        r->decode_raw = raw;
+    }
+    if (r->decoded_frames == r->cached_frames && (raw != r->chunk_raw_size || pos != r->chunk_encoded_size)) {
+        return 0;
+    }
+    return 1;
+}
+
+int trajectory_read_frame(TrajectoryReader* r, uint64_t frame, TrajectoryFrame* out) {
+    if (frame >= r->num_frames) {
+        return 0;
+    }
+    uint64_t chunk = frame / r->frames_per_chunk;
+    if (r->cached_chunk != (int64_t)chunk && !open_chunk(r, chunk)) {
+        return 0;
+    }
+    uint64_t index = frame - chunk * r->frames_per_chunk;
+    if (index >= r->cached_frames) {
+        return 0; // Table et morceau en désaccord
+    }
+    if (index >= r->decoded_frames && !decode_frames(r, (uint32_t)index)) {
+        r->cached_chunk = -1;
+        return 0;
+    }
+    const unsigned char* data = r->frames + r->frame_start[index];
+    TrajectoryFrameHeader h;
+    memcpy(&h, data, sizeof(h));
+    out->step = h.step;
+    out->num_bodies = (int)h.num_bodies;
+    out->transforms = (const TrajectoryTransform*)(data + sizeof(h));
+    out->width = h.num_pixels > 0 ? (int)r->header.width : 0;
+    out->height = h.num_pixels > 0 ? (int)r->header.height : 0;
+    out->pixels = h.num_pixels > 0 ? (const uint32_t*)(out->transforms + h.num_bodies) : NULL;
+    return 1;
+}
+
+int64_t trajectory_frame_of_step(const TrajectoryReader* r, uint64_t step) {
+    if (step < r->first_step || (step - r->first_step) % r->header.stride != 0) {
+        return -1;
+    }
+    uint64_t frame = (step - r->first_step) / r->header.stride;
+    return frame < r->num_frames ? (int64_t)frame : -1;
+}
@@ -0,0 +1,169 @@
+#ifndef ENGINE_TRAJECTORY_H
+#define ENGINE_TRAJECTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "math3d.h"
+#include "raster.h"
+#include "world.h"
+
+// --- Trajectoire ---
+// Sortie en flux des poses des corps à chaque pas enregistré, et en option
+// d'une image par pas, pour l'analyse hors ligne sur des nœuds sans affichage.
+//
+// Les images (poses dans l'ordre des identifiants, puis pixels) sont groupées
+// par morceaux d'un même nombre d'images. Dans un morceau, chaque image est
+// codée par différence (ou exclusif) avec la précédente, octets transposés
+// par plans puis suites de zéros condensées : un corps immobile ne coûte
+// presque rien, et chaque morceau se décode seul. Le thread de simulation
+// recopie l'image dans un des deux tampons de morceau ; un thread
+// d'entrées-sorties code et écrit l'autre. La simulation n'attend que si ce
+// thread a encore un morceau entier de retard.
+//
+// Fichier : en-tête de 64 octets, morceaux (en-tête de 32 octets puis images
+// codées), table des positions des morceaux et épilogue de 64 octets à la fin.
+// Pas enregistrés à intervalle fixe : pas -> image -> morceau par simple
+// division, puis une lecture de la table. Un fichier sans épilogue (exécution
+// interrompue) se relit en parcourant les morceaux. Petit-boutiste uniquement.
+#define TRAJECTORY_FILE_MAGIC "PHTRAJ\r\n" // \r\n : détecte un transfert en mode texte
+#define TRAJECTORY_INDEX_MAGIC "PHTRIDX\n"
+#define TRAJECTORY_FILE_VERSION 1
+#define TRAJECTORY_DEFAULT_CHUNK_BYTES (4 << 20) // Taille visée d'un morceau avant codage
+#define TRAJECTORY_MIN_FRAMES_PER_CHUNK 4    // Même pour de grandes images : le codage par différence a besoin de voisines
+#define TRAJECTORY_MAX_FRAMES_PER_CHUNK 256
+
+// Pose d'un corps (7 mots de 32 bits)
+typedef struct {
+    Vec3D position;
+    Quat orientation;
+} TrajectoryTransform;
+
+// Début de chaque image, suivi de num_bodies TrajectoryTransform puis de
+// num_pixels pixels (0xRRGGBBAA, lignes de `width` pixels sans remplissage)
+typedef struct {
+    uint64_t step;         // world->step_count après le pas
+    uint32_t num_bodies;
+    uint32_t num_pixels;   // 0 ou width * height
+} TrajectoryFrameHeader;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;  // sizeof(TrajectoryFileHeader)
+    uint32_t stride;       // Pas entre deux images
+    uint32_t width;        // Images : 0 sans pixels
+    uint32_t height;
+    float fixed_dt;
+    uint32_t transform_stride; // sizeof(TrajectoryTransform)
+    uint8_t reserved[28];
+} TrajectoryFileHeader;
+
+typedef struct {
+    uint64_t first_frame;
+    uint32_t num_frames;
+    uint32_t reserved;
+    uint64_t raw_size;     // Octets des images décodées
+    uint64_t encoded_size; // Octets qui suivent cet en-tête
+} TrajectoryChunkHeader;
+
+// Dernier bloc du fichier, précédé de la table (uint64 par morceau : position
+// de son en-tête)
+typedef struct {
+    char magic[8];
+    uint64_t first_step;
+    uint64_t num_frames;
+    uint64_t num_chunks;
+    uint64_t index_offset;
+    uint32_t frames_per_chunk;
+    uint8_t reserved[20];
+} TrajectoryIndexFooter;
+
+typedef struct {
+    uint64_t num_frames;
+    uint64_t num_chunks;
+    uint64_t raw_bytes;     // Images avant codage
+    uint64_t file_bytes;    // Écrits jusqu'ici
+    uint64_t capture_ns;    // Recopie des images (thread de simulation)
+    uint64_t stall_ns;      // Attente du thread d'écriture (thread de simulation)
+    uint64_t encode_ns;     // Codage (thread d'écriture)
+    uint64_t write_ns;      // Appels write (thread d'écriture)
+} TrajectoryStats;
+
+typedef struct TrajectoryWriter TrajectoryWriter; // Défini dans trajectory.c
+
+// Crée le fichier et le thread d'écriture. Une image tous les `stride` pas ;
+// width * height pixels par image si width > 0 ; morceaux d'environ
+// chunk_bytes octets (0 : TRAJECTORY_DEFAULT_CHUNK_BYTES). NULL en cas
+// d'échec, avec un message sur la sortie standard.
+TrajectoryWriter* create_trajectory_writer(const char* path, int stride, int width, int height,
+                                           float fixed_dt, size_t chunk_bytes);
+
+// À appeler après chaque pas : enregistre le monde (et `fb`, de la taille
+// donnée à la création, si les images sont demandées) quand world->step_count
+// tombe sur un pas enregistré. Le premier appel fixe le premier pas ; les pas
+// enregistrés doivent ensuite se suivre sans trou. Retourne 0 en cas d'erreur
+// (pas manquant, allocation, écriture).
+int trajectory_append(TrajectoryWriter* w, const World* world, const Framebuffer* fb);
+
+// Statistiques à jour (le thread d'écriture peut être en cours)
+TrajectoryStats trajectory_writer_stats(TrajectoryWriter* w);
+
+// Écrit le dernier morceau, la table et l'épilogue, arrête le thread et ferme
+// le fichier ; les statistiques restent lisibles. Retourne 0 si une écriture
+// a échoué.
+int trajectory_finish(TrajectoryWriter* w);
+
+// trajectory_finish si besoin, puis libère l'écrivain
+int free_trajectory_writer(TrajectoryWriter* w);
+
+// --- Lecture ---
+
+typedef struct {
+    uint64_t step;
+    int num_bodies;
+    const TrajectoryTransform* transforms; // Par identifiant de corps
+    int width, height;                     // 0 sans pixels
+    const uint32_t* pixels;
+} TrajectoryFrame;
+
+typedef struct {
+    void* mapping;
+    size_t size;
+    TrajectoryFileHeader header;
+    uint64_t first_step;
+    uint64_t num_frames;
+    uint64_t num_chunks;
+    uint32_t frames_per_chunk;
+    uint64_t* chunk_offsets;  // Position de l'en-tête de chaque morceau
+    int recovered;            // Table reconstruite (épilogue absent)
+
+    // Morceau lu en dernier, décodé jusqu'à l'image demandée
+    int64_t cached_chunk;     // -1 : aucun
+    uint32_t cached_frames;   // Images du morceau
+    uint32_t decoded_frames;  // Images déjà décodées, depuis le début du morceau
+    uint64_t chunk_raw_size;
+    uint64_t chunk_encoded_size;
+    size_t decode_pos;        // Reprise du décodage dans le flux codé
+    size_t decode_raw;        // ... et dans `frames`
+    unsigned char* frames;    // Images du morceau à la suite
+    size_t frames_capacity;
+    size_t* frame_start;      // Début de chaque image dans `frames`, en octets
+    uint32_t frame_start_capacity;
+    unsigned char* planes;    // Plans d'octets d'une image en cours de décodage
+    size_t planes_capacity;
+} TrajectoryReader;
+
+// Projette le fichier en mémoire et lit la table ; 0 en cas d'erreur
+// (message sur la sortie standard)
+int trajectory_reader_open(TrajectoryReader* r, const char* path);
+void trajectory_reader_close(TrajectoryReader* r);
+
+// Image `frame` (0 <= frame < num_frames) : décode son morceau jusqu'à elle
+// s'il n'est pas déjà en cache. Les pointeurs restent valides jusqu'à la lecture d'un
+// autre morceau. 0 si le morceau est corrompu.
+int trajectory_read_frame(TrajectoryReader* r, uint64_t frame, TrajectoryFrame* out);
+
+// Image du pas `step` ; -1 si ce pas n'a pas été enregistré
+int64_t trajectory_frame_of_step(const TrajectoryReader* r, uint64_t step);
+
+#endif
@@ -0,0 +1,18 @@
+#include "transform.h"
+
+Quat quat_from_axis_angle(Vec3D axis, float angle_rad) {
+    float len = vec3_length(axis);
+    if (len == 0.0f) {
+        return quat_identity();
+    }
+    float s = sinf(0.5f * angle_rad) / len;
+    return (Quat){axis.x * s, axis.y * s, axis.z * s, cosf(0.5f * angle_rad)};
+}
+
+Quat quat_from_euler(Vec3D rotation) {
+    // matrix_make_rotation_y tourne dans le sens indirect autour de Y : angle opposé
+    Quat qx = quat_from_axis_angle((Vec3D){1.0f, 0.0f, 0.0f}, rotation.x);
+    Quat qy = quat_from_axis_angle((Vec3D){0.0f, 1.0f, 0.0f}, -rotation.y);
+    Quat qz = quat_from_axis_angle((Vec3D){0.0f, 0.0f, 1.0f}, rotation.z);
+    return quat_mul(qz, quat_mul(qy, qx));
+}
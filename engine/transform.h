@@ -0,0 +1,140 @@
+#ifndef ENGINE_TRANSFORM_H
+#define ENGINE_TRANSFORM_H
+
+#include "math3d.h"
+
+// Quaternion unitaire d'orientation (x, y, z : partie vectorielle, w : scalaire)
+typedef struct {
+    float x, y, z, w;
+} Quat;
+
+// Transformation affine compacte, même convention vecteur ligne que Mat4x4 :
+// v' = v * L + t, avec L = m[0..2] et t = m[3]. La dernière colonne de la
+// Mat4x4 équivalente, (0, 0, 0, 1), est implicite et n'est jamais calculée.
+typedef struct {
+    float m[4][3];
+} Affine3x4;
+
+// --- Constantes évaluées à la compilation ---
+// Utilisables dans un initialiseur statique, comme MAT4X4_PROJECTION_INIT (math3d.h).
+
+#define QUAT_IDENTITY_INIT {0.0f, 0.0f, 0.0f, 1.0f}
+#define AFFINE_IDENTITY_INIT {{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}}}
+
+// --- Quaternions ---
+
+static inline Quat quat_identity(void) { return (Quat)QUAT_IDENTITY_INIT; }
+
+// Produit de Hamilton : appliquer `b` puis `a`
+static inline Quat quat_mul(Quat a, Quat b) {
+    return (Quat){a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                  a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                  a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                  a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+static inline Quat quat_normalize(Quat q) {
+    float inv = 1.0f / sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return (Quat){q.x * inv, q.y * inv, q.z * inv, q.w * inv};
+}
+
+// Rotation inverse (quaternion unitaire)
+static inline Quat quat_conjugate(Quat q) { return (Quat){-q.x, -q.y, -q.z, q.w}; }
+
+// Rotation d'un vecteur : v + 2w(u x v) + 2u x (u x v), sans passer par une matrice
+static inline Vec3D quat_rotate(Quat q, Vec3D v) {
+    Vec3D u = {q.x, q.y, q.z};
+    Vec3D t = vec3_scale(vec3_cross(u, v), 2.0f);
+    return vec3_add(vec3_add(v, vec3_scale(t, q.w)), vec3_cross(u, t));
+}
+
+// Avance l'orientation d'un pas `dt` à la vitesse angulaire `w` (rad/s, repère
+// monde) : q += dt/2 * (w, 0) * q, puis renormalisation. Pas d'angles d'Euler,
+// donc ni blocage de cardan ni dérive de la norme.
+static inline Quat quat_integrate(Quat q, Vec3D w, float dt) {
+    float h = 0.5f * dt;
+    Quat r = {q.x + h * (q.w * w.x + w.y * q.z - w.z * q.y),
+              q.y + h * (q.w * w.y + w.z * q.x - w.x * q.z),
+              q.z + h * (q.w * w.z + w.x * q.y - w.y * q.x),
+              q.w - h * (w.x * q.x + w.y * q.y + w.z * q.z)};
+    return quat_normalize(r);
+}
+
+Quat quat_from_axis_angle(Vec3D axis, float angle_rad);
+
+// Même rotation que matrix_make_srt : X, puis Y, puis Z
+Quat quat_from_euler(Vec3D rotation);
+
+// --- Transformations affines ---
+
+static inline Affine3x4 affine_identity(void) { return (Affine3x4)AFFINE_IDENTITY_INIT; }
+
+// Scale -> Rotate -> Translate, sans aucune fonction trigonométrique
+static inline Affine3x4 affine_from_trs(Vec3D position, Quat q, Vec3D scale) {
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    // Lignes de la matrice de rotation en convention vecteur ligne, chacune
+    // multipliée par l'échelle de son axe (l'échelle s'applique en premier)
+    return (Affine3x4){{{scale.x * (1.0f - 2.0f * (yy + zz)), scale.x * 2.0f * (xy + wz), scale.x * 2.0f * (xz - wy)},
+                        {scale.y * 2.0f * (xy - wz), scale.y * (1.0f - 2.0f * (xx + zz)), scale.y * 2.0f * (yz + wx)},
+                        {scale.z * 2.0f * (xz + wy), scale.z * 2.0f * (yz - wx), scale.z * (1.0f - 2.0f * (xx + yy))},
+                        {position.x, position.y, position.z}}};
+}
+
+// Composition : appliquer `a` puis `b` (36 multiplications, contre 64 en Mat4x4)
+static inline Affine3x4 affine_mul(const Affine3x4* a, const Affine3x4* b) {
+    Affine3x4 r;
+    for (int c = 0; c < 3; ++c) {
+        float b0 = b->m[0][c], b1 = b->m[1][c], b2 = b->m[2][c];
+        r.m[0][c] = a->m[0][0] * b0 + a->m[0][1] * b1 + a->m[0][2] * b2;
+        r.m[1][c] = a->m[1][0] * b0 + a->m[1][1] * b1 + a->m[1][2] * b2;
+        r.m[2][c] = a->m[2][0] * b0 + a->m[2][1] * b1 + a->m[2][2] * b2;
+        r.m[3][c] = a->m[3][0] * b0 + a->m[3][1] * b1 + a->m[3][2] * b2 + b->m[3][c];
+    }
+    return r;
+}
+
+// Appliquer `a` puis une matrice complète (ex. vue-projection) : 48 multiplications
+static inline Mat4x4 affine_mul_mat4(const Affine3x4* a, const Mat4x4* b) {
+    Mat4x4 r;
+    for (int c = 0; c < 4; ++c) {
+        float b0 = b->m[0][c], b1 = b->m[1][c], b2 = b->m[2][c];
+        r.m[0][c] = a->m[0][0] * b0 + a->m[0][1] * b1 + a->m[0][2] * b2;
+        r.m[1][c] = a->m[1][0] * b0 + a->m[1][1] * b1 + a->m[1][2] * b2;
+        r.m[2][c] = a->m[2][0] * b0 + a->m[2][1] * b1 + a->m[2][2] * b2;
+        r.m[3][c] = a->m[3][0] * b0 + a->m[3][1] * b1 + a->m[3][2] * b2 + b->m[3][c];
+    }
+    return r;
+}
+
+static inline Vec3D affine_apply_point(const Affine3x4* a, Vec3D v) {
+    return (Vec3D){v.x * a->m[0][0] + v.y * a->m[1][0] + v.z * a->m[2][0] + a->m[3][0],
+                   v.x * a->m[0][1] + v.y * a->m[1][1] + v.z * a->m[2][1] + a->m[3][1],
+                   v.x * a->m[0][2] + v.y * a->m[1][2] + v.z * a->m[2][2] + a->m[3][2]};
+}
+
+// Boîte monde englobant la boîte locale transformée (méthode d'Arvo) : le
+// centre est transformé, les demi-côtés s'additionnent en valeur absolue
+static inline AABB affine_transform_aabb(const Affine3x4* a, const AABB* box) {
+    Vec3D c = {0.5f * (box->min.x + box->max.x), 0.5f * (box->min.y + box->max.y), 0.5f * (box->min.z + box->max.z)};
+    Vec3D e = {0.5f * (box->max.x - box->min.x), 0.5f * (box->max.y - box->min.y), 0.5f * (box->max.z - box->min.z)};
+    Vec3D wc = affine_apply_point(a, c);
+    Vec3D we = {e.x * fabsf(a->m[0][0]) + e.y * fabsf(a->m[1][0]) + e.z * fabsf(a->m[2][0]),
+                e.x * fabsf(a->m[0][1]) + e.y * fabsf(a->m[1][1]) + e.z * fabsf(a->m[2][1]),
+                e.x * fabsf(a->m[0][2]) + e.y * fabsf(a->m[1][2]) + e.z * fabsf(a->m[2][2])};
+    return (AABB){vec3_sub(wc, we), vec3_add(wc, we)};
+}
+
+static inline Mat4x4 affine_to_mat4(const Affine3x4* a) {
+    Mat4x4 r;
+    for (int i = 0; i < 4; ++i) {
+        r.m[i][0] = a->m[i][0];
+        r.m[i][1] = a->m[i][1];
+        r.m[i][2] = a->m[i][2];
+        r.m[i][3] = (i == 3) ? 1.0f : 0.0f;
+    }
+    return r;
+}
+
+#endif
@@ -0,0 +1,1181 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "kernels.h"
+#include "profile.h"
+#include "replay.h"
+#include "timer.h"
+#include "world.h"
+
+static void aabb_range(void* ctx, int begin, int end, int chunk);
+
+void create_world(World* world, float fixed_dt) {
+    memset(world, 0, sizeof(*world));
+    body_soa_init(&world->state);
+    world->gravity = (Vec3D){0.0f, -9.81f, 0.0f};
+    world->fixed_dt = (fixed_dt > 0.0f) ? fixed_dt : WORLD_DEFAULT_DT;
+    world->max_substeps = WORLD_DEFAULT_MAX_SUBSTEPS;
+    world->solver_iterations = WORLD_DEFAULT_ITERATIONS;
+    world->friction = SOLVER_DEFAULT_FRICTION;
+    world->allow_sleep = 1;
+    world->ccd_threshold = WORLD_DEFAULT_CCD_THRESHOLD;
+    island_set_init(&world->islands);
+    arena_init(&world->frame);
+    pool_init(&world->joints, sizeof(Joint), WORLD_JOINTS_PER_CHUNK);
+    world->narrowphase = NARROWPHASE_GJK;
+    manifold_cache_init(&world->manifolds);
+    particle_system_init(&world->particles);
+    kernels_get(); // Sélection des noyaux avant tout accès concurrent
+}
+
+void free_world(World* world) {
+    for (int i = 0; i < world->num_bodies; ++i) {
+        free_object(&world->bodies[i]);
+    }
+    for (int m = 0; m < world->num_meshes; ++m) {
+        mesh_asset_release(world->meshes[m]);
+    }
+    mem_free(world->meshes);
+    mem_free(world->mesh_lookup);
+    mem_free(world->body_mesh);
+    world->meshes = NULL;
+    world->mesh_lookup = world->body_mesh = NULL;
+    world->num_meshes = world->mesh_capacity = world->mesh_lookup_size = 0;
+    mem_free(world->bodies);
+    mem_free(world->aabbs);
+    free_broadphase(world->broadphase);
+    island_set_free(&world->islands);
+    manifold_cache_free(&world->manifolds);
+    particle_system_free(&world->particles);
+    pool_free(&world->joints);
+    mem_free(world->joint_list);
+    arena_free(&world->frame);
+    mem_free(world->solver_slot);
+    for (int i = 0; i < world->num_solvers; ++i) {
+        solver_free(&world->solvers[i]);
+    }
+    mem_free(world->solvers);
+    mem_free(world->body_slot);
+    mem_free(world->body_id);
+    mem_free(world->sleep_group);
+    mem_free(world->wake_request);
+    world->body_slot = world->body_id = world->sleep_group = NULL;
+    world->wake_request = NULL;
+    world->num_awake = world->num_asleep = 0;
+    world->broadphase = NULL;
+    world->aabbs = NULL;
+    world->joint_list = NULL;
+    world->num_joints = world->joint_capacity = 0;
+    world->constraint_pairs = NULL;
+    world->constraint_ref = NULL;
+    world->solver_slot = NULL;
+    world->solvers = NULL;
+    world->num_solvers = 0;
+    body_soa_free(&world->state);
+    world->bodies = NULL;
+    world->num_bodies = 0;
+    world->capacity = 0;
+}
+
+// Tableaux par corps pour `capacity` corps (au moins la taille actuelle)
+static int reserve_bodies(World* world, int capacity) {
+    if (capacity <= world->capacity) {
+        return 1;
+    }
+    Object3D* bodies = (Object3D*)mem_realloc(world->bodies, capacity * sizeof(Object3D));
+    if (bodies == NULL) {
+        return 0;
+    }
+    mem_advise_huge_pages(bodies, capacity * sizeof(Object3D));
+    world->bodies = bodies;
+    int* body_mesh = (int*)mem_realloc(world->body_mesh, capacity * sizeof(int));
+    if (body_mesh == NULL) {
+        return 0;
+    }
+    world->body_mesh = body_mesh;
+    AABB* aabbs = (AABB*)mem_realloc(world->aabbs, capacity * sizeof(AABB));
+    if (aabbs == NULL) {
+        return 0;
+    }
+    mem_advise_huge_pages(aabbs, capacity * sizeof(AABB));
+    world->aabbs = aabbs;
+    int* slots = (int*)mem_realloc(world->solver_slot, capacity * sizeof(int));
+    if (slots == NULL) {
+        return 0;
+    }
+    world->solver_slot = slots;
+    int* body_slot = (int*)mem_realloc(world->body_slot, capacity * sizeof(int));
+    if (body_slot == NULL) {
+        return 0;
+    }
+    world->body_slot = body_slot;
+    int* body_id = (int*)mem_realloc(world->body_id, capacity * sizeof(int));
+    if (body_id == NULL) {
+        return 0;
+    }
+    world->body_id = body_id;
+    int* groups = (int*)mem_realloc(world->sleep_group, capacity * sizeof(int));
+    if (groups == NULL) {
+        return 0;
+    }
+    world->sleep_group = groups;
+    unsigned char* wake = (unsigned char*)mem_realloc(world->wake_request, capacity);
+    if (wake == NULL) {
+        return 0;
+    }
+    world->wake_request = wake;
+    world->capacity = capacity;
+    return 1;
+}
+
+int world_reserve(World* world, int num_bodies) {
+    return reserve_bodies(world, num_bodies) && body_soa_reserve(&world->state, num_bodies);
+}
+
+// --- Maillages ---
+
+static unsigned mesh_hash(const MeshAsset* mesh, int size) {
+    uint64_t h = (uint64_t)(uintptr_t)mesh * 0x9E3779B97F4A7C15ull;
+    return (unsigned)(h >> 32) & (unsigned)(size - 1);
+}
+
+// Case de `mesh` dans la table ouverte : la sienne, ou la case libre où l'insérer
+static int mesh_lookup_find(const World* world, const MeshAsset* mesh) {
+    int mask = world->mesh_lookup_size - 1;
+    int k = (int)mesh_hash(mesh, world->mesh_lookup_size);
+    while (world->mesh_lookup[k] >= 0 && world->meshes[world->mesh_lookup[k]] != mesh) {
+        k = (k + 1) & mask;
+    }
+    return k;
+}
+
+// Table reconstruite au double de sa taille quand elle se remplit à moitié
+static int grow_mesh_lookup(World* world) {
+    int size = world->mesh_lookup_size ? world->mesh_lookup_size * 2 : 16;
+    int* table = (int*)mem_alloc((size_t)size * sizeof(int));
+    if (table == NULL) {
+        return 0;
+    }
+    mem_free(world->mesh_lookup);
+    world->mesh_lookup = table;
+    world->mesh_lookup_size = size;
+    for (int k = 0; k < size; ++k) {
+        table[k] = -1;
+    }
+    for (int m = 0; m < world->num_meshes; ++m) {
+        table[mesh_lookup_find(world, world->meshes[m])] = m;
+    }
+    return 1;
+}
+
+int world_mesh_index(World* world, MeshAsset* mesh) {
+    if (world->mesh_lookup_size > 0) {
+        int k = mesh_lookup_find(world, mesh);
+        if (world->mesh_lookup[k] >= 0) {
+            return world->mesh_lookup[k];
+        }
+    }
+    if (2 * (world->num_meshes + 1) > world->mesh_lookup_size && !grow_mesh_lookup(world)) {
+        return -1;
+    }
+    if (world->num_meshes == world->mesh_capacity) {
+        int capacity = world->mesh_capacity ? world->mesh_capacity * 2 : 8;
+        MeshAsset** meshes = (MeshAsset**)mem_realloc(world->meshes, (size_t)capacity * sizeof(MeshAsset*));
+        if (meshes == NULL) {
+            return -1;
+        }
+        world->meshes = meshes;
+        world->mesh_capacity = capacity;
+    }
+    int index = world->num_meshes++;
+    world->meshes[index] = mesh_asset_retain(mesh);
+    world->mesh_lookup[mesh_lookup_find(world, mesh)] = index;
+    return index;
+}
+
+static void update_body(World* world, int index);
+static void wake_body(World* world, int index);
+
+int world_add_body(World* world, const Object3D* obj) {
+    if (obj->mesh == NULL) {
+        return -1;
+    }
+    if (world->num_bodies == world->capacity &&
+        !reserve_bodies(world, world->capacity ? world->capacity * 2 : 16)) {
+        return -1;
+    }
+
+    // Dernière place : le rangement du prochain pas le placera parmi les
+    // corps éveillés s'il est dynamique. Elle est prise avant d'inscrire le
+    // maillage, qui est la dernière étape pouvant échouer : un échec ne
+    // laisse ni entrée ni référence dans le registre.
+    int slot = body_soa_push(&world->state);
+    if (slot < 0) {
+        return -1;
+    }
+    int num_meshes = world->num_meshes;
+    int mesh = world_mesh_index(world, obj->mesh);
+    if (mesh < 0) {
+        world->state.count--; // Place rendue
+        return -1;
+    }
+    world->bodies[slot] = *obj;
+    world->body_mesh[slot] = mesh;
+    int id = world->num_bodies++;
+    world->body_slot[id] = slot;
+    world->body_id[slot] = id;
+    world->sleep_group[slot] = -1;
+    world->wake_request[id] = 0;
+    update_body(world, id);
+    if (world->recorder != NULL) {
+        replay_record_add_body(world->recorder, world->step_count, obj, mesh, mesh == num_meshes);
+    }
+    return id;
+}
+
+Object3D* world_get_body(World* world, int index) {
+    int i = world_body_slot(world, index);
+    if (i < 0) {
+        return NULL;
+    }
+    const BodySoA* s = &world->state;
+    Object3D* body = &world->bodies[i];
+    body->position = (Vec3D){s->px[i], s->py[i], s->pz[i]};
+    body->velocity = (Vec3D){s->vx[i], s->vy[i], s->vz[i]};
+    body->orientation = (Quat){s->qx[i], s->qy[i], s->qz[i], s->qw[i]};
+    body->angular_velocity = (Vec3D){s->wx[i], s->wy[i], s->wz[i]};
+    return body;
+}
+
+void world_update_body(World* world, int index) {
+    int i = world_body_slot(world, index);
+    if (i < 0) {
+        return;
+    }
+    if (world->recorder != NULL) {
+        replay_record_update_body(world->recorder, world->step_count, index, &world->bodies[i]);
+    }
+    update_body(world, index);
+}
+
+static void update_body(World* world, int index) {
+    int i = world->body_slot[index];
+    BodySoA* s = &world->state;
+    const Object3D* body = &world->bodies[i];
+    s->px[i] = body->position.x; s->py[i] = body->position.y; s->pz[i] = body->position.z;
+    s->vx[i] = body->velocity.x; s->vy[i] = body->velocity.y; s->vz[i] = body->velocity.z;
+    s->qx[i] = body->orientation.x; s->qy[i] = body->orientation.y;
+    s->qz[i] = body->orientation.z; s->qw[i] = body->orientation.w;
+    s->wx[i] = body->angular_velocity.x;
+    s->wy[i] = body->angular_velocity.y;
+    s->wz[i] = body->angular_velocity.z;
+    s->inv_mass[i] = body->inv_mass;
+
+    // Inertie d'une boîte pleine de même encombrement que le corps
+    const AABB* bounds = &body->mesh->bounds;
+    float dx = (bounds->max.x - bounds->min.x) * fabsf(body->scale.x);
+    float dy = (bounds->max.y - bounds->min.y) * fabsf(body->scale.y);
+    float dz = (bounds->max.z - bounds->min.z) * fabsf(body->scale.z);
+    float k = 12.0f * body->inv_mass;
+    s->iix[i] = (dy * dy + dz * dz > 0.0f) ? k / (dy * dy + dz * dz) : 0.0f;
+    s->iiy[i] = (dx * dx + dz * dz > 0.0f) ? k / (dx * dx + dz * dz) : 0.0f;
+    s->iiz[i] = (dx * dx + dy * dy > 0.0f) ? k / (dx * dx + dy * dy) : 0.0f;
+
+    // Hors des corps éveillés, les AABB ne sont plus recalculées à chaque
+    // pas : elles le sont tout de suite. Le rangement du prochain pas tient
+    // compte d'un changement de masse et du réveil de l'îlot.
+    if (i >= world->num_awake) {
+        aabb_range(world, i, i + 1, 0);
+        world->activity_dirty = 1;
+    } else if (body->inv_mass == 0.0f) {
+        world->activity_dirty = 1;
+    }
+    wake_body(world, index);
+}
+
+void world_wake_body(World* world, int index) {
+    if (world_body_slot(world, index) < 0) {
+        return;
+    }
+    if (world->recorder != NULL) {
+        replay_record_wake_body(world->recorder, world->step_count, index);
+    }
+    wake_body(world, index);
+}
+
+static void wake_body(World* world, int index) {
+    int i = world->body_slot[index];
+    world->state.sleep_time[i] = 0.0f;
+    int group = world->sleep_group[i];
+    if (group >= 0) {
+        world->wake_request[group] = 1;
+        world->activity_dirty = 1;
+    }
+}
+
+void world_apply_impulse(World* world, int index, Vec3D impulse, Vec3D point) {
+    int i = world_body_slot(world, index);
+    if (i < 0 || world->state.inv_mass[i] == 0.0f) {
+        return;
+    }
+    if (world->recorder != NULL) {
+        replay_record_impulse(world->recorder, world->step_count, index, impulse, point);
+    }
+    BodySoA* s = &world->state;
+    float im = s->inv_mass[i];
+    s->vx[i] += impulse.x * im; s->vy[i] += impulse.y * im; s->vz[i] += impulse.z * im;
+    // dw = I^-1 (r x J), l'inertie étant diagonale dans le repère local
+    Quat q = {s->qx[i], s->qy[i], s->qz[i], s->qw[i]};
+    Vec3D r = vec3_sub(point, (Vec3D){s->px[i], s->py[i], s->pz[i]});
+    Vec3D torque = quat_rotate(quat_conjugate(q), vec3_cross(r, impulse));
+    Vec3D dw = quat_rotate(q, (Vec3D){torque.x * s->iix[i], torque.y * s->iiy[i], torque.z * s->iiz[i]});
+    s->wx[i] += dw.x; s->wy[i] += dw.y; s->wz[i] += dw.z;
+    wake_body(world, index);
+}
+
+PoolHandle world_add_joint(World* world, JointType type, int a, int b, Vec3D anchor, Vec3D axis) {
+    if (a < 0 || b < 0 || a >= world->num_bodies || b >= world->num_bodies || a == b) {
+        return POOL_NULL_HANDLE;
+    }
+    if (world->num_joints == world->joint_capacity) {
+        int new_capacity = world->joint_capacity ? world->joint_capacity * 2 : 16;
+        PoolHandle* list = (PoolHandle*)mem_realloc(world->joint_list, new_capacity * sizeof(PoolHandle));
+        if (list == NULL) {
+            return POOL_NULL_HANDLE;
+        }
+        world->joint_list = list;
+        world->joint_capacity = new_capacity;
+    }
+    PoolHandle handle;
+    Joint* j = (Joint*)pool_alloc(&world->joints, &handle);
+    if (j == NULL) {
+        return POOL_NULL_HANDLE;
+    }
+    if (world->recorder != NULL) {
+        replay_record_joint(world->recorder, world->step_count, type, a, b, anchor, axis);
+    }
+    const BodySoA* s = &world->state;
+    int sa = world->body_slot[a], sb = world->body_slot[b];
+    Vec3D pa = {s->px[sa], s->py[sa], s->pz[sa]}, pb = {s->px[sb], s->py[sb], s->pz[sb]};
+    Quat ia = quat_conjugate((Quat){s->qx[sa], s->qy[sa], s->qz[sa], s->qw[sa]});
+    Quat ib = quat_conjugate((Quat){s->qx[sb], s->qy[sb], s->qz[sb], s->qw[sb]});
+    float length = vec3_length(axis);
+    Vec3D unit = length > 0.0f ? vec3_scale(axis, 1.0f / length) : (Vec3D){0.0f, 1.0f, 0.0f};
+
+    memset(j, 0, sizeof(*j));
+    j->type = type;
+    j->a = a;
+    j->b = b;
+    j->local_anchor_a = quat_rotate(ia, vec3_sub(anchor, pa));
+    j->local_anchor_b = quat_rotate(ib, vec3_sub(anchor, pb));
+    j->local_axis_a = quat_rotate(ia, unit);
+    j->local_axis_b = quat_rotate(ib, unit);
+    j->rest_rotation = quat_mul(ia, quat_conjugate(ib)); // q_a^-1 q_b
+    wake_body(world, a);
+    wake_body(world, b);
+    world->joint_list[world->num_joints++] = handle;
+    return handle;
+}
+
+int world_remove_joint(World* world, PoolHandle joint) {
+    const Joint* j = world_get_joint(world, joint);
+    if (j == NULL) {
+        return 0;
+    }
+    // Position dans l'ordre de création : c'est elle que consigne le journal,
+    // les poignées d'un monde rejoué pouvant différer
+    int k = 0;
+    while (world->joint_list[k].index != joint.index) ++k;
+    if (world->recorder != NULL) {
+        replay_record_remove_joint(world->recorder, world->step_count, k);
+    }
+    wake_body(world, j->a);
+    wake_body(world, j->b);
+    pool_release(&world->joints, joint);
+    memmove(world->joint_list + k, world->joint_list + k + 1, (size_t)(world->num_joints - k - 1) * sizeof(PoolHandle));
+    world->num_joints--;
+    return 1;
+}
+
+void world_set_broadphase(World* world, BroadPhase* bp) {
+    if (world->broadphase != NULL && world->broadphase != bp) {
+        free_broadphase(world->broadphase);
+    }
+    world->broadphase = bp;
+    if (bp != NULL) {
+        bp->jobs = world->jobs;
+        bp->grain = world->deterministic ? WORLD_PAIR_GRAIN : 0;
+    }
+}
+
+void world_set_job_system(World* world, JobSystem* jobs, int deterministic) {
+    world->jobs = jobs;
+    world->deterministic = deterministic;
+    world_set_broadphase(world, world->broadphase);
+}
+
+// Taille des tâches sur les corps : fixe en mode déterministe, sinon
+// quelques tâches par thread pour équilibrer la charge
+static int body_grain(const World* world, int count) {
+    if (world->deterministic || world->jobs == NULL) {
+        return WORLD_BODY_GRAIN;
+    }
+    int grain = count / (4 * job_system_num_threads(world->jobs));
+    return grain < 256 ? 256 : grain;
+}
+
+static void integrate_range(void* ctx, int begin, int end, int chunk) {
+    World* world = (World*)ctx;
+    (void)chunk;
+    kernels_get()->integrate_bodies(&world->state, world->gravity, world->fixed_dt, begin, end);
+}
+
+static Affine3x4 body_matrix(const World* world, int i) {
+    const BodySoA* s = &world->state;
+    return affine_from_trs((Vec3D){s->px[i], s->py[i], s->pz[i]},
+                           (Quat){s->qx[i], s->qy[i], s->qz[i], s->qw[i]}, world->bodies[i].scale);
+}
+
+// AABB du corps i : la boîte locale du maillage transformée, sans toucher
+// aux sommets. Exacte pour une boîte, un peu plus large sinon.
+static AABB body_aabb(const World* world, int i) {
+    Affine3x4 affine = body_matrix(world, i);
+    return affine_transform_aabb(&affine, &world->bodies[i].mesh->bounds);
+}
+
+static void aabb_range(void* ctx, int begin, int end, int chunk) {
+    World* world = (World*)ctx;
+    (void)chunk;
+    for (int i = begin; i < end; ++i) {
+        world->aabbs[i] = body_aabb(world, i);
+    }
+}
+
+void world_update_aabbs(World* world) {
+    job_parallel_for(world->jobs, world->num_awake, body_grain(world, world->num_awake),
+                     aabb_range, world);
+}
+
+// --- Détection continue ---
+
+// Distance maximale entre l'origine du corps i et ses sommets
+static float body_radius(const World* world, int i) {
+    const Object3D* body = &world->bodies[i];
+    const MeshAsset* mesh = body->mesh;
+    Vec3D scale = {fabsf(body->scale.x), fabsf(body->scale.y), fabsf(body->scale.z)};
+    Vec3D center = vec3_scale(vec3_add(mesh->bounds.min, mesh->bounds.max), 0.5f);
+    center = (Vec3D){center.x * scale.x, center.y * scale.y, center.z * scale.z};
+    return vec3_length(center) + mesh->bound_radius * fmaxf(scale.x, fmaxf(scale.y, scale.z));
+}
+
+static int is_swept(const World* world, int i) {
+    return world->ccd_mark != NULL && i < world->num_awake && world->ccd_mark[i];
+}
+
+typedef struct {
+    World* world;
+    int* counts;   // Corps balayés, par morceau
+} SweepJob;
+
+// AABB des corps [begin, end), étirées sur tout le trajet du pas pour les
+// corps à balayer. Le trajet est estimé avec la vitesse après gravité, que le
+// solveur ne fait le plus souvent que réduire.
+static void sweep_range(void* ctx, int begin, int end, int chunk) {
+    SweepJob* job = (SweepJob*)ctx;
+    World* world = job->world;
+    const BodySoA* s = &world->state;
+    float dt = world->fixed_dt;
+    int count = 0;
+    aabb_range(world, begin, end, chunk);
+    for (int i = begin; i < end; ++i) {
+        world->ccd_mark[i] = 0;
+        const Object3D* body = &world->bodies[i];
+        if (!body->ccd && world->ccd_threshold <= 0.0f) continue;
+        Vec3D move = {s->vx[i] * dt, s->vy[i] * dt, s->vz[i] * dt};
+        float turn = sqrtf(s->wx[i] * s->wx[i] + s->wy[i] * s->wy[i] + s->wz[i] * s->wz[i]) * dt;
+        float radius = turn > 0.0f ? body_radius(world, i) : 0.0f;
+        if (!body->ccd) {
+            // Au-delà d'une fraction de sa plus petite dimension, un corps
+            // peut sauter par-dessus un obstacle mince entre deux pas
+            const AABB* local = &body->mesh->bounds;
+            float thinnest = fminf(fminf((local->max.x - local->min.x) * fabsf(body->scale.x),
+                                         (local->max.y - local->min.y) * fabsf(body->scale.y)),
+                                   (local->max.z - local->min.z) * fabsf(body->scale.z));
+            if (vec3_length(move) + turn * radius <= world->ccd_threshold * thinnest) continue;
+        }
+        // Boîte de départ et boîte d'arrivée ; la rotation ne peut pas
+        // écarter un sommet de plus de `radius` de l'origine du corps
+        float grow = fminf(turn * radius, radius);
+        AABB* box = &world->aabbs[i];
+        box->min = (Vec3D){box->min.x + fminf(move.x, 0.0f) - grow, box->min.y + fminf(move.y, 0.0f) - grow,
+                           box->min.z + fminf(move.z, 0.0f) - grow};
+        box->max = (Vec3D){box->max.x + fmaxf(move.x, 0.0f) + grow, box->max.y + fmaxf(move.y, 0.0f) + grow,
+                           box->max.z + fmaxf(move.z, 0.0f) + grow};
+        world->ccd_mark[i] = 1;
+        count++;
+    }
+    job->counts[chunk] = count;
+}
+
+// AABB des corps éveillés et marques de la détection continue. Retourne le
+// nombre de corps à balayer pendant ce pas.
+static int sweep_bodies(World* world) {
+    int awake = world->num_awake;
+    int grain = body_grain(world, awake);
+    SweepJob job = {world, ARENA_NEW(&world->frame, int, job_chunk_count(awake, grain))};
+    world->ccd_mark = ARENA_NEW(&world->frame, unsigned char, awake);
+    if (job.counts == NULL || world->ccd_mark == NULL) {
+        world->ccd_mark = NULL; // Sans mémoire, pas de détection continue pour ce pas
+        world_update_aabbs(world);
+        return 0;
+    }
+    job_parallel_for(world->jobs, awake, grain, sweep_range, &job);
+    int total = 0;
+    for (int c = 0; c < job_chunk_count(awake, grain); ++c) {
+        total += job.counts[c];
+    }
+    return total;
+}
+
+// Corps balayé et l'autre corps d'une de ses paires candidates (places)
+typedef struct {
+    int body, other;
+} CcdCandidate;
+
+// Un corps balayé, ses candidats et son premier contact
+typedef struct {
+    int body;
+    int first, count;      // Dans le tableau des candidats, trié par corps
+    int other;             // -1 : aucun contact pendant le pas
+    TimeOfImpact toi;
+    Vec3D position;        // Pose au premier contact
+    Quat orientation;
+} CcdSweep;
+
+typedef struct {
+    World* world;
+    const CcdCandidate* candidates;
+    CcdSweep* sweeps;
+} CcdJob;
+
+static int compare_candidates(const void* a, const void* b) {
+    const CcdCandidate* x = (const CcdCandidate*)a;
+    const CcdCandidate* y = (const CcdCandidate*)b;
+    if (x->body != y->body) return x->body < y->body ? -1 : 1;
+    return (x->other > y->other) - (x->other < y->other);
+}
+
+// Mouvement du corps i pendant le pas : pose actuelle (positions pas encore
+// intégrées) et vitesses après le solveur. Les corps hors des éveillés
+// restent immobiles.
+static CcdBody ccd_body(const World* world, int i) {
+    const BodySoA* s = &world->state;
+    const Object3D* body = &world->bodies[i];
+    const MeshAsset* mesh = body->mesh;
+    int moving = i < world->num_awake;
+    Vec3D zero = {0.0f, 0.0f, 0.0f};
+    return (CcdBody){mesh->x, mesh->y, mesh->z, mesh->num_vertices, body->scale,
+                     {s->px[i], s->py[i], s->pz[i]},
+                     {s->qx[i], s->qy[i], s->qz[i], s->qw[i]},
+                     moving ? (Vec3D){s->vx[i], s->vy[i], s->vz[i]} : zero,
+                     moving ? (Vec3D){s->wx[i], s->wy[i], s->wz[i]} : zero,
+                     body_radius(world, i)};
+}
+
+// Premier contact de chaque corps balayé : chaque recherche s'arrête à
+// l'instant du meilleur contact déjà trouvé
+static void ccd_range(void* ctx, int begin, int end, int chunk) {
+    CcdJob* job = (CcdJob*)ctx;
+    const World* world = job->world;
+    (void)chunk;
+    for (int k = begin; k < end; ++k) {
+        CcdSweep* sweep = &job->sweeps[k];
+        CcdBody a = ccd_body(world, sweep->body);
+        float limit = world->fixed_dt;
+        sweep->other = -1;
+        for (int c = sweep->first; c < sweep->first + sweep->count; ++c) {
+            int other = job->candidates[c].other;
+            CcdBody b = ccd_body(world, other);
+            TimeOfImpact toi;
+            if (ccd_time_of_impact(&a, &b, limit, &toi)) {
+                limit = toi.t;
+                sweep->other = other;
+                sweep->toi = toi;
+            }
+        }
+        if (sweep->other >= 0) {
+            sweep->position = ccd_position_at(&a, sweep->toi.t);
+            sweep->orientation = ccd_orientation_at(&a, sweep->toi.t);
+        }
+    }
+}
+
+// Paires candidates des corps balayés, puis premier contact de chacun, en
+// parallèle. Appelé après le solveur, avant l'intégration des positions.
+// Retourne le nombre de corps balayés ayant des candidats (dans `out`).
+static int find_impacts(World* world, CcdSweep** out) {
+    const ManifoldCache* cache = &world->manifolds;
+    int num_candidates = 0;
+    for (int p = 0; p < cache->count; ++p) {
+        num_candidates += is_swept(world, cache->manifolds[p].a) + is_swept(world, cache->manifolds[p].b);
+    }
+    CcdCandidate* candidates = ARENA_NEW(&world->frame, CcdCandidate, num_candidates);
+    if (candidates == NULL) {
+        return 0;
+    }
+    int n = 0;
+    for (int p = 0; p < cache->count; ++p) {
+        int a = cache->manifolds[p].a, b = cache->manifolds[p].b;
+        if (is_swept(world, a)) candidates[n++] = (CcdCandidate){a, b};
+        if (is_swept(world, b)) candidates[n++] = (CcdCandidate){b, a};
+    }
+    // Tri total : l'ordre ne dépend que des paires, pas du pool
+    qsort(candidates, n, sizeof(CcdCandidate), compare_candidates);
+    int num_sweeps = 0;
+    for (int c = 0; c < n; ++c) {
+        num_sweeps += (c == 0 || candidates[c].body != candidates[c - 1].body);
+    }
+    CcdSweep* sweeps = ARENA_NEW(&world->frame, CcdSweep, num_sweeps);
+    if (sweeps == NULL) {
+        return 0;
+    }
+    num_sweeps = 0;
+    for (int c = 0; c < n; ++c) {
+        if (c == 0 || candidates[c].body != candidates[c - 1].body) {
+            sweeps[num_sweeps++] = (CcdSweep){.body = candidates[c].body, .first = c};
+        }
+        sweeps[num_sweeps - 1].count++;
+    }
+    CcdJob job = {world, candidates, sweeps};
+    job_parallel_for(world->jobs, num_sweeps, WORLD_CCD_GRAIN, ccd_range, &job);
+    *out = sweeps;
+    return num_sweeps;
+}
+
+// Après l'intégration des positions : chaque corps arrêté reprend sa pose au
+// premier contact et perd sa vitesse d'approche le long de la normale ; le
+// contact discret du pas suivant prend le relais. Un obstacle endormi se
+// réveille au pas suivant.
+static int apply_impacts(World* world, const CcdSweep* sweeps, int num_sweeps) {
+    BodySoA* s = &world->state;
+    int impacts = 0;
+    for (int k = 0; k < num_sweeps; ++k) {
+        const CcdSweep* sweep = &sweeps[k];
+        if (sweep->other < 0) continue;
+        int i = sweep->body, j = sweep->other;
+        s->px[i] = sweep->position.x; s->py[i] = sweep->position.y; s->pz[i] = sweep->position.z;
+        s->qx[i] = sweep->orientation.x; s->qy[i] = sweep->orientation.y;
+        s->qz[i] = sweep->orientation.z; s->qw[i] = sweep->orientation.w;
+        Vec3D v = {s->vx[i], s->vy[i], s->vz[i]};
+        Vec3D relative = j < world->num_awake ? vec3_sub(v, (Vec3D){s->vx[j], s->vy[j], s->vz[j]}) : v;
+        float approach = vec3_dot(relative, sweep->toi.normal);
+        if (approach > 0.0f) {
+            v = vec3_sub(v, vec3_scale(sweep->toi.normal, approach));
+            s->vx[i] = v.x; s->vy[i] = v.y; s->vz[i] = v.z;
+        }
+        if (j >= world->num_awake && world->sleep_group[j] >= 0) {
+            world->wake_request[world->sleep_group[j]] = 1;
+            world->activity_dirty = 1;
+        }
+        impacts++;
+    }
+    return impacts;
+}
+
+// Enveloppe du corps i : sommets partagés de son maillage, pose actuelle
+static ConvexHull body_hull(const World* world, int i) {
+    const MeshAsset* mesh = world->bodies[i].mesh;
+    return (ConvexHull){mesh->x, mesh->y, mesh->z, mesh->num_vertices, body_matrix(world, i)};
+}
+
+static BodyPose body_pose(const BodySoA* s, int i) {
+    return (BodyPose){{s->px[i], s->py[i], s->pz[i]}, {s->qx[i], s->qy[i], s->qz[i], s->qw[i]}};
+}
+
+static void velocity_range(void* ctx, int begin, int end, int chunk) {
+    World* world = (World*)ctx;
+    BodySoA* s = &world->state;
+    float gx = world->gravity.x * world->fixed_dt, gy = world->gravity.y * world->fixed_dt;
+    float gz = world->gravity.z * world->fixed_dt;
+    (void)chunk;
+    for (int i = begin; i < end; ++i) {
+        if (s->inv_mass[i] == 0.0f) continue;
+        s->vx[i] += gx; s->vy[i] += gy; s->vz[i] += gz;
+    }
+}
+
+// Positions et orientations avec les vitesses corrigées par le solveur
+static void position_range(void* ctx, int begin, int end, int chunk) {
+    World* world = (World*)ctx;
+    (void)chunk;
+    kernels_get()->integrate_bodies(&world->state, (Vec3D){0.0f, 0.0f, 0.0f}, world->fixed_dt, begin, end);
+}
+
+// Chaque paire n'écrit que sa propre variété : aucun verrou
+static void narrowphase_range(void* ctx, int begin, int end, int chunk) {
+    World* world = (World*)ctx;
+    (void)chunk;
+    for (int p = begin; p < end; ++p) {
+        ContactManifold* m = &world->manifolds.manifolds[p];
+        if (m->a >= world->num_awake && m->b >= world->num_awake) {
+            continue; // Aucun des deux corps n'a bougé : variété conservée telle quelle
+        }
+        BodyPose pose_a = body_pose(&world->state, m->a), pose_b = body_pose(&world->state, m->b);
+        if (world->narrowphase == NARROWPHASE_GJK) {
+            ConvexHull hull_a = body_hull(world, m->a), hull_b = body_hull(world, m->b);
+            manifold_update(m, &hull_a, &hull_b, pose_a, pose_b);
+            continue;
+        }
+        // Une AABB étirée par la détection continue n'est pas la forme du corps
+        AABB box_a = is_swept(world, m->a) ? body_aabb(world, m->a) : world->aabbs[m->a];
+        AABB box_b = is_swept(world, m->b) ? body_aabb(world, m->b) : world->aabbs[m->b];
+        const AABB* ba = &box_a;
+        const AABB* bb = &box_b;
+        Contact c;
+        if (contact_from_aabbs(ba, bb, m->a, m->b, &c)) {
+            Vec3D center = {0.5f * (fmaxf(ba->min.x, bb->min.x) + fminf(ba->max.x, bb->max.x)),
+                            0.5f * (fmaxf(ba->min.y, bb->min.y) + fminf(ba->max.y, bb->max.y)),
+                            0.5f * (fmaxf(ba->min.z, bb->min.z) + fminf(ba->max.z, bb->max.z))};
+            manifold_from_contact(m, &c, center, pose_a, pose_b);
+        } else {
+            m->num_points = 0;
+        }
+    }
+}
+
+// Résolution des îlots [begin, end) par le solveur du morceau : seuls leurs
+// corps dynamiques, variétés et articulations sont écrits
+static void solve_islands(void* ctx, int begin, int end, int chunk) {
+    World* world = (World*)ctx;
+    const IslandSet* set = &world->islands;
+    Solver* solver = &world->solvers[chunk];
+    BodySoA* s = &world->state;
+    float inv_dt = 1.0f / world->fixed_dt;
+
+    solver_begin(solver);
+    int ok = 1;
+    for (int k = set->body_start[begin]; ok && k < set->body_start[end]; ++k) {
+        ok = solver_add_body(solver, s, set->bodies[k], world->solver_slot);
+    }
+    for (int k = set->pair_start[begin]; ok && k < set->pair_start[end]; ++k) {
+        int ref = world->constraint_ref[set->pairs[k]];
+        if (ref >= 0) {
+            ok = solver_add_manifold(solver, &world->manifolds.manifolds[ref], s, world->solver_slot,
+                                     world->friction, inv_dt);
+        } else {
+            Joint* joint = world_get_joint(world, world->joint_list[-ref - 1]);
+            ok = solver_add_joint(solver, joint, world->body_slot[joint->a], world->body_slot[joint->b],
+                                  s, world->solver_slot, inv_dt);
+        }
+    }
+    if (!ok || !solver_prepare(solver, world->manifolds.warm_start)) {
+        solver_begin(solver); // Allocation impossible : les vitesses restent libres
+        return;
+    }
+    solver_iterate(solver, world->solver_iterations);
+    solver_finish(solver, s);
+}
+
+// Une contrainte entre deux corps hors des éveillés est ignorée. Celle d'un
+// corps éveillé sur un corps endormi est gardée (le corps endormi compte comme
+// statique pendant ce pas) et réveille l'îlot endormi au pas suivant.
+static int constraint_active(World* world, int a, int b) {
+    int awake = world->num_awake;
+    if (a >= awake && b >= awake) {
+        return 0;
+    }
+    int other = a >= awake ? a : b >= awake ? b : -1;
+    if (other >= 0 && world->sleep_group[other] >= 0) {
+        world->wake_request[world->sleep_group[other]] = 1;
+        world->activity_dirty = 1;
+        world->state.sleep_time[other == a ? b : a] = 0.0f;
+    }
+    return 1;
+}
+
+// Contacts touchants puis articulations, dans un ordre fixe. Les paires sont
+// en places de corps.
+static int gather_constraints(World* world) {
+    int num_pairs = world->broadphase ? world->manifolds.count : 0;
+    int needed = num_pairs + world->num_joints;
+    world->constraint_pairs = ARENA_NEW(&world->frame, BodyPair, needed);
+    world->constraint_ref = ARENA_NEW(&world->frame, int, needed);
+    if (world->constraint_pairs == NULL || world->constraint_ref == NULL) {
+        return -1;
+    }
+    int n = 0;
+    for (int p = 0; p < num_pairs; ++p) {
+        const ContactManifold* m = &world->manifolds.manifolds[p];
+        if (m->num_points == 0 || !constraint_active(world, m->a, m->b)) continue;
+        world->constraint_pairs[n] = (BodyPair){m->a, m->b};
+        world->constraint_ref[n++] = p;
+    }
+    world->stats.num_contacts = n;
+    for (int j = 0; j < world->num_joints; ++j) {
+        const Joint* joint = world_get_joint(world, world->joint_list[j]);
+        int a = world->body_slot[joint->a], b = world->body_slot[joint->b];
+        if (!constraint_active(world, a, b)) continue;
+        world->constraint_pairs[n] = (BodyPair){a, b};
+        world->constraint_ref[n++] = -(j + 1);
+    }
+    return n;
+}
+
+// Îlots par morceau : un seul morceau en séquentiel (les lots se remplissent
+// mieux), sinon quelques morceaux par thread
+static int island_grain(const World* world, int num_islands) {
+    int threads = job_system_num_threads(world->jobs);
+    int grain = (world->jobs != NULL && threads > 1) ? num_islands / (4 * threads) : num_islands;
+    return grain > 0 ? grain : 1;
+}
+
+static int reserve_solvers(World* world, int count) {
+    if (count <= world->num_solvers) {
+        return 1;
+    }
+    Solver* solvers = (Solver*)mem_realloc(world->solvers, count * sizeof(Solver));
+    if (solvers == NULL) {
+        return 0;
+    }
+    world->solvers = solvers;
+    for (int i = world->num_solvers; i < count; ++i) {
+        solver_init(&world->solvers[i]);
+    }
+    world->num_solvers = count;
+    return 1;
+}
+
+static void solve_constraints(World* world) {
+    WorldStats* st = &world->stats;
+    uint64_t t0 = timer_now_ns();
+    int num_constraints = gather_constraints(world);
+    if (num_constraints < 0) {
+        return;
+    }
+    PROFILE_BEGIN(islands, "islands");
+    build_islands(&world->islands, world->num_awake, world->state.inv_mass,
+                  world->constraint_pairs, num_constraints);
+    PROFILE_END(islands);
+    uint64_t t1 = timer_now_ns();
+
+    // Les îlots ne partagent aucun corps dynamique : aucun verrou n'est nécessaire,
+    // et le découpage n'influe pas sur le résultat
+    int num_islands = world->islands.num_islands;
+    int grain = island_grain(world, num_islands);
+    int num_chunks = job_chunk_count(num_islands, grain);
+    if (!reserve_solvers(world, num_chunks)) {
+        return;
+    }
+    PROFILE_BEGIN(solve, "solve");
+    job_parallel_for(world->jobs, num_islands, grain, solve_islands, world);
+    PROFILE_END(solve);
+    st->islands_ns = t1 - t0;
+    st->solve_ns = timer_now_ns() - t1;
+    st->num_islands = num_islands;
+
+    int num_rows = 0;
+    st->solver_iterations = world->solver_iterations;
+    for (int c = 0; c < num_chunks; ++c) {
+        const Solver* solver = &world->solvers[c];
+        num_rows += solver_num_rows(solver);
+        st->num_batches += solver->rows.num_batches;
+        if (solver->num_colors > st->num_colors) st->num_colors = solver->num_colors;
+        if (solver->iterations > 0) st->iteration_ns += solver->iterate_ns / (uint64_t)solver->iterations;
+        for (int it = 0; it < solver->iterations && it < SOLVER_MAX_TRACKED_ITERATIONS; ++it) {
+            st->residual[it] += solver->residual[it];
+        }
+    }
+    st->num_rows = num_rows;
+    for (int it = 0; it < SOLVER_MAX_TRACKED_ITERATIONS; ++it) {
+        st->residual[it] = num_rows > 0 ? st->residual[it] / (float)num_rows : 0.0f;
+    }
+}
+
+// --- Sommeil ---
+
+// data[k] = ancien data[order[k]], `tmp` servant de copie
+static void permute_items(void* data, size_t size, const int* order, int count, void* tmp) {
+    char* src = (char*)data;
+    char* dst = (char*)tmp;
+    for (int k = 0; k < count; ++k) {
+        memcpy(dst + (size_t)k * size, src + (size_t)order[k] * size, size);
+    }
+    memcpy(src, dst, (size_t)count * size);
+}
+
+// Les variétés suivent leurs corps ; a < b reste vrai, quitte à échanger les rôles
+static void remap_manifolds(ManifoldCache* cache, const int* new_slot) {
+    for (int p = 0; p < cache->count; ++p) {
+        ContactManifold* m = &cache->manifolds[p];
+        int a = new_slot[m->a], b = new_slot[m->b];
+        if (a > b) {
+            manifold_swap_bodies(m);
+            int t = a; a = b; b = t;
+        }
+        m->a = a;
+        m->b = b;
+    }
+}
+
+static int is_awake(const World* world, int i) {
+    return world->state.inv_mass[i] != 0.0f && world->sleep_group[i] < 0;
+}
+
+// Réveils demandés, puis rangement stable : les corps éveillés d'abord, les
+// autres ensuite, chaque groupe dans son ordre précédent. Le résultat ne
+// dépend que de l'état, pas du découpage en tâches. Retourne 0 en cas
+// d'échec d'allocation (le rangement est retenté au pas suivant).
+static int update_activity(World* world) {
+    if (!world->activity_dirty) {
+        return 1;
+    }
+    int n = world->num_bodies;
+    size_t item = sizeof(Object3D) > sizeof(AABB) ? sizeof(Object3D) : sizeof(AABB);
+    size_t tmp_size = (size_t)n * item;
+    int* order = ARENA_NEW(&world->frame, int, n);    // Nouvelle place -> ancienne
+    int* new_slot = ARENA_NEW(&world->frame, int, n); // Ancienne place -> nouvelle
+    void* tmp = arena_alloc(&world->frame, tmp_size, ARENA_MAX_ALIGN);
+    if (order == NULL || new_slot == NULL || tmp == NULL) {
+        return 0;
+    }
+
+    BodySoA* s = &world->state;
+    for (int i = 0; i < n; ++i) {
+        int group = world->sleep_group[i];
+        if (group >= 0 && world->wake_request[group]) {
+            world->sleep_group[i] = -1;
+            s->sleep_time[i] = 0.0f;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        world->wake_request[i] = 0;
+    }
+
+    int old_awake = world->num_awake;
+    int count = 0, asleep = 0;
+    for (int i = 0; i < n; ++i) {
+        if (is_awake(world, i)) order[count++] = i;
+    }
+    world->num_awake = count;
+    for (int i = 0; i < n; ++i) {
+        if (is_awake(world, i)) continue;
+        order[count++] = i;
+        if (s->inv_mass[i] != 0.0f) asleep++;
+    }
+    world->num_asleep = asleep;
+    world->activity_dirty = 0;
+
+    int moved = 0;
+    for (int k = 0; k < n; ++k) {
+        new_slot[order[k]] = k;
+        if (order[k] != k) moved++;
+    }
+    if (moved > 0) {
+#define PERMUTE_FIELD(f) permute_items(s->f, sizeof(float), order, n, tmp);
+        BODY_SOA_FIELDS(PERMUTE_FIELD)
+#undef PERMUTE_FIELD
+        permute_items(world->bodies, sizeof(Object3D), order, n, tmp);
+        permute_items(world->aabbs, sizeof(AABB), order, n, tmp);
+        permute_items(world->body_mesh, sizeof(int), order, n, tmp);
+        permute_items(world->body_id, sizeof(int), order, n, tmp);
+        permute_items(world->sleep_group, sizeof(int), order, n, tmp);
+        for (int k = 0; k < n; ++k) {
+            world->body_slot[world->body_id[k]] = k;
+        }
+        remap_manifolds(&world->manifolds, new_slot);
+    }
+    world->stats.num_moved = moved;
+
+    // Corps qui viennent de quitter les éveillés : AABB figées à leur
+    // dernière pose, hors de tout solveur
+    for (int k = world->num_awake; k < n; ++k) {
+        world->solver_slot[k] = 0;
+        if (order[k] < old_awake) aabb_range(world, k, k + 1, 0);
+    }
+    return 1;
+}
+
+static void put_to_sleep(World* world, const int* slots, int count) {
+    BodySoA* s = &world->state;
+    int group = world->body_id[slots[0]];
+    for (int k = 0; k < count; ++k) {
+        int i = slots[k];
+        world->sleep_group[i] = group;
+        s->vx[i] = s->vy[i] = s->vz[i] = 0.0f;
+        s->wx[i] = s->wy[i] = s->wz[i] = 0.0f;
+    }
+    world->activity_dirty = 1;
+}
+
+// Temps de repos de chaque corps éveillé, puis endormissement des îlots dont
+// tous les corps sont au repos depuis WORLD_TIME_TO_SLEEP. Sans contraintes,
+// chaque corps est son propre îlot.
+static void update_sleep(World* world, int use_islands) {
+    BodySoA* s = &world->state;
+    float lin = WORLD_SLEEP_LINEAR * WORLD_SLEEP_LINEAR;
+    float ang = WORLD_SLEEP_ANGULAR * WORLD_SLEEP_ANGULAR;
+    for (int i = 0; i < world->num_awake; ++i) {
+        float v2 = s->vx[i] * s->vx[i] + s->vy[i] * s->vy[i] + s->vz[i] * s->vz[i];
+        float w2 = s->wx[i] * s->wx[i] + s->wy[i] * s->wy[i] + s->wz[i] * s->wz[i];
+        s->sleep_time[i] = (v2 > lin || w2 > ang) ? 0.0f : s->sleep_time[i] + world->fixed_dt;
+    }
+    if (!use_islands) {
+        for (int i = 0; i < world->num_awake; ++i) {
+            if (s->sleep_time[i] >= WORLD_TIME_TO_SLEEP) put_to_sleep(world, &i, 1);
+        }
+        return;
+    }
+    // Îlots du pas courant seulement (stats.num_islands reste nul si la
+    // résolution a échoué)
+    const IslandSet* set = &world->islands;
+    for (int k = 0; k < world->stats.num_islands; ++k) {
+        int begin = set->body_start[k], end = set->body_start[k + 1];
+        int rested = 1;
+        for (int j = begin; rested && j < end; ++j) {
+            rested = s->sleep_time[set->bodies[j]] >= WORLD_TIME_TO_SLEEP;
+        }
+        if (rested) put_to_sleep(world, set->bodies + begin, end - begin);
+    }
+}
+
+// Boîtes des corps proches des particules (sphère englobante contre la
+// boîte des particules), puis contraintes et collisions. La boîte d'un corps
+// est celle de son maillage : exacte pour un cube, plus large sinon.
+static void step_particles(World* world) {
+    ParticleSystem* ps = &world->particles;
+    if (!particle_system_integrate(ps, world->gravity, world->fixed_dt, world->jobs)) {
+        return;
+    }
+    const BodySoA* s = &world->state;
+    AABB box = ps->bounds;
+    particle_system_clear_colliders(ps);
+    for (int i = 0; i < world->num_bodies; ++i) {
+        const AABB* local = &world->bodies[i].mesh->bounds;
+        Vec3D scale = world->bodies[i].scale;
+        Quat q = {s->qx[i], s->qy[i], s->qz[i], s->qw[i]};
+        Vec3D c = vec3_scale(vec3_add(local->min, local->max), 0.5f);
+        Vec3D h = vec3_scale(vec3_sub(local->max, local->min), 0.5f);
+        c = vec3_add((Vec3D){s->px[i], s->py[i], s->pz[i]},
+                     quat_rotate(q, (Vec3D){c.x * scale.x, c.y * scale.y, c.z * scale.z}));
+        h = (Vec3D){h.x * fabsf(scale.x), h.y * fabsf(scale.y), h.z * fabsf(scale.z)};
+        float reach = vec3_length(h) + ps->radius;
+        if (c.x + reach <= box.min.x || c.x - reach >= box.max.x || c.y + reach <= box.min.y ||
+            c.y - reach >= box.max.y || c.z + reach <= box.min.z || c.z - reach >= box.max.z) {
+            continue;
+        }
+        ParticleCollider* collider = particle_system_push_collider(ps);
+        if (collider == NULL) {
+            break;
+        }
+        *collider = (ParticleCollider){c, q, h, vec3_length(h)};
+    }
+    particle_system_solve(ps, world->jobs);
+}
+
+void world_step(World* world) {
+    PROFILE_SCOPE("step");
+    WorldStats* st = &world->stats;
+    uint64_t t0 = timer_now_ns();
+    int constrained = world->broadphase != NULL || world->num_joints > 0;
+    memset(st, 0, sizeof(*st));
+    arena_reset(&world->frame);
+    world->ccd_mark = NULL;
+    update_activity(world);
+    int awake = world->num_awake;
+    int grain = body_grain(world, awake);
+    uint64_t t_activity = timer_now_ns();
+    st->sleep_ns = t_activity - t0;
+
+    // Euler semi-implicite : la vitesse est mise à jour avant la position.
+    // Avec des contraintes, le solveur corrige la vitesse entre les deux.
+    PROFILE_BEGIN(integrate, "integrate");
+    job_parallel_for(world->jobs, awake, grain, constrained ? velocity_range : integrate_range, world);
+    PROFILE_END(integrate);
+    uint64_t t1 = timer_now_ns();
+    st->integrate_ns = t1 - t_activity;
+
+    if (world->broadphase != NULL) {
+        BroadPhase* bp = world->broadphase;
+        PROFILE_BEGIN(broadphase, "broadphase");
+        st->num_ccd_bodies = sweep_bodies(world);
+        broadphase_update(bp, world->aabbs, world->num_bodies);
+        PROFILE_END(broadphase);
+        uint64_t t2 = timer_now_ns();
+        st->broadphase_ns = t2 - t1;
+        st->num_pairs = bp->num_pairs;
+
+        // En cas d'échec d'allocation, le cache reste vide (aucune variété) :
+        // le pas se termine sans contacts, positions intégrées et sommeil compris
+        if (manifold_cache_begin(&world->manifolds, bp->pairs, bp->num_pairs)) {
+            // Une paire coûte bien plus qu'un corps : morceaux quatre fois plus petits
+            PROFILE_BEGIN(narrowphase, "narrowphase");
+            job_parallel_for(world->jobs, bp->num_pairs, body_grain(world, bp->num_pairs) / 4,
+                             narrowphase_range, world);
+            PROFILE_END(narrowphase);
+        }
+        st->narrowphase_ns = timer_now_ns() - t2;
+        st->num_reused_manifolds = world->manifolds.num_reused;
+        for (int p = 0; p < world->manifolds.count; ++p) {
+            st->num_gjk_iterations += world->manifolds.manifolds[p].gjk_iterations;
+            st->num_skipped_queries += world->manifolds.manifolds[p].skipped;
+        }
+    }
+    if (constrained) {
+        solve_constraints(world);
+        CcdSweep* sweeps = NULL;
+        int num_sweeps = 0;
+        uint64_t t3 = timer_now_ns();
+        if (st->num_ccd_bodies > 0) {
+            PROFILE_BEGIN(ccd, "ccd");
+            num_sweeps = find_impacts(world, &sweeps);
+            PROFILE_END(ccd);
+            st->ccd_ns = timer_now_ns() - t3;
+            t3 = timer_now_ns();
+        }
+        PROFILE_BEGIN(positions, "integrate");
+        job_parallel_for(world->jobs, awake, grain, position_range, world);
+        PROFILE_END(positions);
+        uint64_t t4 = timer_now_ns();
+        st->integrate_ns += t4 - t3;
+        if (num_sweeps > 0) {
+            st->num_ccd_impacts = apply_impacts(world, sweeps, num_sweeps);
+            st->ccd_ns += timer_now_ns() - t4;
+        }
+    }
+    if (world->particles.particles.count > 1) {
+        uint64_t t4 = timer_now_ns();
+        PROFILE_BEGIN(particles, "particles");
+        step_particles(world);
+        PROFILE_END(particles);
+        st->particles_ns = timer_now_ns() - t4;
+    }
+    if (world->allow_sleep) {
+        uint64_t t4 = timer_now_ns();
+        update_sleep(world, constrained);
+        st->sleep_ns += timer_now_ns() - t4;
+    }
+    st->num_awake = awake;
+    st->num_asleep = world->num_asleep;
+    st->step_ns = timer_now_ns() - t0;
+    world->step_count++;
+}
+
+int world_advance(World* world, float elapsed_s) {
+    int steps = 0;
+    world->accumulator += elapsed_s;
+    while (world->accumulator >= world->fixed_dt && steps < world->max_substeps) {
+        world_step(world);
+        world->accumulator -= world->fixed_dt;
+        steps++;
+    }
+    if (steps == world->max_substeps && world->accumulator >= world->fixed_dt) {
+        // Trop de retard : on abandonne le temps restant plutôt que de ralentir davantage
+        world->accumulator = 0.0f;
+    }
+    return steps;
+}
+
+float world_interpolation_alpha(const World* world) {
+    return world->accumulator / world->fixed_dt;
+}
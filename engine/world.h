@@ -0,0 +1,264 @@
+#ifndef ENGINE_WORLD_H
+#define ENGINE_WORLD_H
+
+#include <stdint.h>
+#include "alloc.h"
+#include "broadphase.h"
+#include "ccd.h"
+#include "contacts.h"
+#include "islands.h"
+#include "jobs.h"
+#include "manifold.h"
+#include "math3d.h"
+#include "mesh_asset.h"
+#include "object3d.h"
+#include "particles.h"
+#include "soa.h"
+#include "solver.h"
+
+// --- Configuration ---
+#define WORLD_DEFAULT_DT (1.0f / 60.0f)
+#define WORLD_DEFAULT_MAX_SUBSTEPS 8
+#define WORLD_DEFAULT_ITERATIONS 8
+#define WORLD_BODY_GRAIN 1024 // Corps par tâche en mode déterministe
+#define WORLD_PAIR_GRAIN 256  // Cellules de grille par tâche en mode déterministe
+#define WORLD_SLEEP_LINEAR 0.02f  // m/s : en dessous, un corps est considéré au repos
+#define WORLD_SLEEP_ANGULAR 0.05f // rad/s
+#define WORLD_TIME_TO_SLEEP 0.5f  // Repos continu exigé de tout un îlot avant de l'endormir
+#define WORLD_DEFAULT_CCD_THRESHOLD 0.5f // Déplacement par pas, en fraction de la plus petite dimension
+#define WORLD_CCD_GRAIN 16        // Corps balayés par tâche
+#define WORLD_JOINTS_PER_CHUNK 64 // Articulations par tranche du pool
+
+typedef struct ReplayLog ReplayLog; // Journal des entrées (replay.h)
+
+// Génération des contacts pour chaque paire candidate
+typedef enum {
+    NARROWPHASE_AABB = 0, // Recouvrement des AABB, axe de moindre pénétration
+    NARROWPHASE_GJK       // GJK/EPA sur les sommets, variétés conservées d'un pas à l'autre
+} NarrowPhaseKind;
+
+// Durées (ns) et volumes du dernier pas, étape par étape
+typedef struct {
+    uint64_t integrate_ns;   // Vitesses puis positions
+    uint64_t broadphase_ns;  // AABB + paires candidates
+    uint64_t narrowphase_ns;
+    uint64_t islands_ns;
+    uint64_t solve_ns;       // Préparation et itérations du solveur, îlot par îlot
+    uint64_t sleep_ns;       // Réveils, endormissements et rangement des corps
+    uint64_t particles_ns;   // Particules : intégration, contraintes et collisions
+    uint64_t ccd_ns;         // Balayage des corps rapides et arrêt au premier contact
+    uint64_t step_ns;
+    int num_pairs;
+    int num_contacts;          // Paires dont la variété a au moins un point
+    int num_islands;
+    int num_reused_manifolds;  // Variétés reprises du pas précédent
+    int num_gjk_iterations;    // Somme sur toutes les paires
+    int num_skipped_queries;   // Paires quasi immobiles : points en cache, sans GJK/EPA
+    int num_awake;             // Corps dynamiques simulés pendant ce pas
+    int num_asleep;            // Corps dynamiques endormis
+    int num_moved;             // Corps déplacés par le rangement en début de pas
+    int num_ccd_bodies;        // Corps balayés par la détection continue
+    int num_ccd_impacts;       // Corps arrêtés au premier contact au lieu de traverser
+
+    // Solveur : lignes, lots de SOLVER_LANES et couleurs (maximum sur les tâches)
+    int num_rows;
+    int num_batches;
+    int num_colors;
+    int solver_iterations;
+    uint64_t iteration_ns;     // Durée d'une itération, cumulée sur les tâches
+    // |variation d'impulsion| moyenne par ligne, itération par itération :
+    // sa décroissance mesure la convergence
+    float residual[SOLVER_MAX_TRACKED_ITERATIONS];
+} WorldStats;
+
+// Monde physique sans rendu : aucune dépendance à SDL ni à une horloge murale.
+// Le temps n'avance que par world_step() (un pas fixe) ou world_advance()
+// (temps écoulé accumulé, consommé par pas fixes).
+typedef struct {
+    // Les corps sont rangés par activité : d'abord les corps dynamiques
+    // éveillés, places [0, num_awake), seuls à être intégrés, transformés et
+    // résolus ; ensuite les corps statiques et endormis, dont les AABB
+    // restent celles du dernier pas où ils ont bougé. Tous les tableaux par
+    // corps (state, bodies, body_mesh, aabbs) suivent cet ordre,
+    // qui change quand un îlot s'endort ou se réveille. Les index de l'API
+    // (world_add_body, world_get_body, Joint) sont des identifiants stables :
+    // body_slot[id] donne la place actuelle du corps.
+    int* body_slot;     // Identifiant -> place
+    int* body_id;       // Place -> identifiant
+    int num_awake;
+    int num_asleep;     // Corps dynamiques hors de [0, num_awake)
+
+    // État cinématique en SoA : c'est lui qu'intègrent les noyaux SIMD.
+    // Les champs position/rotation/vitesses de `bodies` n'en sont qu'une copie,
+    // rafraîchie par world_get_body et repoussée par world_update_body.
+    BodySoA state;
+    Object3D* bodies;
+    int num_bodies;
+    int capacity;
+
+    // Maillages des corps, chacun une seule fois quel que soit le nombre de
+    // ses instances (une référence par entrée, rendue par free_world). Un
+    // corps ne coûte que sa transformation : ses sommets ne sont jamais
+    // recopiés, ni en repère local ni en repère monde.
+    MeshAsset** meshes;
+    int num_meshes;
+    int mesh_capacity;
+    int* mesh_lookup;      // Table ouverte : maillage -> index dans meshes (-1 : case libre)
+    int mesh_lookup_size;  // Puissance de 2, au moins le double de num_meshes
+    int* body_mesh;        // Par place : index du maillage du corps dans meshes
+
+    // Phase large (optionnelle) : AABB monde de la boîte locale du maillage,
+    // recalculées à chaque pas
+    BroadPhase* broadphase;
+    AABB* aabbs;
+
+    // Contacts (une variété par paire candidate, dans l'ordre des paires)
+    NarrowPhaseKind narrowphase;
+    ManifoldCache manifolds;
+
+    // Articulations : enregistrements de longue durée, pris dans un pool et
+    // désignés par les poignées de world_add_joint (une poignée d'articulation
+    // retirée est refusée). joint_list les range dans l'ordre de création,
+    // qui est celui de la résolution.
+    Pool joints;
+    PoolHandle* joint_list;
+    int num_joints;
+    int joint_capacity;
+
+    // Tampons du pas en cours, rendus d'un coup au début du pas suivant
+    Arena frame;
+
+    // Contraintes actives du pas (contacts touchants puis articulations, dans
+    // `frame`) et îlots indépendants. constraint_ref : index de la variété, ou
+    // -(j + 1) pour l'articulation j.
+    BodyPair* constraint_pairs;
+    int* constraint_ref;
+    IslandSet islands;
+
+    // Solveur à impulsions séquentielles : un par morceau de la boucle sur les îlots
+    Solver* solvers;
+    int num_solvers;
+    int* solver_slot;        // Place de chaque corps dynamique dans son solveur
+    int solver_iterations;
+    float friction;
+
+    // Sommeil : un îlot dont tous les corps restent sous les seuils pendant
+    // WORLD_TIME_TO_SLEEP s'endort d'un bloc. Il se réveille d'un bloc quand
+    // un corps éveillé le touche, ou par world_update_body, world_wake_body,
+    // world_apply_impulse, world_add_joint et world_remove_joint.
+    int allow_sleep;
+    int* sleep_group;             // Par place : identifiant d'un corps de l'îlot endormi, -1 sinon
+    unsigned char* wake_request;  // Par identifiant de groupe : réveil au prochain pas
+    int activity_dirty;           // Rangement à refaire au début du prochain pas
+
+    // Détection continue (ccd.h) : un corps marqué `ccd`, ou dont le
+    // déplacement du pas dépasse ccd_threshold fois sa plus petite dimension,
+    // a une AABB étirée sur tout son trajet. Ses paires candidates sont
+    // balayées par avance conservatrice entre le solveur et l'intégration des
+    // positions, et il s'arrête au premier contact au lieu de traverser ; le
+    // reste du pas est perdu pour lui. Les autres corps ne paient que le test
+    // de vitesse, fait avec le calcul de leur AABB.
+    float ccd_threshold;          // 0 : seuls les corps marqués
+    unsigned char* ccd_mark;      // Par place éveillée, dans `frame` : corps balayé pendant ce pas
+
+    // Particules et contraintes de distance (tissus, cordes), avancées à la
+    // fin de chaque pas contre les poses finales des corps rigides
+    ParticleSystem particles;
+
+    // Pool de threads (non possédé, NULL = séquentiel). En mode déterministe,
+    // le découpage du travail ne dépend pas du nombre de threads et le résultat
+    // est identique au bit près quel que soit le pool.
+    JobSystem* jobs;
+    int deterministic;
+    WorldStats stats;
+
+    // Journal des entrées (non possédé, NULL = rien n'est consigné) : ajouts
+    // de corps, mises à jour, réveils, impulsions et articulations y sont
+    // inscrits avec le numéro du pas, pour rejouer l'exécution au bit près
+    ReplayLog* recorder;
+
+    Vec3D gravity;
+    float fixed_dt;
+    float accumulator;  // Temps non encore simulé (< fixed_dt après world_advance)
+    int max_substeps;   // Borne les pas par appel pour éviter la "spirale de la mort"
+    uint64_t step_count;
+} World;
+
+void create_world(World* world, float fixed_dt);
+void free_world(World* world);
+
+// Le monde prend possession de la référence de `obj` à son maillage (rendue
+// par free_world). Retourne l'identifiant du corps, ou -1 en cas d'échec
+// d'allocation ou si `obj` n'a pas de maillage.
+int world_add_body(World* world, const Object3D* obj);
+// Réserve la place de `num_bodies` corps, pour un ajout en bloc. Retourne 0
+// en cas d'échec d'allocation.
+int world_reserve(World* world, int num_bodies);
+
+// Index de `mesh` dans world->meshes, où il est ajouté (avec une référence)
+// s'il n'y est pas encore ; -1 en cas d'échec d'allocation
+int world_mesh_index(World* world, MeshAsset* mesh);
+
+// Recopie l'état du corps depuis le SoA et retourne l'objet (NULL si index invalide).
+// Le pointeur n'est valable que jusqu'au prochain pas.
+Object3D* world_get_body(World* world, int index);
+// Repousse dans le SoA l'état modifié via le pointeur de world_get_body ;
+// réveille le corps et son îlot
+void world_update_body(World* world, int index);
+
+// Place actuelle du corps `index` dans les tableaux par corps (-1 si invalide)
+static inline int world_body_slot(const World* world, int index) {
+    return (index >= 0 && index < world->num_bodies) ? world->body_slot[index] : -1;
+}
+
+// Réveille le corps et tout son îlot au prochain pas
+void world_wake_body(World* world, int index);
+
+// Impulsion (N.s) appliquée au point `point` (repère monde) ; réveille le corps
+void world_apply_impulse(World* world, int index, Vec3D impulse, Vec3D point);
+
+// Articulation entre les corps a et b, ancrée au point `anchor` (repère monde,
+// poses actuelles). `axis` est l'axe libre d'une charnière, ignoré sinon.
+// Retourne la poignée de l'articulation, ou POOL_NULL_HANDLE (corps
+// invalides, allocation).
+PoolHandle world_add_joint(World* world, JointType type, int a, int b, Vec3D anchor, Vec3D axis);
+
+// Retire l'articulation et réveille ses deux corps ; 0 si la poignée est
+// nulle ou périmée (articulation déjà retirée)
+int world_remove_joint(World* world, PoolHandle joint);
+
+// Articulation désignée par la poignée ; NULL si elle a été retirée
+static inline Joint* world_get_joint(const World* world, PoolHandle joint) {
+    return (Joint*)pool_get(&world->joints, joint);
+}
+
+// Le monde prend possession de `bp` (NULL pour désactiver la détection)
+void world_set_broadphase(World* world, BroadPhase* bp);
+
+// Le pool reste la propriété de l'appelant ; NULL pour revenir au séquentiel
+void world_set_job_system(World* world, JobSystem* jobs, int deterministic);
+
+// AABB monde des corps éveillés, depuis la boîte locale de leur maillage
+// (celles des autres corps sont déjà à jour, recalculées à chaque changement)
+void world_update_aabbs(World* world);
+
+// Un pas de durée fixed_dt (Euler semi-implicite). Les corps sont d'abord
+// rangés si des îlots se sont endormis ou réveillés. Sans contrainte, vitesses
+// et positions des corps éveillés sont intégrées d'un bloc. Sinon : gravité sur
+// les vitesses, paires candidates et variétés de contact (si une phase large
+// est installée), îlots, résolution des contacts et articulations, puis
+// positions. Phase étroite et îlots sont traités en parallèle sur le pool.
+// Les corps rapides sont balayés avant l'intégration des positions et
+// arrêtés au premier contact (détection continue).
+// Les particules suivent, projetées hors des boîtes des corps qu'elles
+// touchent. Enfin, les îlots restés au repos assez longtemps s'endorment.
+void world_step(World* world);
+
+// Ajoute `elapsed_s` à l'accumulateur et effectue autant de pas fixes que possible.
+// Retourne le nombre de pas effectués.
+int world_advance(World* world, float elapsed_s);
+
+// Fraction [0, 1) du pas suivant déjà écoulée, pour interpoler l'affichage
+float world_interpolation_alpha(const World* world);
+
+#endif
@@ -4,6 +4,11 @@
 #include <math.h>
 #include <SDL2/SDL.h>
 
+#include "engine/alloc.h"
+#include "engine/clip.h"
+#include "engine/raster.h"
+#include "engine/timer.h"
+
 // --- Constantes ---
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
@@ -37,6 +42,8 @@ typedef struct {
 // --- Variables globales pour SDL ---
 SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
+SDL_Texture* frame_texture = NULL; // Copie du framebuffer logiciel, une fois par image
+Framebuffer framebuffer;
 
 // --- Fonctions matricielles ---
 
@@ -135,7 +142,10 @@ Mat4x4 matrix_projection(float fov_deg, float aspect_ratio, float near_plane, fl
 Mesh create_cube_mesh() {
     Mesh cube;
     cube.num_vertices = 8;
-    cube.vertices = (Vec3D*)malloc(cube.num_vertices * sizeof(Vec3D));
+    cube.num_edges = 12;
+    // Sommets puis arêtes dans un seul bloc
+    cube.vertices = (Vec3D*)malloc(cube.num_vertices * sizeof(Vec3D) + cube.num_edges * sizeof(Edge));
+    cube.edges = (Edge*)(cube.vertices + cube.num_vertices);
     // Définition des sommets du cube (centré à l'origine)
     cube.vertices[0] = (Vec3D){-0.5f, -0.5f, -0.5f};
     cube.vertices[1] = (Vec3D){ 0.5f, -0.5f, -0.5f};
@@ -146,8 +156,6 @@ Mesh create_cube_mesh() {
     cube.vertices[6] = (Vec3D){ 0.5f,  0.5f,  0.5f};
     cube.vertices[7] = (Vec3D){-0.5f,  0.5f,  0.5f};
 
-    cube.num_edges = 12;
-    cube.edges = (Edge*)malloc(cube.num_edges * sizeof(Edge));
     // Face avant
     cube.edges[0] = (Edge){0, 1};
     cube.edges[1] = (Edge){1, 2};
@@ -168,8 +176,7 @@ Mesh create_cube_mesh() {
 }
 
 void free_mesh(Mesh* mesh) {
-    if (mesh->vertices) free(mesh->vertices);
-    if (mesh->edges) free(mesh->edges);
+    free(mesh->vertices); // Les arêtes sont dans le même bloc
     mesh->num_vertices = 0;
     mesh->num_edges = 0;
 }
@@ -189,15 +196,28 @@ bool init_sdl() {
         return false;
     }
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (renderer == NULL) {
+        // Pilote sans accélération (ex. SDL_VIDEODRIVER=dummy)
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    }
     if (renderer == NULL) {
         printf("Le rendu n'a pas pu être créé! Erreur SDL: %s\n", SDL_GetError());
         SDL_DestroyWindow(window);
         return false;
     }
+    frame_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                      SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (frame_texture == NULL || !create_framebuffer(&framebuffer, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        printf("Le framebuffer n'a pas pu être créé! Erreur SDL: %s\n", SDL_GetError());
+        return false;
+    }
     return true;
 }
 
 void close_sdl() {
+    free_framebuffer(&framebuffer);
+    if (frame_texture) SDL_DestroyTexture(frame_texture);
+    frame_texture = NULL;
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     renderer = NULL;
@@ -212,7 +232,10 @@ int main(int argc, char* args[]) {
     }
 
     Mesh cube = create_cube_mesh();
-    Vec2D projected_points[cube.num_vertices]; // Pour stocker les points projetés
+    // Tampons de chaque image, pris dans une arène plutôt que sur la pile :
+    // leur taille suit le maillage, sans limite de pile
+    Arena frame_arena;
+    arena_init(&frame_arena);
 
     float angle_x = 0.0f;
     float angle_y = 0.0f;
@@ -234,11 +257,11 @@ int main(int argc, char* args[]) {
     bool quit = false;
     SDL_Event e;
 
-    Uint32 last_time = SDL_GetTicks();
+    uint64_t last_time = timer_now_ns(); // SDL_GetTicks n'a qu'une résolution d'une milliseconde
 
     while (!quit) {
-        Uint32 current_time = SDL_GetTicks();
-        float delta_time_s = (current_time - last_time) / 1000.0f;
+        uint64_t current_time = timer_now_ns();
+        float delta_time_s = (float)((double)(current_time - last_time) * 1e-9);
         last_time = current_time;
 
         while (SDL_PollEvent(&e) != 0) {
@@ -282,47 +305,49 @@ int main(int argc, char* args[]) {
         Mat4x4 mv_matrix = matrix_multiply_matrix(view_matrix, model_matrix);
         Mat4x4 mvp_matrix = matrix_multiply_matrix(proj_matrix, mv_matrix);
 
-        // Transformer les sommets
+        arena_reset(&frame_arena);
+        Vec4D* clip_points = ARENA_NEW(&frame_arena, Vec4D, cube.num_vertices); // Espace de découpe (avant division)
+        uint8_t* clip_codes = ARENA_NEW(&frame_arena, uint8_t, cube.num_vertices);
+        ScreenLine* lines = ARENA_NEW(&frame_arena, ScreenLine, cube.num_edges);
+        if (clip_points == NULL || clip_codes == NULL || lines == NULL) {
+            printf("Allocation impossible pour les tampons de l'image\n");
+            break;
+        }
+
+        // Transformer les sommets, sans division : la découpe se fait en espace homogène
         for (int i = 0; i < cube.num_vertices; ++i) {
-            Vec3D current_vertex = cube.vertices[i];
-            Vec4D transformed_vertex = matrix_multiply_vector(mvp_matrix, current_vertex);
-
-            // 2. Division Perspective
-            if (transformed_vertex.w != 0.0f && transformed_vertex.w > near_plane) { // Simple test de clipping
-                transformed_vertex.x /= transformed_vertex.w;
-                transformed_vertex.y /= transformed_vertex.w;
-                transformed_vertex.z /= transformed_vertex.w; // z n'est pas utilisé pour le dessin 2D, mais utile pour z-buffer
-
-                // 3. Transformation Viewport (NDC vers Coordonnées Écran)
-                // NDC x,y sont entre -1 et 1.
-                // L'origine (0,0) de l'écran SDL est en haut à gauche.
-                projected_points[i].x = (transformed_vertex.x + 1.0f) * 0.5f * SCREEN_WIDTH;
-                projected_points[i].y = (1.0f - transformed_vertex.y) * 0.5f * SCREEN_HEIGHT; // Y est inversé
-            } else {
-                // Point derrière la caméra ou sur le plan proche, on le met hors écran pour éviter les artefacts
-                projected_points[i].x = -10000; // Hors écran
-                projected_points[i].y = -10000;
-            }
+            Vec4D* p = &clip_points[i];
+            *p = matrix_multiply_vector(mvp_matrix, cube.vertices[i]);
+            clip_outcodes(&p->x, &p->y, &p->z, &p->w, &clip_codes[i], 1, CLIP_DEPTH_MINUS_ONE_TO_ONE);
         }
 
-        // Rendu
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Fond noir
-        SDL_RenderClear(renderer);
+        // Rendu dans le framebuffer logiciel
+        framebuffer_clear(&framebuffer, RGBA(0, 0, 0, 255)); // Fond noir
 
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // Lignes blanches
+        // 2. Découpe contre les six plans, puis 3. division perspective et
+        // 4. transformation viewport (NDC [-1, 1] vers écran, origine en haut à gauche)
+        // des seules arêtes visibles ; une arête qui traverse le plan proche est raccourcie
+        int num_lines = 0;
         for (int i = 0; i < cube.num_edges; ++i) {
-            Vec2D p1 = projected_points[cube.edges[i].v1_idx];
-            Vec2D p2 = projected_points[cube.edges[i].v2_idx];
-
-            // Ne pas dessiner si l'un des points est "clippé" de manière basique
-            if (p1.x > -9000 && p2.x > -9000) {
-                 SDL_RenderDrawLine(renderer, (int)p1.x, (int)p1.y, (int)p2.x, (int)p2.y);
-            }
+            int a = cube.edges[i].v1_idx, b = cube.edges[i].v2_idx;
+            float p1[4], p2[4];
+            ClipResult result = clip_segment(&clip_points[a].x, &clip_points[b].x,
+                                             clip_codes[a], clip_codes[b], p1, p2,
+                                             CLIP_DEPTH_MINUS_ONE_TO_ONE);
+            if (result == CLIP_CULLED) continue;
+            lines[num_lines++] = (ScreenLine){
+                (p1[0] / p1[3] + 1.0f) * 0.5f * SCREEN_WIDTH, (1.0f - p1[1] / p1[3]) * 0.5f * SCREEN_HEIGHT,
+                (p2[0] / p2[3] + 1.0f) * 0.5f * SCREEN_WIDTH, (1.0f - p2[1] / p2[3]) * 0.5f * SCREEN_HEIGHT};
         }
+        raster_lines(&framebuffer, lines, num_lines, RGBA(255, 255, 255, 255)); // Lignes blanches
 
+        // Un seul transfert vers la carte graphique par image
+        SDL_UpdateTexture(frame_texture, NULL, framebuffer.pixels, framebuffer.pitch * (int)sizeof(uint32_t));
+        SDL_RenderCopy(renderer, frame_texture, NULL, NULL);
         SDL_RenderPresent(renderer);
     }
 
+    arena_free(&frame_arena);
     free_mesh(&cube);
     close_sdl();
     return 0;
@@ -0,0 +1,506 @@
+// Simulation sans fenêtre, pour les nœuds de calcul sans affichage.
+// Usage : headless [--bodies N] [--steps N] [--broadphase none|brute|sap|grid]
+//                  [--scene field|piles|pyramid|bullets] [--threads N] [--deterministic]
+//                  [--narrowphase aabb|gjk] [--cold] [--iterations N] [--no-sleep]
+//                  [--load fichier.psnap] [--save fichier.psnap] [--kicks N]
+//                  [--record fichier.plog] [--replay fichier.plog]
+//                  [--trajectory fichier.ptraj] [--trajectory-every N] [--cloth N]
+//                  [--hz N] [--ccd-threshold X]
+// --cold : ni reprise des variétés ni démarrage à chaud du solveur
+// --iterations : passes du solveur par pas
+// --no-sleep : tous les corps dynamiques restent simulés
+// --load : la scène et ses réglages viennent de l'instantané, pas des options
+// --save : instantané du monde après le dernier pas
+// --kicks : impulsion sur un corps tiré au hasard tous les N pas
+// --record : journal des entrées (impulsions...) de l'exécution
+// --replay : rejoue un journal enregistré depuis le même état initial
+// --trajectory : poses des corps écrites en flux (état initial puis tous les
+//                N pas avec --trajectory-every), à relire avec trajectory_dump
+// --cloth : tissu de N x N particules tendu au-dessus de la scène, fixé par
+//           ses quatre coins
+// --hz : pas par seconde simulée (60 par défaut)
+// --ccd-threshold : déplacement par pas, en fraction de la plus petite
+//                   dimension d'un corps, au-delà duquel il est balayé
+//                   (détection continue) ; 0 la désactive
+// --scene bullets : projectiles rapides tirés sur un mur mince ; le résumé
+//                   compte ceux qui l'ont traversé (phase large sap par
+//                   défaut, none refusé)
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/alloc.h"
+#include "engine/broadphase.h"
+#include "engine/jobs.h"
+#include "engine/object3d.h"
+#include "engine/replay.h"
+#include "engine/snapshot.h"
+#include "engine/timer.h"
+#include "engine/trajectory.h"
+#include "engine/world.h"
+
+static BroadPhase* broadphase_from_name(const char* name) {
+    if (strcmp(name, "brute") == 0) return create_broadphase_brute_force();
+    if (strcmp(name, "sap") == 0) return create_broadphase_sap();
+    if (strcmp(name, "grid") == 0) return create_broadphase_hash_grid(0.0f);
+    return NULL;
+}
+
+static int add_cube(World* world, Vec3D position, Vec3D scale, float mass) {
+    Object3D cube;
+    create_cube(&cube, 1.0f);
+    cube.position = position;
+    cube.scale = scale;
+    object_set_mass(&cube, mass);
+    int id = world_add_body(world, &cube);
+    if (id < 0) {
+        free_object(&cube);
+    }
+    return id;
+}
+
+// Cubes répartis au hasard dans un volume rempli à ~30 %
+static int build_field(World* world, int num_bodies) {
+    float side = 1.5f * cbrtf((float)num_bodies);
+    srand(1234);
+    for (int i = 0; i < num_bodies; ++i) {
+        Vec3D p = {side * rand() / (float)RAND_MAX, side * rand() / (float)RAND_MAX,
+                   side * rand() / (float)RAND_MAX};
+        if (add_cube(world, p, (Vec3D){1, 1, 1}, 1.0f) < 0) return 0;
+    }
+    return 1;
+}
+
+// Piles de 5 cubes posées sur un sol statique, assez espacées pour rester disjointes
+static int build_piles(World* world, int num_bodies) {
+    int num_piles = (num_bodies + 4) / 5;
+    int per_row = (int)ceilf(sqrtf((float)num_piles));
+    float extent = per_row * 3.0f;
+    if (add_cube(world, (Vec3D){extent * 0.5f, -0.5f, extent * 0.5f},
+                 (Vec3D){extent + 2.0f, 1.0f, extent + 2.0f}, 0.0f) < 0) {
+        return 0;
+    }
+    for (int i = 0; i < num_bodies; ++i) {
+        int pile = i / 5, level = i % 5;
+        Vec3D p = {(pile % per_row) * 3.0f + 1.0f, 0.5f + level * 1.0f, (pile / per_row) * 3.0f + 1.0f};
+        if (add_cube(world, p, (Vec3D){1, 1, 1}, 1.0f) < 0) return 0;
+    }
+    return 1;
+}
+
+// Pyramide d'au moins `num_bodies` cubes dans le plan xy, sur un sol statique
+static int build_pyramid(World* world, int num_bodies) {
+    int base = 1;
+    while (base * (base + 1) / 2 < num_bodies) base++;
+    if (add_cube(world, (Vec3D){0.0f, -0.5f, 0.0f}, (Vec3D){base * 2.0f + 4.0f, 1.0f, 4.0f}, 0.0f) < 0) {
+        return 0;
+    }
+    for (int level = 0; level < base; ++level) {
+        int count = base - level;
+        for (int i = 0; i < count; ++i) {
+            Vec3D p = {(i - 0.5f * (count - 1)) * 1.05f, 0.5f + level * 1.0f, 0.0f};
+            if (add_cube(world, p, (Vec3D){1, 1, 1}, 1.0f) < 0) return 0;
+        }
+    }
+    return 1;
+}
+
+// Projectiles de 20 cm tirés à 120 m/s sur un mur de 10 cm d'épaisseur : à
+// 60 pas par seconde, un pas les avance de 2 m, bien plus que les deux
+// épaisseurs réunies. Mur et sol sont les corps 0 et 1 ; le sol est assez
+// large pour que les projectiles déviés par le mur ne tombent pas.
+#define BULLET_WALL_X 8.0f
+
+static int build_bullets(World* world, int num_bodies) {
+    int per_row = (int)ceilf(sqrtf((float)num_bodies));
+    float extent = per_row * 0.5f + 2.0f;
+    if (add_cube(world, (Vec3D){BULLET_WALL_X, 0.5f * extent, 0.0f}, (Vec3D){0.1f, extent, extent}, 0.0f) < 0 ||
+        add_cube(world, (Vec3D){BULLET_WALL_X, -0.5f, 0.0f}, (Vec3D){4.0f * BULLET_WALL_X, 1.0f, 3.0f * extent}, 0.0f) < 0) {
+        return 0;
+    }
+    for (int i = 0; i < num_bodies; ++i) {
+        Vec3D p = {0.0f, 1.0f + (i / per_row) * 0.5f, ((i % per_row) - 0.5f * (per_row - 1)) * 0.5f};
+        int id = add_cube(world, p, (Vec3D){0.2f, 0.2f, 0.2f}, 0.1f);
+        if (id < 0) return 0;
+        world_get_body(world, id)->velocity = (Vec3D){120.0f, 0.0f, 0.0f};
+        world_update_body(world, id);
+    }
+    return 1;
+}
+
+// Projectiles passés de l'autre côté du mur
+static int count_tunneled(World* world) {
+    int count = 0;
+    for (int id = 2; id < world->num_bodies; ++id) {
+        count += world_get_body(world, id)->position.x > BULLET_WALL_X;
+    }
+    return count;
+}
+
+// Vitesse du corps dynamique le plus rapide (proche de 0 pour un empilement
+// stable) et hauteur du plus haut (un empilement effondré est aussi immobile)
+static float max_speed(const BodySoA* s, float* max_height) {
+    float max2 = 0.0f;
+    *max_height = -FLT_MAX;
+    for (int i = 0; i < s->count; ++i) {
+        if (s->inv_mass[i] == 0.0f) continue;
+        float v2 = s->vx[i] * s->vx[i] + s->vy[i] * s->vy[i] + s->vz[i] * s->vz[i];
+        if (v2 > max2) max2 = v2;
+        if (s->py[i] > *max_height) *max_height = s->py[i];
+    }
+    return sqrtf(max2);
+}
+
+// Impulsion vers le haut, excentrée, sur un corps choisi d'après le numéro du pas
+static void kick_body(World* world) {
+    uint64_t h = (world->step_count + 1) * 0x9E3779B97F4A7C15ull;
+    int id = (int)((h >> 33) % (uint64_t)world->num_bodies);
+    const Object3D* body = world_get_body(world, id);
+    if (body == NULL || body->inv_mass == 0.0f) {
+        return;
+    }
+    Vec3D point = vec3_add(body->position, (Vec3D){0.3f, 0.0f, 0.0f});
+    world_apply_impulse(world, id, (Vec3D){0.0f, 4.0f * body->mass, 0.0f}, point);
+}
+
+// Tissu de n x n particules couvrant l'emprise des corps, deux unités
+// au-dessus du plus haut, fixé par ses quatre coins
+static int add_cloth(World* world, int n) {
+    const BodySoA* s = &world->state;
+    AABB box = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+    for (int i = 0; i < s->count; ++i) {
+        Vec3D p = {s->px[i], s->py[i], s->pz[i]};
+        if (i == 0) box.min = box.max = p;
+        box.min = (Vec3D){fminf(box.min.x, p.x), fminf(box.min.y, p.y), fminf(box.min.z, p.z)};
+        box.max = (Vec3D){fmaxf(box.max.x, p.x), fmaxf(box.max.y, p.y), fmaxf(box.max.z, p.z)};
+    }
+    float extent = fmaxf(fmaxf(box.max.x - box.min.x, box.max.z - box.min.z), 1.0f);
+    Mesh grid = create_grid_mesh(n, n, extent / (float)(n > 1 ? n - 1 : 1));
+    if (grid.num_vertices == 0) {
+        return 0;
+    }
+    Vec3D center = {0.5f * (box.min.x + box.max.x), box.max.y + 2.0f, 0.5f * (box.min.z + box.max.z)};
+    Affine3x4 place = affine_from_trs(center, quat_identity(), (Vec3D){1.0f, 1.0f, 1.0f});
+    int first = particle_system_add_mesh(&world->particles, &grid, &place, 0.01f, 1.0f);
+    free_mesh(&grid);
+    if (first < 0) {
+        return 0;
+    }
+    const int corners[4] = {0, n - 1, n * (n - 1), n * n - 1};
+    for (int c = 0; c < 4; ++c) {
+        particle_system_set_inv_mass(&world->particles, first + corners[c], 0.0f);
+    }
+    return 1;
+}
+
+#define FNV_BYTES(h, value) \
+    do { \
+        const unsigned char* p_ = (const unsigned char*)&(value); \
+        for (size_t k_ = 0; k_ < sizeof(value); ++k_) (h) = ((h) ^ p_[k_]) * 1099511628211ull; \
+    } while (0)
+
+// Empreinte FNV-1a de l'état des corps, puis des particules s'il y en a,
+// pour comparer deux exécutions au bit près
+static uint64_t state_hash(const BodySoA* s, const ParticleSoA* particles) {
+    uint64_t h = 1469598103934665603ull;
+#define HASH_FIELD(f) for (int i = 0; i < s->count; ++i) FNV_BYTES(h, s->f[i]);
+    BODY_SOA_FIELDS(HASH_FIELD)
+#undef HASH_FIELD
+#define HASH_PARTICLES(f) for (int i = 1; i < particles->count; ++i) FNV_BYTES(h, particles->f[i]);
+    PARTICLE_SOA_FIELDS(HASH_PARTICLES)
+#undef HASH_PARTICLES
+    return h;
+}
+
+int main(int argc, char* argv[]) {
+    int num_bodies = 1000;
+    int num_steps = 1000;
+    int num_threads = 1;
+    int deterministic = 0;
+    const char* bp_name = NULL; // "none", sauf pour la scène bullets ("sap")
+    const char* scene = "field";
+    NarrowPhaseKind narrowphase = NARROWPHASE_GJK;
+    int warm_start = 1;
+    int iterations = WORLD_DEFAULT_ITERATIONS;
+    int allow_sleep = 1;
+    const char* load_path = NULL;
+    const char* save_path = NULL;
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    const char* trajectory_path = NULL;
+    int trajectory_every = 1;
+    int kicks = 0;
+    int cloth = 0;
+    float hz = 1.0f / WORLD_DEFAULT_DT;
+    float ccd_threshold = WORLD_DEFAULT_CCD_THRESHOLD;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bodies") == 0 && i + 1 < argc) num_bodies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) num_steps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--broadphase") == 0 && i + 1 < argc) bp_name = argv[++i];
+        else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) scene = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) num_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--deterministic") == 0) deterministic = 1;
+        else if (strcmp(argv[i], "--narrowphase") == 0 && i + 1 < argc &&
+                 (strcmp(argv[i + 1], "aabb") == 0 || strcmp(argv[i + 1], "gjk") == 0)) {
+            narrowphase = (strcmp(argv[++i], "aabb") == 0) ? NARROWPHASE_AABB : NARROWPHASE_GJK;
+        }
+        else if (strcmp(argv[i], "--cold") == 0) warm_start = 0;
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-sleep") == 0) allow_sleep = 0;
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) load_path = argv[++i];
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) save_path = argv[++i];
+        else if (strcmp(argv[i], "--kicks") == 0 && i + 1 < argc) kicks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+        else if (strcmp(argv[i], "--trajectory") == 0 && i + 1 < argc) trajectory_path = argv[++i];
+        else if (strcmp(argv[i], "--trajectory-every") == 0 && i + 1 < argc) trajectory_every = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cloth") == 0 && i + 1 < argc) cloth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) hz = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--ccd-threshold") == 0 && i + 1 < argc) ccd_threshold = (float)atof(argv[++i]);
+        else {
+            printf("Option inconnue : %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    int bullets = load_path == NULL && strcmp(scene, "bullets") == 0;
+    if (bp_name == NULL) {
+        bp_name = bullets ? "sap" : "none";
+    }
+    if (bullets && strcmp(bp_name, "brute") != 0 && strcmp(bp_name, "sap") != 0 && strcmp(bp_name, "grid") != 0) {
+        // Sans phase large, aucun projectile ne peut rencontrer le mur
+        printf("La scène bullets demande une phase large (brute, sap ou grid)\n");
+        return 1;
+    }
+
+    JobSystem* jobs = (num_threads != 1) ? create_job_system(num_threads) : NULL;
+    World world;
+    create_world(&world, hz > 0.0f ? 1.0f / hz : WORLD_DEFAULT_DT);
+    world_set_broadphase(&world, broadphase_from_name(bp_name));
+    world_set_job_system(&world, jobs, deterministic);
+    world.narrowphase = narrowphase;
+    world.manifolds.warm_start = warm_start;
+    world.solver_iterations = iterations;
+    world.allow_sleep = allow_sleep;
+    world.ccd_threshold = ccd_threshold;
+
+    int ok;
+    if (load_path != NULL) {
+        uint64_t t0 = timer_now_ns();
+        ok = world_load_snapshot(&world, load_path);
+        if (ok) {
+            scene = "instantané";
+            narrowphase = world.narrowphase;
+            warm_start = world.manifolds.warm_start;
+            allow_sleep = world.allow_sleep;
+            printf("Instantané %s restauré : %d corps, pas %llu, en %.3f s\n", load_path, world.num_bodies,
+                   (unsigned long long)world.step_count, (double)(timer_now_ns() - t0) * 1e-9);
+        }
+    } else {
+        ok = (strcmp(scene, "piles") == 0)     ? build_piles(&world, num_bodies)
+             : (strcmp(scene, "pyramid") == 0) ? build_pyramid(&world, num_bodies)
+             : (strcmp(scene, "bullets") == 0) ? build_bullets(&world, num_bodies)
+                                               : build_field(&world, num_bodies);
+        if (!ok) printf("Allocation impossible pour la scène %s\n", scene);
+    }
+    if (ok && cloth > 1 && !add_cloth(&world, cloth)) {
+        printf("Allocation impossible pour le tissu\n");
+        ok = 0;
+    }
+    ReplayLog record, replay;
+    replay_init(&record, world.step_count);
+    replay_init(&replay, world.step_count);
+    if (ok && replay_path != NULL) {
+        ok = replay_load(&replay, replay_path);
+        if (ok && replay.start_step != world.step_count) {
+            printf("%s : enregistré à partir du pas %llu, le monde est au pas %llu\n", replay_path,
+                   (unsigned long long)replay.start_step, (unsigned long long)world.step_count);
+            ok = 0;
+        }
+    }
+    TrajectoryWriter* trajectory = NULL;
+    if (ok && trajectory_path != NULL) {
+        trajectory = create_trajectory_writer(trajectory_path, trajectory_every, 0, 0, world.fixed_dt, 0);
+        ok = trajectory != NULL && trajectory_append(trajectory, &world, NULL);
+    }
+    if (!ok) {
+        free_trajectory_writer(trajectory);
+        replay_free(&replay);
+        free_world(&world);
+        free_job_system(jobs);
+        return 1;
+    }
+    if (record_path != NULL) {
+        world.recorder = &record;
+    }
+
+    uint64_t stage_ns[6] = {0};
+    uint64_t particle_ns[3] = {0};
+    long long particle_contacts = 0, colliders = 0;
+    uint64_t iteration_ns = 0;
+    long long gjk_iterations = 0, reused = 0, skipped = 0, pairs = 0, rows = 0, batches = 0;
+    long long awake = 0, moved = 0, swept = 0, impacts = 0;
+    uint64_t ccd_ns = 0;
+    int colors = 0;
+    uint64_t allocations = 0;
+    uint64_t start = timer_now_ns();
+    for (int s = 0; s < num_steps; ++s) {
+        if (s == num_steps / 2) allocations = mem_allocation_count();
+        if (replay_path != NULL && replay_apply(&replay, &world) < 0) {
+            printf("%s : événement incohérent avec le monde au pas %llu\n", replay_path,
+                   (unsigned long long)world.step_count);
+            break;
+        }
+        if (kicks > 0 && world.step_count % (uint64_t)kicks == 0) kick_body(&world);
+        world_step(&world);
+        if (trajectory != NULL && !trajectory_append(trajectory, &world, NULL)) {
+            free_trajectory_writer(trajectory);
+            trajectory = NULL;
+            break;
+        }
+        stage_ns[0] += world.stats.integrate_ns;
+        stage_ns[1] += world.stats.broadphase_ns;
+        stage_ns[2] += world.stats.islands_ns;
+        stage_ns[3] += world.stats.narrowphase_ns;
+        stage_ns[4] += world.stats.solve_ns;
+        stage_ns[5] += world.stats.sleep_ns;
+        particle_ns[0] += world.particles.stats.integrate_ns;
+        particle_ns[1] += world.particles.stats.solve_ns;
+        particle_ns[2] += world.particles.stats.collide_ns;
+        particle_contacts += world.particles.stats.num_contacts;
+        colliders += world.particles.stats.num_colliders;
+        awake += world.stats.num_awake;
+        moved += world.stats.num_moved;
+        swept += world.stats.num_ccd_bodies;
+        impacts += world.stats.num_ccd_impacts;
+        ccd_ns += world.stats.ccd_ns;
+        iteration_ns += world.stats.iteration_ns;
+        rows += world.stats.num_rows;
+        batches += world.stats.num_batches;
+        if (world.stats.num_colors > colors) colors = world.stats.num_colors;
+        gjk_iterations += world.stats.num_gjk_iterations;
+        reused += world.stats.num_reused_manifolds;
+        skipped += world.stats.num_skipped_queries;
+        pairs += world.stats.num_pairs;
+    }
+    double elapsed = (double)(timer_now_ns() - start) * 1e-9;
+    allocations = mem_allocation_count() - allocations;
+    double steps = num_steps > 0 ? num_steps : 1;
+
+    printf("%d corps (%s), %d pas, %d thread(s)%s : %.3f s (%.0f pas/s)\n",
+           world.num_bodies, scene, num_steps, job_system_num_threads(jobs),
+           deterministic ? " déterministe" : "", elapsed, num_steps / (elapsed > 0.0 ? elapsed : 1e-9));
+    printf("Étapes (ms/pas) : intégration %.3f, phase large %.3f, phase étroite %.3f, îlots %.3f, "
+           "résolution %.3f, sommeil %.3f\n",
+           timer_ns_to_ms(stage_ns[0]) / steps, timer_ns_to_ms(stage_ns[1]) / steps,
+           timer_ns_to_ms(stage_ns[3]) / steps, timer_ns_to_ms(stage_ns[2]) / steps,
+           timer_ns_to_ms(stage_ns[4]) / steps, timer_ns_to_ms(stage_ns[5]) / steps);
+    printf("Sommeil%s : %.0f corps éveillés par pas en moyenne, %d endormis à la fin, "
+           "%.1f corps rangés par pas\n",
+           allow_sleep ? "" : " (désactivé)", awake / steps, world.stats.num_asleep, moved / steps);
+    if (world.broadphase != NULL) {
+        const BroadPhaseStats* st = &world.broadphase->stats;
+        printf("Phase large %s : %d paires, %lld tests, %d contacts, %d îlots\n",
+               world.broadphase->name, st->num_pairs, (long long)st->num_tests,
+               world.stats.num_contacts, world.stats.num_islands);
+        if (narrowphase == NARROWPHASE_GJK) {
+            printf("Phase étroite GJK%s : %.2f itérations par paire, %.0f %% des variétés reprises, "
+                   "%.0f %% sans requête\n",
+                   warm_start ? "" : " (à froid)", pairs ? (double)gjk_iterations / pairs : 0.0,
+                   pairs ? 100.0 * reused / pairs : 0.0, pairs ? 100.0 * skipped / pairs : 0.0);
+        }
+    }
+    if (world.broadphase != NULL) {
+        printf("Détection continue%s : %.1f corps balayés par pas, %lld arrêts au premier contact, "
+               "%.3f ms/pas\n",
+               world.ccd_threshold > 0.0f ? "" : " (corps marqués seulement)", swept / steps, impacts,
+               timer_ns_to_ms(ccd_ns) / steps);
+    }
+    if (strcmp(scene, "bullets") == 0) {
+        printf("Projectiles passés à travers le mur : %d sur %d (%.0f pas/s)\n", count_tunneled(&world),
+               world.num_bodies - 2, 1.0f / world.fixed_dt);
+    }
+    if (rows > 0) {
+        const WorldStats* ws = &world.stats;
+        int last = ws->solver_iterations < SOLVER_MAX_TRACKED_ITERATIONS ? ws->solver_iterations
+                                                                         : SOLVER_MAX_TRACKED_ITERATIONS;
+        printf("Solveur : %d itérations, %.0f lignes en %.0f lots de %d (%.0f %% remplis), %d couleurs, "
+               "%.1f us/itération\n",
+               ws->solver_iterations, rows / steps, batches / steps, SOLVER_LANES,
+               batches ? 100.0 * rows / (batches * (double)SOLVER_LANES) : 0.0, colors,
+               iteration_ns / steps * 1e-3);
+        float top;
+        float speed = max_speed(&world.state, &top);
+        printf("Convergence (dernier pas, |delta impulsion| moyen) : %.2e -> %.2e ; "
+               "vitesse max %.4f m/s, corps le plus haut à y = %.3f\n",
+               last > 0 ? ws->residual[0] : 0.0f, last > 0 ? ws->residual[last - 1] : 0.0f, speed, top);
+    }
+    const ParticleSystem* ps = &world.particles;
+    if (ps->particles.count > 1) {
+        int num_batches = ps->batches.num_batches;
+        printf("Particules : %d, %d contraintes en %d lots de %d (%.0f %% remplis), %d couleurs, "
+               "%d itérations\n",
+               ps->particles.count - 1, ps->num_constraints, num_batches, PARTICLE_LANES,
+               num_batches ? 100.0 * ps->num_constraints / (num_batches * (double)PARTICLE_LANES) : 0.0,
+               ps->num_colors, ps->iterations);
+        printf("Particules (ms/pas) : intégration %.3f, contraintes %.3f (%.1f us/itération), "
+               "collisions %.3f ; %.0f corps proches, %.0f contacts par pas\n",
+               timer_ns_to_ms(particle_ns[0]) / steps, timer_ns_to_ms(particle_ns[1]) / steps,
+               ps->iterations > 0 ? (double)particle_ns[1] / steps / ps->iterations * 1e-3 : 0.0,
+               timer_ns_to_ms(particle_ns[2]) / steps, colliders / steps, particle_contacts / steps);
+    }
+    if (mem_counting_enabled()) {
+        printf("Allocations pendant la seconde moitié des pas : %llu\n", (unsigned long long)allocations);
+    }
+    printf("Empreinte de l'état : %016llx\n", (unsigned long long)state_hash(&world.state, &world.particles.particles));
+
+    int status = trajectory_path == NULL || trajectory != NULL ? 0 : 1;
+    if (trajectory != NULL) {
+        uint64_t t0 = timer_now_ns();
+        if (trajectory_finish(trajectory)) {
+            TrajectoryStats st = trajectory_writer_stats(trajectory);
+            double frames = st.num_frames ? (double)st.num_frames : 1.0;
+            printf("Trajectoire %s : %llu images en %llu morceaux, %.1f Mo écrits (%.1f %% du brut), "
+                   "capture %.3f ms/image, attente %.3f ms, codage %.3f ms/image (thread d'écriture), "
+                   "fermeture en %.3f s\n",
+                   trajectory_path, (unsigned long long)st.num_frames, (unsigned long long)st.num_chunks,
+                   st.file_bytes / (1024.0 * 1024.0), st.raw_bytes ? 100.0 * st.file_bytes / st.raw_bytes : 0.0,
+                   timer_ns_to_ms(st.capture_ns) / frames, timer_ns_to_ms(st.stall_ns),
+                   timer_ns_to_ms(st.encode_ns) / frames, (double)(timer_now_ns() - t0) * 1e-9);
+        } else {
+            status = 1;
+        }
+        free_trajectory_writer(trajectory);
+    }
+    if (replay_path != NULL) {
+        printf("Journal %s rejoué : %d événements%s\n", replay_path, replay.num_events,
+               replay_done(&replay) ? "" : " (incomplet)");
+        if (!replay_done(&replay)) status = 1;
+    }
+    if (record_path != NULL) {
+        world.recorder = NULL;
+        if (replay_save(&record, record_path)) {
+            printf("Journal %s écrit : %d événements\n", record_path, record.num_events);
+        } else {
+            status = 1;
+        }
+    }
+    if (save_path != NULL) {
+        uint64_t t0 = timer_now_ns();
+        if (world_save_snapshot(&world, save_path)) {
+            printf("Instantané %s écrit : %.1f Mo en %.3f s\n", save_path,
+                   world_snapshot_size(&world) / (1024.0 * 1024.0), (double)(timer_now_ns() - t0) * 1e-9);
+        } else {
+            status = 1;
+        }
+    }
+
+    replay_free(&record);
+    replay_free(&replay);
+    free_world(&world);
+    free_job_system(jobs);
+    return status;
+}
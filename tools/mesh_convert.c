@@ -0,0 +1,73 @@
+// Conversion d'un maillage OBJ vers le format binaire projetable en mémoire.
+// Le maillage est d'abord préparé (mesh_optimize) : arêtes en double retirées,
+// sommets et arêtes rangés pour la localité. Les taux d'échec de cache du
+// découpage des arêtes, simulés avant et après, sont affichés.
+// Usage : mesh_convert entree.obj sortie.pmesh [--keep-order]
+// --keep-order : sommets et arêtes écrits dans l'ordre du fichier d'entrée
+#include <stdio.h>
+#include <string.h>
+
+#include "engine/mesh.h"
+#include "engine/mesh_io.h"
+#include "engine/mesh_optimize.h"
+#include "engine/timer.h"
+
+// --- Configuration ---
+#define L1_BYTES (32 * 1024)
+#define L1_WAYS 8
+#define L2_BYTES (1024 * 1024)
+#define L2_WAYS 16
+
+static const char* format_names[] = {"32 bits", "16 bits", "écarts 16 bits"};
+
+// Taux d'échec simulés et taille des index d'arêtes compressés
+static void print_locality(const char* label, const Mesh* mesh) {
+    double l1 = mesh_edge_miss_rate(mesh->edges, mesh->num_edges, mesh->num_vertices, L1_BYTES, L1_WAYS);
+    double l2 = mesh_edge_miss_rate(mesh->edges, mesh->num_edges, mesh->num_vertices, L2_BYTES, L2_WAYS);
+    size_t num_words;
+    EdgeIndexFormat format = edge_stream_format(mesh->edges, mesh->num_edges, mesh->num_vertices, &num_words);
+    double bytes = format == EDGE_INDEX_32 ? (double)sizeof(Edge) : 2.0 * (double)num_words / mesh->num_edges;
+    printf("%s : échecs de cache %.2f %% (L1 %d Ko), %.2f %% (L2 %d Ko), index %s, %.2f octets par arête\n",
+           label, 100.0 * l1, L1_BYTES / 1024, 100.0 * l2, L2_BYTES / 1024, format_names[format], bytes);
+}
+
+int main(int argc, char* argv[]) {
+    int keep_order = argc == 4 && strcmp(argv[3], "--keep-order") == 0;
+    if (argc != 3 && !keep_order) {
+        printf("Usage : %s entree.obj sortie.pmesh [--keep-order]\n", argv[0]);
+        return 1;
+    }
+    Mesh mesh;
+    uint64_t start = timer_now_ns();
+    if (!load_mesh_file(&mesh, argv[1])) {
+        return 1;
+    }
+    uint64_t loaded = timer_now_ns();
+    if (mesh.num_edges > 0) {
+        print_locality("Ordre d'origine", &mesh);
+    }
+    if (!keep_order) {
+        int removed = mesh_optimize(&mesh);
+        if (removed < 0) {
+            printf("Préparation impossible (index hors limites ou allocation)\n");
+            free_mesh(&mesh);
+            return 1;
+        }
+        if (mesh.num_edges > 0) {
+            print_locality("Après préparation", &mesh);
+        }
+        printf("%d arêtes dégénérées ou en double retirées, préparation %.1f ms\n", removed,
+               timer_ns_to_ms(timer_now_ns() - loaded));
+    }
+    uint64_t prepared = timer_now_ns();
+    if (!save_mesh_binary(&mesh, argv[2])) {
+        free_mesh(&mesh);
+        return 1;
+    }
+    uint64_t saved = timer_now_ns();
+    printf("%s : %d sommets, %d arêtes uniques (lecture %.1f ms, écriture %.1f ms)\n",
+           argv[2], mesh.num_vertices, mesh.num_edges,
+           timer_ns_to_ms(loaded - start), timer_ns_to_ms(saved - prepared));
+    free_mesh(&mesh);
+    return 0;
+}
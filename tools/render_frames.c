@@ -0,0 +1,324 @@
+// Rendu filaire sans SDL : simule un champ de cubes et trame chaque image dans
+// un Framebuffer, avec écriture PPM optionnelle.
+// Usage : render_frames [--bodies N] [--frames N] [--size LxH] [--output prefixe]
+//                       [--threads N] [--tile N]   (--tile 0 : sans tuilage)
+//                       [--camera Z]  (avance la caméra de Z dans le champ de cubes)
+//                       [--mesh fichier.obj|fichier.pmesh]  (remplace les cubes)
+//                       [--profile trace.json]  (trace Chrome et résumé p50/p99 par étape)
+//                       [--scene]  (matrices monde en cache dans un graphe de scène)
+//                       [--static F]  (fraction F des corps immobiles, entre 0 et 1)
+//                       [--cull]  (corps hors du tronc écartés via une hiérarchie de boîtes)
+//                       [--trajectory fichier.ptraj]  (poses et images en flux, voir trajectory_dump)
+//                       [--pipeline]  (simulation en temps réel sur son propre thread, rendu interpolé)
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/alloc.h"
+#include "engine/jobs.h"
+#include "engine/mesh_io.h"
+#include "engine/object3d.h"
+#include "engine/profile.h"
+#include "engine/raster.h"
+#include "engine/render.h"
+#include "engine/scene.h"
+#include "engine/sim_thread.h"
+#include "engine/timer.h"
+#include "engine/trajectory.h"
+#include "engine/world.h"
+
+// Cubes (ou instances de `mesh`) en rotation devant la caméra, sur une grille carrée.
+// Un corps sur 1/static_fraction est statique (ni vitesse ni masse).
+static int build_scene(World* world, int num_bodies, MeshAsset* mesh, float static_fraction) {
+    int per_row = (int)ceilf(sqrtf((float)num_bodies));
+    float spacing = 2.0f;
+    float half = 0.5f * (per_row - 1) * spacing;
+    for (int i = 0; i < num_bodies; ++i) {
+        Object3D cube;
+        if (mesh == NULL) {
+            create_cube(&cube, 1.0f);
+        } else {
+            create_object_instance(&cube, mesh);
+        }
+        cube.position = (Vec3D){(i % per_row) * spacing - half, (i / per_row) * spacing - half,
+                                half * 1.5f + 3.0f};
+        cube.angular_velocity = (Vec3D){0.5f + 0.01f * (i % 7), 0.8f, 0.0f};
+        // Répartition régulière : le corps i est statique si la part cumulée franchit un entier
+        if ((int)((i + 1) * static_fraction) != (int)(i * static_fraction)) {
+            cube.angular_velocity = (Vec3D){0.0f, 0.0f, 0.0f};
+            object_set_mass(&cube, 0.0f);
+        }
+        if (world_add_body(world, &cube) < 0) {
+            free_object(&cube);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    int num_bodies = 100;
+    int num_frames = 120;
+    int width = 800, height = 600;
+    int num_threads = 1;
+    int tile_size = RENDER_DEFAULT_TILE;
+    float camera_z = 0.0f;
+    const char* output_prefix = NULL;
+    const char* mesh_path = NULL;
+    const char* profile_path = NULL;
+    int use_scene = 0;
+    float static_fraction = 0.0f;
+    int use_culling = 0;
+    const char* trajectory_path = NULL;
+    int pipeline = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bodies") == 0 && i + 1 < argc) num_bodies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) num_frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                printf("Taille invalide : %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output_prefix = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) num_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tile") == 0 && i + 1 < argc) tile_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mesh") == 0 && i + 1 < argc) mesh_path = argv[++i];
+        else if (strcmp(argv[i], "--camera") == 0 && i + 1 < argc) camera_z = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) profile_path = argv[++i];
+        else if (strcmp(argv[i], "--scene") == 0) use_scene = 1;
+        else if (strcmp(argv[i], "--static") == 0 && i + 1 < argc) static_fraction = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--cull") == 0) use_culling = 1;
+        else if (strcmp(argv[i], "--trajectory") == 0 && i + 1 < argc) trajectory_path = argv[++i];
+        else if (strcmp(argv[i], "--pipeline") == 0) pipeline = 1;
+        else {
+            printf("Option inconnue : %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Un seul maillage partagé par tous les corps de la scène
+    MeshAsset* asset = NULL;
+    if (mesh_path != NULL) {
+        uint64_t load_start = timer_now_ns();
+        Mesh mesh;
+        if (!load_mesh_file(&mesh, mesh_path)) {
+            return 1;
+        }
+        asset = mesh_asset_create(&mesh);
+        free_mesh(&mesh);
+        if (asset == NULL) {
+            printf("Allocation impossible pour %s\n", mesh_path);
+            return 1;
+        }
+        printf("%s : %d sommets, %d arêtes, chargé en %.3f ms\n", mesh_path, asset->num_vertices,
+               asset->num_edges, timer_ns_to_ms(timer_now_ns() - load_start));
+    }
+
+    Framebuffer fb;
+    if (!create_framebuffer(&fb, width, height)) {
+        printf("Allocation du framebuffer impossible\n");
+        return 1;
+    }
+    JobSystem* jobs = (num_threads != 1) ? create_job_system(num_threads) : NULL;
+    WireRenderer wire;
+    wire_renderer_init(&wire, width, height);
+    wire_renderer_set_tiling(&wire, jobs, tile_size);
+    wire_renderer_set_culling(&wire, use_culling);
+    World world;
+    create_world(&world, WORLD_DEFAULT_DT);
+    world.gravity = (Vec3D){0.0f, 0.0f, 0.0f};
+    if (static_fraction < 0.0f || static_fraction > 1.0f) {
+        printf("--static attend une fraction entre 0 et 1\n");
+        return 1;
+    }
+    if (pipeline && trajectory_path != NULL) {
+        printf("--trajectory enregistre les pas du monde simulé : incompatible avec --pipeline\n");
+        return 1;
+    }
+    int built = build_scene(&world, num_bodies, asset, static_fraction);
+    // Avec --pipeline, le rendu dessine une copie du monde jamais simulée, où
+    // sont écrites les poses interpolées ; le monde simulé appartient à son thread
+    World view;
+    create_world(&view, WORLD_DEFAULT_DT);
+    if (built && pipeline) {
+        built = build_scene(&view, num_bodies, asset, static_fraction);
+    }
+    World* shown = pipeline ? &view : &world;
+    mesh_asset_release(asset); // Les corps gardent leurs références
+    // Un nœud racine par corps : la pose du corps est la transformation du nœud
+    SceneGraph scene;
+    scene_graph_init(&scene);
+    for (int i = 0; built && use_scene && i < world.num_bodies; ++i) {
+        SceneTransform t = {{0, 0, 0}, QUAT_IDENTITY_INIT, {1, 1, 1}};
+        built = scene_graph_add_node(&scene, -1, i, t) >= 0;
+    }
+    if (!built) {
+        printf("Allocation impossible pour %d cubes\n", num_bodies);
+    }
+    TrajectoryWriter* trajectory = NULL;
+    if (built && trajectory_path != NULL) {
+        trajectory = create_trajectory_writer(trajectory_path, 1, width, height, world.fixed_dt, 0);
+        built = trajectory != NULL;
+    }
+    PoseBuffer poses;
+    pose_buffer_init(&poses, world.fixed_dt);
+    SimThread* sim = NULL;
+    if (built && pipeline) {
+        sim = create_sim_thread(&world, &poses);
+        built = sim != NULL;
+    }
+    if (!built) {
+        pose_buffer_free(&poses);
+        scene_graph_free(&scene);
+        free_world(&view);
+        free_world(&world);
+        wire_renderer_free(&wire);
+        free_job_system(jobs);
+        free_framebuffer(&fb);
+        return 1;
+    }
+    Mat4x4 view_proj = matrix_multiply_matrix(matrix_make_translation(0.0f, 0.0f, -camera_z),
+                                              matrix_make_projection(90.0f, (float)width / (float)height, 0.1f, 1000.0f));
+
+    uint64_t transform_ns = 0, bin_ns = 0, raster_ns = 0;
+    long long num_binned = 0;
+    long long num_lines = 0;
+    long long num_updated = 0;
+    long long num_culled = 0, num_refit = 0;
+    uint64_t cull_ns = 0;
+    uint64_t allocations = 0;
+    ClipStats clip = {0};
+    int status = 0;
+    long long fresh_frames = 0;
+    double alpha_sum = 0.0;
+    profile_set_thread_name("main");
+    profile_set_enabled(profile_path != NULL);
+    uint64_t start = timer_now_ns();
+    for (int frame = 0; frame < num_frames; ++frame) {
+        PROFILE_SCOPE("frame");
+        if (frame == num_frames / 2) allocations = mem_allocation_count();
+        if (pipeline) {
+            // Jamais bloquant : le dernier état publié, ou le même qu'à l'image précédente
+            fresh_frames += pose_buffer_acquire(&poses);
+            alpha_sum += pose_buffer_apply(&poses, timer_now_ns(), &view);
+        } else {
+            world_step(&world);
+        }
+        framebuffer_clear(&fb, RGBA(0, 0, 0, 255));
+        wire_renderer_begin(&wire);
+        int added;
+        if (use_scene) {
+            scene_graph_sync_world(&scene, shown);
+            scene_graph_update(&scene);
+            num_updated += scene.num_updated;
+            added = wire_renderer_add_scene(&wire, shown, &scene, &view_proj);
+        } else {
+            added = wire_renderer_add_world(&wire, shown, &view_proj);
+        }
+        if (!added) {
+            printf("Allocation impossible pour les segments\n");
+            break;
+        }
+        wire_renderer_draw(&wire, &fb, RGBA(255, 255, 255, 255));
+        transform_ns += wire.stats.transform_ns;
+        bin_ns += wire.stats.bin_ns;
+        raster_ns += wire.stats.raster_ns;
+        num_lines += wire.stats.num_lines;
+        num_binned += wire.stats.num_binned;
+        num_culled += wire.stats.num_culled;
+        num_refit += wire.stats.num_refit;
+        cull_ns += wire.stats.cull_ns;
+        clip.culled += wire.stats.clip.culled;
+        clip.clipped += wire.stats.clip.clipped;
+        clip.accepted += wire.stats.clip.accepted;
+
+        if (output_prefix != NULL) {
+            PROFILE_SCOPE("present");
+            char path[512];
+            snprintf(path, sizeof(path), "%s%04d.ppm", output_prefix, frame);
+            if (!framebuffer_write_ppm(&fb, path)) {
+                printf("Impossible d'écrire %s\n", path);
+                break;
+            }
+        }
+        if (trajectory != NULL) {
+            PROFILE_SCOPE("trajectory");
+            if (!trajectory_append(trajectory, &world, &fb)) {
+                status = 1;
+                break;
+            }
+        }
+    }
+    double elapsed = (double)(timer_now_ns() - start) * 1e-9;
+    allocations = mem_allocation_count() - allocations;
+    SimThreadStats sim_stats = {0};
+    if (sim != NULL) {
+        sim_stats = sim_thread_stats(sim);
+        free_sim_thread(sim);
+    }
+    profile_set_enabled(0);
+    double frames = num_frames > 0 ? num_frames : 1;
+
+    printf("%d cubes, %d images %dx%d, %d thread(s), tuiles %d : %.3f s (%.1f images/s)\n",
+           world.num_bodies, num_frames, width, height, job_system_num_threads(jobs), tile_size,
+           elapsed, num_frames / (elapsed > 0.0 ? elapsed : 1e-9));
+    printf("Par image : transformation %.3f ms, répartition %.3f ms, tramage %.3f ms\n",
+           timer_ns_to_ms(transform_ns) / frames, timer_ns_to_ms(bin_ns) / frames,
+           timer_ns_to_ms(raster_ns) / frames);
+    printf("Par image : %.0f segments, %.0f références segment-tuile\n",
+           num_lines / frames, num_binned / frames);
+    printf("Découpe par image : %.0f arêtes rejetées, %.0f découpées, %.0f acceptées\n",
+           clip.culled / frames, clip.clipped / frames, clip.accepted / frames);
+    if (use_culling) {
+        printf("Élagage par image : %.0f corps écartés sur %d, %.0f nœuds réajustés, %.3f ms (%d construction(s))\n",
+               num_culled / frames, world.num_bodies, num_refit / frames, timer_ns_to_ms(cull_ns) / frames,
+               wire.bvh.num_builds);
+    }
+    if (pipeline) {
+        double steps = sim_stats.steps ? (double)sim_stats.steps : 1.0;
+        printf("Simulation : %llu pas en %.3f s (%.1f pas/s, cible %.1f), %llu abandonnés, %.3f ms/pas, "
+               "publication %.3f ms\n",
+               (unsigned long long)sim_stats.steps, elapsed, sim_stats.steps / (elapsed > 0.0 ? elapsed : 1e-9),
+               1.0 / world.fixed_dt, (unsigned long long)sim_stats.dropped_steps,
+               timer_ns_to_ms(sim_stats.step_ns) / steps,
+               timer_ns_to_ms(sim_stats.publish_ns) / (sim_stats.publishes ? (double)sim_stats.publishes : 1.0));
+        printf("Rendu : %lld images sur %d avec un nouvel état, fraction d'interpolation moyenne %.2f\n",
+               fresh_frames, num_frames, alpha_sum / frames);
+    }
+    if (use_scene) {
+        printf("Graphe de scène : %.0f nœuds recalculés par image sur %d\n", num_updated / frames, scene.count);
+    }
+    if (mem_counting_enabled()) {
+        printf("Allocations pendant la seconde moitié des images : %llu\n", (unsigned long long)allocations);
+    }
+    if (trajectory != NULL) {
+        if (trajectory_finish(trajectory)) {
+            TrajectoryStats st = trajectory_writer_stats(trajectory);
+            printf("Trajectoire %s : %llu images, %.1f Mo écrits (%.1f %% du brut), capture %.3f ms/image, "
+                   "attente %.3f ms, codage %.3f ms/image (thread d'écriture)\n",
+                   trajectory_path, (unsigned long long)st.num_frames, st.file_bytes / (1024.0 * 1024.0),
+                   st.raw_bytes ? 100.0 * st.file_bytes / st.raw_bytes : 0.0,
+                   timer_ns_to_ms(st.capture_ns) / frames, timer_ns_to_ms(st.stall_ns),
+                   timer_ns_to_ms(st.encode_ns) / frames);
+        }
+        if (!free_trajectory_writer(trajectory)) status = 1;
+    }
+    if (profile_path != NULL) {
+        profile_print_summary(stdout);
+        if (profile_write_chrome_trace(profile_path)) {
+            printf("Trace écrite dans %s\n", profile_path);
+        }
+    }
+
+    pose_buffer_free(&poses);
+    scene_graph_free(&scene);
+    free_world(&view);
+    free_world(&world);
+    wire_renderer_free(&wire);
+    free_job_system(jobs);
+    free_framebuffer(&fb);
+    return status;
+}
@@ -0,0 +1,436 @@
+// Banc de charge sans affichage, pour dimensionner les machines et repérer
+// une perte de passage à l'échelle avant une livraison. Chaque scène est
+// construite à partir de zéro, puis simulée un nombre fixe de pas avec 1, 2,
+// 4... threads jusqu'au maximum : débit, durée de chaque étape, mémoire
+// maximale et accélération par rapport à un thread. Résultats en JSON (sur
+// la sortie standard ou dans --output), progression sur la sortie d'erreur.
+// Usage : stress [--scene falling|pyramids|field|meshes|all] [--bodies N]
+//                [--steps N] [--warmup N] [--threads N] [--deterministic]
+//                [--broadphase grid|sap|brute] [--narrowphase aabb|gjk]
+//                [--mesh-detail N] [--no-sleep]
+//                [--output fichier.json]
+// --threads : nombre maximal de threads (défaut : un par cœur)
+// --broadphase : grille par défaut, la plus rapide sur ces scènes étendues
+// --warmup : pas simulés avant la mesure, le temps que les contacts s'établissent
+// --deterministic : découpage fixe du travail ; l'empreinte finale doit alors
+//                   être la même pour tous les nombres de threads
+// --mesh-detail : anneaux des sphères de la scène meshes (environ 2 N² sommets)
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "engine/broadphase.h"
+#include "engine/jobs.h"
+#include "engine/kernels.h"
+#include "engine/mesh.h"
+#include "engine/mesh_asset.h"
+#include "engine/object3d.h"
+#include "engine/timer.h"
+#include "engine/world.h"
+
+// --- Configuration ---
+#define STRESS_DEFAULT_BODIES 20000
+#define STRESS_DEFAULT_STEPS 200
+#define STRESS_DEFAULT_WARMUP 60
+#define STRESS_DEFAULT_MESH_DETAIL 12
+#define STRESS_PYRAMID_BASE 10  // 55 cubes par pyramide
+#define STRESS_SEED 0x9e3779b9u
+#define STRESS_MAX_RUNS 32
+
+typedef int (*SceneBuilder)(World* world, int num_bodies, int mesh_detail);
+
+typedef struct {
+    const char* name;
+    SceneBuilder build;
+} StressScene;
+
+enum { STAGE_INTEGRATE, STAGE_BROADPHASE, STAGE_NARROWPHASE, STAGE_ISLANDS, STAGE_SOLVE, STAGE_CCD, STAGE_SLEEP,
+       NUM_STAGES };
+static const char* stage_names[NUM_STAGES] = {"integrate", "broadphase", "narrowphase", "islands",
+                                              "solve", "ccd", "sleep"};
+
+// Une exécution d'une scène avec un nombre de threads donné
+typedef struct {
+    int threads;
+    double seconds;            // Pas mesurés seulement
+    double stage_ms[NUM_STAGES]; // Moyennes par pas
+    double step_p50_ms, step_p99_ms;
+    double pairs, contacts, awake; // Moyennes par pas
+    double peak_rss_mb;
+    uint64_t hash;
+} StressRun;
+
+typedef struct {
+    int num_steps;
+    int warmup;
+    int deterministic;
+    int allow_sleep;
+    int mesh_detail;
+    const char* broadphase;
+    NarrowPhaseKind narrowphase;
+} StressConfig;
+
+static uint32_t rng_state = STRESS_SEED;
+
+// xorshift32 : mêmes scènes d'une exécution et d'une machine à l'autre
+static float frand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state >> 8) * (1.0f / 16777216.0f);
+}
+
+static BroadPhase* broadphase_from_name(const char* name) {
+    if (strcmp(name, "brute") == 0) return create_broadphase_brute_force();
+    if (strcmp(name, "sap") == 0) return create_broadphase_sap();
+    return create_broadphase_hash_grid(0.0f);
+}
+
+// --- Scènes ---
+
+static int add_body(World* world, Object3D* body) {
+    if (world_add_body(world, body) < 0) {
+        free_object(body);
+        return 0;
+    }
+    return 1;
+}
+
+static int add_cube(World* world, Vec3D position, Vec3D scale, Quat orientation, float mass) {
+    Object3D cube;
+    create_cube(&cube, 1.0f);
+    cube.position = position;
+    cube.scale = scale;
+    cube.orientation = orientation;
+    object_set_mass(&cube, mass);
+    return add_body(world, &cube);
+}
+
+static int add_ground(World* world, float extent) {
+    return add_cube(world, (Vec3D){0.0f, -0.5f, 0.0f}, (Vec3D){extent, 1.0f, extent}, quat_identity(), 0.0f);
+}
+
+static Quat random_orientation(void) {
+    return quat_from_euler((Vec3D){6.2832f * frand(), 6.2832f * frand(), 6.2832f * frand()});
+}
+
+// Côté d'un réseau carré de `count` cases
+static int lattice_side(int count) {
+    int side = 1;
+    while (side * side < count) ++side;
+    return side;
+}
+
+// Cubes de create_cube lâchés en colonnes au-dessus d'un sol, orientations
+// tirées au hasard : ils tombent, rebondissent et s'entassent
+static int build_falling(World* world, int num_bodies, int mesh_detail) {
+    (void)mesh_detail;
+    int layers = (int)ceilf(cbrtf((float)num_bodies));
+    int side = lattice_side((num_bodies + layers - 1) / layers);
+    if (!add_ground(world, side * 1.6f + 4.0f)) return 0;
+    for (int i = 0; i < num_bodies; ++i) {
+        int layer = i / (side * side), cell = i % (side * side);
+        Vec3D p = {((cell % side) - 0.5f * (side - 1)) * 1.6f, 2.0f + layer * 1.6f,
+                   ((cell / side) - 0.5f * (side - 1)) * 1.6f};
+        if (!add_cube(world, p, (Vec3D){1, 1, 1}, random_orientation(), 1.0f)) return 0;
+    }
+    return 1;
+}
+
+// Pyramides de STRESS_PYRAMID_BASE cubes de base, côte à côte : chacune est
+// un îlot aux contacts fortement couplés, dominé par le solveur
+static int build_pyramids(World* world, int num_bodies, int mesh_detail) {
+    (void)mesh_detail;
+    const int base = STRESS_PYRAMID_BASE, per_pyramid = base * (base + 1) / 2;
+    int num_pyramids = (num_bodies + per_pyramid - 1) / per_pyramid;
+    int side = lattice_side(num_pyramids);
+    float spacing = base * 1.05f + 2.0f;
+    if (!add_ground(world, side * spacing + 4.0f)) return 0;
+    for (int p = 0, added = 0; p < num_pyramids; ++p) {
+        Vec3D origin = {((p % side) - 0.5f * (side - 1)) * spacing, 0.0f, ((p / side) - 0.5f * (side - 1)) * 3.0f};
+        for (int level = 0; level < base && added < num_bodies; ++level) {
+            int count = base - level;
+            for (int i = 0; i < count && added < num_bodies; ++i, ++added) {
+                Vec3D pos = {origin.x + (i - 0.5f * (count - 1)) * 1.05f, 0.5f + level * 1.0f, origin.z};
+                if (!add_cube(world, pos, (Vec3D){1, 1, 1}, quat_identity(), 1.0f)) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Boîtes de tailles et d'orientations aléatoires réparties dans un volume
+// rempli à ~30 %, au-dessus d'un sol
+static int build_field(World* world, int num_bodies, int mesh_detail) {
+    (void)mesh_detail;
+    float side = 1.5f * cbrtf((float)num_bodies);
+    if (!add_ground(world, side + 4.0f)) return 0;
+    for (int i = 0; i < num_bodies; ++i) {
+        Vec3D p = {side * (frand() - 0.5f), 1.0f + side * frand(), side * (frand() - 0.5f)};
+        Vec3D scale = {0.5f + frand(), 0.5f + frand(), 0.5f + frand()};
+        if (!add_cube(world, p, scale, random_orientation(), scale.x * scale.y * scale.z)) return 0;
+    }
+    return 1;
+}
+
+// Sphères à nombreux sommets, instances d'un même maillage partagé : le
+// support GJK et la transformation des sommets dominent
+static int build_meshes(World* world, int num_bodies, int mesh_detail) {
+    Mesh sphere = create_sphere_mesh(mesh_detail, 2 * mesh_detail, 0.5f);
+    MeshAsset* asset = sphere.num_vertices > 0 ? mesh_asset_create(&sphere) : NULL;
+    free_mesh(&sphere);
+    if (asset == NULL) return 0;
+    int layers = (int)ceilf(cbrtf((float)num_bodies));
+    int side = lattice_side((num_bodies + layers - 1) / layers);
+    int ok = add_ground(world, side * 1.3f + 4.0f);
+    for (int i = 0; i < num_bodies && ok; ++i) {
+        int layer = i / (side * side), cell = i % (side * side);
+        Object3D body;
+        create_object_instance(&body, asset);
+        body.position = (Vec3D){((cell % side) - 0.5f * (side - 1)) * 1.3f + 0.1f * frand(), 1.0f + layer * 1.3f,
+                                ((cell / side) - 0.5f * (side - 1)) * 1.3f + 0.1f * frand()};
+        body.orientation = random_orientation();
+        ok = add_body(world, &body);
+    }
+    mesh_asset_release(asset);
+    return ok;
+}
+
+static const StressScene scenes[] = {
+    {"falling", build_falling},
+    {"pyramids", build_pyramids},
+    {"field", build_field},
+    {"meshes", build_meshes},
+};
+#define NUM_SCENES ((int)(sizeof(scenes) / sizeof(scenes[0])))
+
+// --- Mesures ---
+
+// Remet à zéro le maximum de mémoire résidente du processus (Linux) ;
+// retourne 0 si le noyau le refuse : le maximum est alors celui du processus
+static int reset_peak_rss(void) {
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (f == NULL) {
+        return 0;
+    }
+    int ok = fputs("5", f) >= 0;
+    return fclose(f) == 0 && ok;
+}
+
+// Mémoire résidente maximale (Mo) depuis la dernière remise à zéro
+static double peak_rss_mb(void) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f == NULL) {
+        return 0.0;
+    }
+    char line[256];
+    long kb = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) break;
+    }
+    fclose(f);
+    return kb / 1024.0;
+}
+
+// Empreinte FNV-1a de l'état des corps, comme celle de headless
+static uint64_t state_hash(const BodySoA* s) {
+    uint64_t h = 1469598103934665603ull;
+#define HASH_FIELD(f) \
+    for (int i = 0; i < s->count; ++i) { \
+        const unsigned char* p = (const unsigned char*)&s->f[i]; \
+        for (size_t k = 0; k < sizeof(float); ++k) h = (h ^ p[k]) * 1099511628211ull; \
+    }
+    BODY_SOA_FIELDS(HASH_FIELD)
+#undef HASH_FIELD
+    return h;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Construit la scène, la met en route puis mesure `num_steps` pas. Retourne
+// 0 en cas d'échec d'allocation.
+static int run_scene(const StressScene* scene, int num_bodies, int threads, const StressConfig* cfg,
+                     int rss_reset, StressRun* run, int* num_world_bodies, long long* num_vertices) {
+    uint64_t* step_ns = (uint64_t*)malloc((size_t)(cfg->num_steps > 0 ? cfg->num_steps : 1) * sizeof(uint64_t));
+    JobSystem* jobs = threads > 1 ? create_job_system(threads) : NULL;
+    if (step_ns == NULL || (threads > 1 && jobs == NULL)) {
+        free(step_ns);
+        free_job_system(jobs);
+        return 0;
+    }
+    if (rss_reset) reset_peak_rss();
+    rng_state = STRESS_SEED;
+    World world;
+    create_world(&world, WORLD_DEFAULT_DT);
+    world_set_broadphase(&world, broadphase_from_name(cfg->broadphase));
+    world_set_job_system(&world, jobs, cfg->deterministic);
+    world.narrowphase = cfg->narrowphase;
+    world.allow_sleep = cfg->allow_sleep;
+    int ok = world_reserve(&world, num_bodies + 1) && scene->build(&world, num_bodies, cfg->mesh_detail);
+    if (ok) {
+        *num_world_bodies = world.num_bodies;
+        *num_vertices = 0;
+        for (int i = 0; i < world.num_bodies; ++i) *num_vertices += world.bodies[i].mesh->num_vertices;
+        for (int s = 0; s < cfg->warmup; ++s) world_step(&world);
+
+        memset(run, 0, sizeof(*run));
+        run->threads = threads;
+        uint64_t start = timer_now_ns();
+        for (int s = 0; s < cfg->num_steps; ++s) {
+            world_step(&world);
+            const WorldStats* st = &world.stats;
+            run->stage_ms[STAGE_INTEGRATE] += timer_ns_to_ms(st->integrate_ns);
+            run->stage_ms[STAGE_BROADPHASE] += timer_ns_to_ms(st->broadphase_ns);
+            run->stage_ms[STAGE_NARROWPHASE] += timer_ns_to_ms(st->narrowphase_ns);
+            run->stage_ms[STAGE_ISLANDS] += timer_ns_to_ms(st->islands_ns);
+            run->stage_ms[STAGE_SOLVE] += timer_ns_to_ms(st->solve_ns);
+            run->stage_ms[STAGE_CCD] += timer_ns_to_ms(st->ccd_ns);
+            run->stage_ms[STAGE_SLEEP] += timer_ns_to_ms(st->sleep_ns);
+            run->pairs += st->num_pairs;
+            run->contacts += st->num_contacts;
+            run->awake += st->num_awake;
+            step_ns[s] = st->step_ns;
+        }
+        run->seconds = (double)(timer_now_ns() - start) * 1e-9;
+        double steps = cfg->num_steps > 0 ? cfg->num_steps : 1;
+        for (int k = 0; k < NUM_STAGES; ++k) run->stage_ms[k] /= steps;
+        run->pairs /= steps;
+        run->contacts /= steps;
+        run->awake /= steps;
+        if (cfg->num_steps > 0) {
+            qsort(step_ns, (size_t)cfg->num_steps, sizeof(uint64_t), compare_u64);
+            run->step_p50_ms = timer_ns_to_ms(step_ns[(cfg->num_steps - 1) / 2]);
+            run->step_p99_ms = timer_ns_to_ms(step_ns[(cfg->num_steps - 1) * 99 / 100]);
+        }
+        run->hash = state_hash(&world.state);
+        run->peak_rss_mb = peak_rss_mb();
+    }
+    free_world(&world);
+    free_job_system(jobs);
+    free(step_ns);
+    return ok;
+}
+
+// --- Sortie JSON ---
+
+static void write_run(FILE* f, const StressRun* run, const StressRun* single, int num_steps, int last) {
+    double rate = run->seconds > 0.0 ? num_steps / run->seconds : 0.0;
+    double speedup = run->seconds > 0.0 ? single->seconds / run->seconds : 0.0;
+    fprintf(f, "      {\"threads\":%d,\"seconds\":%.4f,\"steps_per_s\":%.2f,\"speedup\":%.3f,\"efficiency\":%.3f,",
+            run->threads, run->seconds, rate, speedup, speedup / run->threads);
+    fprintf(f, "\"step_p50_ms\":%.4f,\"step_p99_ms\":%.4f,\"stages_ms\":{", run->step_p50_ms, run->step_p99_ms);
+    for (int k = 0; k < NUM_STAGES; ++k) {
+        fprintf(f, "\"%s\":%.4f%s", stage_names[k], run->stage_ms[k], k + 1 < NUM_STAGES ? "," : "");
+    }
+    fprintf(f, "},\"pairs\":%.1f,\"contacts\":%.1f,\"awake\":%.1f,\"peak_rss_mb\":%.1f,\"hash\":\"%016llx\"}%s\n",
+            run->pairs, run->contacts, run->awake, run->peak_rss_mb, (unsigned long long)run->hash,
+            last ? "" : ",");
+}
+
+int main(int argc, char* argv[]) {
+    const char* scene_name = "all";
+    const char* output_path = NULL;
+    int num_bodies = STRESS_DEFAULT_BODIES;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = cores > 0 ? (int)cores : 1;
+    StressConfig cfg = {STRESS_DEFAULT_STEPS, STRESS_DEFAULT_WARMUP, 0, 1, STRESS_DEFAULT_MESH_DETAIL, "grid",
+                         NARROWPHASE_GJK};
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) scene_name = argv[++i];
+        else if (strcmp(argv[i], "--bodies") == 0 && i + 1 < argc) num_bodies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) cfg.num_steps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) cfg.warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) max_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--deterministic") == 0) cfg.deterministic = 1;
+        else if (strcmp(argv[i], "--broadphase") == 0 && i + 1 < argc) cfg.broadphase = argv[++i];
+        else if (strcmp(argv[i], "--narrowphase") == 0 && i + 1 < argc &&
+                 (strcmp(argv[i + 1], "aabb") == 0 || strcmp(argv[i + 1], "gjk") == 0)) {
+            cfg.narrowphase = (strcmp(argv[++i], "aabb") == 0) ? NARROWPHASE_AABB : NARROWPHASE_GJK;
+        }
+        else if (strcmp(argv[i], "--mesh-detail") == 0 && i + 1 < argc) cfg.mesh_detail = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-sleep") == 0) cfg.allow_sleep = 0;
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output_path = argv[++i];
+        else {
+            printf("Option inconnue : %s\n", argv[i]);
+            return 1;
+        }
+    }
+    int first_scene = -1;
+    for (int k = 0; k < NUM_SCENES; ++k) {
+        if (strcmp(scene_name, scenes[k].name) == 0) first_scene = k;
+    }
+    if (first_scene < 0 && strcmp(scene_name, "all") != 0) {
+        printf("Scène inconnue : %s (falling, pyramids, field, meshes ou all)\n", scene_name);
+        return 1;
+    }
+    if (num_bodies < 1 || cfg.num_steps < 1 || cfg.warmup < 0 || max_threads < 1 || cfg.mesh_detail < 2) {
+        printf("--bodies, --steps et --threads doivent valoir au moins 1, --mesh-detail au moins 2\n");
+        return 1;
+    }
+    if (strcmp(cfg.broadphase, "sap") != 0 && strcmp(cfg.broadphase, "grid") != 0 &&
+        strcmp(cfg.broadphase, "brute") != 0) {
+        printf("Phase large inconnue : %s (grid, sap ou brute)\n", cfg.broadphase);
+        return 1;
+    }
+    int last_scene = first_scene < 0 ? NUM_SCENES - 1 : first_scene;
+    if (first_scene < 0) first_scene = 0;
+
+    // 1, 2, 4... puis le maximum demandé
+    int thread_counts[STRESS_MAX_RUNS];
+    int num_runs = 0;
+    for (int t = 1; t < max_threads && num_runs < STRESS_MAX_RUNS - 1; t *= 2) thread_counts[num_runs++] = t;
+    thread_counts[num_runs++] = max_threads;
+
+    FILE* out = stdout;
+    if (output_path != NULL && (out = fopen(output_path, "w")) == NULL) {
+        printf("Impossible de créer %s\n", output_path);
+        return 1;
+    }
+    int rss_reset = reset_peak_rss();
+    fprintf(out, "{\"tool\":\"stress\",\"simd\":\"%s\",\"cores\":%ld,\"steps\":%d,\"warmup\":%d,"
+                 "\"broadphase\":\"%s\",\"narrowphase\":\"%s\",\"deterministic\":%s,\"sleep\":%s,"
+                 "\"peak_rss_scope\":\"%s\",\"scenes\":[\n",
+            kernels_get()->name, cores, cfg.num_steps, cfg.warmup, cfg.broadphase,
+            cfg.narrowphase == NARROWPHASE_GJK ? "gjk" : "aabb", cfg.deterministic ? "true" : "false", cfg.allow_sleep ? "true" : "false",
+            rss_reset ? "run" : "process");
+    int status = 0;
+    for (int k = first_scene; k <= last_scene; ++k) {
+        StressRun runs[STRESS_MAX_RUNS];
+        int world_bodies = 0;
+        long long vertices = 0;
+        int done = 0;
+        for (; done < num_runs; ++done) {
+            fprintf(stderr, "%s : %d corps, %d thread(s)...", scenes[k].name, num_bodies, thread_counts[done]);
+            if (!run_scene(&scenes[k], num_bodies, thread_counts[done], &cfg, rss_reset, &runs[done],
+                           &world_bodies, &vertices)) {
+                fprintf(stderr, " allocation impossible\n");
+                status = 1;
+                break;
+            }
+            fprintf(stderr, " %.1f pas/s\n", cfg.num_steps / (runs[done].seconds > 0.0 ? runs[done].seconds : 1e-9));
+        }
+        int hashes_match = 1;
+        for (int r = 1; r < done; ++r) hashes_match &= runs[r].hash == runs[0].hash;
+        fprintf(out, "  {\"scene\":\"%s\",\"bodies\":%d,\"vertices\":%lld,\"hashes_match\":%s,\"runs\":[\n",
+                scenes[k].name, world_bodies, vertices, hashes_match ? "true" : "false");
+        for (int r = 0; r < done; ++r) write_run(out, &runs[r], &runs[0], cfg.num_steps, r + 1 == done);
+        fprintf(out, "  ]}%s\n", k < last_scene ? "," : "");
+        if (cfg.deterministic && !hashes_match) {
+            fprintf(stderr, "%s : empreintes différentes selon le nombre de threads\n", scenes[k].name);
+            status = 1;
+        }
+    }
+    fprintf(out, "]}\n");
+    if (out != stdout && fclose(out) != 0) {
+        printf("Écriture incomplète de %s\n", output_path);
+        return 1;
+    }
+    return status;
+}
@@ -0,0 +1,151 @@
+// Lecture d'une trajectoire (.ptraj) écrite par headless ou render_frames.
+// Usage : trajectory_dump fichier.ptraj [--step N] [--body ID] [--ppm sortie.ppm]
+//                         [--csv sortie.csv] [--seeks N]
+// Sans option : résumé du fichier (images, morceaux, taux de compression)
+// --step : pose du corps --body (0 par défaut) au pas N, temps d'accès compris
+// --ppm : image du pas --step (ou de la dernière image)
+// --csv : pose du corps --body à chaque image enregistrée
+// --seeks : N accès à des pas tirés au hasard, temps moyen par accès
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/raster.h"
+#include "engine/timer.h"
+#include "engine/trajectory.h"
+
+static void print_pose(const TrajectoryFrame* f, int body) {
+    if (body < 0 || body >= f->num_bodies) {
+        printf("Pas %llu : pas de corps %d (%d corps)\n", (unsigned long long)f->step, body, f->num_bodies);
+        return;
+    }
+    const TrajectoryTransform* t = &f->transforms[body];
+    printf("Pas %llu, corps %d/%d : position (%.4f, %.4f, %.4f), orientation (%.4f, %.4f, %.4f, %.4f)\n",
+           (unsigned long long)f->step, body, f->num_bodies, t->position.x, t->position.y, t->position.z,
+           t->orientation.x, t->orientation.y, t->orientation.z, t->orientation.w);
+}
+
+// Octets bruts et codés de tous les morceaux, d'après leurs en-têtes
+static void chunk_sizes(const TrajectoryReader* r, uint64_t* raw, uint64_t* encoded) {
+    *raw = *encoded = 0;
+    for (uint64_t c = 0; c < r->num_chunks; ++c) {
+        TrajectoryChunkHeader ch;
+        memcpy(&ch, (const char*)r->mapping + r->chunk_offsets[c], sizeof(ch));
+        *raw += ch.raw_size;
+        *encoded += ch.encoded_size;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage : %s fichier.ptraj [--step N] [--body ID] [--ppm sortie.ppm] [--csv sortie.csv] "
+               "[--seeks N]\n", argv[0]);
+        return 1;
+    }
+    const char* path = argv[1];
+    long long step = -1;
+    int body = 0;
+    const char* ppm_path = NULL;
+    const char* csv_path = NULL;
+    int seeks = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) step = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--body") == 0 && i + 1 < argc) body = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) ppm_path = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csv_path = argv[++i];
+        else if (strcmp(argv[i], "--seeks") == 0 && i + 1 < argc) seeks = atoi(argv[++i]);
+        else {
+            printf("Option inconnue : %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    uint64_t t0 = timer_now_ns();
+    TrajectoryReader r;
+    if (!trajectory_reader_open(&r, path)) {
+        return 1;
+    }
+    uint64_t raw, encoded;
+    chunk_sizes(&r, &raw, &encoded);
+    printf("%s : %llu images (pas %llu à %llu, tous les %u), %llu morceaux de %u images%s, ouvert en %.3f ms\n",
+           path, (unsigned long long)r.num_frames, (unsigned long long)r.first_step,
+           (unsigned long long)(r.first_step + (r.num_frames ? r.num_frames - 1 : 0) * r.header.stride),
+           r.header.stride, (unsigned long long)r.num_chunks, r.frames_per_chunk,
+           r.recovered ? " (table reconstruite)" : "", timer_ns_to_ms(timer_now_ns() - t0));
+    if (r.header.width > 0) {
+        printf("Images %ux%u\n", r.header.width, r.header.height);
+    }
+    printf("%.1f Mo bruts, %.1f Mo codés (%.1f %%)\n", raw / (1024.0 * 1024.0), encoded / (1024.0 * 1024.0),
+           raw ? 100.0 * encoded / raw : 0.0);
+
+    int status = 0;
+    TrajectoryFrame frame;
+    if (step >= 0) {
+        int64_t f = trajectory_frame_of_step(&r, (uint64_t)step);
+        t0 = timer_now_ns();
+        if (f < 0) {
+            printf("Pas %lld non enregistré\n", step);
+            status = 1;
+        } else if (!trajectory_read_frame(&r, (uint64_t)f, &frame)) {
+            printf("%s : morceau corrompu\n", path);
+            status = 1;
+        } else {
+            printf("Image %lld lue en %.3f ms\n", (long long)f, timer_ns_to_ms(timer_now_ns() - t0));
+            print_pose(&frame, body);
+        }
+    }
+    if (status == 0 && ppm_path != NULL) {
+        uint64_t f = step >= 0 ? (uint64_t)trajectory_frame_of_step(&r, (uint64_t)step) : r.num_frames - 1;
+        if (r.num_frames == 0 || !trajectory_read_frame(&r, f, &frame) || frame.pixels == NULL) {
+            printf("%s : pas d'image à écrire\n", path);
+            status = 1;
+        } else {
+            Framebuffer fb = {(uint32_t*)frame.pixels, frame.width, frame.height, frame.width};
+            if (framebuffer_write_ppm(&fb, ppm_path)) {
+                printf("Image du pas %llu écrite dans %s\n", (unsigned long long)frame.step, ppm_path);
+            } else {
+                printf("Impossible d'écrire %s\n", ppm_path);
+                status = 1;
+            }
+        }
+    }
+    if (status == 0 && csv_path != NULL) {
+        FILE* out = fopen(csv_path, "w");
+        if (out == NULL) {
+            printf("Impossible de créer %s\n", csv_path);
+            return 1;
+        }
+        fprintf(out, "step,x,y,z,qx,qy,qz,qw\n");
+        uint64_t f = 0;
+        for (; f < r.num_frames && trajectory_read_frame(&r, f, &frame); ++f) {
+            if (body >= frame.num_bodies) continue;
+            const TrajectoryTransform* t = &frame.transforms[body];
+            fprintf(out, "%llu,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n", (unsigned long long)frame.step,
+                    t->position.x, t->position.y, t->position.z, t->orientation.x, t->orientation.y,
+                    t->orientation.z, t->orientation.w);
+        }
+        fclose(out);
+        if (f < r.num_frames) {
+            printf("%s : morceau corrompu à l'image %llu\n", path, (unsigned long long)f);
+            status = 1;
+        } else {
+            printf("Corps %d : %llu poses écrites dans %s\n", body, (unsigned long long)f, csv_path);
+        }
+    }
+    if (status == 0 && seeks > 0 && r.num_frames > 0) {
+        // Sauts au hasard : chaque accès décode au plus un morceau
+        srand(42);
+        t0 = timer_now_ns();
+        for (int i = 0; i < seeks; ++i) {
+            uint64_t f = (uint64_t)(((double)rand() / ((double)RAND_MAX + 1.0)) * (double)r.num_frames);
+            if (!trajectory_read_frame(&r, f, &frame)) {
+                printf("%s : morceau corrompu à l'image %llu\n", path, (unsigned long long)f);
+                status = 1;
+                break;
+            }
+        }
+        printf("%d accès au hasard : %.3f ms par accès\n", seeks, timer_ns_to_ms(timer_now_ns() - t0) / seeks);
+    }
+    trajectory_reader_close(&r);
+    return status;
+}